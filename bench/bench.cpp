@@ -0,0 +1,223 @@
+#include "bench.h"
+
+#include <new>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <iomanip>
+#include <algorithm>
+
+// Allocation Counters
+// These are updated by replaced global operator new, so that allocations in kernels (including std::vector in core) are counted.
+static std::atomic<uint64_t> allocation_count( 0 );
+static std::atomic<uint64_t> allocation_bytes( 0 );
+
+static void* allocate( const size_t size )
+{
+    allocation_count.fetch_add( 1, std::memory_order_relaxed );
+    allocation_bytes.fetch_add( size, std::memory_order_relaxed );
+    return std::malloc( size == 0 ? 1 : size );
+}
+
+void* operator new( size_t size )
+{
+    void* pointer = allocate( size );
+    if( !pointer ){
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[]( size_t size )
+{
+    return ::operator new( size );
+}
+
+void* operator new( size_t size, const std::nothrow_t& ) noexcept
+{
+    return allocate( size );
+}
+
+void* operator new[]( size_t size, const std::nothrow_t& ) noexcept
+{
+    return allocate( size );
+}
+
+void operator delete( void* pointer ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete[]( void* pointer ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete( void* pointer, const std::nothrow_t& ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete[]( void* pointer, const std::nothrow_t& ) noexcept
+{
+    std::free( pointer );
+}
+
+namespace bench
+{
+    // Retrieve Allocations since Program Start
+    bench::Allocations allocations()
+    {
+        bench::Allocations allocations;
+        allocations.count = allocation_count.load( std::memory_order_relaxed );
+        allocations.bytes = allocation_bytes.load( std::memory_order_relaxed );
+        return allocations;
+    }
+
+    // Percentile of Sorted Samples (Nearest Rank)
+    static double percentile( const std::vector<double>& sorted, const double p )
+    {
+        if( sorted.empty() ){
+            return 0.0;
+        }
+
+        const size_t rank = static_cast<size_t>( std::ceil( p * sorted.size() ) );
+        return sorted[std::min( std::max( rank, static_cast<size_t>( 1 ) ), sorted.size() ) - 1];
+    }
+
+    // Constructor
+    Runner::Runner( const bench::Options& options )
+        : options( options )
+    {
+        samples.reserve( static_cast<size_t>( options.max_iterations ) );
+    }
+
+    // Run Benchmark
+    const bench::Result& Runner::run( const std::string& kernel, const std::string& source,
+                                      const int32_t width, const int32_t height, const int32_t threads,
+                                      const uint64_t pixels, const uint64_t bytes,
+                                      const std::function<void( const uint64_t )>& prepare,
+                                      const std::function<void( const uint64_t )>& body )
+    {
+        typedef std::chrono::steady_clock clock;
+
+        // Warm Up (Allocate Internal Buffers of Kernels, Fill Caches)
+        for( uint64_t iteration = 0; iteration < options.warmup; iteration++ ){
+            prepare( iteration );
+            body( iteration );
+        }
+
+        // Measure
+        samples.clear();
+        uint64_t count = 0;
+        uint64_t count_allocated = 0;
+        uint64_t bytes_allocated = 0;
+        double total = 0.0;
+        while( count < options.max_iterations && ( count < options.min_iterations || total < options.min_time * 1e9 ) ){
+            const uint64_t iteration = options.warmup + count;
+            prepare( iteration );
+
+            const bench::Allocations before = bench::allocations();
+            const clock::time_point start = clock::now();
+            body( iteration );
+            const clock::time_point end = clock::now();
+            const bench::Allocations after = bench::allocations();
+
+            const double elapsed = static_cast<double>( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() );
+            samples.push_back( elapsed );
+            total += elapsed;
+            bytes_allocated += after.bytes - before.bytes;
+            count_allocated += after.count - before.count;
+            count++;
+        }
+
+        std::sort( samples.begin(), samples.end() );
+
+        bench::Result result;
+        result.kernel = kernel;
+        result.source = source;
+        result.width = width;
+        result.height = height;
+        result.threads = threads;
+        result.backend = backend;
+        result.load = load;
+        result.iterations = count;
+        result.min = samples.front();
+        result.mean = total / count;
+        result.p50 = percentile( samples, 0.50 );
+        result.p99 = percentile( samples, 0.99 );
+        result.max = samples.back();
+        result.ns_per_pixel = pixels ? result.p50 / pixels : 0.0;
+        result.gb_per_s = ( bytes && result.p50 > 0.0 ) ? bytes / result.p50 : 0.0; // bytes/ns == GB/s
+        result.allocations = static_cast<double>( count_allocated ) / count;
+        result.allocated_bytes = static_cast<double>( bytes_allocated ) / count;
+
+        results.push_back( result );
+        return results.back();
+    }
+
+    // Write Results as CSV (Header + One Row per Result)
+    void writeCsv( std::ostream& os, const std::vector<bench::Result>& results )
+    {
+        os << "kernel,source,width,height,threads,backend,load,iterations,min_ns,mean_ns,p50_ns,p99_ns,max_ns,ns_per_pixel,gb_per_s,allocations,allocated_bytes,ratio\n";
+        os << std::fixed;
+        for( const bench::Result& result : results ){
+            os << result.kernel << "," << result.source << ","
+               << result.width << "," << result.height << "," << result.threads << "," << result.backend << "," << result.load << "," << result.iterations << ","
+               << std::setprecision( 0 ) << result.min << "," << result.mean << "," << result.p50 << "," << result.p99 << "," << result.max << ","
+               << std::setprecision( 4 ) << result.ns_per_pixel << "," << result.gb_per_s << ","
+               << std::setprecision( 2 ) << result.allocations << "," << result.allocated_bytes << "," << result.ratio << "\n";
+        }
+        os.flush();
+    }
+
+    // Write Results as JSON ({ "context": {...}, "results": [...] })
+    void writeJson( std::ostream& os, const std::vector<bench::Result>& results )
+    {
+        os << "{\n";
+        os << "  \"context\": {\n";
+        os << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        #if defined( _MSC_VER )
+        os << "    \"compiler\": \"msvc " << _MSC_VER << "\",\n";
+        #elif defined( __VERSION__ )
+        os << "    \"compiler\": \"" << __VERSION__ << "\",\n";
+        #else
+        os << "    \"compiler\": \"unknown\",\n";
+        #endif
+        #ifdef _OPENMP
+        os << "    \"openmp\": true,\n";
+        #else
+        os << "    \"openmp\": false,\n";
+        #endif
+        #ifdef NUITRACK_NATIVE
+        os << "    \"native\": true\n";
+        #else
+        os << "    \"native\": false\n";
+        #endif
+        os << "  },\n";
+
+        os << "  \"results\": [";
+        os << std::fixed;
+        for( size_t index = 0; index < results.size(); index++ ){
+            const bench::Result& result = results[index];
+            os << ( index == 0 ? "\n" : ",\n" );
+            os << "    { \"kernel\": \"" << result.kernel << "\", \"source\": \"" << result.source << "\", "
+               << "\"width\": " << result.width << ", \"height\": " << result.height << ", "
+               << "\"threads\": " << result.threads << ", \"backend\": \"" << result.backend << "\", \"load\": " << result.load << ", "
+               << "\"iterations\": " << result.iterations << ", "
+               << std::setprecision( 0 )
+               << "\"min_ns\": " << result.min << ", \"mean_ns\": " << result.mean << ", "
+               << "\"p50_ns\": " << result.p50 << ", \"p99_ns\": " << result.p99 << ", \"max_ns\": " << result.max << ", "
+               << std::setprecision( 4 )
+               << "\"ns_per_pixel\": " << result.ns_per_pixel << ", \"gb_per_s\": " << result.gb_per_s << ", "
+               << std::setprecision( 2 )
+               << "\"allocations\": " << result.allocations << ", \"allocated_bytes\": " << result.allocated_bytes << ", "
+               << "\"ratio\": " << result.ratio << " }";
+        }
+        os << "\n  ]\n";
+        os << "}\n";
+        os.flush();
+    }
+}
@@ -0,0 +1,163 @@
+// This is micro benchmark runner for frame kernels of nuitrack_core.
+// Each iteration is timed individually, and results are reported as percentiles of iterations.
+//
+// #include "bench.h"
+//
+// bench::Runner runner( options );
+// runner.run( "drawDepth", "synthetic", width, height, threads, width * height, width * height * 4,
+//     [&]( const uint64_t iteration ){ /* prepare input (not timed) */ },
+//     [&]( const uint64_t iteration ){ /* kernel (timed) */ }
+// );
+// bench::writeCsv( std::cout, runner.getResults() );
+//
+// Allocations are counted by replacing global operator new/delete in bench.cpp.
+// Those are counted only while timed kernel is running.
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __BENCH__
+#define __BENCH__
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+#include <functional>
+
+namespace bench
+{
+    struct Options
+    {
+        // Iterations that are run before measurement
+        uint64_t warmup;
+
+        // Measurement continues until both minimum iterations and minimum time are reached, or maximum iterations.
+        uint64_t min_iterations;
+        uint64_t max_iterations;
+        double min_time; // seconds
+
+        Options()
+            : warmup( 5 ), min_iterations( 30 ), max_iterations( 100000 ), min_time( 0.25 ){}
+    };
+
+    struct Result
+    {
+        std::string kernel;
+        std::string source;
+        int32_t width;
+        int32_t height;
+        int32_t threads;
+        std::string backend; // backend of parallel loops (empty for single thread kernels)
+        int32_t load; // number of background load threads
+        uint64_t iterations;
+
+        // Latency of Iteration (nanoseconds)
+        double min;
+        double mean;
+        double p50;
+        double p99;
+        double max;
+
+        // Throughput (based on p50)
+        double ns_per_pixel;
+        double gb_per_s;
+
+        // Allocations per Iteration
+        double allocations;
+        double allocated_bytes;
+
+        // Compression Ratio (Raw / Encoded, 0 if not applicable)
+        double ratio;
+
+        Result()
+            : width( 0 ), height( 0 ), threads( 0 ), load( 0 ), iterations( 0 ),
+              min( 0.0 ), mean( 0.0 ), p50( 0.0 ), p99( 0.0 ), max( 0.0 ),
+              ns_per_pixel( 0.0 ), gb_per_s( 0.0 ), allocations( 0.0 ), allocated_bytes( 0.0 ), ratio( 0.0 ){}
+    };
+
+    struct Allocations
+    {
+        uint64_t count;
+        uint64_t bytes;
+    };
+
+    // Retrieve Allocations since Program Start
+    bench::Allocations allocations();
+
+    class Runner
+    {
+    private:
+        bench::Options options;
+        std::vector<bench::Result> results;
+
+        // Context of Following Results
+        std::string backend;
+        int32_t load = 0;
+
+        // Latency of Each Iteration (Reserved before Measurement)
+        std::vector<double> samples;
+
+    public:
+        // Constructor
+        Runner( const bench::Options& options = bench::Options() );
+
+        // Run Benchmark
+        // pixels and bytes (read + written) are per iteration, these are used for ns/pixel and GB/s. (0 if not applicable)
+        const bench::Result& run( const std::string& kernel, const std::string& source,
+                                  const int32_t width, const int32_t height, const int32_t threads,
+                                  const uint64_t pixels, const uint64_t bytes,
+                                  const std::function<void( const uint64_t )>& prepare,
+                                  const std::function<void( const uint64_t )>& body );
+
+        // Set Backend of Parallel Loops and Number of Background Load Threads of Following Results
+        void setContext( const std::string& backend, const int32_t load )
+        {
+            this->backend = backend;
+            this->load = load;
+        }
+
+        // Set Compression Ratio of Last Result (Codec Kernels)
+        void setRatio( const double ratio )
+        {
+            if( !results.empty() ){
+                results.back().ratio = ratio;
+            }
+        }
+
+        // Retrieve Results
+        const std::vector<bench::Result>& getResults() const
+        {
+            return results;
+        }
+    };
+
+    // Write Results as CSV (Header + One Row per Result)
+    void writeCsv( std::ostream& os, const std::vector<bench::Result>& results );
+
+    // Write Results as JSON ({ "context": {...}, "results": [...] })
+    void writeJson( std::ostream& os, const std::vector<bench::Result>& results );
+}
+
+#endif // __BENCH__
@@ -0,0 +1,944 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+#include "bench.h"
+#include "frame.h"
+#include "filter.h"
+#include "pointcloud.h"
+#include "occupancy.h"
+#include "registration.h"
+#include "fusion.h"
+#include "codec.h"
+#include "synthetic.h"
+#include "parallel.h"
+#include "profile.h"
+#include "trace.h"
+#ifdef NUITRACK_BENCH_PARSER
+#include "parser.h"
+#endif
+#ifdef NUITRACK_BENCH_ZSTD
+#include <zstd.h>
+#endif
+#ifdef NUITRACK_BENCH_LZ4
+#include <lz4.h>
+#endif
+
+// Set of Frames (Cycled over Iterations)
+struct Frames
+{
+    std::string source;
+    int32_t width = 0;
+    int32_t height = 0;
+    std::vector<std::vector<uint16_t>> depth;
+    std::vector<std::vector<uint16_t>> labels;
+    std::vector<std::vector<uint8_t>> color;
+};
+
+struct Arguments
+{
+    std::vector<std::pair<int32_t, int32_t>> resolutions = { { 320, 240 }, { 640, 480 }, { 1280, 720 } };
+    std::vector<int32_t> threads;
+    std::vector<parallel::Backend> backends;
+    std::vector<int32_t> loads = { 0 };
+    std::vector<std::string> kernels;
+    std::string format = "csv";
+    std::string output;
+    int32_t frames = 8;
+    int32_t users = 2;
+    uint32_t max_distance = 5000;
+    bench::Options options;
+
+    // Recorded Frames (Raw, Concatenated Frames)
+    std::pair<int32_t, int32_t> size = { 0, 0 };
+    std::string depth_file;
+    std::string labels_file;
+    std::string color_file;
+    std::string json_file;
+};
+
+// Split String by Delimiter
+std::vector<std::string> split( const std::string& text, const char delimiter )
+{
+    std::vector<std::string> tokens;
+    std::istringstream iss( text );
+    std::string token;
+    while( std::getline( iss, token, delimiter ) ){
+        if( !token.empty() ){
+            tokens.push_back( token );
+        }
+    }
+    return tokens;
+}
+
+// Parse Size (e.g. 640x480)
+std::pair<int32_t, int32_t> parseSize( const std::string& text )
+{
+    const std::vector<std::string> tokens = split( text, 'x' );
+    if( tokens.size() != 2 ){
+        throw std::runtime_error( "failed invalid size " + text );
+    }
+
+    return std::make_pair( std::stoi( tokens[0] ), std::stoi( tokens[1] ) );
+}
+
+// Print Usage
+void usage()
+{
+    std::cout << "usage: nuitrack_bench [options]\n"
+              << "  --resolutions WxH,...  synthetic frame resolutions (default 320x240,640x480,1280x720)\n"
+              << "  --threads N,...        thread counts (default 1, powers of 2 and hardware threads)\n"
+              << "  --backends NAME,...    backends of parallel loops, pool or openmp (default pool,openmp)\n"
+              << "  --loads N,...          background load threads that emulate threads of NuiTrack SDK (default 0)\n"
+              << "  --kernels NAME,...     kernels to run (default all)\n"
+              << "  --format csv|json      output format (default csv)\n"
+              << "  --output FILE          output file (default stdout)\n"
+              << "  --frames N             number of synthetic frames (default 8)\n"
+              << "  --users N              number of synthetic users (default 2)\n"
+              << "  --iterations N         minimum iterations (default 30)\n"
+              << "  --min-time SECONDS     minimum measurement time (default 0.25)\n"
+              << "  --warmup N             warmup iterations (default 5)\n"
+              << "  --size WxH             resolution of recorded frames\n"
+              << "  --depth FILE           recorded depth frames (raw uint16, concatenated)\n"
+              << "  --labels FILE          recorded user label frames (raw uint16, concatenated)\n"
+              << "  --color FILE           recorded color frames (raw BGR uint8, concatenated)\n"
+              << "  --json FILE            recorded instances JSON (one per line)\n"
+              << "kernels: drawColor drawDepth showDepth drawUser parse bilateral temporal hole_filling pointcloud registration occupancy voxel fusion rvl_encode rvl_decode zstd_encode zstd_decode lz4_encode lz4_decode profile_scope profile_scope_trace\n";
+}
+
+// Parse Arguments
+Arguments parseArguments( int argc, char* argv[] )
+{
+    Arguments arguments;
+    for( int i = 1; i < argc; i++ ){
+        const std::string option = argv[i];
+        if( option == "--help" || option == "-h" ){
+            usage();
+            std::exit( 0 );
+        }
+
+        if( i + 1 >= argc ){
+            throw std::runtime_error( "failed missing value of " + option );
+        }
+
+        const std::string value = argv[++i];
+        if( option == "--resolutions" ){
+            arguments.resolutions.clear();
+            for( const std::string& token : split( value, ',' ) ){
+                arguments.resolutions.push_back( parseSize( token ) );
+            }
+        }
+        else if( option == "--threads" ){
+            for( const std::string& token : split( value, ',' ) ){
+                arguments.threads.push_back( std::max( std::stoi( token ), 1 ) );
+            }
+        }
+        else if( option == "--backends" ){
+            for( const std::string& token : split( value, ',' ) ){
+                if( token != "pool" && token != "openmp" ){
+                    throw std::runtime_error( "failed unknown backend " + token );
+                }
+                arguments.backends.push_back( ( token == "openmp" ) ? parallel::Backend::OPENMP : parallel::Backend::POOL );
+            }
+        }
+        else if( option == "--loads" ){
+            arguments.loads.clear();
+            for( const std::string& token : split( value, ',' ) ){
+                arguments.loads.push_back( std::max( std::stoi( token ), 0 ) );
+            }
+        }
+        else if( option == "--kernels" ){
+            arguments.kernels = split( value, ',' );
+        }
+        else if( option == "--format" ){
+            arguments.format = value;
+        }
+        else if( option == "--output" ){
+            arguments.output = value;
+        }
+        else if( option == "--frames" ){
+            arguments.frames = std::max( std::stoi( value ), 1 );
+        }
+        else if( option == "--users" ){
+            arguments.users = std::stoi( value );
+        }
+        else if( option == "--iterations" ){
+            arguments.options.min_iterations = std::max( std::stoull( value ), 1ull );
+        }
+        else if( option == "--min-time" ){
+            arguments.options.min_time = std::stod( value );
+        }
+        else if( option == "--warmup" ){
+            arguments.options.warmup = std::stoull( value );
+        }
+        else if( option == "--size" ){
+            arguments.size = parseSize( value );
+        }
+        else if( option == "--depth" ){
+            arguments.depth_file = value;
+        }
+        else if( option == "--labels" ){
+            arguments.labels_file = value;
+        }
+        else if( option == "--color" ){
+            arguments.color_file = value;
+        }
+        else if( option == "--json" ){
+            arguments.json_file = value;
+        }
+        else{
+            throw std::runtime_error( "failed unknown option " + option );
+        }
+    }
+
+    if( arguments.format != "csv" && arguments.format != "json" ){
+        throw std::runtime_error( "failed unknown format " + arguments.format );
+    }
+
+    // Default Backends (Pool, and OpenMP if Available)
+    if( arguments.backends.empty() ){
+        arguments.backends.push_back( parallel::Backend::POOL );
+        #ifdef _OPENMP
+        arguments.backends.push_back( parallel::Backend::OPENMP );
+        #endif
+    }
+
+    // Default Thread Counts (1, 2, 4, ... and Hardware Threads)
+    if( arguments.threads.empty() ){
+        const int32_t hardware = std::max( static_cast<int32_t>( std::thread::hardware_concurrency() ), 1 );
+        for( int32_t threads = 1; threads < hardware; threads *= 2 ){
+            arguments.threads.push_back( threads );
+        }
+        arguments.threads.push_back( hardware );
+    }
+
+    return arguments;
+}
+
+// Load Raw Frames
+template<typename T>
+std::vector<std::vector<T>> loadRaw( const std::string& path, const size_t elements )
+{
+    std::ifstream ifs( path, std::ios::binary );
+    if( !ifs.is_open() ){
+        throw std::runtime_error( "failed can't open " + path );
+    }
+
+    std::vector<std::vector<T>> frames;
+    std::vector<T> frame( elements );
+    while( ifs.read( reinterpret_cast<char*>( frame.data() ), elements * sizeof( T ) ) ){
+        frames.push_back( frame );
+    }
+
+    if( frames.empty() ){
+        throw std::runtime_error( "failed no complete frame in " + path );
+    }
+
+    return frames;
+}
+
+// Generate Synthetic Frames
+Frames generateFrames( const int32_t width, const int32_t height, const int32_t count, const int32_t users )
+{
+    const synthetic::Scene scene( width, height, users );
+    const size_t total = static_cast<size_t>( width ) * height;
+
+    Frames frames;
+    frames.source = "synthetic";
+    frames.width = width;
+    frames.height = height;
+    frames.depth.assign( count, std::vector<uint16_t>( total ) );
+    frames.labels.assign( count, std::vector<uint16_t>( total ) );
+    frames.color.assign( count, std::vector<uint8_t>( total * 3 ) );
+    for( int32_t index = 0; index < count; index++ ){
+        scene.generate( index, frames.depth[index].data(), frames.labels[index].data(), frames.color[index].data() );
+    }
+
+    return frames;
+}
+
+// Load Recorded Frames
+Frames loadFrames( const Arguments& arguments )
+{
+    const int32_t width = arguments.size.first;
+    const int32_t height = arguments.size.second;
+    if( width <= 0 || height <= 0 ){
+        throw std::runtime_error( "failed recorded frames require --size" );
+    }
+
+    const size_t total = static_cast<size_t>( width ) * height;
+
+    Frames frames;
+    frames.source = "recorded";
+    frames.width = width;
+    frames.height = height;
+    if( !arguments.depth_file.empty() ){
+        frames.depth = loadRaw<uint16_t>( arguments.depth_file, total );
+    }
+    if( !arguments.labels_file.empty() ){
+        frames.labels = loadRaw<uint16_t>( arguments.labels_file, total );
+    }
+    if( !arguments.color_file.empty() ){
+        frames.color = loadRaw<uint8_t>( arguments.color_file, total * 3 );
+    }
+
+    return frames;
+}
+
+// Background Load that Emulates Threads of NuiTrack SDK
+// Each thread alternates busy 4 ms and sleep 4 ms (phase is shifted per thread), like trackers that run per frame.
+class Load
+{
+private:
+    std::vector<std::thread> threads;
+    std::atomic<bool> running;
+
+public:
+    // Constructor (Start Threads)
+    Load( const int32_t count )
+        : running( true )
+    {
+        for( int32_t index = 0; index < count; index++ ){
+            threads.emplace_back( [this, index](){
+                typedef std::chrono::steady_clock clock;
+                const std::chrono::microseconds period( 4000 );
+                std::this_thread::sleep_for( period * index / 4 );
+                volatile uint64_t sink = 0;
+                while( running ){
+                    const clock::time_point until = clock::now() + period;
+                    while( clock::now() < until ){
+                        for( int32_t i = 0; i < 1000; i++ ){
+                            sink = sink + i;
+                        }
+                    }
+                    std::this_thread::sleep_for( period );
+                }
+            } );
+        }
+    }
+
+    // Destructor (Join Threads)
+    ~Load()
+    {
+        running = false;
+        for( std::thread& thread : threads ){
+            thread.join();
+        }
+    }
+};
+
+class Bench
+{
+private:
+    const Arguments& arguments;
+    bench::Runner runner;
+
+public:
+    // Constructor
+    Bench( const Arguments& arguments )
+        : arguments( arguments ), runner( arguments.options ){}
+
+    // Retrieve Results
+    const std::vector<bench::Result>& getResults() const
+    {
+        return runner.getResults();
+    }
+
+    // Run Frame Kernels at All Background Loads, Backends and Thread Counts
+    void runFrames( const Frames& frames )
+    {
+        for( const int32_t load : arguments.loads ){
+            const Load background( load );
+            for( const parallel::Backend backend : arguments.backends ){
+                parallel::setBackend( backend );
+                for( const int32_t threads : arguments.threads ){
+                    parallel::setThreads( threads );
+                    runner.setContext( parallel::name( backend ), load );
+                    runColor( frames, threads );
+                    runDepth( frames, threads );
+                    runUser( frames, threads );
+                    runFilter( frames, threads );
+                    runPointCloud( frames, threads );
+                }
+            }
+        }
+        runner.setContext( "", 0 );
+    }
+
+    // Run Scoped Timer (Overhead of 1000 Scopes, with and without Trace)
+    void runProfile()
+    {
+        #ifdef NUITRACK_PROFILE
+        if( enabled( "profile_scope" ) ){
+            run( "profile_scope", "synthetic", 0, 0, 1, 1000, 0,
+                []( const uint64_t ){},
+                []( const uint64_t ){
+                    for( int32_t i = 0; i < 1000; i++ ){
+                        PROFILE_SCOPE( "bench::profile_scope" );
+                    }
+                }
+            );
+        }
+
+        // Scoped Timer with Trace (Written to Temporary File)
+        const std::string path = "nuitrack_bench_trace.json";
+        if( enabled( "profile_scope_trace" ) && trace::start( path ) ){
+            run( "profile_scope_trace", "synthetic", 0, 0, 1, 1000, 0,
+                []( const uint64_t ){},
+                []( const uint64_t ){
+                    for( int32_t i = 0; i < 1000; i++ ){
+                        PROFILE_SCOPE( "bench::profile_scope_trace" );
+                    }
+                    trace::flush();
+                }
+            );
+
+            trace::stop();
+            std::remove( path.c_str() );
+        }
+        #endif
+    }
+
+    // Run Skeleton Fusion (4 Cameras around Scene x Users, Single Thread)
+    void runFusion( const int32_t frames, const int32_t users )
+    {
+        if( !enabled( "fusion" ) ){
+            return;
+        }
+
+        const int32_t cameras = 4;
+        const int32_t count = std::max( users, 1 );
+        fusion::Fuser fuser( cameras );
+
+        // Cameras on Circle of 3 meters Looking at Center (Rotation about Y axis, Camera to World)
+        std::vector<camera::Extrinsics> extrinsics( cameras );
+        for( int32_t camera = 0; camera < cameras; camera++ ){
+            const float angle = camera * 2.0f * 3.14159265f / cameras;
+            const float c = std::cos( angle ), s = std::sin( angle );
+            camera::Extrinsics& transform = extrinsics[camera];
+            const float rotation[9] = { c, 0.0f, s, 0.0f, 1.0f, 0.0f, -s, 0.0f, c };
+            std::copy( rotation, rotation + 9, transform.rotation );
+            transform.translation[0] = -3000.0f * s;
+            transform.translation[1] = 0.0f;
+            transform.translation[2] = -3000.0f * c;
+            fuser.setExtrinsics( camera, transform );
+        }
+
+        // Skeletons of Each Camera (Users on Grid in World, Noise +-10mm, Occluded Joints have Zero Confidence)
+        std::vector<std::vector<std::vector<fusion::Skeleton>>> inputs( std::max( frames, 1 ), std::vector<std::vector<fusion::Skeleton>>( cameras ) );
+        for( size_t frame = 0; frame < inputs.size(); frame++ ){
+            for( int32_t camera = 0; camera < cameras; camera++ ){
+                const camera::Extrinsics& transform = extrinsics[camera];
+                for( int32_t user = 0; user < count; user++ ){
+                    fusion::Skeleton skeleton;
+                    skeleton.id = ( user + camera ) % count + 1;
+                    for( int32_t joint = 1; joint < fusion::JOINTS; joint++ ){
+                        const uint32_t noise = static_cast<uint32_t>( ( frame * 131 + camera * 31 + user * 7 + joint ) * 2654435761u );
+                        const float wx = ( user % 3 - 1 ) * 900.0f + ( joint % 5 - 2 ) * 100.0f + frame * 5.0f;
+                        const float wy = ( joint / 5 - 2 ) * 300.0f;
+                        const float wz = ( user / 3 - 0.5f ) * 900.0f + ( joint % 3 - 1 ) * 50.0f;
+                        const float dx = wx - transform.translation[0], dy = wy - transform.translation[1], dz = wz - transform.translation[2];
+                        const float* r = transform.rotation;
+                        fusion::Joint& output = skeleton.joints[joint];
+                        output.x = r[0] * dx + r[3] * dy + r[6] * dz + ( noise % 21 ) - 10.0f;
+                        output.y = r[1] * dx + r[4] * dy + r[7] * dz + ( ( noise >> 8 ) % 21 ) - 10.0f;
+                        output.z = r[2] * dx + r[5] * dy + r[8] * dz + ( ( noise >> 16 ) % 21 ) - 10.0f;
+                        output.confidence = ( ( noise >> 24 ) % 8 == 0 ) ? 0.0f : 0.3f + ( ( noise >> 4 ) % 8 ) * 0.1f;
+                    }
+                    inputs[frame][camera].push_back( skeleton );
+                }
+                std::rotate( inputs[frame][camera].begin(), inputs[frame][camera].begin() + camera % count, inputs[frame][camera].end() );
+            }
+        }
+
+        run( "fusion", "synthetic", 0, 0, 1, static_cast<uint64_t>( cameras ) * count, 0,
+            []( const uint64_t ){},
+            [&]( const uint64_t iteration ){
+                const std::vector<fusion::Fused>& fused = fuser.fuse( inputs[iteration % inputs.size()] );
+                if( static_cast<int32_t>( fused.size() ) != count ){
+                    throw std::runtime_error( "failed fusion (" + std::to_string( fused.size() ) + " fused skeletons of " + std::to_string( count ) + " users)" );
+                }
+            }
+        );
+    }
+
+    // Run Depth Codec (RVL, and zstd/LZ4 if Available) on Depth and User Labels (Single Thread)
+    // Encoded frames are decoded and compared with input before measurement, and kernels throw if round trip is not lossless.
+    void runCodec( const Frames& frames )
+    {
+        if( frames.depth.empty() ){
+            return;
+        }
+
+        const int32_t total = frames.width * frames.height;
+        const bool labeled = !frames.labels.empty();
+        const uint64_t raw = total * ( labeled ? 4ull : 2ull );
+        const size_t count = frames.depth.size();
+
+        // Encoded Frames (Input of Decoder)
+        std::vector<std::vector<uint8_t>> encoded( count );
+        std::vector<size_t> sizes( count );
+        uint64_t compressed = 0;
+        for( size_t index = 0; index < count; index++ ){
+            const uint16_t* labels = labeled ? frames.labels[index % frames.labels.size()].data() : nullptr;
+            sizes[index] = codec::encode( frames.depth[index].data(), labels, frames.width, frames.height, encoded[index] );
+            compressed += sizes[index];
+        }
+
+        // Round Trip
+        std::vector<uint16_t> depth( total );
+        std::vector<uint16_t> labels( labeled ? total : 0 );
+        for( size_t index = 0; index < count; index++ ){
+            codec::decode( encoded[index].data(), sizes[index], depth.data(), labeled ? labels.data() : nullptr );
+            if( depth != frames.depth[index] || ( labeled && labels != frames.labels[index % frames.labels.size()] ) ){
+                throw std::runtime_error( "failed rvl round trip (frame " + std::to_string( index ) + ")" );
+            }
+        }
+
+        const double ratio = static_cast<double>( raw * count ) / compressed;
+        compressed /= count;
+
+        if( enabled( "rvl_encode" ) ){
+            std::vector<uint8_t> buffer;
+            run( "rvl_encode", frames.source, frames.width, frames.height, 1, total, raw + compressed,
+                []( const uint64_t ){},
+                [&]( const uint64_t iteration ){
+                    const size_t index = iteration % count;
+                    codec::encode( frames.depth[index].data(), labeled ? frames.labels[index % frames.labels.size()].data() : nullptr, frames.width, frames.height, buffer );
+                }
+            );
+            runner.setRatio( ratio );
+        }
+
+        if( enabled( "rvl_decode" ) ){
+            run( "rvl_decode", frames.source, frames.width, frames.height, 1, total, raw + compressed,
+                []( const uint64_t ){},
+                [&]( const uint64_t iteration ){
+                    const size_t index = iteration % count;
+                    codec::decode( encoded[index].data(), sizes[index], depth.data(), labeled ? labels.data() : nullptr );
+                }
+            );
+            runner.setRatio( ratio );
+        }
+
+        #ifdef NUITRACK_BENCH_ZSTD
+        runCompressor( frames, "zstd",
+            []( const std::vector<uint8_t>& input ){
+                return ZSTD_compressBound( input.size() );
+            },
+            []( const std::vector<uint8_t>& input, std::vector<uint8_t>& output ){
+                const size_t size = ZSTD_compress( output.data(), output.size(), input.data(), input.size(), 1 );
+                if( ZSTD_isError( size ) ){
+                    throw std::runtime_error( std::string( "failed zstd compress (" ) + ZSTD_getErrorName( size ) + ")" );
+                }
+                return size;
+            },
+            []( const uint8_t* data, const size_t size, std::vector<uint8_t>& output ){
+                const size_t result = ZSTD_decompress( output.data(), output.size(), data, size );
+                if( ZSTD_isError( result ) ){
+                    throw std::runtime_error( std::string( "failed zstd decompress (" ) + ZSTD_getErrorName( result ) + ")" );
+                }
+            }
+        );
+        #endif
+
+        #ifdef NUITRACK_BENCH_LZ4
+        runCompressor( frames, "lz4",
+            []( const std::vector<uint8_t>& input ){
+                return static_cast<size_t>( LZ4_compressBound( static_cast<int>( input.size() ) ) );
+            },
+            []( const std::vector<uint8_t>& input, std::vector<uint8_t>& output ){
+                const int size = LZ4_compress_default( reinterpret_cast<const char*>( input.data() ), reinterpret_cast<char*>( output.data() ), static_cast<int>( input.size() ), static_cast<int>( output.size() ) );
+                if( size <= 0 ){
+                    throw std::runtime_error( "failed lz4 compress" );
+                }
+                return static_cast<size_t>( size );
+            },
+            []( const uint8_t* data, const size_t size, std::vector<uint8_t>& output ){
+                if( LZ4_decompress_safe( reinterpret_cast<const char*>( data ), reinterpret_cast<char*>( output.data() ), static_cast<int>( size ), static_cast<int>( output.size() ) ) < 0 ){
+                    throw std::runtime_error( "failed lz4 decompress" );
+                }
+            }
+        );
+        #endif
+    }
+
+    // Run JSON Parser (Single Thread)
+    void runParser( const std::vector<std::string>& jsons, const std::string& source )
+    {
+        #ifdef NUITRACK_BENCH_PARSER
+        if( !enabled( "parse" ) || jsons.empty() ){
+            return;
+        }
+
+        uint64_t bytes = 0;
+        for( const std::string& json : jsons ){
+            bytes += json.size();
+        }
+        bytes /= jsons.size();
+
+        size_t humans = 0;
+        run( "parse", source, 0, 0, 1, 0, bytes,
+            []( const uint64_t ){},
+            [&]( const uint64_t iteration ){
+                const parser::JSON json = parser::parse( jsons[iteration % jsons.size()] );
+                humans += json.humans.size();
+            }
+        );
+        #else
+        static_cast<void>( jsons );
+        static_cast<void>( source );
+        #endif
+    }
+
+private:
+    // Check Kernel is Enabled
+    bool enabled( const std::string& kernel ) const
+    {
+        return arguments.kernels.empty() || std::find( arguments.kernels.begin(), arguments.kernels.end(), kernel ) != arguments.kernels.end();
+    }
+
+    // Run Benchmark and Report Progress
+    void run( const std::string& kernel, const std::string& source, const int32_t width, const int32_t height, const int32_t threads,
+              const uint64_t pixels, const uint64_t bytes,
+              const std::function<void( const uint64_t )>& prepare, const std::function<void( const uint64_t )>& body )
+    {
+        const bench::Result& result = runner.run( kernel, source, width, height, threads, pixels, bytes, prepare, body );
+        std::cerr << kernel << " " << source << " " << width << "x" << height << " threads=" << threads;
+        if( !result.backend.empty() ){
+            std::cerr << " backend=" << result.backend << " load=" << result.load;
+        }
+        std::cerr << " p50=" << result.p50 / 1e6 << "ms p99=" << result.p99 / 1e6 << "ms" << std::endl;
+    }
+
+    // Run General Purpose Compressor on Depth and User Labels (Concatenated Raw Bytes, Single Thread)
+    void runCompressor( const Frames& frames, const std::string& name,
+                        const std::function<size_t( const std::vector<uint8_t>& )>& bound,
+                        const std::function<size_t( const std::vector<uint8_t>&, std::vector<uint8_t>& )>& compress,
+                        const std::function<void( const uint8_t*, const size_t, std::vector<uint8_t>& )>& decompress )
+    {
+        const int32_t total = frames.width * frames.height;
+        const size_t count = frames.depth.size();
+
+        // Raw Frames (Depth followed by User Labels)
+        std::vector<std::vector<uint8_t>> raws( count );
+        for( size_t index = 0; index < count; index++ ){
+            const uint8_t* depth = reinterpret_cast<const uint8_t*>( frames.depth[index].data() );
+            raws[index].assign( depth, depth + total * sizeof( uint16_t ) );
+            if( !frames.labels.empty() ){
+                const uint8_t* labels = reinterpret_cast<const uint8_t*>( frames.labels[index % frames.labels.size()].data() );
+                raws[index].insert( raws[index].end(), labels, labels + total * sizeof( uint16_t ) );
+            }
+        }
+        const uint64_t raw = raws.front().size();
+
+        // Compressed Frames and Round Trip
+        std::vector<std::vector<uint8_t>> encoded( count );
+        std::vector<uint8_t> decoded( raw );
+        uint64_t compressed = 0;
+        for( size_t index = 0; index < count; index++ ){
+            encoded[index].resize( bound( raws[index] ) );
+            encoded[index].resize( compress( raws[index], encoded[index] ) );
+            compressed += encoded[index].size();
+
+            decompress( encoded[index].data(), encoded[index].size(), decoded );
+            if( decoded != raws[index] ){
+                throw std::runtime_error( "failed " + name + " round trip (frame " + std::to_string( index ) + ")" );
+            }
+        }
+
+        const double ratio = static_cast<double>( raw * count ) / compressed;
+        compressed /= count;
+
+        if( enabled( name + "_encode" ) ){
+            std::vector<uint8_t> buffer( bound( raws.front() ) );
+            run( name + "_encode", frames.source, frames.width, frames.height, 1, total, raw + compressed,
+                []( const uint64_t ){},
+                [&]( const uint64_t iteration ){
+                    compress( raws[iteration % count], buffer );
+                }
+            );
+            runner.setRatio( ratio );
+        }
+
+        if( enabled( name + "_decode" ) ){
+            run( name + "_decode", frames.source, frames.width, frames.height, 1, total, raw + compressed,
+                []( const uint64_t ){},
+                [&]( const uint64_t iteration ){
+                    const std::vector<uint8_t>& data = encoded[iteration % count];
+                    decompress( data.data(), data.size(), decoded );
+                }
+            );
+            runner.setRatio( ratio );
+        }
+    }
+
+    // drawColor (Copy Color Frame to cv::Mat)
+    void runColor( const Frames& frames, const int32_t threads )
+    {
+        if( !enabled( "drawColor" ) || frames.color.empty() ){
+            return;
+        }
+
+        const int32_t total = frames.width * frames.height;
+        std::vector<uint8_t> color_mat( total * 3 );
+        run( "drawColor", frames.source, frames.width, frames.height, threads, total, total * 6ull,
+            []( const uint64_t ){},
+            [&]( const uint64_t iteration ){
+                frame::copyColor( frames.color[iteration % frames.color.size()].data(), color_mat.data(), total );
+            }
+        );
+    }
+
+    // drawDepth (Copy Depth Frame to cv::Mat) and showDepth (Convert Depth to Gray)
+    void runDepth( const Frames& frames, const int32_t threads )
+    {
+        if( frames.depth.empty() ){
+            return;
+        }
+
+        const int32_t total = frames.width * frames.height;
+        if( enabled( "drawDepth" ) ){
+            std::vector<uint16_t> depth_mat( total );
+            run( "drawDepth", frames.source, frames.width, frames.height, threads, total, total * 4ull,
+                []( const uint64_t ){},
+                [&]( const uint64_t iteration ){
+                    frame::copyDepth( frames.depth[iteration % frames.depth.size()].data(), depth_mat.data(), total );
+                }
+            );
+        }
+
+        if( enabled( "showDepth" ) ){
+            std::vector<uint8_t> scale_mat( total );
+            run( "showDepth", frames.source, frames.width, frames.height, threads, total, total * 3ull,
+                []( const uint64_t ){},
+                [&]( const uint64_t iteration ){
+                    frame::convertDepthToGray( frames.depth[iteration % frames.depth.size()].data(), scale_mat.data(), total, arguments.max_distance );
+                }
+            );
+        }
+    }
+
+    // drawUser (Convert Depth to BGR and Overlay User Labels)
+    void runUser( const Frames& frames, const int32_t threads )
+    {
+        if( !enabled( "drawUser" ) || frames.depth.empty() || frames.labels.empty() ){
+            return;
+        }
+
+        // Same palette as User sample
+        const uint8_t palette[6 * 3] = { 255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 0, 255, 0, 255, 0, 255, 255 };
+
+        const int32_t total = frames.width * frames.height;
+        std::vector<uint8_t> user_mat( total * 3 );
+        run( "drawUser", frames.source, frames.width, frames.height, threads, total, total * 12ull,
+            []( const uint64_t ){},
+            [&]( const uint64_t iteration ){
+                frame::convertDepthToBgr( frames.depth[iteration % frames.depth.size()].data(), user_mat.data(), total, arguments.max_distance );
+                frame::overlayLabels( frames.labels[iteration % frames.labels.size()].data(), user_mat.data(), total, palette, 6 );
+            }
+        );
+    }
+
+    // Depth Filters (In-Place, Input is Restored before Each Iteration)
+    void runFilter( const Frames& frames, const int32_t threads )
+    {
+        if( frames.depth.empty() ){
+            return;
+        }
+
+        const int32_t total = frames.width * frames.height;
+        std::vector<uint16_t> work( total );
+        const std::function<void( const uint64_t )> restore = [&]( const uint64_t iteration ){
+            const std::vector<uint16_t>& depth = frames.depth[iteration % frames.depth.size()];
+            std::copy( depth.begin(), depth.end(), work.begin() );
+        };
+
+        if( enabled( "bilateral" ) ){
+            filter::Bilateral bilateral;
+            run( "bilateral", frames.source, frames.width, frames.height, threads, total, total * 4ull, restore,
+                [&]( const uint64_t ){
+                    bilateral.apply( work.data(), frames.width, frames.height );
+                }
+            );
+        }
+
+        if( enabled( "temporal" ) ){
+            filter::Temporal temporal;
+            run( "temporal", frames.source, frames.width, frames.height, threads, total, total * 4ull, restore,
+                [&]( const uint64_t ){
+                    temporal.apply( work.data(), frames.width, frames.height );
+                }
+            );
+        }
+
+        if( enabled( "hole_filling" ) ){
+            filter::HoleFilling hole_filling;
+            run( "hole_filling", frames.source, frames.width, frames.height, threads, total, total * 4ull, restore,
+                [&]( const uint64_t ){
+                    hole_filling.apply( work.data(), frames.width, frames.height );
+                }
+            );
+        }
+    }
+
+    // Point Cloud, Registration and Occupancy
+    void runPointCloud( const Frames& frames, const int32_t threads )
+    {
+        if( frames.depth.empty() ){
+            return;
+        }
+
+        const int32_t total = frames.width * frames.height;
+        const camera::Intrinsics intrinsics = camera::Intrinsics::fromFov( frames.width, frames.height, 70.0f * 3.14159265f / 180.0f );
+
+        pointcloud::Generator generator;
+        generator.setIntrinsics( frames.width, frames.height, intrinsics );
+
+        // Points of Each Frame (Input of Occupancy)
+        std::vector<std::vector<pointcloud::Point>> clouds( frames.depth.size() );
+        uint64_t points = 0;
+        for( size_t index = 0; index < frames.depth.size(); index++ ){
+            points += generator.generate( frames.depth[index].data(), clouds[index] );
+        }
+        points /= frames.depth.size();
+
+        if( enabled( "pointcloud" ) ){
+            std::vector<pointcloud::Point> cloud;
+            run( "pointcloud", frames.source, frames.width, frames.height, threads, total, total * 2ull + points * sizeof( pointcloud::Point ),
+                []( const uint64_t ){},
+                [&]( const uint64_t iteration ){
+                    generator.generate( frames.depth[iteration % frames.depth.size()].data(), cloud );
+                }
+            );
+        }
+
+        if( enabled( "registration" ) ){
+            // Color camera is 25mm right of depth camera (RealSense D415)
+            camera::Extrinsics extrinsics;
+            extrinsics.translation[0] = -25.0f;
+
+            registration::Registrator registrator;
+            registrator.setCalibration( frames.width, frames.height, intrinsics, frames.width, frames.height, intrinsics, extrinsics );
+
+            std::vector<uint16_t> registered( total );
+            run( "registration", frames.source, frames.width, frames.height, threads, total, total * 4ull,
+                []( const uint64_t ){},
+                [&]( const uint64_t iteration ){
+                    registrator.apply( frames.depth[iteration % frames.depth.size()].data(), registered.data() );
+                }
+            );
+        }
+
+        if( enabled( "occupancy" ) ){
+            occupancy::Grid grid( 50.0f, occupancy::Range( -3000.0f, 3000.0f ), occupancy::Range( 0.0f, 6000.0f ) );
+            run( "occupancy", frames.source, frames.width, frames.height, threads, total, points * sizeof( pointcloud::Point ),
+                []( const uint64_t ){},
+                [&]( const uint64_t iteration ){
+                    const std::vector<pointcloud::Point>& cloud = clouds[iteration % clouds.size()];
+                    grid.accumulate( cloud.data(), cloud.size() );
+                }
+            );
+        }
+
+        if( enabled( "voxel" ) ){
+            occupancy::VoxelGrid voxel( 50.0f, occupancy::Range( -3000.0f, 3000.0f ), occupancy::Range( -2000.0f, 2000.0f ), occupancy::Range( 0.0f, 6000.0f ) );
+            std::vector<pointcloud::Point> downsampled;
+            run( "voxel", frames.source, frames.width, frames.height, threads, total, points * sizeof( pointcloud::Point ),
+                []( const uint64_t ){},
+                [&]( const uint64_t iteration ){
+                    const std::vector<pointcloud::Point>& cloud = clouds[iteration % clouds.size()];
+                    voxel.downsample( cloud.data(), cloud.size(), downsampled );
+                }
+            );
+        }
+    }
+};
+
+int main( int argc, char* argv[] )
+{
+    try{
+        const Arguments arguments = parseArguments( argc, argv );
+        Bench bench( arguments );
+
+        const bool recorded = !arguments.depth_file.empty() || !arguments.labels_file.empty() || !arguments.color_file.empty() || !arguments.json_file.empty();
+        if( recorded ){
+            // Recorded Frames
+            if( !arguments.depth_file.empty() || !arguments.labels_file.empty() || !arguments.color_file.empty() ){
+                const Frames frames = loadFrames( arguments );
+                bench.runFrames( frames );
+                bench.runCodec( frames );
+            }
+
+            if( !arguments.json_file.empty() ){
+                std::ifstream ifs( arguments.json_file );
+                if( !ifs.is_open() ){
+                    throw std::runtime_error( "failed can't open " + arguments.json_file );
+                }
+
+                std::vector<std::string> jsons;
+                std::string line;
+                while( std::getline( ifs, line ) ){
+                    if( !line.empty() ){
+                        jsons.push_back( line );
+                    }
+                }
+                bench.runParser( jsons, "recorded" );
+            }
+        }
+        else{
+            // Synthetic Frames
+            for( const std::pair<int32_t, int32_t>& resolution : arguments.resolutions ){
+                const Frames frames = generateFrames( resolution.first, resolution.second, arguments.frames, arguments.users );
+                bench.runFrames( frames );
+                bench.runCodec( frames );
+            }
+
+            std::vector<std::string> jsons;
+            for( int32_t index = 0; index < arguments.frames; index++ ){
+                jsons.push_back( synthetic::instancesJson( index, arguments.users ) );
+            }
+            bench.runParser( jsons, "synthetic" );
+            bench.runFusion( arguments.frames, arguments.users );
+            bench.runProfile();
+        }
+
+        // Output Results
+        if( arguments.output.empty() ){
+            if( arguments.format == "json" ){
+                bench::writeJson( std::cout, bench.getResults() );
+            }
+            else{
+                bench::writeCsv( std::cout, bench.getResults() );
+            }
+        }
+        else{
+            std::ofstream ofs( arguments.output );
+            if( !ofs.is_open() ){
+                throw std::runtime_error( "failed can't open " + arguments.output );
+            }
+
+            if( arguments.format == "json" ){
+                bench::writeJson( ofs, bench.getResults() );
+            }
+            else{
+                bench::writeCsv( ofs, bench.getResults() );
+            }
+        }
+    } catch( std::exception& ex ){
+        std::cout << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,426 @@
+#include "affinity.h"
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#elif defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#endif
+
+namespace affinity
+{
+    // Number of Logical Cores
+    int32_t cores()
+    {
+        return std::max( static_cast<int32_t>( std::thread::hardware_concurrency() ), 1 );
+    }
+
+    // Parse Core Set
+    std::vector<int32_t> parse( const std::string& text )
+    {
+        std::vector<int32_t> core_set;
+        std::istringstream stream( text );
+        std::string token;
+        while( std::getline( stream, token, ',' ) ){
+            if( token.empty() ){
+                continue;
+            }
+
+            try{
+                const size_t dash = token.find( '-' );
+                const int32_t first = std::stoi( token.substr( 0, dash ) );
+                const int32_t last = ( dash == std::string::npos ) ? first : std::stoi( token.substr( dash + 1 ) );
+                if( first < 0 || last < first ){
+                    throw std::invalid_argument( token );
+                }
+
+                for( int32_t core = first; core <= last; core++ ){
+                    core_set.push_back( core );
+                }
+            }
+            catch( const std::exception& ){
+                throw std::runtime_error( "failed to parse core set (" + text + ")" );
+            }
+        }
+
+        std::sort( core_set.begin(), core_set.end() );
+        core_set.erase( std::unique( core_set.begin(), core_set.end() ), core_set.end() );
+        return core_set;
+    }
+
+    // Format Core Set
+    std::string format( const std::vector<int32_t>& core_set )
+    {
+        std::ostringstream stream;
+        for( size_t index = 0; index < core_set.size(); ){
+            size_t last = index;
+            while( last + 1 < core_set.size() && core_set[last + 1] == core_set[last] + 1 ){
+                last++;
+            }
+
+            stream << ( index == 0 ? "" : "," ) << core_set[index];
+            if( last > index ){
+                stream << "-" << core_set[last];
+            }
+            index = last + 1;
+        }
+        return stream.str();
+    }
+
+    // Split Cores into Contiguous Core Sets of Same Size
+    std::vector<std::vector<int32_t>> split( const int32_t groups, const int32_t cores )
+    {
+        std::vector<std::vector<int32_t>> core_sets( std::max( groups, 0 ) );
+        if( core_sets.empty() || cores <= 0 ){
+            return core_sets;
+        }
+
+        // Cores per Group (Remainder is not Used, so that Pipelines have Same Capacity)
+        const int32_t size = std::max( cores / groups, 1 );
+        for( int32_t group = 0; group < groups; group++ ){
+            const int32_t first = ( group * size ) % cores;
+            for( int32_t core = first; core < first + size && core < cores; core++ ){
+                core_sets[group].push_back( core );
+            }
+        }
+        return core_sets;
+    }
+
+    // Pin Calling Thread to Core Set
+    bool pin( const std::vector<int32_t>& core_set )
+    {
+        if( core_set.empty() ){
+            return false;
+        }
+
+        #if defined( _WIN32 )
+        DWORD_PTR mask = 0;
+        for( const int32_t core : core_set ){
+            if( core < static_cast<int32_t>( sizeof( DWORD_PTR ) * 8 ) ){
+                mask |= static_cast<DWORD_PTR>( 1 ) << core;
+            }
+        }
+        return mask != 0 && SetThreadAffinityMask( GetCurrentThread(), mask ) != 0;
+        #elif defined( __linux__ )
+        cpu_set_t mask;
+        CPU_ZERO( &mask );
+        for( const int32_t core : core_set ){
+            if( core < CPU_SETSIZE ){
+                CPU_SET( core, &mask );
+            }
+        }
+        return pthread_setaffinity_np( pthread_self(), sizeof( mask ), &mask ) == 0;
+        #else
+        return false;
+        #endif
+    }
+
+    // Parse Placement
+    affinity::Placement parsePlacement( const std::string& text )
+    {
+        affinity::Placement placement;
+        std::istringstream stream( text );
+        std::string core_set, policy, priority;
+        std::getline( stream, core_set, ':' );
+        std::getline( stream, policy, ':' );
+        std::getline( stream, priority, ':' );
+
+        placement.core_set = affinity::parse( core_set );
+
+        if( policy == "fifo" ){
+            placement.policy = affinity::Policy::FIFO;
+        }
+        else if( policy == "rr" ){
+            placement.policy = affinity::Policy::ROUND_ROBIN;
+        }
+        else if( !policy.empty() && policy != "normal" ){
+            throw std::runtime_error( "failed to parse scheduling policy (" + text + ")" );
+        }
+
+        if( !priority.empty() ){
+            try{
+                placement.priority = std::stoi( priority );
+            }
+            catch( const std::exception& ){
+                throw std::runtime_error( "failed to parse priority (" + text + ")" );
+            }
+        }
+        else if( placement.policy != affinity::Policy::NORMAL ){
+            placement.priority = 1;
+        }
+
+        return placement;
+    }
+
+    // Format Placement
+    std::string format( const affinity::Placement& placement )
+    {
+        const char* policies[] = { "normal", "fifo", "rr" };
+        std::ostringstream stream;
+        stream << affinity::format( placement.core_set ) << ":" << policies[static_cast<int32_t>( placement.policy )] << ":" << placement.priority;
+        return stream.str();
+    }
+
+    // Set Scheduling Policy and Priority of Calling Thread
+    bool prioritize( const affinity::Policy policy, const int32_t priority )
+    {
+        #if defined( _WIN32 )
+        // Windows has no real-time policy for thread, real-time is mapped to highest priorities of thread
+        int32_t level = THREAD_PRIORITY_NORMAL;
+        if( policy != affinity::Policy::NORMAL ){
+            level = ( priority >= 50 ) ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+        }
+        else if( priority != 0 ){
+            level = ( priority <= -10 ) ? THREAD_PRIORITY_HIGHEST : ( priority < 0 ) ? THREAD_PRIORITY_ABOVE_NORMAL :
+                    ( priority < 10 ) ? THREAD_PRIORITY_BELOW_NORMAL : THREAD_PRIORITY_LOWEST;
+        }
+        return SetThreadPriority( GetCurrentThread(), level ) != 0;
+        #elif defined( __linux__ )
+        if( policy != affinity::Policy::NORMAL ){
+            const int scheduler = ( policy == affinity::Policy::FIFO ) ? SCHED_FIFO : SCHED_RR;
+            sched_param parameter = {};
+            parameter.sched_priority = std::min( std::max( priority, sched_get_priority_min( scheduler ) ), sched_get_priority_max( scheduler ) );
+            return pthread_setschedparam( pthread_self(), scheduler, &parameter ) == 0;
+        }
+
+        // Back to Time Sharing, then Nice Value of This Thread (Linux Applies Nice Value per Thread)
+        sched_param parameter = {};
+        if( pthread_setschedparam( pthread_self(), SCHED_OTHER, &parameter ) != 0 ){
+            return false;
+        }
+        return priority == 0 || setpriority( PRIO_PROCESS, static_cast<id_t>( syscall( SYS_gettid ) ), priority ) == 0;
+        #else
+        return policy == affinity::Policy::NORMAL && priority == 0;
+        #endif
+    }
+
+    // Apply Placement to Calling Thread
+    bool place( const affinity::Placement& placement )
+    {
+        bool placed = true;
+        if( !placement.core_set.empty() ){
+            placed = affinity::pin( placement.core_set ) && placed;
+        }
+        if( placement.policy != affinity::Policy::NORMAL || placement.priority != 0 ){
+            placed = affinity::prioritize( placement.policy, placement.priority ) && placed;
+        }
+        return placed;
+    }
+
+    // Identifier of Calling Thread in OS
+    static int64_t identifier()
+    {
+        #if defined( _WIN32 )
+        return static_cast<int64_t>( GetCurrentThreadId() );
+        #elif defined( __linux__ )
+        return static_cast<int64_t>( syscall( SYS_gettid ) );
+        #else
+        return static_cast<int64_t>( std::hash<std::thread::id>()( std::this_thread::get_id() ) );
+        #endif
+    }
+
+    // Read Usage of Thread from OS (Returns false if thread has exited or not supported)
+    static bool read( const int64_t id, affinity::Usage& usage )
+    {
+        #if defined( _WIN32 )
+        HANDLE handle = OpenThread( THREAD_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>( id ) );
+        if( handle == nullptr ){
+            return false;
+        }
+
+        FILETIME creation, exit, kernel, user;
+        const bool succeeded = GetThreadTimes( handle, &creation, &exit, &kernel, &user ) != 0;
+        if( succeeded ){
+            const uint64_t kernel_time = ( static_cast<uint64_t>( kernel.dwHighDateTime ) << 32 ) | kernel.dwLowDateTime;
+            const uint64_t user_time = ( static_cast<uint64_t>( user.dwHighDateTime ) << 32 ) | user.dwLowDateTime;
+            usage.cpu = ( kernel_time + user_time ) * 1e-7; // 100 nanoseconds
+            usage.policy = "priority " + std::to_string( GetThreadPriority( handle ) );
+        }
+        CloseHandle( handle );
+        return succeeded;
+        #elif defined( __linux__ )
+        const std::string directory = "/proc/self/task/" + std::to_string( id );
+
+        // CPU Time, Last Core, Policy (Fields after Command Name, which may contain Spaces)
+        std::ifstream stat( directory + "/stat" );
+        std::string line;
+        if( !std::getline( stat, line ) || line.rfind( ')' ) == std::string::npos ){
+            return false;
+        }
+
+        std::istringstream fields( line.substr( line.rfind( ')' ) + 2 ) );
+        std::vector<std::string> values;
+        std::string value;
+        while( fields >> value ){
+            values.push_back( value );
+        }
+        if( values.size() < 39 ){
+            return false;
+        }
+
+        // Field n of proc(5) is values[n - 3]
+        const double ticks = static_cast<double>( sysconf( _SC_CLK_TCK ) );
+        usage.cpu = ( std::stoull( values[11] ) + std::stoull( values[12] ) ) / ticks; // utime, stime
+        usage.core = std::stoi( values[36] ); // processor
+        const int32_t policy = std::stoi( values[38] );
+        if( policy == SCHED_FIFO || policy == SCHED_RR ){
+            usage.policy = std::string( policy == SCHED_FIFO ? "fifo " : "rr " ) + values[37]; // rt_priority
+        }
+        else{
+            usage.policy = "normal " + values[16]; // nice
+        }
+
+        // Context Switches and Allowed Cores
+        std::ifstream status( directory + "/status" );
+        while( std::getline( status, line ) ){
+            const size_t colon = line.find( ':' );
+            if( colon == std::string::npos ){
+                continue;
+            }
+
+            const std::string key = line.substr( 0, colon );
+            std::string content = line.substr( colon + 1 );
+            content.erase( 0, content.find_first_not_of( " \t" ) );
+            if( key == "voluntary_ctxt_switches" ){
+                usage.voluntary = std::stoull( content );
+            }
+            else if( key == "nonvoluntary_ctxt_switches" ){
+                usage.involuntary = std::stoull( content );
+            }
+            else if( key == "Cpus_allowed_list" ){
+                usage.cores = content;
+            }
+        }
+        return true;
+        #else
+        static_cast<void>( id );
+        static_cast<void>( usage );
+        return false;
+        #endif
+    }
+
+    // Attached Threads
+    struct Registry
+    {
+        struct Entry
+        {
+            int64_t id;
+            affinity::Usage previous; // usage at previous report
+        };
+
+        std::mutex mutex;
+        std::vector<Entry> entries;
+        std::chrono::steady_clock::time_point previous = std::chrono::steady_clock::now();
+    };
+
+    static Registry& registry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    // Attach Calling Thread to Usage Report
+    void attach( const std::string& name )
+    {
+        Registry& registry = affinity::registry();
+        const int64_t id = identifier();
+
+        Registry::Entry entry;
+        entry.id = id;
+        read( id, entry.previous );
+        entry.previous.name = name;
+
+        std::lock_guard<std::mutex> lock( registry.mutex );
+        std::vector<Registry::Entry>::iterator found = std::find_if( registry.entries.begin(), registry.entries.end(), [id]( const Registry::Entry& entry ){ return entry.id == id; } );
+        if( found != registry.entries.end() ){
+            found->previous.name = name;
+        }
+        else{
+            registry.entries.push_back( entry );
+        }
+    }
+
+    // Detach Calling Thread from Usage Report
+    void detach()
+    {
+        Registry& registry = affinity::registry();
+        const int64_t id = identifier();
+
+        std::lock_guard<std::mutex> lock( registry.mutex );
+        registry.entries.erase( std::remove_if( registry.entries.begin(), registry.entries.end(), [id]( const Registry::Entry& entry ){ return entry.id == id; } ), registry.entries.end() );
+    }
+
+    // Usage of Attached Threads
+    std::vector<affinity::Usage> usage()
+    {
+        Registry& registry = affinity::registry();
+        std::lock_guard<std::mutex> lock( registry.mutex );
+
+        std::vector<affinity::Usage> usages;
+        for( const Registry::Entry& entry : registry.entries ){
+            affinity::Usage usage;
+            usage.name = entry.previous.name;
+            if( read( entry.id, usage ) ){
+                usages.push_back( usage );
+            }
+        }
+        return usages;
+    }
+
+    // Write Usage of Attached Threads since previous report
+    bool report( std::ostream& os, const double interval )
+    {
+        Registry& registry = affinity::registry();
+        std::lock_guard<std::mutex> lock( registry.mutex );
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double>( now - registry.previous ).count();
+        if( registry.entries.empty() || elapsed < interval ){
+            return false;
+        }
+        registry.previous = now;
+
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << "threads (" << std::fixed << std::setprecision( 1 ) << elapsed << " s)" << std::endl;
+        os << "  " << std::left << std::setw( 24 ) << "thread" << std::right
+           << std::setw( 8 ) << "cpu %" << std::setw( 10 ) << "invol/s" << std::setw( 10 ) << "vol/s" << std::setw( 6 ) << "core"
+           << "  " << std::left << std::setw( 12 ) << "cores" << "policy" << std::right << std::endl;
+        for( std::vector<Registry::Entry>::iterator entry = registry.entries.begin(); entry != registry.entries.end(); ){
+            affinity::Usage usage;
+            usage.name = entry->previous.name;
+            if( !read( entry->id, usage ) ){
+                // Thread has Exited without Detach
+                entry = registry.entries.erase( entry );
+                continue;
+            }
+
+            const affinity::Usage& previous = entry->previous;
+            os << "  " << std::left << std::setw( 24 ) << usage.name << std::right
+               << std::setprecision( 1 ) << std::setw( 8 ) << ( usage.cpu - previous.cpu ) * 100.0 / elapsed
+               << std::setw( 10 ) << ( usage.involuntary - previous.involuntary ) / elapsed
+               << std::setw( 10 ) << ( usage.voluntary - previous.voluntary ) / elapsed
+               << std::setw( 6 ) << usage.core
+               << "  " << std::left << std::setw( 12 ) << usage.cores << usage.policy << std::right << std::endl;
+            entry->previous = usage;
+            entry++;
+        }
+        os.flags( flags );
+        os.precision( precision );
+
+        return true;
+    }
+}
@@ -0,0 +1,131 @@
+// This is thread affinity that pins calling thread (and threads that it creates later, e.g. workers of pool) to set of cores.
+// Core set is written as list of core indices and ranges (e.g. "0-3,6"). Pinning is supported on Linux and Windows (up to 64 cores).
+// Placement adds scheduling policy and priority (e.g. "2-3:fifo:10"). Real-time policy (SCHED_FIFO, SCHED_RR) requires permission (CAP_SYS_NICE or RLIMIT_RTPRIO),
+// and placement that is not permitted is reported by return value instead of exception, so that program runs with default scheduling.
+// Threads that are attached by name are reported with CPU time, context switches and allowed cores read from OS (Linux /proc, CPU time only on Windows).
+//
+// #include "affinity.h"
+//
+// const std::vector<std::vector<int32_t>> core_sets = affinity::split( devices );
+// std::thread thread( [&](){
+//     affinity::pin( core_sets[0] );
+//     pool::Parameters parameters;
+//     parameters.threads = static_cast<int32_t>( core_sets[0].size() );
+//     parameters.core_set = core_sets[0];
+//     parallel::configure( parameters );
+//     /* work of pipeline */
+// } );
+//
+// affinity::place( affinity::parsePlacement( "2:fifo:10" ) ); // returns false if not permitted
+// affinity::attach( "capture" );
+// affinity::report( std::cout, 5.0 ); // CPU %, involuntary and voluntary context switches per second of attached threads
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __AFFINITY__
+#define __AFFINITY__
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+namespace affinity
+{
+    // Number of Logical Cores
+    int32_t cores();
+
+    // Parse Core Set (e.g. "0-3,6" -> 0, 1, 2, 3, 6)
+    std::vector<int32_t> parse( const std::string& text );
+
+    // Format Core Set (e.g. 0, 1, 2, 3, 6 -> "0-3,6")
+    std::string format( const std::vector<int32_t>& core_set );
+
+    // Split Cores into Contiguous Core Sets of Same Size (Groups Share Cores if Groups exceed Cores)
+    std::vector<std::vector<int32_t>> split( const int32_t groups, const int32_t cores = affinity::cores() );
+
+    // Pin Calling Thread to Core Set (Returns false if not supported)
+    bool pin( const std::vector<int32_t>& core_set );
+
+    // Scheduling Policy
+    enum class Policy
+    {
+        NORMAL, // time sharing (priority is nice value, -20 to 19)
+        FIFO, // real-time, runs until it blocks (priority is 1 to 99)
+        ROUND_ROBIN // real-time, time sliced between threads of same priority (priority is 1 to 99)
+    };
+
+    // Placement of Thread
+    struct Placement
+    {
+        std::vector<int32_t> core_set; // empty doesn't pin
+        affinity::Policy policy = affinity::Policy::NORMAL;
+        int32_t priority = 0; // 0 of normal policy keeps priority
+
+        bool empty() const
+        {
+            return core_set.empty() && policy == affinity::Policy::NORMAL && priority == 0;
+        }
+    };
+
+    // Parse Placement ("<core set>[:<policy>[:<priority>]]", e.g. "2-3:fifo:10", ":normal:-5", policy is normal, fifo or rr)
+    affinity::Placement parsePlacement( const std::string& text );
+
+    // Format Placement
+    std::string format( const affinity::Placement& placement );
+
+    // Set Scheduling Policy and Priority of Calling Thread (Returns false if not supported or not permitted)
+    bool prioritize( const affinity::Policy policy, const int32_t priority );
+
+    // Apply Placement to Calling Thread (Returns false if any part is not supported or not permitted)
+    bool place( const affinity::Placement& placement );
+
+    // Usage of Thread
+    struct Usage
+    {
+        std::string name;
+        double cpu = 0.0; // seconds (user + system)
+        uint64_t voluntary = 0; // context switches by blocking (waiting, sleeping)
+        uint64_t involuntary = 0; // context switches by preemption (time slice, higher priority)
+        int32_t core = -1; // core that thread ran on last (-1 is unknown)
+        std::string cores; // allowed cores (empty is unknown)
+        std::string policy; // scheduling policy and priority (empty is unknown)
+    };
+
+    // Attach Calling Thread to Usage Report with Name (e.g. "capture", "worker 1")
+    void attach( const std::string& name );
+
+    // Detach Calling Thread from Usage Report (Call before Thread Exits)
+    void detach();
+
+    // Usage of Attached Threads (Cumulative since Thread Start)
+    std::vector<affinity::Usage> usage();
+
+    // Write Usage of Attached Threads since previous report if interval (seconds) has elapsed
+    bool report( std::ostream& os, const double interval );
+}
+
+#endif // __AFFINITY__
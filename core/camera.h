@@ -0,0 +1,101 @@
+// This is camera parameters that shared by point cloud generator and software registration.
+// camera::Intrinsics is pinhole camera model without distortion (RealSense D400 depth stream).
+// camera::Extrinsics is rigid transform from one camera to another camera.
+//
+// #include "camera.h"
+//
+// const tdv::nuitrack::OutputMode mode = depth_sensor->getOutputMode();
+// const camera::Intrinsics intrinsics = camera::Intrinsics::fromFov( mode.xres, mode.yres, mode.hfov );
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __CAMERA__
+#define __CAMERA__
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+namespace camera
+{
+    struct Intrinsics
+    {
+        float fx;
+        float fy;
+        float cx;
+        float cy;
+
+        Intrinsics()
+            : fx( 0.0f ), fy( 0.0f ), cx( 0.0f ), cy( 0.0f ){}
+
+        Intrinsics( const float fx, const float fy, const float cx, const float cy )
+            : fx( fx ), fy( fy ), cx( cx ), cy( cy ){}
+
+        // Create Intrinsics from Field of View (tdv::nuitrack::OutputMode provides xres, yres and hfov)
+        static Intrinsics fromFov( const uint32_t width, const uint32_t height, const float hfov )
+        {
+            const float focal = ( width * 0.5f ) / std::tan( hfov * 0.5f );
+            return Intrinsics( focal, focal, width * 0.5f, height * 0.5f );
+        }
+
+        // Scale Intrinsics to Other Resolution
+        Intrinsics scale( const float scale_x, const float scale_y ) const
+        {
+            return Intrinsics( fx * scale_x, fy * scale_y, cx * scale_x, cy * scale_y );
+        }
+
+        bool operator==( const Intrinsics& other ) const
+        {
+            return fx == other.fx && fy == other.fy && cx == other.cx && cy == other.cy;
+        }
+
+        bool operator!=( const Intrinsics& other ) const
+        {
+            return !( *this == other );
+        }
+    };
+
+    struct Extrinsics
+    {
+        // Row-Major Rotation Matrix, Translation in Millimeter
+        float rotation[9];
+        float translation[3];
+
+        Extrinsics()
+            : rotation{ 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f }, translation{ 0.0f, 0.0f, 0.0f }{}
+
+        bool operator==( const Extrinsics& other ) const
+        {
+            return std::equal( rotation, rotation + 9, other.rotation ) && std::equal( translation, translation + 3, other.translation );
+        }
+
+        bool operator!=( const Extrinsics& other ) const
+        {
+            return !( *this == other );
+        }
+    };
+}
+
+#endif // __CAMERA__
@@ -0,0 +1,594 @@
+#include "codec.h"
+
+#include <string>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define CODEC_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace codec
+{
+    // Magic of Encoded Frame ("RVL1")
+    static const uint32_t MAGIC = 0x314C5652u;
+
+    // Flags of Encoded Frame
+    static const uint32_t FLAG_LABELS = 1u;
+
+    // Maximum Width and Height
+    static const int32_t MAX_SIZE = 65535;
+
+    // Count Trailing Zero Bits (Non-Zero Value)
+    static inline uint32_t countTrailingZeros( const uint32_t value )
+    {
+        #ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward( &index, value );
+        return static_cast<uint32_t>( index );
+        #else
+        return static_cast<uint32_t>( __builtin_ctz( value ) );
+        #endif
+    }
+
+    // Count Trailing Zero Bits (Non-Zero 64 bit Value)
+    static inline uint32_t countTrailingZeros64( const uint64_t value )
+    {
+        #if defined( _MSC_VER ) && defined( _M_X64 )
+        unsigned long index;
+        _BitScanForward64( &index, value );
+        return static_cast<uint32_t>( index );
+        #elif defined( _MSC_VER )
+        const uint32_t lower = static_cast<uint32_t>( value );
+        return lower ? countTrailingZeros( lower ) : 32 + countTrailingZeros( static_cast<uint32_t>( value >> 32 ) );
+        #else
+        return static_cast<uint32_t>( __builtin_ctzll( value ) );
+        #endif
+    }
+
+    // Count Pixels Equal to Value from Begin
+    static inline uint32_t countEqual( const uint16_t* pixels, const uint32_t begin, const uint32_t end, const uint16_t value )
+    {
+        uint32_t index = begin;
+        #ifdef CODEC_SSE2
+        const __m128i target = _mm_set1_epi16( static_cast<short>( value ) );
+        for( ; index + 8 <= end; index += 8 ){
+            const __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels + index ) );
+            const uint32_t mask = static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi16( block, target ) ) );
+            if( mask != 0xFFFFu ){
+                return index + ( countTrailingZeros( ~mask ) >> 1 ) - begin;
+            }
+        }
+        #endif
+        while( index < end && pixels[index] == value ){
+            index++;
+        }
+        return index - begin;
+    }
+
+    // Count Non-Zero Pixels from Begin
+    static inline uint32_t countNonZero( const uint16_t* pixels, const uint32_t begin, const uint32_t end )
+    {
+        uint32_t index = begin;
+        #ifdef CODEC_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for( ; index + 8 <= end; index += 8 ){
+            const __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels + index ) );
+            const uint32_t mask = static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi16( block, zero ) ) );
+            if( mask != 0u ){
+                return index + ( countTrailingZeros( mask ) >> 1 ) - begin;
+            }
+        }
+        #endif
+        while( index < end && pixels[index] != 0 ){
+            index++;
+        }
+        return index - begin;
+    }
+
+    // Table of Short Variable Length Codes (Values less than 512, Up to 3 Nibbles)
+    // Entry is code | ( bits << 16 ).
+    struct Table
+    {
+        static const uint32_t VALUES = 512;
+
+        uint32_t encoder[VALUES];
+
+        Table()
+        {
+            for( uint32_t value = 0; value < VALUES; value++ ){
+                uint32_t code = 0;
+                uint32_t bits = 0;
+                uint32_t rest = value;
+                while( rest >= 8 ){
+                    code |= ( ( rest & 7 ) | 8 ) << bits;
+                    bits += 4;
+                    rest >>= 3;
+                }
+                code |= rest << bits;
+                bits += 4;
+                encoder[value] = code | ( bits << 16 );
+            }
+        }
+    };
+
+    static const codec::Table& table()
+    {
+        static const codec::Table table;
+        return table;
+    }
+
+    // Writer of Nibbles (Packed from Least Significant Bit, Little Endian)
+    // Accumulated bits are stored every time, and output advances by completed bytes. (Output needs 8 bytes of slack)
+    class Writer
+    {
+    private:
+        uint8_t* output;
+        const uint32_t* codes;
+        uint64_t word = 0;
+        uint32_t used = 0; // 0 or 4
+
+    public:
+        // Constructor
+        Writer( uint8_t* output )
+            : output( output ), codes( codec::table().encoder ){}
+
+        // Append Code of Bits (Multiple of 4, Up to 56)
+        inline void put( const uint64_t code, const uint32_t bits )
+        {
+            word |= code << used;
+            used += bits;
+            std::memcpy( output, &word, sizeof( word ) );
+            const uint32_t bytes = used >> 3;
+            output += bytes;
+            word >>= bytes * 8;
+            used &= 7;
+        }
+
+        // Retrieve Entry of Short Code (Value less than Table::VALUES)
+        inline uint32_t entry( const uint32_t value ) const
+        {
+            return codes[value];
+        }
+
+        // Append Variable Length Value (3 bits per Nibble, Lower First, Most Significant Bit is Continuation)
+        inline void value( uint32_t value )
+        {
+            if( value < Table::VALUES ){
+                const uint32_t entry = codes[value];
+                put( entry & 0xFFFF, entry >> 16 );
+                return;
+            }
+
+            uint64_t code = 0;
+            uint32_t bits = 0;
+            do{
+                code |= static_cast<uint64_t>( ( value & 7 ) | 8 ) << bits;
+                bits += 4;
+                value >>= 3;
+            } while( value >= 8 );
+            code |= static_cast<uint64_t>( value ) << bits;
+            put( code, bits + 4 );
+        }
+
+        // Flush Last Nibble (Returns End of Output)
+        uint8_t* flush()
+        {
+            if( used > 0 ){
+                output++;
+                word = 0;
+                used = 0;
+            }
+            return output;
+        }
+    };
+
+    // Reader of Nibbles
+    // Ends of codes are found from nibbles without continuation bit in window of 60 bits, so several codes are decoded without dependency.
+    class Reader
+    {
+    private:
+        const uint8_t* data;
+        const size_t size;
+        size_t position = 0; // bits
+
+        // Continuation Bits of 15 Nibbles
+        static const uint64_t CONTINUATIONS = 0x0888888888888888ull;
+
+        // Remove Continuation Bits of Short Code (Up to 3 Nibbles)
+        static inline uint32_t compact( const uint64_t code )
+        {
+            return static_cast<uint32_t>( ( code & 7 ) | ( ( code >> 1 ) & 0x38 ) | ( ( code >> 2 ) & 0x1C0 ) );
+        }
+
+        // Retrieve Window of 60 Bits from Position (Zero beyond End)
+        inline uint64_t window() const
+        {
+            const size_t byte = position >> 3;
+            uint64_t word = 0;
+            if( byte + sizeof( word ) <= size ){
+                std::memcpy( &word, data + byte, sizeof( word ) );
+            }
+            else if( byte < size ){
+                std::memcpy( &word, data + byte, size - byte );
+            }
+            return word >> ( position & 7 );
+        }
+
+    public:
+        // Constructor
+        Reader( const uint8_t* data, const size_t size )
+            : data( data ), size( size ){}
+
+        // Retrieve Variable Length Value
+        inline uint32_t value()
+        {
+            const uint64_t bits = window();
+            const uint64_t ends = ~bits & CONTINUATIONS;
+            const uint32_t length = ( ends != 0 ) ? countTrailingZeros64( ends ) + 1 : 64;
+            if( length <= 12 ){
+                position += length;
+                return compact( bits & ( ( 1ull << length ) - 1 ) );
+            }
+
+            // Long Code (Up to 11 Nibbles)
+            uint64_t value = 0;
+            for( uint32_t nibble = 0; nibble * 4 < length && nibble < 11; nibble++ ){
+                value |= ( ( bits >> ( nibble * 4 ) ) & 7 ) << ( nibble * 3 );
+            }
+            if( length > 44 || value > 0xFFFFFFFFull ){
+                throw std::runtime_error( "failed to decode frame (invalid variable length value)" );
+            }
+            position += length;
+            return static_cast<uint32_t>( value );
+        }
+
+        // Retrieve 4 Variable Length Values (Returns false without advance if any of them is not short code)
+        inline bool values( uint32_t values[4] )
+        {
+            const uint64_t bits = window();
+            const uint64_t t0 = ~bits & CONTINUATIONS;
+            const uint64_t t1 = t0 & ( t0 - 1 );
+            const uint64_t t2 = t1 & ( t1 - 1 );
+            const uint64_t t3 = t2 & ( t2 - 1 );
+            if( t3 == 0 ){
+                return false;
+            }
+
+            const uint32_t e0 = countTrailingZeros64( t0 ) + 1;
+            const uint32_t e1 = countTrailingZeros64( t1 ) + 1;
+            const uint32_t e2 = countTrailingZeros64( t2 ) + 1;
+            const uint32_t e3 = countTrailingZeros64( t3 ) + 1;
+            if( ( e0 | ( e1 - e0 ) | ( e2 - e1 ) | ( e3 - e2 ) ) > 12 ){
+                return false;
+            }
+
+            values[0] = compact( bits & ( ( 1ull << e0 ) - 1 ) );
+            values[1] = compact( ( bits >> e0 ) & ( ( 1ull << ( e1 - e0 ) ) - 1 ) );
+            values[2] = compact( ( bits >> e1 ) & ( ( 1ull << ( e2 - e1 ) ) - 1 ) );
+            values[3] = compact( ( bits >> e2 ) & ( ( 1ull << ( e3 - e2 ) ) - 1 ) );
+            position += e3;
+            return true;
+        }
+
+        // Check Position is not beyond End
+        inline void check() const
+        {
+            if( position > size * 8 ){
+                throw std::runtime_error( "failed to decode frame (truncated data)" );
+            }
+        }
+    };
+
+    // Zigzag Encoding of Difference
+    static inline uint32_t zigzag( const int32_t delta )
+    {
+        return static_cast<uint32_t>( delta * 2 ) ^ static_cast<uint32_t>( delta >> 31 );
+    }
+
+    // Zigzag Decoding of Difference
+    static inline int32_t unzigzag( const uint32_t value )
+    {
+        return static_cast<int32_t>( value >> 1 ) ^ -static_cast<int32_t>( value & 1 );
+    }
+
+    #ifdef CODEC_SSE2
+    // Encode Differences of 8 Non-Zero Pixels to 2 Codes (Returns false if any difference needs long code)
+    // Zigzag of difference is computed from saturated differences, and short codes (3 nibbles) are built in 16 bit lanes.
+    // Adjacent codes are merged with multiply-add (code[2k] + code[2k+1] * 2^bits[2k]).
+    static inline bool encodeBlock( const uint16_t* pixels, const int32_t previous, uint64_t code[2], uint32_t bits[2] )
+    {
+        const __m128i current = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels ) );
+        const __m128i before = _mm_insert_epi16( _mm_slli_si128( current, 2 ), previous, 0 );
+
+        // Zigzag (2 * positive, 2 * negative - 1)
+        const __m128i positive = _mm_subs_epu16( current, before );
+        const __m128i negative = _mm_subs_epu16( before, current );
+        const __m128i sign = _mm_andnot_si128( _mm_cmpeq_epi16( negative, _mm_setzero_si128() ), _mm_set1_epi16( 1 ) );
+        const __m128i magnitude = _mm_or_si128( positive, negative );
+        const __m128i zigzag = _mm_subs_epu16( _mm_adds_epu16( magnitude, magnitude ), sign );
+        const __m128i longer = _mm_subs_epu16( zigzag, _mm_set1_epi16( Table::VALUES - 1 ) );
+        if( _mm_movemask_epi8( _mm_cmpeq_epi16( longer, _mm_setzero_si128() ) ) != 0xFFFF ){
+            return false;
+        }
+
+        // Short Codes (1-3 Nibbles) and Their Bits
+        const __m128i seven = _mm_set1_epi16( 7 );
+        const __m128i two = _mm_cmpgt_epi16( zigzag, seven );
+        const __m128i three = _mm_cmpgt_epi16( zigzag, _mm_set1_epi16( 63 ) );
+        __m128i codes = _mm_and_si128( zigzag, seven );
+        codes = _mm_or_si128( codes, _mm_slli_epi16( _mm_and_si128( _mm_srli_epi16( zigzag, 3 ), seven ), 4 ) );
+        codes = _mm_or_si128( codes, _mm_slli_epi16( _mm_srli_epi16( zigzag, 6 ), 8 ) );
+        codes = _mm_or_si128( codes, _mm_and_si128( two, _mm_set1_epi16( 0x08 ) ) );
+        codes = _mm_or_si128( codes, _mm_and_si128( three, _mm_set1_epi16( 0x80 ) ) );
+        const __m128i lengths = _mm_add_epi16( _mm_set1_epi16( 4 ), _mm_add_epi16( _mm_and_si128( two, _mm_set1_epi16( 4 ) ), _mm_and_si128( three, _mm_set1_epi16( 4 ) ) ) );
+        const __m128i powers = _mm_add_epi16( _mm_set1_epi16( 16 ), _mm_add_epi16( _mm_and_si128( two, _mm_set1_epi16( 240 ) ), _mm_and_si128( three, _mm_set1_epi16( 3840 ) ) ) );
+
+        // Merge Pairs into 32 bit Lanes (Up to 24 bits)
+        const __m128i multipliers = _mm_or_si128( _mm_slli_epi32( powers, 16 ), _mm_set1_epi32( 1 ) );
+        alignas( 16 ) uint32_t pairs[4];
+        alignas( 16 ) uint32_t sizes[4];
+        _mm_store_si128( reinterpret_cast<__m128i*>( pairs ), _mm_madd_epi16( codes, multipliers ) );
+        _mm_store_si128( reinterpret_cast<__m128i*>( sizes ), _mm_madd_epi16( lengths, _mm_set1_epi16( 1 ) ) );
+
+        code[0] = static_cast<uint64_t>( pairs[0] ) | ( static_cast<uint64_t>( pairs[1] ) << sizes[0] );
+        code[1] = static_cast<uint64_t>( pairs[2] ) | ( static_cast<uint64_t>( pairs[3] ) << sizes[2] );
+        bits[0] = sizes[0] + sizes[1];
+        bits[1] = sizes[2] + sizes[3];
+        return true;
+    }
+    #endif
+
+    // Encode Depth (Returns End of Output)
+    static uint8_t* encodeDepth( const uint16_t* depth, const uint32_t total, uint8_t* output )
+    {
+        codec::Writer writer( output );
+        int32_t previous = 0;
+        uint32_t index = 0;
+        while( index < total ){
+            const uint32_t zeros = countEqual( depth, index, total, 0 );
+            index += zeros;
+            const uint32_t nonzeros = countNonZero( depth, index, total );
+            writer.value( zeros );
+            writer.value( nonzeros );
+
+            // Difference from Previous Non-Zero Pixel (8 or 4 Short Codes are Appended at Once)
+            const uint32_t end = index + nonzeros;
+            #ifdef CODEC_SSE2
+            for( ; index + 8 <= end; index += 8 ){
+                uint64_t code[2];
+                uint32_t bits[2];
+                if( !encodeBlock( depth + index, previous, code, bits ) ){
+                    for( uint32_t offset = 0; offset < 8; offset++ ){
+                        writer.value( zigzag( depth[index + offset] - previous ) );
+                        previous = depth[index + offset];
+                    }
+                    continue;
+                }
+                writer.put( code[0], bits[0] );
+                writer.put( code[1], bits[1] );
+                previous = depth[index + 7];
+            }
+            #endif
+            for( ; index + 4 <= end; index += 4 ){
+                const uint32_t z0 = zigzag( depth[index] - previous );
+                const uint32_t z1 = zigzag( depth[index + 1] - depth[index] );
+                const uint32_t z2 = zigzag( depth[index + 2] - depth[index + 1] );
+                const uint32_t z3 = zigzag( depth[index + 3] - depth[index + 2] );
+                previous = depth[index + 3];
+
+                if( ( z0 | z1 | z2 | z3 ) < Table::VALUES ){
+                    const uint32_t e0 = writer.entry( z0 ), e1 = writer.entry( z1 ), e2 = writer.entry( z2 ), e3 = writer.entry( z3 );
+                    const uint32_t b0 = e0 >> 16, b1 = e1 >> 16, b2 = e2 >> 16, b3 = e3 >> 16;
+                    const uint64_t code = static_cast<uint64_t>( e0 & 0xFFFF ) | ( static_cast<uint64_t>( e1 & 0xFFFF ) << b0 ) |
+                                          ( static_cast<uint64_t>( e2 & 0xFFFF ) << ( b0 + b1 ) ) | ( static_cast<uint64_t>( e3 & 0xFFFF ) << ( b0 + b1 + b2 ) );
+                    writer.put( code, b0 + b1 + b2 + b3 );
+                }
+                else{
+                    writer.value( z0 );
+                    writer.value( z1 );
+                    writer.value( z2 );
+                    writer.value( z3 );
+                }
+            }
+            for( ; index < end; index++ ){
+                writer.value( zigzag( depth[index] - previous ) );
+                previous = depth[index];
+            }
+        }
+        return writer.flush();
+    }
+
+    // Encode User Labels (Returns End of Output)
+    static uint8_t* encodeLabels( const uint16_t* labels, const uint32_t total, uint8_t* output )
+    {
+        codec::Writer writer( output );
+        uint32_t index = 0;
+        while( index < total ){
+            const uint16_t label = labels[index];
+            const uint32_t run = countEqual( labels, index, total, label );
+            writer.value( label );
+            writer.value( run - 1 );
+            index += run;
+        }
+        return writer.flush();
+    }
+
+    // Decode Depth
+    static void decodeDepth( const uint8_t* data, const size_t size, uint16_t* depth, const uint32_t total )
+    {
+        codec::Reader reader( data, size );
+        int32_t previous = 0;
+        uint32_t index = 0;
+        while( index < total ){
+            const uint32_t zeros = reader.value();
+            const uint32_t nonzeros = reader.value();
+            if( zeros > total - index || nonzeros > total - index - zeros || zeros + nonzeros == 0 ){
+                throw std::runtime_error( "failed to decode depth (invalid run length)" );
+            }
+
+            std::fill( depth + index, depth + index + zeros, static_cast<uint16_t>( 0 ) );
+            index += zeros;
+
+            // Difference from Previous Non-Zero Pixel (4 Short Codes are Decoded from One Window)
+            // Pixels out of range are accumulated, and checked once per run.
+            const uint32_t end = index + nonzeros;
+            uint32_t invalid = 0;
+            for( ; index + 4 <= end; index += 4 ){
+                uint32_t z[4];
+                if( !reader.values( z ) ){
+                    for( uint32_t offset = 0; offset < 4; offset++ ){
+                        z[offset] = reader.value();
+                        if( z[offset] > 131071u ){
+                            throw std::runtime_error( "failed to decode depth (invalid difference)" );
+                        }
+                    }
+                }
+
+                const int32_t p0 = previous + unzigzag( z[0] );
+                const int32_t p1 = p0 + unzigzag( z[1] );
+                const int32_t p2 = p1 + unzigzag( z[2] );
+                const int32_t p3 = p2 + unzigzag( z[3] );
+                invalid |= ( static_cast<uint32_t>( p0 - 1 ) > 65534u ) | ( static_cast<uint32_t>( p1 - 1 ) > 65534u ) |
+                           ( static_cast<uint32_t>( p2 - 1 ) > 65534u ) | ( static_cast<uint32_t>( p3 - 1 ) > 65534u );
+                depth[index] = static_cast<uint16_t>( p0 );
+                depth[index + 1] = static_cast<uint16_t>( p1 );
+                depth[index + 2] = static_cast<uint16_t>( p2 );
+                depth[index + 3] = static_cast<uint16_t>( p3 );
+                previous = p3;
+            }
+            for( ; index < end; index++ ){
+                const uint32_t z = reader.value();
+                if( z > 131071u ){
+                    throw std::runtime_error( "failed to decode depth (invalid difference)" );
+                }
+                previous += unzigzag( z );
+                invalid |= static_cast<uint32_t>( previous - 1 ) > 65534u;
+                depth[index] = static_cast<uint16_t>( previous );
+            }
+
+            if( invalid ){
+                throw std::runtime_error( "failed to decode depth (invalid difference)" );
+            }
+            reader.check();
+        }
+    }
+
+    // Decode User Labels
+    static void decodeLabels( const uint8_t* data, const size_t size, uint16_t* labels, const uint32_t total )
+    {
+        codec::Reader reader( data, size );
+        uint32_t index = 0;
+        while( index < total ){
+            const uint32_t label = reader.value();
+            const uint32_t run = reader.value();
+            if( label > 65535 || run >= total - index ){
+                throw std::runtime_error( "failed to decode labels (invalid run)" );
+            }
+
+            std::fill( labels + index, labels + index + run + 1, static_cast<uint16_t>( label ) );
+            index += run + 1;
+        }
+        reader.check();
+    }
+
+    // Write Little Endian Word
+    static inline void store( uint8_t* output, const uint32_t value )
+    {
+        output[0] = static_cast<uint8_t>( value );
+        output[1] = static_cast<uint8_t>( value >> 8 );
+        output[2] = static_cast<uint8_t>( value >> 16 );
+        output[3] = static_cast<uint8_t>( value >> 24 );
+    }
+
+    // Read Little Endian Word
+    static inline uint32_t load( const uint8_t* data )
+    {
+        return static_cast<uint32_t>( data[0] ) | ( static_cast<uint32_t>( data[1] ) << 8 ) |
+               ( static_cast<uint32_t>( data[2] ) << 16 ) | ( static_cast<uint32_t>( data[3] ) << 24 );
+    }
+
+    // Retrieve Maximum Size of Encoded Frame (bytes)
+    size_t bound( const int32_t width, const int32_t height, const bool labels )
+    {
+        // Each pixel needs at most 4.5 bytes for depth (difference and run lengths) and 4 bytes for labels, and 8 bytes of slack for writer
+        const size_t total = static_cast<size_t>( std::max( width, 0 ) ) * static_cast<size_t>( std::max( height, 0 ) );
+        const size_t channel = total * 5 + 16;
+        return HEADER_BYTES + channel * ( labels ? 2 : 1 );
+    }
+
+    // Encode Depth (and User Labels if not nullptr)
+    size_t encode( const uint16_t* depth, const uint16_t* labels, const int32_t width, const int32_t height, std::vector<uint8_t>& buffer )
+    {
+        if( !depth || width <= 0 || height <= 0 || width > MAX_SIZE || height > MAX_SIZE ){
+            throw std::runtime_error( "failed to encode frame (" + std::to_string( width ) + "x" + std::to_string( height ) + ")" );
+        }
+
+        const size_t required = bound( width, height, labels != nullptr );
+        if( buffer.size() < required ){
+            buffer.resize( required );
+        }
+
+        const uint32_t total = static_cast<uint32_t>( width ) * static_cast<uint32_t>( height );
+        uint8_t* const begin = buffer.data();
+        uint8_t* const depth_begin = begin + HEADER_BYTES;
+        uint8_t* const depth_end = encodeDepth( depth, total, depth_begin );
+        uint8_t* const labels_end = labels ? encodeLabels( labels, total, depth_end ) : depth_end;
+
+        store( begin, MAGIC );
+        store( begin + 4, static_cast<uint32_t>( width ) );
+        store( begin + 8, static_cast<uint32_t>( height ) );
+        store( begin + 12, labels ? FLAG_LABELS : 0u );
+        store( begin + 16, static_cast<uint32_t>( depth_end - depth_begin ) );
+        store( begin + 20, static_cast<uint32_t>( labels_end - depth_end ) );
+
+        return static_cast<size_t>( labels_end - begin );
+    }
+
+    // Retrieve Header of Encoded Frame (Throws if not valid)
+    codec::Header header( const uint8_t* data, const size_t size )
+    {
+        if( !data || size < HEADER_BYTES || load( data ) != MAGIC ){
+            throw std::runtime_error( "failed to decode frame (invalid header)" );
+        }
+
+        codec::Header header;
+        header.width = load( data + 4 );
+        header.height = load( data + 8 );
+        header.labels = ( load( data + 12 ) & FLAG_LABELS ) != 0;
+        header.depth_bytes = load( data + 16 );
+        header.label_bytes = load( data + 20 );
+
+        const uint64_t required = HEADER_BYTES + static_cast<uint64_t>( header.depth_bytes ) + header.label_bytes;
+        if( header.width == 0 || header.height == 0 || header.width > static_cast<uint32_t>( MAX_SIZE ) || header.height > static_cast<uint32_t>( MAX_SIZE ) ||
+            header.labels != ( header.label_bytes != 0 ) || required > size ){
+            throw std::runtime_error( "failed to decode frame (invalid header)" );
+        }
+
+        return header;
+    }
+
+    // Decode Depth (and User Labels if not nullptr) to width * height Pixels (Throws if corrupted)
+    void decode( const uint8_t* data, const size_t size, uint16_t* depth, uint16_t* labels )
+    {
+        const codec::Header header = codec::header( data, size );
+        if( labels && !header.labels ){
+            throw std::runtime_error( "failed to decode labels (frame has no labels)" );
+        }
+
+        const uint32_t total = header.width * header.height;
+        const uint8_t* const depth_begin = data + HEADER_BYTES;
+        if( depth ){
+            decodeDepth( depth_begin, header.depth_bytes, depth, total );
+        }
+        if( labels ){
+            decodeLabels( depth_begin + header.depth_bytes, header.label_bytes, labels, total );
+        }
+    }
+}
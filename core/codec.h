@@ -0,0 +1,80 @@
+// This is lossless codec of depth frames (RVL, Run length and Variable Length coding) for recording and transport.
+// Depth is coded as pairs of runs (zero pixels, non-zero pixels), and each non-zero pixel is coded as difference from
+// previous non-zero pixel. Run lengths and differences (zigzag) are coded with variable length nibbles (3 bits + continuation bit).
+// User labels are optionally coded alongside depth as runs of same label.
+// Runs are scanned 8 pixels at a time with SSE2 (scalar on other architectures).
+// Reference: A. D. Wilson, "Fast Lossless Depth Image Compression", ACM ISS 2017.
+//
+// #include "codec.h"
+//
+// std::vector<uint8_t> buffer;
+// const size_t size = codec::encode( depth, labels /* or nullptr */, width, height, buffer );
+// write( buffer.data(), size );
+//
+// const codec::Header header = codec::header( data, size );
+// std::vector<uint16_t> depth( header.width * header.height );
+// std::vector<uint16_t> labels( header.width * header.height );
+// codec::decode( data, size, depth.data(), header.labels ? labels.data() : nullptr );
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __CODEC__
+#define __CODEC__
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace codec
+{
+    // Header of Encoded Frame
+    struct Header
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        bool labels = false; // user labels are coded
+        uint32_t depth_bytes = 0;
+        uint32_t label_bytes = 0;
+    };
+
+    // Size of Header in Encoded Frame (bytes)
+    static const size_t HEADER_BYTES = 24;
+
+    // Retrieve Maximum Size of Encoded Frame (bytes)
+    size_t bound( const int32_t width, const int32_t height, const bool labels );
+
+    // Encode Depth (and User Labels if not nullptr)
+    // Buffer is grown to bound() if it is smaller (never shrunk), and returns size of encoded frame. (only first bytes of buffer are valid)
+    size_t encode( const uint16_t* depth, const uint16_t* labels, const int32_t width, const int32_t height, std::vector<uint8_t>& buffer );
+
+    // Retrieve Header of Encoded Frame (Throws if not valid)
+    codec::Header header( const uint8_t* data, const size_t size );
+
+    // Decode Depth (and User Labels if not nullptr) to width * height Pixels (Throws if corrupted)
+    void decode( const uint8_t* data, const size_t size, uint16_t* depth, uint16_t* labels );
+}
+
+#endif // __CODEC__
@@ -0,0 +1,267 @@
+#include "filter.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace filter
+{
+    // Apply Filter
+    void Bilateral::apply( uint16_t* data, const int32_t width, const int32_t height )
+    {
+        buffer.resize( static_cast<size_t>( width ) * height );
+
+        const int32_t tiles_x = ( width + TILE_WIDTH - 1 ) / TILE_WIDTH;
+        const int32_t tiles_y = ( height + TILE_HEIGHT - 1 ) / TILE_HEIGHT;
+        const int32_t tiles = tiles_x * tiles_y;
+
+        // Horizontal Pass (data -> buffer)
+        parallel::forEach( tiles, 1, [&]( const int32_t first, const int32_t last, const int32_t ){
+            for( int32_t tile = first; tile < last; tile++ ){
+                const int32_t x_begin = ( tile % tiles_x ) * TILE_WIDTH, x_end = std::min( x_begin + TILE_WIDTH, width );
+                const int32_t y_begin = ( tile / tiles_x ) * TILE_HEIGHT, y_end = std::min( y_begin + TILE_HEIGHT, height );
+                float sum[TILE_WIDTH], weight_sum[TILE_WIDTH];
+                for( int32_t y = y_begin; y < y_end; y++ ){
+                    const uint16_t* row = data + y * width;
+                    std::fill( sum, sum + TILE_WIDTH, 0.0f );
+                    std::fill( weight_sum, weight_sum + TILE_WIDTH, 0.0f );
+                    for( int32_t k = -radius; k <= radius; k++ ){
+                        const int32_t begin = std::max( x_begin, -k ), end = std::min( x_end, width - k );
+                        accumulate( row + begin, row + begin + k, end - begin, space_weights[k + radius], sum + ( begin - x_begin ), weight_sum + ( begin - x_begin ) );
+                    }
+                    resolve( row + x_begin, sum, weight_sum, x_end - x_begin, buffer.data() + y * width + x_begin );
+                }
+            }
+        } );
+
+        // Vertical Pass (buffer -> data)
+        parallel::forEach( tiles, 1, [&]( const int32_t first, const int32_t last, const int32_t ){
+            for( int32_t tile = first; tile < last; tile++ ){
+                const int32_t x_begin = ( tile % tiles_x ) * TILE_WIDTH, x_end = std::min( x_begin + TILE_WIDTH, width );
+                const int32_t y_begin = ( tile / tiles_x ) * TILE_HEIGHT, y_end = std::min( y_begin + TILE_HEIGHT, height );
+                float sum[TILE_WIDTH], weight_sum[TILE_WIDTH];
+                for( int32_t y = y_begin; y < y_end; y++ ){
+                    const uint16_t* center = buffer.data() + y * width + x_begin;
+                    std::fill( sum, sum + TILE_WIDTH, 0.0f );
+                    std::fill( weight_sum, weight_sum + TILE_WIDTH, 0.0f );
+                    const int32_t begin = std::max( y - radius, 0 ), end = std::min( y + radius, height - 1 );
+                    for( int32_t i = begin; i <= end; i++ ){
+                        accumulate( center, buffer.data() + i * width + x_begin, x_end - x_begin, space_weights[i - y + radius], sum, weight_sum );
+                    }
+                    resolve( center, sum, weight_sum, x_end - x_begin, data + y * width + x_begin );
+                }
+            }
+        } );
+    }
+
+    // Initialize Weight Table
+    void Bilateral::initialize()
+    {
+        space_weights.resize( radius * 2 + 1 );
+        for( int32_t i = -radius; i <= radius; i++ ){
+            space_weights[i + radius] = std::exp( -( i * i ) / ( 2.0f * sigma_space * sigma_space ) );
+        }
+    }
+
+    // Accumulate Weighted Neighbors
+    // Range weight is Cauchy kernel instead of Gaussian kernel to avoid exp() and table lookup,
+    // so that this loop is vectorized by compiler. Difference larger than 3 sigma is regarded as edge.
+    void Bilateral::accumulate( const uint16_t* center, const uint16_t* neighbor, const int32_t count, const float space_weight, float* sum, float* weight_sum ) const
+    {
+        const float scale = 1.0f / ( 2.0f * sigma_range * sigma_range );
+        const float threshold = 9.0f * sigma_range * sigma_range;
+        for( int32_t x = 0; x < count; x++ ){
+            const float value = neighbor[x];
+            const float difference = value - center[x];
+            const float square = difference * difference;
+            const float mask = static_cast<float>( square < threshold ) * static_cast<float>( value != 0.0f );
+            const float weight = mask * space_weight / ( 1.0f + square * scale );
+            sum[x] += weight * value;
+            weight_sum[x] += weight;
+        }
+    }
+
+    // Resolve Weighted Average (Invalid Pixel Stays Invalid)
+    void Bilateral::resolve( const uint16_t* center, const float* sum, const float* weight_sum, const int32_t count, uint16_t* output ) const
+    {
+        for( int32_t x = 0; x < count; x++ ){
+            output[x] = center[x] ? static_cast<uint16_t>( sum[x] / weight_sum[x] + 0.5f ) : 0;
+        }
+    }
+
+    // Apply Filter
+    void Temporal::apply( uint16_t* data, const int32_t width, const int32_t height )
+    {
+        const int32_t total = width * height;
+
+        // Reset History When Resolution Changed
+        if( this->width != width || this->height != height ){
+            this->width = width;
+            this->height = height;
+            state.assign( data, data + total );
+            history.resize( total );
+            for( int32_t index = 0; index < total; index++ ){
+                history[index] = data[index] ? 1 : 0;
+            }
+            return;
+        }
+
+        parallel::forEach( total, GRAIN, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t index = begin; index < end; index++ ){
+                const uint16_t depth = data[index];
+                const uint8_t valid = ( history[index] << 1 ) | ( depth ? 1 : 0 );
+                float smoothed = state[index];
+
+                if( depth ){
+                    if( smoothed == 0.0f || std::abs( depth - smoothed ) > delta ){
+                        smoothed = depth;
+                    }
+                    else{
+                        smoothed += alpha * ( depth - smoothed );
+                    }
+                    data[index] = static_cast<uint16_t>( smoothed + 0.5f );
+                }
+                else if( smoothed != 0.0f && count( valid ) >= persistence ){
+                    data[index] = static_cast<uint16_t>( smoothed + 0.5f );
+                }
+                else{
+                    smoothed = 0.0f;
+                }
+
+                state[index] = smoothed;
+                history[index] = valid;
+            }
+        } );
+    }
+
+    // Count Valid Frames
+    int32_t Temporal::count( uint8_t bits )
+    {
+        int32_t count = 0;
+        for( ; bits; bits &= bits - 1 ){
+            count++;
+        }
+        return count;
+    }
+
+    // Apply Filter
+    void HoleFilling::apply( uint16_t* data, const int32_t width, const int32_t height )
+    {
+        buffer.resize( static_cast<size_t>( width ) * height );
+
+        // Horizontal Pass
+        parallel::forEach( height, 1, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t y = begin; y < end; y++ ){
+                uint16_t* row = data + y * width;
+                uint16_t* left = buffer.data() + y * width;
+
+                // Left -> Right
+                uint16_t value = 0;
+                int32_t distance = radius + 1;
+                for( int32_t x = 0; x < width; x++ ){
+                    if( row[x] ){
+                        value = row[x];
+                        distance = 0;
+                    }
+                    else{
+                        distance++;
+                    }
+                    left[x] = distance <= radius ? value : 0;
+                }
+
+                // Right -> Left (Fill with Farther Candidate)
+                value = 0;
+                distance = radius + 1;
+                for( int32_t x = width - 1; x >= 0; x-- ){
+                    if( row[x] ){
+                        value = row[x];
+                        distance = 0;
+                        continue;
+                    }
+                    distance++;
+                    const uint16_t right = distance <= radius ? value : 0;
+                    row[x] = std::max( left[x], right );
+                }
+            }
+        } );
+
+        // Vertical Pass
+        // Each strip of columns is swept from top to bottom, then bottom to top.
+        const int32_t strips = ( width + TILE_WIDTH - 1 ) / TILE_WIDTH;
+        parallel::forEach( strips, 1, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t strip = begin; strip < end; strip++ ){
+                const int32_t x_begin = strip * TILE_WIDTH, x_end = std::min( x_begin + TILE_WIDTH, width );
+                uint16_t values[TILE_WIDTH];
+                int32_t distances[TILE_WIDTH];
+
+                // Top -> Bottom
+                std::fill( values, values + TILE_WIDTH, 0 );
+                std::fill( distances, distances + TILE_WIDTH, radius + 1 );
+                for( int32_t y = 0; y < height; y++ ){
+                    const uint16_t* row = data + y * width;
+                    uint16_t* above = buffer.data() + y * width;
+                    for( int32_t x = x_begin; x < x_end; x++ ){
+                        const int32_t i = x - x_begin;
+                        if( row[x] ){
+                            values[i] = row[x];
+                            distances[i] = 0;
+                        }
+                        else{
+                            distances[i]++;
+                        }
+                        above[x] = distances[i] <= radius ? values[i] : 0;
+                    }
+                }
+
+                // Bottom -> Top (Fill with Farther Candidate)
+                std::fill( values, values + TILE_WIDTH, 0 );
+                std::fill( distances, distances + TILE_WIDTH, radius + 1 );
+                for( int32_t y = height - 1; y >= 0; y-- ){
+                    uint16_t* row = data + y * width;
+                    const uint16_t* above = buffer.data() + y * width;
+                    for( int32_t x = x_begin; x < x_end; x++ ){
+                        const int32_t i = x - x_begin;
+                        if( row[x] ){
+                            values[i] = row[x];
+                            distances[i] = 0;
+                            continue;
+                        }
+                        distances[i]++;
+                        const uint16_t below = distances[i] <= radius ? values[i] : 0;
+                        row[x] = std::max( above[x], below );
+                    }
+                }
+            }
+        } );
+    }
+
+    // Apply Filters (Bilateral -> Temporal -> Hole Filling)
+    void Pipeline::apply( uint16_t* data, const int32_t width, const int32_t height )
+    {
+        elapsed = Elapsed();
+
+        if( use_bilateral ){
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            bilateral.apply( data, width, height );
+            elapsed.bilateral = milliseconds( start );
+        }
+
+        if( use_temporal ){
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            temporal.apply( data, width, height );
+            elapsed.temporal = milliseconds( start );
+        }
+
+        if( use_hole_filling ){
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            hole_filling.apply( data, width, height );
+            elapsed.hole_filling = milliseconds( start );
+        }
+    }
+
+    // Elapsed Milliseconds from Start
+    double Pipeline::milliseconds( const std::chrono::steady_clock::time_point& start )
+    {
+        return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    }
+}
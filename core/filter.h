@@ -0,0 +1,200 @@
+// This is depth filters that reduce holes and flicker of depth data that retrieved from NuiTrack depth sensor.
+// All filters work in-place on uint16_t depth buffer (millimeter, 0 is invalid).
+//
+// #include "filter.h"
+//
+// filter::Pipeline pipeline;
+// pipeline.apply( depth_mat.ptr<uint16_t>(), depth_mat.cols, depth_mat.rows );
+// std::cout << pipeline.elapsed.bilateral << " ms" << std::endl;
+//
+// filter::Bilateral   : Edge-preserving smoothing. It is approximated by separable horizontal and vertical passes.
+// filter::Temporal    : Exponential smoothing over time. Invalid pixels are kept while they were valid in recent frames.
+// filter::HoleFilling : Fill invalid pixels with farther valid neighbor. It is separable horizontal and vertical passes.
+//
+// The passes are multi-threaded (parallel::forEach). Passes are processed in tiles to keep rows in cache.
+// Work buffers are allocated when resolution is changed, not every frame.
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __FILTER__
+#define __FILTER__
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+namespace filter
+{
+    // Tile Size of Passes
+    // Rows of tile and accumulators ( 256 columns of float ) fit in L1 cache.
+    static const int32_t TILE_WIDTH = 256;
+    static const int32_t TILE_HEIGHT = 32;
+
+    // Minimum Number of Pixels per Task of Parallel Loop of Pixels
+    static const int32_t GRAIN = 16384;
+
+    class Bilateral
+    {
+    private:
+        int32_t radius = 2;
+        float sigma_space = 2.0f;
+        float sigma_range = 30.0f;
+
+        // Weight Table of Space
+        std::vector<float> space_weights;
+
+        // Intermediate Buffer (Result of Horizontal Pass)
+        std::vector<uint16_t> buffer;
+
+    public:
+        // Constructor
+        Bilateral()
+        {
+            initialize();
+        }
+
+        // Set Parameters
+        // radius is pixels, sigma_space is pixels, sigma_range is millimeter.
+        void setParameters( const int32_t radius, const float sigma_space, const float sigma_range )
+        {
+            this->radius = std::max( radius, 1 );
+            this->sigma_space = sigma_space;
+            this->sigma_range = sigma_range;
+            initialize();
+        }
+
+        // Apply Filter
+        void apply( uint16_t* data, const int32_t width, const int32_t height );
+
+    private:
+        // Initialize Weight Table
+        void initialize();
+
+        // Accumulate Weighted Neighbors
+        // Range weight is Cauchy kernel instead of Gaussian kernel to avoid exp() and table lookup,
+        // so that this loop is vectorized by compiler. Difference larger than 3 sigma is regarded as edge.
+        void accumulate( const uint16_t* center, const uint16_t* neighbor, const int32_t count, const float space_weight, float* sum, float* weight_sum ) const;
+
+        // Resolve Weighted Average (Invalid Pixel Stays Invalid)
+        void resolve( const uint16_t* center, const float* sum, const float* weight_sum, const int32_t count, uint16_t* output ) const;
+    };
+
+    class Temporal
+    {
+    private:
+        float alpha = 0.4f;
+        uint16_t delta = 20;
+        int32_t persistence = 3;
+
+        // Smoothed Depth
+        std::vector<float> state;
+
+        // Valid History of Last 8 Frames (Ring Buffer of Bits, LSB is Latest)
+        std::vector<uint8_t> history;
+
+        int32_t width = 0;
+        int32_t height = 0;
+
+    public:
+        // Set Parameters
+        // alpha is weight of current frame (0.0-1.0), delta is threshold of depth change (millimeter) to reset smoothing,
+        // persistence is number of valid frames in last 8 frames to keep invalid pixel.
+        void setParameters( const float alpha, const uint16_t delta, const int32_t persistence )
+        {
+            this->alpha = alpha;
+            this->delta = delta;
+            this->persistence = persistence;
+        }
+
+        // Reset History
+        void reset()
+        {
+            width = 0;
+            height = 0;
+        }
+
+        // Apply Filter
+        void apply( uint16_t* data, const int32_t width, const int32_t height );
+
+    private:
+        // Count Valid Frames
+        static int32_t count( uint8_t bits );
+    };
+
+    class HoleFilling
+    {
+    private:
+        int32_t radius = 8;
+
+        // Candidates from Left or Above
+        std::vector<uint16_t> buffer;
+
+    public:
+        // Set Parameters
+        // radius is maximum distance (pixels) to search valid neighbor.
+        void setParameters( const int32_t radius )
+        {
+            this->radius = radius;
+        }
+
+        // Apply Filter
+        void apply( uint16_t* data, const int32_t width, const int32_t height );
+    };
+
+    class Pipeline
+    {
+    public:
+        struct Elapsed
+        {
+            double bilateral;
+            double temporal;
+            double hole_filling;
+
+            Elapsed()
+                : bilateral( 0.0 ), temporal( 0.0 ), hole_filling( 0.0 ){}
+        };
+
+        filter::Bilateral bilateral;
+        filter::Temporal temporal;
+        filter::HoleFilling hole_filling;
+
+        bool use_bilateral = true;
+        bool use_temporal = true;
+        bool use_hole_filling = true;
+
+        // Processing Time of Last Frame (milliseconds)
+        Elapsed elapsed;
+
+        // Apply Filters (Bilateral -> Temporal -> Hole Filling)
+        void apply( uint16_t* data, const int32_t width, const int32_t height );
+
+    private:
+        // Elapsed Milliseconds from Start
+        static double milliseconds( const std::chrono::steady_clock::time_point& start );
+    };
+}
+
+#endif // __FILTER__
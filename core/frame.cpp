@@ -0,0 +1,69 @@
+#include "frame.h"
+#include "parallel.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace frame
+{
+    // Copy Color
+    void copyColor( const uint8_t* color_data, uint8_t* bgr, const int32_t count )
+    {
+        parallel::forEach( count, BLOCK_SIZE, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            std::memcpy( bgr + begin * 3, color_data + begin * 3, ( end - begin ) * 3 );
+        } );
+    }
+
+    // Copy Depth
+    void copyDepth( const uint16_t* depth_data, uint16_t* depth, const int32_t count )
+    {
+        parallel::forEach( count, BLOCK_SIZE, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            std::memcpy( depth + begin, depth_data + begin, ( end - begin ) * sizeof( uint16_t ) );
+        } );
+    }
+
+    // Convert Depth to Gray
+    void convertDepthToGray( const uint16_t* depth_data, uint8_t* gray, const int32_t count, const uint32_t max_distance )
+    {
+        const float scale = -255.0f / max_distance;
+        parallel::forEach( count, BLOCK_SIZE, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t index = begin; index < end; index++ ){
+                const float value = depth_data[index] * scale + 255.0f;
+                gray[index] = static_cast<uint8_t>( std::min( std::max( value, 0.0f ), 255.0f ) + 0.5f );
+            }
+        } );
+    }
+
+    // Convert Depth to BGR
+    void convertDepthToBgr( const uint16_t* depth_data, uint8_t* bgr, const int32_t count, const uint32_t max_distance )
+    {
+        const float scale = -255.0f / max_distance;
+        parallel::forEach( count, BLOCK_SIZE, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t index = begin; index < end; index++ ){
+                const float value = depth_data[index] * scale + 255.0f;
+                const uint8_t gray = static_cast<uint8_t>( std::min( std::max( value, 0.0f ), 255.0f ) + 0.5f );
+                bgr[index * 3 + 0] = gray;
+                bgr[index * 3 + 1] = gray;
+                bgr[index * 3 + 2] = gray;
+            }
+        } );
+    }
+
+    // Overlay User Labels
+    void overlayLabels( const uint16_t* label_data, uint8_t* bgr, const int32_t count, const uint8_t* palette, const int32_t palette_count )
+    {
+        parallel::forEach( count, BLOCK_SIZE, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t index = begin; index < end; index++ ){
+                const uint16_t label = label_data[index];
+                if( label == 0 ){
+                    continue;
+                }
+
+                const uint8_t* color = palette + ( ( label - 1 ) % palette_count ) * 3;
+                bgr[index * 3 + 0] = color[0];
+                bgr[index * 3 + 1] = color[1];
+                bgr[index * 3 + 2] = color[2];
+            }
+        } );
+    }
+}
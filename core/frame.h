@@ -0,0 +1,105 @@
+// This is frame conversion kernels that convert data retrieved from NuiTrack to image buffer.
+// These kernels work on raw buffers, so that same kernels are used by all samples and benchmarks.
+//
+// #include "frame.h"
+//
+// color_mat.create( color_height, color_width, CV_8UC3 );
+// frame::copyColor( reinterpret_cast<const uint8_t*>( color_frame->getData() ), color_mat.data, color_mat.total() );
+//
+// depth_mat.create( depth_height, depth_width, CV_16UC1 );
+// frame::copyDepth( depth_frame->getData(), depth_mat.ptr<uint16_t>(), depth_mat.total() );
+//
+// Each kernel splits buffer into tiles (at least BLOCK_SIZE pixels) and processes tiles in parallel on work-stealing pool (parallel::forEach).
+// The loop in each tile is simple enough to be vectorized by compiler.
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __FRAME__
+#define __FRAME__
+
+#include "parallel.h"
+#include "slots.h"
+
+#include <cstdint>
+
+namespace frame
+{
+    // Minimum Number of Pixels per Task of Parallel Loop
+    static const int32_t BLOCK_SIZE = 16384;
+
+    // Copy Color
+    // tdv::nuitrack::Color3 is BGR order same as CV_8UC3.
+    void copyColor( const uint8_t* color_data, uint8_t* bgr, const int32_t count );
+
+    // Copy Depth
+    void copyDepth( const uint16_t* depth_data, uint16_t* depth, const int32_t count );
+
+    // Convert Depth to Gray
+    // 0-max_distance -> 255(white)-0(black), same as cv::Mat::convertTo( gray, CV_8U, -255.0 / max_distance, 255.0 ).
+    void convertDepthToGray( const uint16_t* depth_data, uint8_t* gray, const int32_t count, const uint32_t max_distance );
+
+    // Convert Depth to BGR
+    // Same as convertDepthToGray(), but each pixel is written to 3 channels.
+    void convertDepthToBgr( const uint16_t* depth_data, uint8_t* bgr, const int32_t count, const uint32_t max_distance );
+
+    // Overlay User Labels
+    // Pixel that has label is painted with palette[label - 1] (BGR). Label larger than palette_count wraps around.
+    void overlayLabels( const uint16_t* label_data, uint8_t* bgr, const int32_t count, const uint8_t* palette, const int32_t palette_count );
+
+    // Overlay User Labels by Slots of User IDs
+    // Pixel that has label is painted with color of slot of label in colors (BGR value of 3 bytes). Label that has no slot is left as is.
+    // Table is only read (IDs of users of frame are acquired before), slot of label is looked up once per run of same label.
+    template<typename T>
+    inline void overlayLabels( const uint16_t* label_data, uint8_t* bgr, const int32_t count, const slots::Table<T>& colors )
+    {
+        static_assert( sizeof( T ) == 3, "color must be BGR of 3 bytes" );
+
+        parallel::forEach( count, BLOCK_SIZE, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            uint16_t last = 0;
+            const uint8_t* color = nullptr;
+            for( int32_t index = begin; index < end; index++ ){
+                const uint16_t label = label_data[index];
+                if( label == 0 ){
+                    continue;
+                }
+
+                if( label != last ){
+                    const uint32_t slot = colors.find( label );
+                    color = ( slot != slots::NONE ) ? reinterpret_cast<const uint8_t*>( &colors.at( slot ) ) : nullptr;
+                    last = label;
+                }
+                if( !color ){
+                    continue;
+                }
+
+                bgr[index * 3 + 0] = color[0];
+                bgr[index * 3 + 1] = color[1];
+                bgr[index * 3 + 2] = color[2];
+            }
+        } );
+    }
+}
+
+#endif // __FRAME__
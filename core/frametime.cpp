@@ -0,0 +1,92 @@
+#include "frametime.h"
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace frametime
+{
+    // Update at End of Loop (Returns true if frame time of new frame was measured)
+    bool Meter::update( const bool processed )
+    {
+        // Frame Time is Accumulated until New Frame is Processed
+        pause();
+        resume();
+
+        if( !processed ){
+            return false;
+        }
+
+        frame_time = busy;
+        busy = 0.0;
+        return true;
+    }
+
+    // Pause Frame Time
+    void Meter::pause()
+    {
+        if( running ){
+            busy += std::chrono::duration<double>( frametime::clock::now() - mark ).count();
+            running = false;
+        }
+    }
+
+    // Resume Frame Time
+    void Meter::resume()
+    {
+        mark = frametime::clock::now();
+        running = true;
+    }
+
+    // Restart Measurement (e.g. after Reconfiguration)
+    void Meter::restart()
+    {
+        busy = 0.0;
+        resume();
+    }
+
+    // Constructor
+    Window::Window( const int32_t size )
+        : size( size )
+    {
+        if( size <= 0 ){
+            throw std::runtime_error( "failed window of frame time is empty" );
+        }
+
+        frame_times.reserve( size );
+        sorted.reserve( size );
+    }
+
+    // Add Frame Time (seconds)
+    void Window::add( const double frame_time )
+    {
+        if( static_cast<int32_t>( frame_times.size() ) < size ){
+            frame_times.push_back( frame_time );
+        }
+        else{
+            frame_times[frames % size] = frame_time;
+        }
+        frames++;
+    }
+
+    // Clear Frame Times (e.g. after Change of Controller)
+    void Window::clear()
+    {
+        frame_times.clear();
+        frames = 0;
+    }
+
+    // Percentile of Frame Times in Window (seconds, 0.0 if empty)
+    double Window::percentile( const double ratio ) const
+    {
+        if( frame_times.empty() ){
+            return 0.0;
+        }
+
+        // Partial Sort on Work Buffer (Frame Times are Kept in Order of Ring)
+        sorted.assign( frame_times.begin(), frame_times.end() );
+        const size_t rank = std::min( static_cast<size_t>( std::ceil( ratio * sorted.size() ) ), sorted.size() ) - 1;
+        std::nth_element( sorted.begin(), sorted.begin() + rank, sorted.end() );
+        return sorted[rank];
+    }
+}
@@ -0,0 +1,147 @@
+// This is frame time measurement shared by controllers that adapt main loop to CPU load (quality::Controller, shedding::Controller).
+// Meter accumulates busy time of main loop excluding idle time (waiting for sensor or pacing) until new frame is processed,
+// and Window keeps frame times of last frames as ring buffer to evaluate percentiles.
+// One meter is measured per main loop, and its frame time is passed to each controller.
+//
+// #include "frametime.h"
+//
+// frametime::Meter meter;
+// frametime::Window window( 30 );
+//
+// while( true ){
+//     update(); /* wrap waiting with const frametime::Idle idle( meter ); */
+//     if( meter.update( updated ) ){
+//         window.add( meter.get() );
+//         const double p90 = window.percentile( 0.9 );
+//     }
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __FRAMETIME__
+#define __FRAMETIME__
+
+#include <chrono>
+#include <vector>
+#include <cstdint>
+
+namespace frametime
+{
+    typedef std::chrono::steady_clock clock;
+
+    // Meter of Frame Time (Busy Time of Main Loop until New Frame is Processed)
+    class Meter
+    {
+    private:
+        clock::time_point mark;
+        double busy = 0.0; // seconds since previous frame (excluding idle)
+        double frame_time = 0.0; // seconds of last frame
+        bool running = false;
+
+    public:
+        // Update at End of Loop (Returns true if frame time of new frame was measured)
+        // processed is true if new frame was processed in this loop, busy time of loops without new frame is counted to next frame.
+        bool update( const bool processed );
+
+        // Pause and Resume Frame Time (Idle Time is not Counted)
+        void pause();
+        void resume();
+
+        // Restart Measurement (e.g. after Reconfiguration)
+        void restart();
+
+        // Frame Time of Last Frame (seconds)
+        double get() const
+        {
+            return frame_time;
+        }
+    };
+
+    // Window of Frame Times (Ring Buffer of Last Frames)
+    class Window
+    {
+    private:
+        std::vector<double> frame_times;
+        mutable std::vector<double> sorted; // work buffer of percentile
+        int32_t size;
+        int32_t frames = 0; // frames since clear
+
+    public:
+        // Constructor
+        Window( const int32_t size );
+
+        // Add Frame Time (seconds)
+        void add( const double frame_time );
+
+        // Clear Frame Times (e.g. after Change of Controller)
+        void clear();
+
+        // Percentile of Frame Times in Window (seconds, 0.0 if empty)
+        double percentile( const double ratio ) const;
+
+        // Window is Filled with Frames since Previous Evaluation (Every size Frames)
+        bool completed() const
+        {
+            return frames > 0 && frames % size == 0;
+        }
+
+        // Number of Frames since Clear
+        int32_t getFrames() const
+        {
+            return frames;
+        }
+
+        // Number of Frame Times in Window
+        int32_t getCount() const
+        {
+            return static_cast<int32_t>( frame_times.size() );
+        }
+    };
+
+    // Idle Time (Scope is not Counted as Frame Time)
+    class Idle
+    {
+    private:
+        frametime::Meter& meter;
+
+    public:
+        Idle( frametime::Meter& meter )
+            : meter( meter )
+        {
+            meter.pause();
+        }
+
+        ~Idle()
+        {
+            meter.resume();
+        }
+
+        Idle( const Idle& ) = delete;
+        Idle& operator=( const Idle& ) = delete;
+    };
+}
+
+#endif // __FRAMETIME__
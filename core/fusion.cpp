@@ -0,0 +1,263 @@
+#include "fusion.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace fusion
+{
+    // Cost of Pair that can't be Associated
+    static const float IMPOSSIBLE = 1e9f;
+
+    // Solve Assignment of Row-Major Cost Matrix
+    const std::vector<int32_t>& Assignment::solve( const float* cost, const int32_t rows, const int32_t cols )
+    {
+        assignment.assign( std::max( rows, 0 ), -1 );
+        if( rows <= 0 || cols <= 0 ){
+            return assignment;
+        }
+
+        // Algorithm requires Rows <= Columns (Transpose Otherwise)
+        const bool transposed = rows > cols;
+        const int32_t n = transposed ? cols : rows;
+        const int32_t m = transposed ? rows : cols;
+        const auto at = [&]( const int32_t i, const int32_t j ){
+            return static_cast<double>( transposed ? cost[j * cols + i] : cost[i * cols + j] );
+        };
+
+        // Potentials and Augmenting Paths (1-Based, Column 0 is Virtual)
+        const double infinity = std::numeric_limits<double>::infinity();
+        u.assign( n + 1, 0.0 );
+        v.assign( m + 1, 0.0 );
+        p.assign( m + 1, 0 );
+        way.assign( m + 1, 0 );
+        for( int32_t i = 1; i <= n; i++ ){
+            p[0] = i;
+            int32_t j0 = 0;
+            minv.assign( m + 1, infinity );
+            used.assign( m + 1, 0 );
+            do{
+                used[j0] = 1;
+                const int32_t i0 = p[j0];
+                double delta = infinity;
+                int32_t j1 = 0;
+                for( int32_t j = 1; j <= m; j++ ){
+                    if( used[j] ){
+                        continue;
+                    }
+
+                    const double current = at( i0 - 1, j - 1 ) - u[i0] - v[j];
+                    if( current < minv[j] ){
+                        minv[j] = current;
+                        way[j] = j0;
+                    }
+                    if( minv[j] < delta ){
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+
+                for( int32_t j = 0; j <= m; j++ ){
+                    if( used[j] ){
+                        u[p[j]] += delta;
+                        v[j] -= delta;
+                    }
+                    else{
+                        minv[j] -= delta;
+                    }
+                }
+                j0 = j1;
+            } while( p[j0] != 0 );
+
+            do{
+                const int32_t j1 = way[j0];
+                p[j0] = p[j1];
+                j0 = j1;
+            } while( j0 != 0 );
+        }
+
+        // Column of Each Row
+        for( int32_t j = 1; j <= m; j++ ){
+            if( p[j] == 0 ){
+                continue;
+            }
+
+            if( transposed ){
+                assignment[j - 1] = p[j] - 1;
+            }
+            else{
+                assignment[p[j] - 1] = j - 1;
+            }
+        }
+
+        return assignment;
+    }
+
+    // Constructor
+    Fuser::Fuser( const uint32_t sources )
+        : extrinsics( sources )
+    {
+    }
+
+    // Set Extrinsics of Source (Camera to World)
+    void Fuser::setExtrinsics( const uint32_t source, const camera::Extrinsics& extrinsics )
+    {
+        if( source >= this->extrinsics.size() ){
+            this->extrinsics.resize( source + 1 );
+        }
+        this->extrinsics[source] = extrinsics;
+    }
+
+    // Weighted Mean Distance of Joints
+    float Fuser::distance( const std::array<fusion::Joint, JOINTS>& a, const std::array<fusion::Joint, JOINTS>& b )
+    {
+        float sum = 0.0f;
+        float weights = 0.0f;
+        for( int32_t joint = 1; joint < JOINTS; joint++ ){
+            const float weight = std::min( a[joint].confidence, b[joint].confidence );
+            if( weight <= 0.0f ){
+                continue;
+            }
+
+            const float dx = a[joint].x - b[joint].x;
+            const float dy = a[joint].y - b[joint].y;
+            const float dz = a[joint].z - b[joint].z;
+            sum += weight * std::sqrt( dx * dx + dy * dy + dz * dz );
+            weights += weight;
+        }
+
+        return weights > 0.0f ? sum / weights : -1.0f;
+    }
+
+    // Add Skeleton to Cluster
+    void Fuser::add( Cluster& cluster, const fusion::Skeleton& skeleton, const uint32_t source )
+    {
+        for( int32_t joint = 0; joint < JOINTS; joint++ ){
+            const fusion::Joint& input = skeleton.joints[joint];
+            std::array<float, 4>& sum = cluster.sums[joint];
+            fusion::Joint& output = cluster.joints[joint];
+            if( input.confidence <= 0.0f ){
+                continue;
+            }
+
+            // Weighted Mean by Confidence, Confidence of Fused Joint is Highest Confidence
+            sum[0] += input.confidence * input.x;
+            sum[1] += input.confidence * input.y;
+            sum[2] += input.confidence * input.z;
+            sum[3] += input.confidence;
+            output.x = sum[0] / sum[3];
+            output.y = sum[1] / sum[3];
+            output.z = sum[2] / sum[3];
+            output.confidence = std::max( output.confidence, input.confidence );
+        }
+
+        cluster.members.push_back( { source, skeleton.id } );
+    }
+
+    // Fuse Skeletons of Sources
+    const std::vector<fusion::Fused>& Fuser::fuse( const std::vector<std::vector<fusion::Skeleton>>& skeletons )
+    {
+        count = 0;
+
+        for( uint32_t source = 0; source < skeletons.size(); source++ ){
+            // Transform Skeletons to World Coordinates
+            const camera::Extrinsics& transform = source < extrinsics.size() ? extrinsics[source] : camera::Extrinsics();
+            const float* r = transform.rotation;
+            const float* t = transform.translation;
+            world.resize( skeletons[source].size() );
+            for( size_t index = 0; index < skeletons[source].size(); index++ ){
+                const fusion::Skeleton& input = skeletons[source][index];
+                fusion::Skeleton& output = world[index];
+                output.id = input.id;
+                for( int32_t joint = 0; joint < JOINTS; joint++ ){
+                    const fusion::Joint& a = input.joints[joint];
+                    fusion::Joint& b = output.joints[joint];
+                    b.x = r[0] * a.x + r[1] * a.y + r[2] * a.z + t[0];
+                    b.y = r[3] * a.x + r[4] * a.y + r[5] * a.z + t[1];
+                    b.z = r[6] * a.x + r[7] * a.y + r[8] * a.z + t[2];
+                    b.confidence = a.confidence;
+                }
+            }
+
+            // Cost of Clusters and Skeletons of Source (Pairs beyond Threshold can't be Associated)
+            const int32_t rows = static_cast<int32_t>( count );
+            const int32_t cols = static_cast<int32_t>( world.size() );
+            cost.resize( static_cast<size_t>( rows ) * cols );
+            for( int32_t row = 0; row < rows; row++ ){
+                for( int32_t col = 0; col < cols; col++ ){
+                    const float d = distance( clusters[row].joints, world[col].joints );
+                    cost[row * cols + col] = ( d < 0.0f || d > threshold ) ? IMPOSSIBLE : d;
+                }
+            }
+
+            // Associate Skeletons to Clusters (At Most One Skeleton of Each Source per Cluster)
+            const std::vector<int32_t>& columns = assignment.solve( cost.data(), rows, cols );
+            associated.assign( cols, 0 );
+            for( int32_t row = 0; row < rows; row++ ){
+                const int32_t col = columns[row];
+                if( col >= 0 && cost[row * cols + col] < IMPOSSIBLE ){
+                    add( clusters[row], world[col], source );
+                    associated[col] = 1;
+                }
+            }
+
+            // Skeletons that were Not Associated Start New Clusters
+            for( int32_t col = 0; col < cols; col++ ){
+                if( associated[col] ){
+                    continue;
+                }
+
+                if( count == clusters.size() ){
+                    clusters.emplace_back();
+                }
+
+                Cluster& cluster = clusters[count++];
+                for( int32_t joint = 0; joint < JOINTS; joint++ ){
+                    cluster.sums[joint] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                    cluster.joints[joint] = fusion::Joint();
+                }
+                cluster.members.clear();
+                add( cluster, world[col], source );
+            }
+        }
+
+        // Fused Skeletons of Current Frame
+        std::swap( fused, previous );
+        fused.resize( count );
+        for( size_t index = 0; index < count; index++ ){
+            fused[index].id = 0;
+            fused[index].joints = clusters[index].joints;
+            fused[index].members = clusters[index].members;
+        }
+
+        // Keep IDs over Frames
+        track();
+
+        return fused;
+    }
+
+    // Assign IDs of Previous Frame to Fused Skeletons
+    void Fuser::track()
+    {
+        const int32_t rows = static_cast<int32_t>( fused.size() );
+        const int32_t cols = static_cast<int32_t>( previous.size() );
+        cost.resize( static_cast<size_t>( rows ) * cols );
+        for( int32_t row = 0; row < rows; row++ ){
+            for( int32_t col = 0; col < cols; col++ ){
+                const float d = distance( fused[row].joints, previous[col].joints );
+                cost[row * cols + col] = ( d < 0.0f || d > threshold ) ? IMPOSSIBLE : d;
+            }
+        }
+
+        const std::vector<int32_t>& columns = assignment.solve( cost.data(), rows, cols );
+        for( int32_t row = 0; row < rows; row++ ){
+            const int32_t col = columns[row];
+            if( col >= 0 && cost[row * cols + col] < IMPOSSIBLE ){
+                fused[row].id = previous[col].id;
+            }
+            else{
+                fused[row].id = next_id++;
+            }
+        }
+    }
+}
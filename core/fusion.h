@@ -0,0 +1,159 @@
+// This is fusion of skeletons from several calibrated cameras into one world coordinate system.
+// Skeletons of each camera are transformed by extrinsics (camera to world), and associated with skeletons of other cameras
+// by minimum cost assignment (Hungarian algorithm) on confidence weighted mean distance of joints.
+// Associated joints are merged by weighted mean with confidence, and fused skeletons keep their ID over frames.
+//
+// #include "fusion.h"
+//
+// fusion::Fuser fuser( devices );
+// fuser.setExtrinsics( device, extrinsics ); // camera to world
+//
+// std::vector<std::vector<fusion::Skeleton>> skeletons( devices ); // camera coordinates (millimeter) of each device
+// const std::vector<fusion::Fused>& fused = fuser.fuse( skeletons );
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __FUSION__
+#define __FUSION__
+
+#include "camera.h"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace fusion
+{
+    // Number of Joints (Same as tdv::nuitrack::JointType)
+    static const int32_t JOINTS = 25;
+
+    // Joint (Millimeter)
+    struct Joint
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float confidence = 0.0f; // 0.0 is not tracked
+    };
+
+    // Skeleton of Camera
+    struct Skeleton
+    {
+        int32_t id = 0;
+        std::array<fusion::Joint, JOINTS> joints;
+    };
+
+    // Skeleton of Camera that is Part of Fused Skeleton
+    struct Member
+    {
+        uint32_t source;
+        int32_t id;
+    };
+
+    // Fused Skeleton (World Coordinates)
+    struct Fused
+    {
+        int32_t id = 0;
+        std::array<fusion::Joint, JOINTS> joints;
+        std::vector<fusion::Member> members;
+    };
+
+    // Minimum Cost Assignment of Rows to Columns (Hungarian Algorithm, Rectangular Cost Matrix)
+    class Assignment
+    {
+    private:
+        std::vector<double> u, v, minv;
+        std::vector<int32_t> p, way;
+        std::vector<char> used;
+        std::vector<int32_t> assignment;
+
+    public:
+        // Solve Assignment of Row-Major Cost Matrix (Returns Column of Each Row, -1 is Not Assigned)
+        const std::vector<int32_t>& solve( const float* cost, const int32_t rows, const int32_t cols );
+    };
+
+    // Fuser of Skeletons
+    class Fuser
+    {
+    private:
+        std::vector<camera::Extrinsics> extrinsics;
+        float threshold = 300.0f; // millimeter
+
+        // Clusters of Current Frame (Weighted Sum of Joints)
+        struct Cluster
+        {
+            std::array<std::array<float, 4>, JOINTS> sums; // weighted x, y, z and sum of weights
+            std::array<fusion::Joint, JOINTS> joints; // weighted mean
+            std::vector<fusion::Member> members;
+        };
+        std::vector<Cluster> clusters;
+        size_t count = 0;
+
+        std::vector<fusion::Skeleton> world; // skeletons of source in world coordinates
+        std::vector<float> cost;
+        std::vector<char> associated;
+        fusion::Assignment assignment;
+
+        // Fused Skeletons of Current and Previous Frame
+        std::vector<fusion::Fused> fused;
+        std::vector<fusion::Fused> previous;
+        int32_t next_id = 1;
+
+    public:
+        // Constructor
+        Fuser( const uint32_t sources );
+
+        // Set Extrinsics of Source (Camera to World)
+        void setExtrinsics( const uint32_t source, const camera::Extrinsics& extrinsics );
+
+        // Set Threshold of Association (Maximum Weighted Mean Distance of Joints, Millimeter)
+        void setThreshold( const float threshold )
+        {
+            this->threshold = threshold;
+        }
+
+        // Fuse Skeletons of Sources (Camera Coordinates, Index is Source)
+        const std::vector<fusion::Fused>& fuse( const std::vector<std::vector<fusion::Skeleton>>& skeletons );
+
+        // Fused Skeletons of Last Frame
+        const std::vector<fusion::Fused>& getFused() const
+        {
+            return fused;
+        }
+
+        // Weighted Mean Distance of Joints (Weight is Lower Confidence of Two Joints, Negative if No Common Joint)
+        static float distance( const std::array<fusion::Joint, JOINTS>& a, const std::array<fusion::Joint, JOINTS>& b );
+
+    private:
+        // Add Skeleton to Cluster
+        void add( Cluster& cluster, const fusion::Skeleton& skeleton, const uint32_t source );
+
+        // Assign IDs of Previous Frame to Fused Skeletons
+        void track();
+    };
+}
+
+#endif // __FUSION__
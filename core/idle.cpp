@@ -0,0 +1,111 @@
+#include "idle.h"
+
+#include <iomanip>
+
+namespace idle
+{
+    // Seconds of Duration
+    static inline double seconds( const clock::duration& duration )
+    {
+        return std::chrono::duration<double>( duration ).count();
+    }
+
+    // Constructor
+    Monitor::Monitor( const idle::Parameters& parameters )
+        : parameters( parameters )
+    {
+    }
+
+    // Accumulate Time of Current Mode
+    void Monitor::accumulate( const clock::time_point& now )
+    {
+        ( idle ? usage.idle : usage.active ) += seconds( now - mark );
+        mark = now;
+    }
+
+    // Update Presence at New Tracker Frame (Returns true if mode was changed)
+    bool Monitor::update( const bool present )
+    {
+        const clock::time_point now = clock::now();
+        if( present ){
+            seen = now;
+        }
+
+        // Active at First Frame with Users, Idle after Timeout without Users
+        const bool next = !present && seconds( now - seen ) >= parameters.timeout;
+        if( next == idle ){
+            return false;
+        }
+
+        accumulate( now );
+        if( log ){
+            const std::ios::fmtflags flags = log->flags();
+            const std::streamsize precision = log->precision();
+            *log << std::fixed << std::setprecision( 1 );
+            if( next ){
+                *log << "idle enter (no users for " << seconds( now - seen ) << " s, active for " << seconds( now - changed ) << " s)" << std::endl;
+            }
+            else{
+                *log << "idle exit (users appeared, idle for " << seconds( now - changed ) << " s)" << std::endl;
+            }
+            log->flags( flags );
+            log->precision( precision );
+        }
+
+        idle = next;
+        changed = now;
+        processed = clock::time_point();
+        usage.transitions++;
+        return true;
+    }
+
+    // Processing is Due (Every Call in Active Mode, at Idle Rate in Idle Mode)
+    bool Monitor::due()
+    {
+        if( !idle ){
+            return true;
+        }
+
+        const clock::time_point now = clock::now();
+        if( parameters.rate > 0.0 && seconds( now - processed ) >= 1.0 / parameters.rate ){
+            processed = now;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Summarize Time Spent in Each Mode since previous summary
+    idle::Usage Monitor::summarize()
+    {
+        const clock::time_point now = clock::now();
+        accumulate( now );
+        previous = now;
+
+        const idle::Usage summary = usage;
+        usage = idle::Usage();
+        return summary;
+    }
+
+    // Write Time Spent in Each Mode if interval (seconds) has elapsed since previous summary
+    bool Monitor::report( std::ostream& os, const double interval )
+    {
+        const double elapsed = seconds( clock::now() - previous );
+        if( elapsed < interval ){
+            return false;
+        }
+
+        const idle::Usage summary = summarize();
+        const double total = summary.active + summary.idle;
+
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << std::fixed << std::setprecision( 1 )
+           << "idle (" << elapsed << " s, " << ( idle ? "idle" : "active" ) << "): active " << summary.active << " s (" << ( total > 0.0 ? summary.active * 100.0 / total : 0.0 ) << "%), idle "
+           << summary.idle << " s (" << ( total > 0.0 ? summary.idle * 100.0 / total : 0.0 ) << "%), " << summary.transitions << " transitions" << std::endl;
+        os.flags( flags );
+        os.precision( precision );
+
+        return true;
+    }
+}
@@ -0,0 +1,125 @@
+// This is idle mode that throttles processing while no users are present (e.g. installation that sits empty most of the day).
+// Presence is updated at each new tracker frame, and mode becomes idle when no users have been present for timeout.
+// In idle mode, conversion, overlay and display run at low rate, and full rate comes back at first frame that has users.
+// Time spent in each mode and transitions are reported.
+//
+// #include "idle.h"
+//
+// idle::Monitor monitor;
+// monitor.setLog( &std::cout );
+//
+// while( true ){
+//     update();
+//     if( user_updated ){
+//         monitor.update( !user_frame->getUsers().empty() );
+//     }
+//     if( updated && monitor.due() ){
+//         draw(); /* conversion and overlay */
+//         show();
+//     }
+//     monitor.report( std::cout, 5.0 ); /* print time in each mode every 5 seconds */
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __IDLE__
+#define __IDLE__
+
+#include <chrono>
+#include <ostream>
+#include <cstdint>
+
+namespace idle
+{
+    typedef std::chrono::steady_clock clock;
+
+    // Parameters of Monitor
+    struct Parameters
+    {
+        double timeout = 5.0; // seconds without users until idle
+        double rate = 2.0; // Hz of processing in idle mode
+    };
+
+    // Time Spent in Each Mode
+    struct Usage
+    {
+        double active = 0.0; // seconds
+        double idle = 0.0; // seconds
+        uint64_t transitions = 0; // number of mode changes
+    };
+
+    // Monitor of Presence
+    class Monitor
+    {
+    private:
+        idle::Parameters parameters;
+        std::ostream* log = nullptr;
+        bool idle = false;
+
+        clock::time_point start = clock::now();
+        clock::time_point seen = start; // last time users were present (or start)
+        clock::time_point changed = start; // time of last mode change
+        clock::time_point processed; // last processing in idle mode
+        clock::time_point mark = start; // beginning of current accumulation
+        clock::time_point previous = start; // time of previous report
+
+        idle::Usage usage; // since previous report
+
+    public:
+        // Constructor
+        Monitor( const idle::Parameters& parameters = idle::Parameters() );
+
+        // Set Log Stream of Mode Changes (nullptr disables)
+        void setLog( std::ostream* log )
+        {
+            this->log = log;
+        }
+
+        // Update Presence at New Tracker Frame (Returns true if mode was changed)
+        bool update( const bool present );
+
+        // Processing is Due (Every Call in Active Mode, at Idle Rate in Idle Mode)
+        bool due();
+
+        // Mode is Idle
+        bool isIdle() const
+        {
+            return idle;
+        }
+
+        // Summarize Time Spent in Each Mode since previous summary
+        idle::Usage summarize();
+
+        // Write Time Spent in Each Mode if interval (seconds) has elapsed since previous summary
+        bool report( std::ostream& os, const double interval );
+
+    private:
+        // Accumulate Time of Current Mode
+        void accumulate( const clock::time_point& now );
+    };
+}
+
+#endif // __IDLE__
@@ -0,0 +1,297 @@
+// This is join buffer that combines results of several modalities (e.g. skeleton, hand, user, gesture) by timestamp.
+// Results arrive through different calls (waitUpdate() of trackers, callback of gestures) and possibly different threads, each with its own timestamp.
+// Each modality has lock-free ring of recent results (single producer, any number of readers), and query returns bundle of result of each modality
+// that is closest in time to timestamp (e.g. latest skeleton), so that downstream logic sees one consistent snapshot.
+// Producer never waits for readers (cell that is being read is skipped), and reader retries if cell is overwritten while it is found.
+//
+// #include "join.h"
+//
+// join::Joiner<tdv::nuitrack::SkeletonData::Ptr, tdv::nuitrack::GestureData::Ptr> joiner;
+// joiner.setTolerance( 1, 0.5 ); /* gesture within 0.5 seconds of skeleton */
+//
+// /* Main Thread */
+// joiner.ring<0>().push( skeleton_data->getTimestamp(), skeleton_data );
+//
+// /* Callback of Gestures */
+// joiner.ring<1>().push( gesture_data->getTimestamp(), gesture_data );
+//
+// /* Consumer */
+// join::Joiner<tdv::nuitrack::SkeletonData::Ptr, tdv::nuitrack::GestureData::Ptr>::Bundle bundle;
+// if( joiner.latest<0>( bundle ) ){ /* anchored at latest skeleton */
+//     const join::Item<tdv::nuitrack::GestureData::Ptr>& gesture = std::get<1>( bundle.items );
+//     if( gesture.valid ){ /* gesture.value is closest to skeleton */ }
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __JOIN__
+#define __JOIN__
+
+#include <array>
+#include <tuple>
+#include <atomic>
+#include <memory>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+namespace join
+{
+    // Default Number of Results Kept per Modality
+    static const size_t CAPACITY = 16;
+
+    // Result of Modality in Bundle
+    template<typename T>
+    struct Item
+    {
+        bool valid = false; // modality has result within tolerance
+        uint64_t timestamp = 0; // microseconds
+        T value;
+    };
+
+    // Lock-Free Ring of Recent Results of Modality (Single Producer, Any Number of Readers)
+    template<typename T>
+    class Ring
+    {
+    private:
+        // Cell of Ring
+        struct Cell
+        {
+            std::atomic<uint32_t> state; // bit 0 is set while producer writes, other bits count readers (2 per reader)
+            std::atomic<uint64_t> generation; // generation of push (0 is empty)
+            std::atomic<uint64_t> timestamp;
+            T value;
+
+            Cell()
+                : state( 0 ), generation( 0 ), timestamp( 0 )
+            {
+            }
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        size_t capacity;
+        size_t next = 0; // producer only
+        uint64_t generation = 0; // producer only
+        std::atomic<uint64_t> pushed;
+        std::atomic<uint64_t> dropped; // every cell was being read
+
+    public:
+        // Constructor
+        explicit Ring( const size_t capacity = join::CAPACITY )
+            : cells( new Cell[capacity > 0 ? capacity : 1] ), capacity( capacity > 0 ? capacity : 1 ), pushed( 0 ), dropped( 0 )
+        {
+        }
+
+        // Push Result (Producer Thread, Timestamp is Microseconds, Returns false if every cell was being read)
+        bool push( const uint64_t timestamp, T value )
+        {
+            for( size_t attempt = 0; attempt < capacity; attempt++ ){
+                Cell& cell = cells[next];
+                next = ( next + 1 ) % capacity;
+
+                // Cell that is being Read is Skipped (Producer never Waits)
+                uint32_t expected = 0;
+                if( !cell.state.compare_exchange_strong( expected, 1, std::memory_order_acquire, std::memory_order_relaxed ) ){
+                    continue;
+                }
+
+                cell.value = std::move( value );
+                cell.timestamp.store( timestamp, std::memory_order_relaxed );
+                cell.generation.store( ++generation, std::memory_order_release );
+                cell.state.store( 0, std::memory_order_release );
+                pushed.fetch_add( 1, std::memory_order_relaxed );
+                return true;
+            }
+
+            dropped.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+
+        // Find Result Closest to Timestamp within Tolerance (Microseconds, Any Thread)
+        bool nearest( const uint64_t timestamp, const uint64_t tolerance, join::Item<T>& item ) const
+        {
+            while( true ){
+                size_t best = capacity;
+                uint64_t best_generation = 0;
+                uint64_t best_distance = std::numeric_limits<uint64_t>::max();
+                for( size_t index = 0; index < capacity; index++ ){
+                    const uint64_t generation = cells[index].generation.load( std::memory_order_acquire );
+                    if( generation == 0 ){
+                        continue;
+                    }
+
+                    // Later Result wins Tie
+                    const uint64_t time = cells[index].timestamp.load( std::memory_order_relaxed );
+                    const uint64_t distance = ( time > timestamp ) ? time - timestamp : timestamp - time;
+                    if( distance < best_distance || ( distance == best_distance && generation > best_generation ) ){
+                        best = index;
+                        best_generation = generation;
+                        best_distance = distance;
+                    }
+                }
+
+                if( best == capacity || best_distance > tolerance ){
+                    item = join::Item<T>();
+                    return false;
+                }
+
+                // Cell was Overwritten after it was Found, Find Again
+                if( read( best, best_generation, item ) ){
+                    return true;
+                }
+            }
+        }
+
+        // Timestamp of Latest Result (Any Thread, Returns false if ring is empty)
+        bool latest( uint64_t& timestamp ) const
+        {
+            uint64_t best_generation = 0;
+            for( size_t index = 0; index < capacity; index++ ){
+                const uint64_t generation = cells[index].generation.load( std::memory_order_acquire );
+                if( generation > best_generation ){
+                    best_generation = generation;
+                    timestamp = cells[index].timestamp.load( std::memory_order_relaxed );
+                }
+            }
+            return best_generation != 0;
+        }
+
+        // Number of Pushed Results
+        uint64_t getPushed() const
+        {
+            return pushed.load( std::memory_order_relaxed );
+        }
+
+        // Number of Results that were Dropped because Every Cell was being Read
+        uint64_t getDropped() const
+        {
+            return dropped.load( std::memory_order_relaxed );
+        }
+
+    private:
+        // Read Cell if it still has Generation (Pinned while Value is Copied, so that Producer Skips it)
+        bool read( const size_t index, const uint64_t generation, join::Item<T>& item ) const
+        {
+            Cell& cell = cells[index];
+            uint32_t state = cell.state.load( std::memory_order_relaxed );
+            do{
+                if( state & 1 ){
+                    return false;
+                }
+            } while( !cell.state.compare_exchange_weak( state, state + 2, std::memory_order_acquire, std::memory_order_relaxed ) );
+
+            const bool valid = ( cell.generation.load( std::memory_order_relaxed ) == generation );
+            if( valid ){
+                item.valid = true;
+                item.timestamp = cell.timestamp.load( std::memory_order_relaxed );
+                item.value = cell.value;
+            }
+
+            cell.state.fetch_sub( 2, std::memory_order_release );
+            return valid;
+        }
+    };
+
+    // Join Buffer of Modalities
+    template<typename... T>
+    class Joiner
+    {
+    public:
+        // Bundle of Results Closest to Timestamp
+        struct Bundle
+        {
+            uint64_t timestamp = 0; // microseconds
+            std::tuple<join::Item<T>...> items; // result of each modality (invalid if none within tolerance)
+        };
+
+    private:
+        std::tuple<join::Ring<T>...> rings;
+        std::array<uint64_t, sizeof...( T )> tolerances; // microseconds
+
+    public:
+        // Constructor
+        // tolerance is maximum difference of timestamps of result from timestamp of bundle (seconds).
+        explicit Joiner( const double tolerance = 0.05 )
+        {
+            tolerances.fill( static_cast<uint64_t>( tolerance * 1000000.0 ) );
+        }
+
+        // Ring of Modality
+        template<size_t I>
+        join::Ring<typename std::tuple_element<I, std::tuple<T...>>::type>& ring()
+        {
+            return std::get<I>( rings );
+        }
+
+        // Tolerance of Modality (Seconds, e.g. Longer for Sparse Events)
+        void setTolerance( const size_t modality, const double tolerance )
+        {
+            tolerances[modality] = static_cast<uint64_t>( tolerance * 1000000.0 );
+        }
+
+        // Query Bundle Closest to Timestamp (Microseconds, Returns Number of Valid Results)
+        size_t query( const uint64_t timestamp, Bundle& bundle ) const
+        {
+            bundle.timestamp = timestamp;
+            return Query<sizeof...( T )>::run( *this, timestamp, bundle );
+        }
+
+        // Query Bundle Anchored at Latest Result of Modality (Returns false if modality has no result)
+        template<size_t I>
+        bool latest( Bundle& bundle ) const
+        {
+            uint64_t timestamp = 0;
+            if( !std::get<I>( rings ).latest( timestamp ) ){
+                return false;
+            }
+            query( timestamp, bundle );
+            return std::get<I>( bundle.items ).valid;
+        }
+
+    private:
+        // Query of Each Modality (Modalities before N)
+        template<size_t N, typename Dummy = void>
+        struct Query
+        {
+            static size_t run( const Joiner& joiner, const uint64_t timestamp, Bundle& bundle )
+            {
+                const bool valid = std::get<N - 1>( joiner.rings ).nearest( timestamp, joiner.tolerances[N - 1], std::get<N - 1>( bundle.items ) );
+                return Query<N - 1>::run( joiner, timestamp, bundle ) + ( valid ? 1 : 0 );
+            }
+        };
+
+        template<typename Dummy>
+        struct Query<0, Dummy>
+        {
+            static size_t run( const Joiner&, const uint64_t, Bundle& )
+            {
+                return 0;
+            }
+        };
+    };
+}
+
+#endif // __JOIN__
@@ -0,0 +1,185 @@
+#include "loop.h"
+#include "profile.h"
+#include "trace.h"
+#include "affinity.h"
+
+#include <string>
+#include <algorithm>
+
+namespace loop
+{
+    // Set Quality Controller (Processing Resolution is Reconfigured by ProcessWidth and ProcessHeight of each Prefix)
+    void Runner::setQuality( quality::Controller* quality, const std::vector<std::string>& prefixes )
+    {
+        this->quality = quality;
+        this->prefixes = prefixes;
+    }
+
+    // Set Shedding Controller (Display is Shown Every n-th Frame while Display Stage is Shed)
+    void Runner::setShedding( shedding::Controller* shedding, const uint32_t display_stage, const uint32_t display_divisor )
+    {
+        this->shedding = shedding;
+        this->display_shedding = true;
+        this->display_stage = display_stage;
+        this->display_divisor = std::max( display_divisor, 1u );
+    }
+
+    // Set Reconfigurator (Changed Config is Applied at Frame Boundary by Hooks of Sample)
+    void Runner::setReconfigurator( reconfig::Reconfigurator* reconfigurator, const reconfig::Hooks& hooks, const bool hot )
+    {
+        this->reconfigurator = reconfigurator;
+        this->hooks = hooks;
+        this->hot = hot;
+    }
+
+    // Set Log Stream of Reports (nullptr disables) and Interval of Periodic Reports (seconds)
+    void Runner::setLog( std::ostream* log, const double interval )
+    {
+        this->log = log;
+        this->interval = interval;
+    }
+
+    // Begin Loop after Update
+    void Runner::begin( const bool processed, const uint64_t timestamp )
+    {
+        // Update Pacer with Timestamp of New Frame
+        if( pacer && processed ){
+            pacer->update( timestamp );
+        }
+
+        // Measure Gap of Reconfiguration
+        if( reconfigurator ){
+            reconfigurator->update( processed, pacer ? pacer->getInterval() : 0.0 );
+        }
+    }
+
+    // Draw and Show are Due (Any Stream has New Frame, Idle Rate in Idle Mode, Every n-th Frame while Display Rate is Shed)
+    bool Runner::due( const bool updated )
+    {
+        if( !updated ){
+            return false;
+        }
+
+        // Idle Rate while No Users are Present
+        if( monitor && !monitor->due() ){
+            return false;
+        }
+
+        // Every n-th Frame while Display Rate is Shed
+        if( shedding && display_shedding && shedding->isShed( display_stage ) ){
+            return display_count++ % display_divisor == 0;
+        }
+
+        return true;
+    }
+
+    // Report Startup at First Frame, Profile, Consumers, Idle Mode and Threads, and Flush Trace
+    void Runner::report( const bool updated )
+    {
+        if( log ){
+            // Report Startup Timing at First Frame
+            if( timeline && updated && timeline->markFirstFrame() ){
+                timeline->report( *log );
+            }
+
+            // Report Profile
+            PROFILE_REPORT( *log, interval );
+
+            // Report Achieved Rates of Consumers
+            if( scheduler ){
+                scheduler->report( *log, interval );
+            }
+
+            // Report Time Spent in Each Mode
+            if( monitor ){
+                monitor->report( *log, interval );
+            }
+
+            // Report CPU Time and Context Switches of Threads
+            affinity::report( *log, interval );
+        }
+        else if( timeline && updated ){
+            timeline->markFirstFrame();
+        }
+
+        // Flush Trace
+        TRACE_FLUSH();
+    }
+
+    // End Loop (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+    void Runner::end( const bool processed, const uint64_t dropped )
+    {
+        // Measure Frame Time (Excluding Waiting, Accumulated until New Frame is Processed)
+        meter.update( processed );
+        const double budget = pacer ? pacer->getInterval() : 0.0;
+
+        // Adapt Processing Resolution to Frame Time (Budget is Frame Interval)
+        if( quality ){
+            quality->setBudget( budget );
+            if( quality->update( processed, meter.get(), dropped ) ){
+                applyQuality();
+            }
+        }
+
+        // Shed Optional Work under Overload (Budget is Frame Interval)
+        if( shedding ){
+            shedding->setBudget( budget );
+            shedding->update( processed, meter.get() );
+        }
+
+        // Apply Changed Config at Frame Boundary
+        if( reconfigurator && reconfigurator->pending() ){
+            applyConfig( dropped );
+        }
+
+        // Wait for Next Frame (Sleep until Predicted Arrival of Next Frame or Display Deadline)
+        if( pacer ){
+            PROFILE_SCOPE( "pacing::Pacer::wait" );
+            const frametime::Idle idle( meter ); // waiting is not counted as frame time
+            pacer->wait();
+        }
+    }
+
+    // Apply Quality (Reconfigure Processing Resolution of Quality Controller)
+    void Runner::applyQuality()
+    {
+        PROFILE_SCOPE( "loop::Runner::applyQuality" );
+
+        if( !reconfigurator ){
+            return;
+        }
+
+        // Reconfigure Processing Resolution (Applied at Frame Boundary)
+        const quality::Resolution& resolution = quality->getResolution();
+        for( const std::string& prefix : prefixes ){
+            reconfigurator->set( prefix + "ProcessWidth", std::to_string( resolution.width ) );
+            reconfigurator->set( prefix + "ProcessHeight", std::to_string( resolution.height ) );
+        }
+    }
+
+    // Apply Config (Recreate Only Modules Affected by Changed Config)
+    void Runner::applyConfig( const uint64_t dropped )
+    {
+        PROFILE_SCOPE( "loop::Runner::applyConfig" );
+
+        // Apply Changed Config with Hooks of Sample (Gap until Next Frame is Measured)
+        const reconfig::Change change = reconfigurator->apply( hooks, hot );
+        if( change.empty() ){
+            return;
+        }
+
+        // Reset Pacing after Re-Initialize (Timestamp is Restarted)
+        if( pacer && change.affects( reconfig::RESTART ) ){
+            pacer->reset();
+        }
+
+        // Restart Measurement of Frame Time
+        meter.restart();
+        if( quality ){
+            quality->restart( dropped );
+        }
+        if( shedding ){
+            shedding->restart();
+        }
+    }
+}
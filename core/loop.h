@@ -0,0 +1,166 @@
+// This is runner of main loop that orchestrates per-frame work common to samples.
+// Pacing, gap of reconfiguration, idle mode and display rate, reports and trace flush, and adaptation to CPU load
+// (frame time, quality, shedding, changed config at frame boundary) run in same order in every sample.
+// Components are owned by sample and attached to runner (component that is not attached is not used),
+// and sample keeps only its own update, draw and show, and key handling.
+//
+// #include "loop.h"
+//
+// loop::Runner runner;
+// runner.setPacer( &pacer );
+// runner.setReconfigurator( &reconfigurator, hooks, true );
+// runner.setQuality( &quality_controller, { "Realsense2Module.RGB." } );
+// runner.setLog( &std::cout, 5.0 );
+//
+// while( true ){
+//     update();
+//     runner.begin( color_updated, color_frame->getTimestamp() );
+//     if( runner.due( updated ) ){
+//         draw();
+//         show();
+//     }
+//     runner.report( updated );
+//     if( cv::pollKey() == 'q' ){
+//         break;
+//     }
+//     runner.end( color_updated, color_sequence.getDropped() ); /* sleeps until next frame */
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __LOOP__
+#define __LOOP__
+
+#include "pacing.h"
+#include "frametime.h"
+#include "quality.h"
+#include "shedding.h"
+#include "idle.h"
+#include "schedule.h"
+#include "startup.h"
+#include "reconfig.h"
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+namespace loop
+{
+    // Runner of Main Loop
+    class Runner
+    {
+    private:
+        // Components of Sample (nullptr is not used)
+        pacing::Pacer* pacer = nullptr;
+        startup::Timeline* timeline = nullptr;
+        schedule::Scheduler* scheduler = nullptr;
+        idle::Monitor* monitor = nullptr;
+        quality::Controller* quality = nullptr;
+        shedding::Controller* shedding = nullptr;
+        reconfig::Reconfigurator* reconfigurator = nullptr;
+
+        // Quality
+        std::vector<std::string> prefixes; // config prefixes of processing resolution (e.g. "Realsense2Module.RGB.")
+
+        // Display Rate (Stage of Shedding)
+        bool display_shedding = false;
+        uint32_t display_stage = 0;
+        uint32_t display_divisor = 2; // shows every n-th frame while display rate is shed
+        uint64_t display_count = 0;
+
+        // Reconfiguration
+        reconfig::Hooks hooks;
+        bool hot = true;
+
+        // Frame Time (Shared by Quality and Shedding)
+        frametime::Meter meter;
+
+        // Report
+        std::ostream* log = nullptr;
+        double interval = 5.0; // seconds
+
+    public:
+        // Set Pacer (Sleeps until Next Frame of Base Stream)
+        void setPacer( pacing::Pacer* pacer )
+        {
+            this->pacer = pacer;
+        }
+
+        // Set Startup Timeline (Reported at First Frame)
+        void setStartup( startup::Timeline* timeline )
+        {
+            this->timeline = timeline;
+        }
+
+        // Set Scheduler (Achieved Rates of Consumers are Reported)
+        void setScheduler( schedule::Scheduler* scheduler )
+        {
+            this->scheduler = scheduler;
+        }
+
+        // Set Idle Monitor (Draw and Show run at Idle Rate while No Users are Present, Presence is Updated by Sample)
+        void setIdle( idle::Monitor* monitor )
+        {
+            this->monitor = monitor;
+        }
+
+        // Set Quality Controller (Processing Resolution is Reconfigured by ProcessWidth and ProcessHeight of each Prefix)
+        void setQuality( quality::Controller* quality, const std::vector<std::string>& prefixes );
+
+        // Set Shedding Controller (Display is Shown Every n-th Frame while Display Stage is Shed)
+        void setShedding( shedding::Controller* shedding, const uint32_t display_stage, const uint32_t display_divisor = 2 );
+
+        // Set Reconfigurator (Changed Config is Applied at Frame Boundary by Hooks of Sample)
+        void setReconfigurator( reconfig::Reconfigurator* reconfigurator, const reconfig::Hooks& hooks, const bool hot = true );
+
+        // Set Log Stream of Reports (nullptr disables) and Interval of Periodic Reports (seconds)
+        void setLog( std::ostream* log, const double interval );
+
+        // Begin Loop after Update
+        // processed is true if base stream has new frame, timestamp is timestamp of that frame (microseconds).
+        void begin( const bool processed, const uint64_t timestamp );
+
+        // Draw and Show are Due (Any Stream has New Frame, Idle Rate in Idle Mode, Every n-th Frame while Display Rate is Shed)
+        bool due( const bool updated );
+
+        // Report Startup at First Frame, Profile, Consumers, Idle Mode and Threads, and Flush Trace
+        void report( const bool updated );
+
+        // End Loop (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+        // processed is true if base stream has new frame, dropped is total number of dropped frames of base stream.
+        void end( const bool processed, const uint64_t dropped );
+
+    private:
+        // Apply Quality (Reconfigure Processing Resolution of Quality Controller)
+        void applyQuality();
+
+        // Apply Config (Recreate Only Modules Affected by Changed Config)
+        void applyConfig( const uint64_t dropped );
+    };
+}
+
+#endif // __LOOP__
@@ -0,0 +1,164 @@
+// This is merger of timestamped streams from several sources (e.g. pipelines of devices) into one stream in time order.
+// Each source pushes items in time order from its own thread, and consumer pops item when it can't be preceded by item of other sources,
+// that is, every other source has pushed item at same time or later, or item has waited for latency (source is late or stopped).
+// Time is monotonic time (e.g. pacing::Pacer::arrival() of frame timestamp), so that streams of different device clocks are comparable.
+//
+// #include "merge.h"
+//
+// merge::Merger<cv::Mat> merger( devices );
+//
+// /* Pipeline Thread of Device */
+// merger.push( device, pacer.arrival( frame->getTimestamp() ), mat );
+//
+// /* Consumer Thread */
+// merge::Item<cv::Mat> item;
+// while( merger.pop( item ) ){
+//     show( item.source, item.value );
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __MERGE__
+#define __MERGE__
+
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+namespace merge
+{
+    typedef std::chrono::steady_clock clock;
+
+    // Item of Stream
+    template<typename T>
+    struct Item
+    {
+        uint32_t source = 0;
+        clock::time_point time;
+        uint64_t order = 0; // order of push (tie break of same time)
+        T value;
+    };
+
+    // Merger of Timestamped Streams
+    template<typename T>
+    class Merger
+    {
+    private:
+        mutable std::mutex mutex;
+        std::vector<merge::Item<T>> items; // heap (earliest first)
+        std::vector<clock::time_point> watermarks; // time of last pushed item of each source
+        clock::duration latency;
+        size_t capacity;
+        uint64_t order = 0;
+        uint64_t merged = 0;
+        uint64_t dropped = 0;
+
+    public:
+        // Constructor
+        // latency is maximum time to wait for other sources, capacity is maximum number of pending items (oldest is dropped).
+        Merger( const uint32_t sources, const double latency = 0.1, const size_t capacity = 64 )
+            : watermarks( sources, clock::time_point::min() ),
+              latency( std::chrono::duration_cast<clock::duration>( std::chrono::duration<double>( latency ) ) ),
+              capacity( std::max<size_t>( capacity, 1 ) )
+        {
+        }
+
+        // Push Item of Source (Thread-Safe, Items of Each Source are in Time Order)
+        void push( const uint32_t source, const clock::time_point& time, T value )
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( source >= watermarks.size() ){
+                return;
+            }
+
+            merge::Item<T> item;
+            item.source = source;
+            item.time = time;
+            item.order = order++;
+            item.value = std::move( value );
+            items.push_back( std::move( item ) );
+            std::push_heap( items.begin(), items.end(), later );
+            watermarks[source] = std::max( watermarks[source], time );
+
+            // Drop Oldest Item if Consumer can't keep up (Bound Memory)
+            while( items.size() > capacity ){
+                std::pop_heap( items.begin(), items.end(), later );
+                items.pop_back();
+                dropped++;
+            }
+        }
+
+        // Pop Earliest Item if it can't be Preceded by Item of Other Sources (Thread-Safe, Non-Blocking)
+        bool pop( merge::Item<T>& item )
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( items.empty() ){
+                return false;
+            }
+
+            const merge::Item<T>& earliest = items.front();
+            if( clock::now() < earliest.time + latency ){
+                for( size_t source = 0; source < watermarks.size(); source++ ){
+                    if( source != earliest.source && watermarks[source] < earliest.time ){
+                        return false;
+                    }
+                }
+            }
+
+            std::pop_heap( items.begin(), items.end(), later );
+            item = std::move( items.back() );
+            items.pop_back();
+            merged++;
+            return true;
+        }
+
+        // Number of Items that were Popped
+        uint64_t getMerged() const
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            return merged;
+        }
+
+        // Number of Items that were Dropped by Capacity
+        uint64_t getDropped() const
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            return dropped;
+        }
+
+    private:
+        // Order of Heap (Earliest on Top)
+        static bool later( const merge::Item<T>& a, const merge::Item<T>& b )
+        {
+            return a.time != b.time ? a.time > b.time : a.order > b.order;
+        }
+    };
+}
+
+#endif // __MERGE__
@@ -0,0 +1,169 @@
+#include "occupancy.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace occupancy
+{
+    // Minimum Number of Points (or Cells) per Task of Parallel Loop
+    static const int32_t GRAIN = 4096;
+
+    // Constructor
+    // range_x and range_z are floor area, range_y is height band of points to count. (millimeter)
+    Grid::Grid( const float cell_size, const occupancy::Range& range_x, const occupancy::Range& range_z, const occupancy::Range& range_y )
+        : cell_size( cell_size ), range_x( range_x ), range_z( range_z ), range_y( range_y )
+    {
+        if( cell_size <= 0.0f || range_x.length() <= 0.0f || range_z.length() <= 0.0f ){
+            throw std::runtime_error( "failed invalid grid size" );
+        }
+
+        cols = static_cast<int32_t>( std::ceil( range_x.length() / cell_size ) );
+        rows = static_cast<int32_t>( std::ceil( range_z.length() / cell_size ) );
+        heat.assign( cols * rows, 0.0f );
+
+        partial_count = parallel::threads();
+        partials.assign( partial_count * cols * rows, 0 );
+    }
+
+    // Accumulate Points of One Frame
+    void Grid::accumulate( const pointcloud::Point* points, const size_t count )
+    {
+        const int32_t cells = cols * rows;
+        const int32_t total = static_cast<int32_t>( count );
+        const float scale = 1.0f / cell_size;
+
+        // Re-allocate if number of threads was changed (e.g. parallel::setThreads)
+        if( partial_count < parallel::threads() ){
+            partial_count = parallel::threads();
+            partials.assign( partial_count * cells, 0 );
+        }
+
+        // Accumulate to Partial Grid of Each Thread
+        parallel::forEach( total, GRAIN, [&]( const int32_t begin, const int32_t end, const int32_t thread ){
+            uint32_t* partial = partials.data() + thread * cells;
+
+            for( int32_t index = begin; index < end; index++ ){
+                const pointcloud::Point& point = points[index];
+                if( !range_x.contains( point.x ) || !range_z.contains( point.z ) || !range_y.contains( point.y ) ){
+                    continue;
+                }
+
+                const int32_t col = static_cast<int32_t>( ( point.x - range_x.min ) * scale );
+                const int32_t row = static_cast<int32_t>( ( range_z.max - point.z ) * scale ); // Far -> Top
+                if( col < cols && row < rows ){
+                    partial[row * cols + col]++;
+                }
+            }
+        } );
+
+        // Merge Partial Grids and Apply Decay
+        // Partial grids are cleared here for next frame.
+        const float gain = 1.0f - decay;
+        parallel::forEach( cells, GRAIN, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t cell = begin; cell < end; cell++ ){
+                uint32_t sum = 0;
+                for( int32_t partial = 0; partial < partial_count; partial++ ){
+                    uint32_t& value = partials[partial * cells + cell];
+                    sum += value;
+                    value = 0;
+                }
+                heat[cell] = heat[cell] * decay + ( sum >= min_points ? gain : 0.0f );
+            }
+        } );
+    }
+
+    // Constructor
+    // Memory is ( size_x * size_y * size_z * 16 bytes ) per thread. Keep voxel_size large enough.
+    VoxelGrid::VoxelGrid( const float voxel_size, const occupancy::Range& range_x, const occupancy::Range& range_y, const occupancy::Range& range_z )
+        : voxel_size( voxel_size ), range_x( range_x ), range_y( range_y ), range_z( range_z )
+    {
+        if( voxel_size <= 0.0f || range_x.length() <= 0.0f || range_y.length() <= 0.0f || range_z.length() <= 0.0f ){
+            throw std::runtime_error( "failed invalid voxel grid size" );
+        }
+
+        size_x = static_cast<int32_t>( std::ceil( range_x.length() / voxel_size ) );
+        size_y = static_cast<int32_t>( std::ceil( range_y.length() / voxel_size ) );
+        size_z = static_cast<int32_t>( std::ceil( range_z.length() / voxel_size ) );
+
+        partial_count = parallel::threads();
+        partials.assign( static_cast<size_t>( partial_count ) * size_x * size_y * size_z, Voxel() );
+        touched.resize( partial_count );
+    }
+
+    // Downsample Points (Output Centroid of Each Occupied Voxel)
+    size_t VoxelGrid::downsample( const pointcloud::Point* points, const size_t count, std::vector<pointcloud::Point>& output )
+    {
+        const int32_t voxels = size_x * size_y * size_z;
+        const int32_t total = static_cast<int32_t>( count );
+        const float scale = 1.0f / voxel_size;
+
+        if( partial_count < parallel::threads() ){
+            partial_count = parallel::threads();
+            partials.assign( static_cast<size_t>( partial_count ) * voxels, Voxel() );
+            touched.resize( partial_count );
+        }
+
+        // Accumulate to Partial Grid of Each Thread
+        parallel::forEach( total, GRAIN, [&]( const int32_t begin, const int32_t end, const int32_t thread ){
+            Voxel* partial = partials.data() + static_cast<size_t>( thread ) * voxels;
+            std::vector<int32_t>& list = touched[thread];
+
+            for( int32_t index = begin; index < end; index++ ){
+                const pointcloud::Point& point = points[index];
+                if( !range_x.contains( point.x ) || !range_y.contains( point.y ) || !range_z.contains( point.z ) ){
+                    continue;
+                }
+
+                const int32_t x = static_cast<int32_t>( ( point.x - range_x.min ) * scale );
+                const int32_t y = static_cast<int32_t>( ( point.y - range_y.min ) * scale );
+                const int32_t z = static_cast<int32_t>( ( point.z - range_z.min ) * scale );
+                if( x < size_x && y < size_y && z < size_z ){
+                    const int32_t voxel_index = ( z * size_y + y ) * size_x + x;
+                    Voxel& voxel = partial[voxel_index];
+                    if( voxel.count == 0 ){
+                        list.push_back( voxel_index );
+                    }
+                    voxel.x += point.x;
+                    voxel.y += point.y;
+                    voxel.z += point.z;
+                    voxel.count++;
+                }
+            }
+        } );
+
+        // Merge Touched Voxels of Partial Grids
+        // Merged voxel is stored to first partial grid, touched voxels of other partial grids are cleared for next call.
+        occupied.swap( touched[0] );
+        for( int32_t partial = 1; partial < partial_count; partial++ ){
+            Voxel* grid = partials.data() + static_cast<size_t>( partial ) * voxels;
+            for( const int32_t index : touched[partial] ){
+                Voxel& merged = partials[index];
+                Voxel& voxel = grid[index];
+                if( merged.count == 0 ){
+                    occupied.push_back( index );
+                }
+                merged.x += voxel.x;
+                merged.y += voxel.y;
+                merged.z += voxel.z;
+                merged.count += voxel.count;
+                voxel = Voxel();
+            }
+            touched[partial].clear();
+        }
+
+        // Output Centroids in Order of Grid (Same Order Regardless of Threads)
+        std::sort( occupied.begin(), occupied.end() );
+        output.clear();
+        for( const int32_t index : occupied ){
+            Voxel& voxel = partials[index];
+            const float inverse = 1.0f / voxel.count;
+            output.push_back( pointcloud::Point( voxel.x * inverse, voxel.y * inverse, voxel.z * inverse ) );
+            voxel = Voxel();
+        }
+        occupied.clear();
+        touched[0].swap( occupied ); // keep capacity of both lists
+
+        return output.size();
+    }
+}
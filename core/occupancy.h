@@ -0,0 +1,182 @@
+// This is occupancy grid that accumulates point cloud that generated from NuiTrack depth sensor.
+// occupancy::Grid is floor (X-Z plane) heat map that decays over time.
+// occupancy::VoxelGrid downsamples point cloud to centroid of each voxel.
+//
+// #include "pointcloud.h"
+// #include "occupancy.h"
+//
+// occupancy::Grid grid( 50.0f, occupancy::Range( -3000.0f, 3000.0f ), occupancy::Range( 0.0f, 6000.0f ) );
+// grid.setDecay( 0.95f );
+//
+// generator.generate( depth_frame->getData(), points );
+// grid.accumulate( points.data(), points.size() );
+// const float heat = grid.at( row, col ); /* 0.0 (never occupied) - 1.0 (always occupied) */
+//
+// Both grids are dense (hash-free) arrays. Each thread accumulates to own partial grid,
+// then the partial grids are merged once per frame. There is no atomic operation and no lock.
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __OCCUPANCY__
+#define __OCCUPANCY__
+
+#include "pointcloud.h"
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace occupancy
+{
+    struct Range
+    {
+        float min;
+        float max;
+
+        Range()
+            : min( 0.0f ), max( 0.0f ){}
+
+        Range( const float min, const float max )
+            : min( min ), max( max ){}
+
+        float length() const
+        {
+            return max - min;
+        }
+
+        bool contains( const float value ) const
+        {
+            return min <= value && value < max;
+        }
+    };
+
+    class Grid
+    {
+    private:
+        float cell_size;
+        occupancy::Range range_x;
+        occupancy::Range range_z;
+        occupancy::Range range_y;
+        int32_t cols;
+        int32_t rows;
+
+        // Heat Map (Exponential Moving Average of Occupancy)
+        std::vector<float> heat;
+        float decay = 0.95f;
+
+        // Minimum Number of Points to Regard Cell as Occupied in Frame
+        uint32_t min_points = 10;
+
+        // Partial Grids (Point Counts of Each Thread)
+        std::vector<uint32_t> partials;
+        int32_t partial_count;
+
+    public:
+        // Constructor
+        // range_x and range_z are floor area, range_y is height band of points to count. (millimeter)
+        Grid( const float cell_size, const occupancy::Range& range_x, const occupancy::Range& range_z, const occupancy::Range& range_y = occupancy::Range( -10000.0f, 10000.0f ) );
+
+        // Set Decay (0.0-1.0, larger is longer memory)
+        void setDecay( const float decay )
+        {
+            this->decay = decay;
+        }
+
+        // Set Minimum Number of Points to Regard Cell as Occupied
+        void setMinPoints( const uint32_t min_points )
+        {
+            this->min_points = min_points;
+        }
+
+        // Clear Heat Map
+        void clear()
+        {
+            std::fill( heat.begin(), heat.end(), 0.0f );
+        }
+
+        // Accumulate Points of One Frame
+        void accumulate( const pointcloud::Point* points, const size_t count );
+
+        // Retrieve Heat (0.0-1.0)
+        float at( const int32_t row, const int32_t col ) const
+        {
+            return heat[row * cols + col];
+        }
+
+        // Retrieve Heat Map (Row-Major, Far -> Top)
+        const std::vector<float>& data() const
+        {
+            return heat;
+        }
+
+        int32_t width() const
+        {
+            return cols;
+        }
+
+        int32_t height() const
+        {
+            return rows;
+        }
+    };
+
+    class VoxelGrid
+    {
+    private:
+        struct Voxel
+        {
+            float x;
+            float y;
+            float z;
+            uint32_t count;
+        };
+
+        float voxel_size;
+        occupancy::Range range_x;
+        occupancy::Range range_y;
+        occupancy::Range range_z;
+        int32_t size_x;
+        int32_t size_y;
+        int32_t size_z;
+
+        // Partial Grids (Sum of Points of Each Thread)
+        std::vector<Voxel> partials;
+        int32_t partial_count;
+
+        // Voxels that were Touched by Each Thread (Merge and Output visit only these, not whole grid)
+        std::vector<std::vector<int32_t>> touched;
+        std::vector<int32_t> occupied; // voxels of merged grid
+
+    public:
+        // Constructor
+        // Memory is ( size_x * size_y * size_z * 16 bytes ) per thread. Keep voxel_size large enough.
+        VoxelGrid( const float voxel_size, const occupancy::Range& range_x, const occupancy::Range& range_y, const occupancy::Range& range_z );
+
+        // Downsample Points (Output Centroid of Each Occupied Voxel)
+        size_t downsample( const pointcloud::Point* points, const size_t count, std::vector<pointcloud::Point>& output );
+    };
+}
+
+#endif // __OCCUPANCY__
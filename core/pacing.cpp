@@ -0,0 +1,111 @@
+#include "pacing.h"
+
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+namespace pacing
+{
+    // Seconds to Duration of Clock
+    static inline pacing::clock::duration seconds( const double value )
+    {
+        return std::chrono::duration_cast<pacing::clock::duration>( std::chrono::duration<double>( value ) );
+    }
+
+    // Constructor
+    Pacer::Pacer( const double max_sleep, const double poll )
+        : max_sleep( max_sleep ), poll( poll )
+    {
+    }
+
+    // Update Pacer with Timestamp of New Frame (microseconds)
+    void Pacer::update( const uint64_t timestamp )
+    {
+        const pacing::clock::time_point now = pacing::clock::now();
+        const pacing::clock::time_point arrival = now - std::chrono::duration_cast<pacing::clock::duration>( std::chrono::microseconds( timestamp ) );
+
+        // First Frame, or Timestamp went Backward (Restart)
+        if( first || timestamp <= last ){
+            reset();
+            first = false;
+            last = timestamp;
+            reference = arrival;
+            offsets[0] = 0.0;
+            count = 1;
+            return;
+        }
+
+        // Frame Interval from Sensor Timestamps (Dropped Frames are counted by rounding to multiple of interval)
+        const double delta = ( timestamp - last ) / 1e6;
+        last = timestamp;
+        if( interval <= 0.0 ){
+            interval = delta;
+        }
+        else{
+            const double frames = std::max( std::floor( delta / interval + 0.5 ), 1.0 );
+            interval = interval * 0.9 + ( delta / frames ) * 0.1;
+        }
+
+        // Offset of Sensor Clock (Earliest Arrival of Recent Frames is Closest to When Frame became Available)
+        const double current = std::chrono::duration<double>( arrival - reference ).count();
+        offsets[count % WINDOW] = current;
+        count++;
+        offset = *std::min_element( offsets.begin(), offsets.begin() + std::min( count, WINDOW ) );
+        jitter = jitter * 0.9 + ( current - offset ) * 0.1;
+    }
+
+    // Wake Margin before Predicted Arrival (seconds)
+    double Pacer::getMargin() const
+    {
+        return std::min( std::max( jitter * 0.5, poll * 0.5 ), interval * 0.1 );
+    }
+
+    // Sleep until Predicted Next Frame (or Display Deadline)
+    void Pacer::wait()
+    {
+        std::this_thread::sleep_until( deadline() );
+    }
+
+    // Time to Wake for Next Frame
+    pacing::clock::time_point Pacer::deadline() const
+    {
+        const pacing::clock::time_point now = pacing::clock::now();
+
+        // Unknown Frame Rate (Poll)
+        if( interval <= 0.0 ){
+            return now + seconds( poll );
+        }
+
+        // Predicted Arrival of Next Frame (Skip Frames that were Dropped by Sensor)
+        pacing::clock::time_point expected = reference + seconds( offset + last / 1e6 + interval );
+        const pacing::clock::duration half = seconds( interval * 0.5 );
+        while( expected + half < now ){
+            expected += seconds( interval );
+        }
+
+        // Wake Slightly Before Arrival, but not beyond Display Deadline
+        const pacing::clock::time_point target = expected - seconds( getMargin() );
+        if( target > now ){
+            return std::min( target, now + seconds( max_sleep ) );
+        }
+
+        // Frame is Due (Late), Poll
+        return now + seconds( poll );
+    }
+
+    // Monotonic Time of Frame Timestamp
+    pacing::clock::time_point Pacer::arrival( const uint64_t timestamp ) const
+    {
+        return reference + seconds( offset + timestamp / 1e6 );
+    }
+
+    // Reset Estimation (e.g. Frame Rate was Changed)
+    void Pacer::reset()
+    {
+        first = true;
+        count = 0;
+        offset = 0.0;
+        interval = 0.0;
+        jitter = 0.0;
+    }
+}
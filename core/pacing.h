@@ -0,0 +1,113 @@
+// This is frame pacing that sleeps main loop until predicted arrival of next sensor frame.
+// Frame interval is measured from sensor timestamps, and offset between sensor clock and monotonic clock is tracked
+// with minimum of (arrival - timestamp) over recent frames, so that loop wakes just when next frame becomes available.
+// Loop also wakes at display deadline (max_sleep), so that keyboard and window events are polled without blocking.
+//
+// #include "pacing.h"
+//
+// pacing::Pacer pacer;
+//
+// while( true ){
+//     update();
+//     if( color_updated ){
+//         pacer.update( color_frame->getTimestamp() ); /* microseconds */
+//     }
+//     if( cv::pollKey() == 'q' ){
+//         break;
+//     }
+//     pacer.wait();
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __PACING__
+#define __PACING__
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace pacing
+{
+    typedef std::chrono::steady_clock clock;
+
+    // Number of Recent Frames to Track Offset of Sensor Clock
+    static const int32_t WINDOW = 32;
+
+    // Pacer of Main Loop
+    class Pacer
+    {
+    private:
+        double max_sleep; // seconds
+        double poll; // seconds
+        bool first = true;
+        uint64_t last = 0; // timestamp of last frame (microseconds)
+        clock::time_point reference; // monotonic time of timestamp 0 at first frame
+        std::array<double, WINDOW> offsets; // (arrival - timestamp) - reference of recent frames (seconds)
+        int32_t count = 0;
+        double offset = 0.0; // minimum of offsets (seconds)
+        double interval = 0.0; // estimated frame interval (seconds)
+        double jitter = 0.0; // estimated deviation of arrival from minimum offset (seconds)
+
+    public:
+        // Constructor
+        // max_sleep is display deadline (e.g. 1/60 seconds), poll is sleep while expected frame is late.
+        Pacer( const double max_sleep = 1.0 / 60.0, const double poll = 0.001 );
+
+        // Update Pacer with Timestamp of New Frame (microseconds)
+        void update( const uint64_t timestamp );
+
+        // Sleep until Predicted Next Frame (or Display Deadline)
+        void wait();
+
+        // Time to Wake for Next Frame (Predicted Arrival minus Margin, Display Deadline, or Poll if Frame is Late)
+        // Loop that paces several streams sleeps until earliest deadline of them.
+        clock::time_point deadline() const;
+
+        // Monotonic Time of Frame Timestamp (Arrival without Delivery Delay, Comparable between Sensors)
+        clock::time_point arrival( const uint64_t timestamp ) const;
+
+        // Reset Estimation (e.g. Frame Rate was Changed)
+        void reset();
+
+        // Estimated Frame Interval (seconds)
+        double getInterval() const
+        {
+            return interval;
+        }
+
+        // Estimated Jitter of Arrival (seconds)
+        double getJitter() const
+        {
+            return jitter;
+        }
+
+        // Wake Margin before Predicted Arrival (seconds)
+        double getMargin() const;
+    };
+}
+
+#endif // __PACING__
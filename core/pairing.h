@@ -0,0 +1,361 @@
+// This is synchronizer that pairs frames of two streams (e.g. color and depth) by nearest timestamp.
+// Nuitrack::update() returns latest frame of each sensor, and these frames are not guaranteed to be captured at same instant.
+// Synchronizer keeps short ring of recent frames of each stream (by reference, e.g. Ptr of frame), and pops pair whose timestamps differ within tolerance.
+// Frame that can't have partner within tolerance is dropped as unmatched, and pair waits for closer frame of other stream at most for latency.
+// Pairs, unmatched frames, skew of timestamps and added latency (time that frames waited for partner) are reported.
+//
+// #include "pairing.h"
+//
+// pairing::Synchronizer<tdv::nuitrack::RGBFrame::Ptr, tdv::nuitrack::DepthFrame::Ptr> synchronizer( "color", "depth" );
+//
+// while( true ){
+//     tdv::nuitrack::Nuitrack::update();
+//     synchronizer.pushFirst( color_frame->getTimestamp(), color_frame ); /* new frame only, microseconds */
+//     synchronizer.pushSecond( depth_frame->getTimestamp(), depth_frame );
+//     if( synchronizer.pop( color_frame, depth_frame ) ){
+//         draw(); /* color and depth of same instant */
+//     }
+//     synchronizer.report( std::cout, 5.0 ); /* print pairs and unmatched frames every 5 seconds */
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __PAIRING__
+#define __PAIRING__
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <initializer_list>
+
+namespace pairing
+{
+    typedef std::chrono::steady_clock clock;
+
+    // Parameters of Synchronizer
+    struct Parameters
+    {
+        double tolerance = 0.015; // seconds, maximum difference of timestamps of pair (half frame interval of 30 fps)
+        double latency = 0.05; // seconds, maximum wait for closer frame of other stream
+        uint32_t capacity = 4; // frames kept per stream (oldest is dropped as unmatched)
+    };
+
+    // Statistics of Synchronizer
+    struct Statistics
+    {
+        uint64_t pairs = 0;
+        uint64_t unmatched_first = 0; // frames of first stream that were dropped without partner
+        uint64_t unmatched_second = 0; // frames of second stream that were dropped without partner
+        uint64_t restarts = 0; // timestamp went backward (frames are dropped)
+        double skew = 0.0; // total difference of timestamps of pairs (seconds)
+        double latency = 0.0; // total added latency of pairs (seconds)
+        double max_latency = 0.0; // seconds
+    };
+
+    // Item of Stream
+    template<typename T>
+    struct Item
+    {
+        uint64_t timestamp = 0; // microseconds
+        clock::time_point arrival;
+        T value;
+    };
+
+    // Ring of Recent Items of Stream (Fixed Capacity, No Allocation after Construction)
+    template<typename T>
+    class Ring
+    {
+    private:
+        std::vector<pairing::Item<T>> items;
+        size_t head = 0;
+        size_t count = 0;
+        uint64_t last = 0; // timestamp of last pushed item
+        double interval = 0.0; // estimated interval of timestamps (microseconds)
+
+    public:
+        // Constructor
+        explicit Ring( const size_t capacity )
+            : items( std::max<size_t>( capacity, 2 ) )
+        {
+        }
+
+        // Push Item (Returns false if oldest item was dropped to make room)
+        bool push( const uint64_t timestamp, const clock::time_point& arrival, T value )
+        {
+            if( last != 0 ){
+                const double elapsed = static_cast<double>( timestamp - last );
+                interval = ( interval <= 0.0 ) ? elapsed : interval * 0.9 + elapsed * 0.1;
+            }
+            last = timestamp;
+
+            const bool dropped = ( count == items.size() );
+            if( dropped ){
+                pop();
+            }
+
+            pairing::Item<T>& item = items[( head + count ) % items.size()];
+            item.timestamp = timestamp;
+            item.arrival = arrival;
+            item.value = std::move( value );
+            count++;
+            return !dropped;
+        }
+
+        // Pop Oldest Item (Reference of Value is Released)
+        void pop()
+        {
+            items[head].value = T();
+            head = ( head + 1 ) % items.size();
+            count--;
+        }
+
+        // Item in Order of Push (0 is Oldest)
+        pairing::Item<T>& at( const size_t index )
+        {
+            return items[( head + index ) % items.size()];
+        }
+
+        // Clear Items (Estimated Interval is Kept)
+        void clear()
+        {
+            while( count > 0 ){
+                pop();
+            }
+            last = 0;
+        }
+
+        bool empty() const
+        {
+            return count == 0;
+        }
+
+        size_t size() const
+        {
+            return count;
+        }
+
+        // Timestamp of Last Pushed Item (0 if Cleared)
+        uint64_t getLast() const
+        {
+            return last;
+        }
+
+        // Estimated Interval of Timestamps (Microseconds, 0 if Unknown)
+        double getInterval() const
+        {
+            return interval;
+        }
+    };
+
+    // Synchronizer of Two Streams
+    template<typename A, typename B>
+    class Synchronizer
+    {
+    private:
+        std::string first_name;
+        std::string second_name;
+        pairing::Parameters parameters;
+        pairing::Ring<A> firsts;
+        pairing::Ring<B> seconds;
+        pairing::Statistics statistics; // since previous summary
+        pairing::Statistics total;
+        clock::time_point previous = clock::now();
+
+    public:
+        // Constructor
+        Synchronizer( const std::string& first_name = "first", const std::string& second_name = "second", const pairing::Parameters& parameters = pairing::Parameters() )
+            : first_name( first_name ), second_name( second_name ), parameters( parameters ), firsts( parameters.capacity ), seconds( parameters.capacity )
+        {
+        }
+
+        // Push New Frame of First Stream (Timestamp is Microseconds)
+        void pushFirst( const uint64_t timestamp, A value, const clock::time_point& arrival = clock::now() )
+        {
+            restart( timestamp, firsts.getLast() );
+            if( !firsts.push( timestamp, arrival, std::move( value ) ) ){
+                count( statistics.unmatched_first, total.unmatched_first );
+            }
+        }
+
+        // Push New Frame of Second Stream (Timestamp is Microseconds)
+        void pushSecond( const uint64_t timestamp, B value, const clock::time_point& arrival = clock::now() )
+        {
+            restart( timestamp, seconds.getLast() );
+            if( !seconds.push( timestamp, arrival, std::move( value ) ) ){
+                count( statistics.unmatched_second, total.unmatched_second );
+            }
+        }
+
+        // Pop Pair of Nearest Timestamps (Returns false if no pair is ready, first and second are not changed)
+        bool pop( A& first, B& second, const clock::time_point& now = clock::now() )
+        {
+            const double tolerance = parameters.tolerance * 1000000.0;
+            const clock::duration latency = std::chrono::duration_cast<clock::duration>( std::chrono::duration<double>( parameters.latency ) );
+
+            while( !firsts.empty() && !seconds.empty() ){
+                const pairing::Item<A>& a = firsts.at( 0 );
+                const pairing::Item<B>& b = seconds.at( 0 );
+                const double difference = static_cast<double>( static_cast<int64_t>( a.timestamp - b.timestamp ) ); // positive if second is earlier
+
+                // Earlier Frame can't have Partner within Tolerance (Later Frames of Other Stream are even Later)
+                if( difference > tolerance ){
+                    seconds.pop();
+                    count( statistics.unmatched_second, total.unmatched_second );
+                    continue;
+                }
+                if( -difference > tolerance ){
+                    firsts.pop();
+                    count( statistics.unmatched_first, total.unmatched_first );
+                    continue;
+                }
+
+                // Next Frame of Stream that is Earlier may be Closer to Partner
+                if( difference > 0.0 ){
+                    if( seconds.size() > 1 ){
+                        if( std::abs( static_cast<double>( static_cast<int64_t>( a.timestamp - seconds.at( 1 ).timestamp ) ) ) < difference ){
+                            seconds.pop();
+                            count( statistics.unmatched_second, total.unmatched_second );
+                            continue;
+                        }
+                    }
+                    else if( !closest( difference, seconds.getInterval() ) && now - a.arrival < latency ){
+                        return false;
+                    }
+                }
+                else if( difference < 0.0 ){
+                    if( firsts.size() > 1 ){
+                        if( std::abs( static_cast<double>( static_cast<int64_t>( firsts.at( 1 ).timestamp - b.timestamp ) ) ) < -difference ){
+                            firsts.pop();
+                            count( statistics.unmatched_first, total.unmatched_first );
+                            continue;
+                        }
+                    }
+                    else if( !closest( -difference, firsts.getInterval() ) && now - b.arrival < latency ){
+                        return false;
+                    }
+                }
+
+                // Pair (Added Latency is Time since Later Frame of Pair Arrived)
+                const double waited = std::chrono::duration_cast<std::chrono::duration<double>>( now - std::max( a.arrival, b.arrival ) ).count();
+                for( pairing::Statistics* target : { &statistics, &total } ){
+                    target->pairs++;
+                    target->skew += std::abs( difference ) / 1000000.0;
+                    target->latency += waited;
+                    target->max_latency = std::max( target->max_latency, waited );
+                }
+
+                first = std::move( firsts.at( 0 ).value );
+                second = std::move( seconds.at( 0 ).value );
+                firsts.pop();
+                seconds.pop();
+                return true;
+            }
+
+            return false;
+        }
+
+        // Drop Pending Frames (e.g. Streams are Restarted by Reconfiguration, Statistics are Kept)
+        void reset()
+        {
+            firsts.clear();
+            seconds.clear();
+        }
+
+        // Parameters
+        void setParameters( const pairing::Parameters& parameters )
+        {
+            this->parameters = parameters;
+        }
+
+        const pairing::Parameters& getParameters() const
+        {
+            return parameters;
+        }
+
+        // Statistics since Start
+        const pairing::Statistics& getStatistics() const
+        {
+            return total;
+        }
+
+        // Write Pairs and Unmatched Frames if interval (seconds) has elapsed since previous report
+        bool report( std::ostream& os, const double interval )
+        {
+            const clock::time_point now = clock::now();
+            const double elapsed = std::chrono::duration_cast<std::chrono::duration<double>>( now - previous ).count();
+            if( elapsed < interval ){
+                return false;
+            }
+            previous = now;
+
+            const std::ios::fmtflags flags = os.flags();
+            const std::streamsize precision = os.precision();
+            const double pairs = static_cast<double>( std::max<uint64_t>( statistics.pairs, 1 ) );
+            os << "pairing " << first_name << "/" << second_name << " (" << std::fixed << std::setprecision( 1 ) << elapsed << " s)" << std::endl;
+            os << "  " << std::right << std::setw( 10 ) << "pairs/s" << std::setw( 10 ) << "skew ms" << std::setw( 12 ) << "latency ms" << std::setw( 10 ) << "max ms" << std::endl;
+            os << "  " << std::setprecision( 1 ) << std::setw( 10 ) << statistics.pairs / elapsed
+               << std::setprecision( 3 ) << std::setw( 10 ) << statistics.skew * 1000.0 / pairs
+               << std::setw( 12 ) << statistics.latency * 1000.0 / pairs << std::setw( 10 ) << statistics.max_latency * 1000.0 << std::endl;
+            os << "  unmatched " << first_name << " " << statistics.unmatched_first << ", " << second_name << " " << statistics.unmatched_second << ", restarts " << statistics.restarts << std::endl;
+            os.flags( flags );
+            os.precision( precision );
+
+            statistics = pairing::Statistics();
+            return true;
+        }
+
+    private:
+        // Count Unmatched Frame
+        static void count( uint64_t& recent, uint64_t& all )
+        {
+            recent++;
+            all++;
+        }
+
+        // Difference is Closest that Next Frame can have (Next Frame comes Interval Later)
+        static bool closest( const double difference, const double interval )
+        {
+            return interval > 0.0 && difference * 2.0 <= interval;
+        }
+
+        // Drop Pending Frames if Timestamp went Backward (Stream was Restarted)
+        void restart( const uint64_t timestamp, const uint64_t last )
+        {
+            if( last != 0 && timestamp < last ){
+                reset();
+                statistics.restarts++;
+                total.restarts++;
+            }
+        }
+    };
+}
+
+#endif // __PAIRING__
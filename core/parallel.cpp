@@ -0,0 +1,192 @@
+#include "parallel.h"
+#include "affinity.h"
+#include "trace.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace parallel
+{
+    // Default Parameters of Pool (NUITRACK_THREADS, NUITRACK_CORES that is Placement of Workers)
+    static pool::Parameters defaults()
+    {
+        pool::Parameters parameters;
+        const char* threads = std::getenv( "NUITRACK_THREADS" );
+        if( threads && *threads ){
+            parameters.threads = std::max( std::atoi( threads ), 0 );
+        }
+
+        const char* cores = std::getenv( "NUITRACK_CORES" );
+        if( cores && *cores ){
+            const affinity::Placement placement = affinity::parsePlacement( cores );
+            parameters.core_set = placement.core_set;
+            parameters.policy = placement.policy;
+            parameters.priority = placement.priority;
+        }
+        return parameters;
+    }
+
+    // Default Backend (NUITRACK_PARALLEL)
+    static parallel::Backend initial()
+    {
+        const char* environment = std::getenv( "NUITRACK_PARALLEL" );
+        return ( environment && std::string( environment ) == "openmp" ) ? parallel::Backend::OPENMP : parallel::Backend::POOL;
+    }
+
+    static std::atomic<parallel::Backend> backend( initial() );
+
+    // Pool of Calling Thread
+    struct Local
+    {
+        pool::Parameters parameters = defaults();
+        std::unique_ptr<pool::Pool> pool;
+    };
+
+    static thread_local Local local;
+
+    // Set Backend
+    void setBackend( const parallel::Backend backend )
+    {
+        parallel::backend = backend;
+    }
+
+    // Backend
+    parallel::Backend getBackend()
+    {
+        return backend;
+    }
+
+    // Name of Backend
+    const char* name( const parallel::Backend backend )
+    {
+        return ( backend == parallel::Backend::OPENMP ) ? "openmp" : "pool";
+    }
+
+    // Configure Pool of Calling Thread
+    void configure( const pool::Parameters& parameters )
+    {
+        local.parameters = parameters;
+        local.pool.reset();
+    }
+
+    // Place Workers of Pool of Calling Thread
+    void place( const affinity::Placement& placement )
+    {
+        local.parameters.core_set = placement.core_set;
+        local.parameters.policy = placement.policy;
+        local.parameters.priority = placement.priority;
+        local.pool.reset();
+    }
+
+    // Pool of Calling Thread (Created at First Use)
+    pool::Pool& pool()
+    {
+        if( !local.pool ){
+            local.pool.reset( new pool::Pool( local.parameters ) );
+        }
+        return *local.pool;
+    }
+
+    // Maximum Number of Threads in Parallel Loop
+    int32_t threads()
+    {
+        if( backend == parallel::Backend::OPENMP ){
+            #ifdef _OPENMP
+            return omp_get_max_threads();
+            #else
+            return 1;
+            #endif
+        }
+
+        if( local.pool ){
+            return local.pool->getSize();
+        }
+        return ( local.parameters.threads > 0 ) ? local.parameters.threads : affinity::cores();
+    }
+
+    // Set Number of Threads
+    void setThreads( const int32_t threads )
+    {
+        #ifdef _OPENMP
+        omp_set_num_threads( std::max( threads, 1 ) );
+        #endif
+
+        if( local.parameters.threads != threads ){
+            local.parameters.threads = threads;
+            local.pool.reset();
+        }
+    }
+
+    // Run Task
+    void run( const int32_t count, const int32_t grain, const pool::Task& task )
+    {
+        const int32_t tile = std::max( grain, 1 );
+
+        // Loop inside Loop runs on Calling Thread (Worker doesn't Create Pool of its Own, Index of Executing Thread is Kept for Per-Thread Buffers)
+        const int32_t executing = pool::current();
+        if( executing >= 0 ){
+            for( int32_t begin = 0; begin < count; begin += tile ){
+                task.call( task.context, begin, std::min( begin + tile, count ), executing );
+            }
+            return;
+        }
+
+        if( backend == parallel::Backend::POOL ){
+            parallel::pool().run( count, grain, task );
+            return;
+        }
+
+        // OpenMP (Team per Loop, Static Schedule of Tiles of Grain)
+        const int32_t tiles = ( std::max( count, 0 ) + tile - 1 ) / tile;
+        std::exception_ptr exception = nullptr;
+        std::atomic<bool> failed( false );
+
+        #pragma omp parallel
+        {
+            #pragma omp for
+            for( int32_t index = 0; index < tiles; index++ ){
+                // Exception can't leave Parallel Region, First Exception is Rethrown after Region (Remaining Tiles are Skipped)
+                if( failed.load( std::memory_order_relaxed ) ){
+                    continue;
+                }
+
+                const int32_t begin = index * tile;
+                #ifdef _OPENMP
+                const int32_t thread = omp_get_thread_num();
+                #else
+                const int32_t thread = 0;
+                #endif
+                try{
+                    task.call( task.context, begin, std::min( begin + tile, count ), thread );
+                } catch( ... ){
+                    #pragma omp critical( parallel_exception )
+                    {
+                        if( !exception ){
+                            exception = std::current_exception();
+                        }
+                    }
+                    failed = true;
+                }
+            }
+
+            // Hand Events of Team Thread to Writer Thread before End of Region (Calling Thread flushes by itself)
+            #ifdef _OPENMP
+            if( omp_get_thread_num() != 0 ){
+                TRACE_FLUSH();
+            }
+            #endif
+        }
+
+        if( exception ){
+            std::rethrow_exception( exception );
+        }
+    }
+}
@@ -0,0 +1,91 @@
+// This is parallel loop of kernels that runs on work-stealing pool (pool::Pool) of calling thread, or OpenMP for comparison.
+// Each thread that calls loops has own pool (created at first loop), so pipelines on different threads don't share workers.
+// Function receives range of elements and index of executing thread for per-thread partial buffers.
+// Backend is selected by parallel::setBackend() or NUITRACK_PARALLEL environment variable (pool or openmp),
+// and default pool is configured by NUITRACK_THREADS (number of threads) and NUITRACK_CORES (placement of workers, e.g. "0-3" or "0-3:fifo:10").
+//
+// #include "parallel.h"
+//
+// std::vector<uint32_t> partials( parallel::threads() * size );
+// parallel::forEach( count, 4096, [&]( const int32_t begin, const int32_t end, const int32_t thread ){
+//     uint32_t* partial = partials.data() + thread * size;
+//     /* accumulate [begin, end) to own partial buffer */
+// } );
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __PARALLEL__
+#define __PARALLEL__
+
+#include "pool.h"
+
+#include <cstdint>
+
+namespace parallel
+{
+    // Backend of Parallel Loops
+    enum class Backend
+    {
+        POOL,
+        OPENMP // runs on calling thread if OpenMP is not available
+    };
+
+    // Set Backend of Following Parallel Loops (All Threads)
+    void setBackend( const parallel::Backend backend );
+
+    // Backend of Parallel Loops
+    parallel::Backend getBackend();
+
+    // Name of Backend ("pool" or "openmp")
+    const char* name( const parallel::Backend backend );
+
+    // Configure Pool of Calling Thread (Workers are Re-created at Next Loop)
+    void configure( const pool::Parameters& parameters );
+
+    // Place Workers of Pool of Calling Thread (Core Set, Scheduling Policy and Priority, Workers are Re-created at Next Loop)
+    void place( const affinity::Placement& placement );
+
+    // Pool of Calling Thread
+    pool::Pool& pool();
+
+    // Maximum Number of Threads in Parallel Loop of Calling Thread
+    int32_t threads();
+
+    // Set Number of Threads for Following Parallel Loops of Calling Thread
+    void setThreads( const int32_t threads );
+
+    // Run Task over [0, count) in Tiles of at least grain Elements
+    void run( const int32_t count, const int32_t grain, const pool::Task& task );
+
+    // Run Function over [0, count) in Tiles of at least grain Elements
+    // function( begin, end, thread ) is called for each tile, thread is index of executing thread (0 to threads() - 1).
+    template<typename Function>
+    inline void forEach( const int32_t count, const int32_t grain, const Function& function )
+    {
+        parallel::run( count, grain, pool::Task::of( function ) );
+    }
+}
+
+#endif // __PARALLEL__
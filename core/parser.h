@@ -49,7 +49,7 @@
 
 #include <vector>
 #include <string>
-#include <strstream>
+#include <sstream>
 #include <iostream>
 
 #define LANDMARK 31
@@ -155,7 +155,7 @@ namespace parser
 
     struct JSON
     {
-        int64_t timestamp;
+        int64_t timestamp = 0; // 0 if instances have no timestamp
         std::vector<parser::Human> humans;
 
         friend std::ostream& operator<<( std::ostream& os, const parser::JSON& json )
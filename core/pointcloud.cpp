@@ -0,0 +1,121 @@
+#include "pointcloud.h"
+#include "parallel.h"
+
+namespace pointcloud
+{
+    // Set Intrinsics
+    void Generator::setIntrinsics( const uint32_t width, const uint32_t height, const camera::Intrinsics& intrinsics )
+    {
+        if( this->width == width && this->height == height && this->intrinsics == intrinsics ){
+            return;
+        }
+
+        this->width = width;
+        this->height = height;
+        this->intrinsics = intrinsics;
+
+        ray_x.resize( width );
+        for( uint32_t x = 0; x < width; x++ ){
+            ray_x[x] = ( x - intrinsics.cx ) / intrinsics.fx;
+        }
+
+        // Y-Axis is upward same as tdv::nuitrack::Joint::real
+        ray_y.resize( height );
+        for( uint32_t y = 0; y < height; y++ ){
+            ray_y[y] = ( intrinsics.cy - y ) / intrinsics.fy;
+        }
+
+        offsets.resize( height + 1 );
+    }
+
+    // Generate Point Cloud
+    size_t Generator::generate( const uint16_t* depth_data, std::vector<pointcloud::Point>& points )
+    {
+        return generate( depth_data, nullptr, points, nullptr );
+    }
+
+    // Generate Point Cloud
+    size_t Generator::generate( const uint16_t* depth_data, const uint16_t* label_data, std::vector<pointcloud::Point>& points, std::vector<uint16_t>* point_labels )
+    {
+        if( depth_data == nullptr || width == 0 || height == 0 ){
+            points.clear();
+            return 0;
+        }
+
+        const int32_t rows = static_cast<int32_t>( height );
+        const int32_t cols = static_cast<int32_t>( width );
+
+        // Count Valid Points of Each Row
+        parallel::forEach( rows, 1, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t y = begin; y < end; y++ ){
+                const uint16_t* depth_row = depth_data + y * cols;
+                uint32_t count = 0;
+                if( label_data ){
+                    const uint16_t* label_row = label_data + y * cols;
+                    for( int32_t x = 0; x < cols; x++ ){
+                        count += ( depth_row[x] != 0 ) & ( label_row[x] != 0 );
+                    }
+                }
+                else{
+                    for( int32_t x = 0; x < cols; x++ ){
+                        count += ( depth_row[x] != 0 );
+                    }
+                }
+                offsets[y + 1] = count;
+            }
+        } );
+
+        // Exclusive Prefix Sum
+        offsets[0] = 0;
+        for( int32_t y = 0; y < rows; y++ ){
+            offsets[y + 1] += offsets[y];
+        }
+
+        const size_t total = offsets[rows];
+        points.resize( total );
+        if( point_labels ){
+            point_labels->resize( total );
+        }
+
+        // Unproject and Compact
+        // Row buffer of each thread is kept for next frame.
+        const int32_t threads = parallel::threads();
+        if( rows_x.size() < static_cast<size_t>( threads ) * cols ){
+            rows_x.resize( static_cast<size_t>( threads ) * cols );
+        }
+
+        parallel::forEach( rows, 1, [&]( const int32_t begin, const int32_t end, const int32_t thread ){
+            float* xs = rows_x.data() + static_cast<size_t>( thread ) * cols;
+
+            for( int32_t y = begin; y < end; y++ ){
+                const uint16_t* depth_row = depth_data + y * cols;
+                const uint16_t* label_row = label_data ? label_data + y * cols : nullptr;
+                const float ray = ray_y[y];
+
+                // Multiply whole row without branch (vectorized by compiler)
+                const float* rays = ray_x.data();
+                for( int32_t x = 0; x < cols; x++ ){
+                    xs[x] = rays[x] * static_cast<float>( depth_row[x] );
+                }
+
+                // Write only valid points to own range of this row
+                uint32_t index = offsets[y];
+                for( int32_t x = 0; x < cols; x++ ){
+                    const uint16_t depth = depth_row[x];
+                    if( depth == 0 || ( label_row && label_row[x] == 0 ) ){
+                        continue;
+                    }
+
+                    const float z = static_cast<float>( depth );
+                    points[index] = pointcloud::Point( xs[x], ray * z, z );
+                    if( point_labels ){
+                        ( *point_labels )[index] = label_row ? label_row[x] : 0;
+                    }
+                    index++;
+                }
+            }
+        } );
+
+        return total;
+    }
+}
@@ -0,0 +1,99 @@
+// This is point cloud generator that unprojects depth data that retrieved from NuiTrack depth sensor.
+// The generated points are output to std::vector<pointcloud::Point> that contains only valid (non-zero) depth.
+//
+// #include "pointcloud.h"
+//
+// const tdv::nuitrack::OutputMode mode = depth_sensor->getOutputMode();
+// pointcloud::Generator generator;
+// generator.setIntrinsics( width, height, camera::Intrinsics::fromFov( mode.xres, mode.yres, mode.hfov ) );
+//
+// std::vector<pointcloud::Point> points;
+// generator.generate( depth_frame->getData(), points );
+// for( const pointcloud::Point& point : points ){
+//     /* access point data (millimeter, same coordinate system as tdv::nuitrack::Joint::real) */
+// }
+//
+// The ray tables are computed once per resolution. Each frame costs one multiply per coordinate.
+// If user labels are given, only the points that belong to users are generated.
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __POINTCLOUD__
+#define __POINTCLOUD__
+
+#include "camera.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace pointcloud
+{
+    struct Point
+    {
+        float x;
+        float y;
+        float z;
+
+        Point()
+            : x( 0.0f ), y( 0.0f ), z( 0.0f ){}
+
+        Point( const float x, const float y, const float z )
+            : x( x ), y( y ), z( z ){}
+    };
+
+    class Generator
+    {
+    private:
+        uint32_t width = 0;
+        uint32_t height = 0;
+        camera::Intrinsics intrinsics;
+
+        // Ray Tables
+        // The ray of pixel (x, y) is ( ray_x[x], ray_y[y], 1.0 ) for pinhole camera without distortion (RealSense D400 depth stream).
+        std::vector<float> ray_x;
+        std::vector<float> ray_y;
+
+        // Output Offset of Each Row (Exclusive Prefix Sum of Valid Points)
+        std::vector<uint32_t> offsets;
+
+        // Row Buffer of Each Thread (Unprojected X of Row)
+        std::vector<float> rows_x;
+
+    public:
+        // Set Intrinsics
+        // Ray tables are rebuilt only when resolution or intrinsics are changed.
+        void setIntrinsics( const uint32_t width, const uint32_t height, const camera::Intrinsics& intrinsics );
+
+        // Generate Point Cloud
+        size_t generate( const uint16_t* depth_data, std::vector<pointcloud::Point>& points );
+
+        // Generate Point Cloud
+        // If label_data is not nullptr, generate only points that labeled as user (label != 0).
+        // If point_labels is not nullptr, output label of each point.
+        size_t generate( const uint16_t* depth_data, const uint16_t* label_data, std::vector<pointcloud::Point>& points, std::vector<uint16_t>* point_labels = nullptr );
+    };
+}
+
+#endif // __POINTCLOUD__
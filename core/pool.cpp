@@ -0,0 +1,231 @@
+#include "pool.h"
+#include "trace.h"
+
+#include <chrono>
+#include <algorithm>
+
+namespace pool
+{
+    // Index of Thread that is Executing Tile on This Thread (-1 is outside of loop)
+    static thread_local int32_t executing = -1;
+
+    // Maximum Number of Tiles (16 bits of Range)
+    static const int32_t MAX_TILES = 0xFFFF;
+
+    // Index of Thread that is Executing Tile on Calling Thread
+    int32_t current()
+    {
+        return executing;
+    }
+
+    // Pack Range of Tiles
+    static inline uint64_t pack( const uint32_t generation, const int32_t begin, const int32_t end )
+    {
+        return ( static_cast<uint64_t>( generation ) << 32 ) | ( static_cast<uint64_t>( begin ) << 16 ) | static_cast<uint64_t>( end );
+    }
+
+    static inline uint32_t generationOf( const uint64_t range )
+    {
+        return static_cast<uint32_t>( range >> 32 );
+    }
+
+    static inline int32_t beginOf( const uint64_t range )
+    {
+        return static_cast<int32_t>( ( range >> 16 ) & 0xFFFF );
+    }
+
+    static inline int32_t endOf( const uint64_t range )
+    {
+        return static_cast<int32_t>( range & 0xFFFF );
+    }
+
+    // Spin (Yielding to Other Threads) until Condition or Timeout
+    template<typename Condition>
+    static inline bool spin( const int32_t microseconds, const Condition& condition )
+    {
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::microseconds( microseconds );
+        while( !condition() ){
+            if( std::chrono::steady_clock::now() >= deadline ){
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // Constructor
+    Pool::Pool( const pool::Parameters& parameters )
+        : parameters( parameters ), generation( 0 ), completed( 0 ), stop( false ), steals( 0 ), loops( 0 )
+    {
+        size = ( parameters.threads > 0 ) ? parameters.threads : affinity::cores();
+        slots.reset( new Slot[size] );
+        for( int32_t thread = 0; thread < size; thread++ ){
+            slots[thread].range.store( 0 );
+        }
+
+        workers.reserve( size - 1 );
+        for( int32_t thread = 1; thread < size; thread++ ){
+            workers.emplace_back( [this, thread](){ work( thread ); } );
+        }
+    }
+
+    // Destructor
+    Pool::~Pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            stop = true;
+        }
+        wake.notify_all();
+
+        for( std::thread& worker : workers ){
+            worker.join();
+        }
+    }
+
+    // Run Task
+    void Pool::run( const int32_t count, const int32_t grain, const pool::Task& task )
+    {
+        if( count <= 0 ){
+            return;
+        }
+
+        // Tile Size (At least Grain, About Tasks Tiles per Thread)
+        const int32_t wanted = size * std::max( parameters.tasks, 1 );
+        int32_t tile = std::max( std::max( grain, 1 ), ( count + wanted - 1 ) / wanted );
+        if( ( count + tile - 1 ) / tile > MAX_TILES ){
+            tile = ( count + MAX_TILES - 1 ) / MAX_TILES;
+        }
+        const int32_t tiles = ( count + tile - 1 ) / tile;
+
+        // Run on Calling Thread (Single Thread, Single Tile, or Loop inside Loop)
+        if( size == 1 || tiles == 1 || executing >= 0 ){
+            const int32_t thread = std::max( executing, 0 );
+            for( int32_t begin = 0; begin < count; begin += tile ){
+                task.call( task.context, begin, std::min( begin + tile, count ), thread );
+            }
+            return;
+        }
+
+        // Publish Loop (Contiguous Range of Tiles for Each Thread)
+        this->task = task;
+        this->count = count;
+        this->tile = tile;
+        this->tiles = tiles;
+        completed = 0;
+        exception = nullptr;
+
+        const uint32_t next = generation + 1;
+        for( int32_t thread = 0; thread < size; thread++ ){
+            slots[thread].range.store( pack( next, static_cast<int32_t>( static_cast<int64_t>( tiles ) * thread / size ), static_cast<int32_t>( static_cast<int64_t>( tiles ) * ( thread + 1 ) / size ) ) );
+        }
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            generation = next;
+        }
+        wake.notify_all();
+        loops++;
+
+        // Calling Thread Participates
+        executing = 0;
+        execute( 0, next );
+        executing = -1;
+
+        // Wait for Tiles that Other Threads are Executing
+        if( !spin( parameters.spin, [this](){ return completed == this->tiles; } ) ){
+            std::unique_lock<std::mutex> lock( mutex );
+            done.wait( lock, [this](){ return completed == this->tiles; } );
+        }
+
+        if( exception ){
+            std::exception_ptr thrown = exception;
+            exception = nullptr;
+            std::rethrow_exception( thrown );
+        }
+    }
+
+    // Worker Loop
+    void Pool::work( const int32_t thread )
+    {
+        affinity::Placement placement;
+        if( !parameters.core_set.empty() ){
+            placement.core_set.push_back( parameters.core_set[thread % parameters.core_set.size()] );
+        }
+        placement.policy = parameters.policy;
+        placement.priority = parameters.priority;
+        affinity::place( placement );
+        affinity::attach( parameters.name + " " + std::to_string( thread ) );
+
+        uint32_t seen = 0;
+        while( true ){
+            // Spin then Sleep until Next Loop
+            if( !spin( parameters.spin, [&](){ return generation != seen || stop; } ) ){
+                std::unique_lock<std::mutex> lock( mutex );
+                wake.wait( lock, [&](){ return generation != seen || stop; } );
+            }
+
+            if( stop ){
+                affinity::detach();
+                return;
+            }
+
+            seen = generation;
+            executing = thread;
+            execute( thread, seen );
+            executing = -1;
+
+            // Hand Events of This Worker to Writer Thread (Worker never returns to caller, so it flushes itself)
+            TRACE_FLUSH();
+        }
+    }
+
+    // Execute Own Tiles then Steal Tiles of Others
+    // Range of stale generation is never taken, so worker that wakes late doesn't touch next loop.
+    void Pool::execute( const int32_t thread, const uint32_t generation )
+    {
+        // Own Range from Front
+        std::atomic<uint64_t>& own = slots[thread].range;
+        uint64_t range = own.load();
+        while( generationOf( range ) == generation && beginOf( range ) < endOf( range ) ){
+            if( own.compare_exchange_weak( range, pack( generation, beginOf( range ) + 1, endOf( range ) ) ) ){
+                executeTile( thread, beginOf( range ) );
+                range = own.load();
+            }
+        }
+
+        // Steal from Back of Ranges of Others
+        for( int32_t offset = 1; offset < size; offset++ ){
+            std::atomic<uint64_t>& victim = slots[( thread + offset ) % size].range;
+            range = victim.load();
+            while( generationOf( range ) == generation && beginOf( range ) < endOf( range ) ){
+                if( victim.compare_exchange_weak( range, pack( generation, beginOf( range ), endOf( range ) - 1 ) ) ){
+                    steals++;
+                    executeTile( thread, endOf( range ) - 1 );
+                    range = victim.load();
+                }
+            }
+        }
+    }
+
+    // Execute One Tile
+    // Loop can't be finished until this tile is completed, so members of loop are stable here.
+    void Pool::executeTile( const int32_t thread, const int32_t index )
+    {
+        const int32_t tiles = this->tiles;
+        const int32_t begin = index * tile;
+        try{
+            task.call( task.context, begin, std::min( begin + tile, count ), thread );
+        }
+        catch( ... ){
+            std::lock_guard<std::mutex> lock( mutex );
+            if( !exception ){
+                exception = std::current_exception();
+            }
+        }
+
+        if( completed.fetch_add( 1 ) + 1 == tiles ){
+            std::lock_guard<std::mutex> lock( mutex );
+            done.notify_one();
+        }
+    }
+}
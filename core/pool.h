@@ -0,0 +1,186 @@
+// This is persistent work-stealing thread pool that runs frame kernels.
+// Range of loop is split into tiles (at least grain elements), tiles are distributed to workers as contiguous ranges,
+// and worker that has finished own range steals tiles from end of ranges of others (worker that is preempted doesn't stall loop).
+// Calling thread runs first range, and workers spin shortly then sleep between loops (no team is forked per loop).
+//
+// #include "pool.h"
+//
+// pool::Parameters parameters;
+// parameters.threads = 4;
+// parameters.core_set = affinity::parse( "0-3" );
+// pool::Pool pool( parameters );
+// pool.forEach( count, 16384, [&]( const int32_t begin, const int32_t end, const int32_t thread ){
+//     /* process [begin, end), thread is index of executing thread (0 is calling thread) for per-thread buffers */
+// } );
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __POOL__
+#define __POOL__
+
+#include "affinity.h"
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <exception>
+#include <condition_variable>
+
+namespace pool
+{
+    // Parameters of Pool
+    struct Parameters
+    {
+        int32_t threads = 0; // number of threads including calling thread (0 is number of logical cores)
+        std::vector<int32_t> core_set; // cores of workers, worker n is pinned to core_set[n % size] (empty doesn't pin)
+        affinity::Policy policy = affinity::Policy::NORMAL; // scheduling policy of workers
+        int32_t priority = 0; // priority of workers (see affinity::Placement)
+        std::string name = "worker"; // workers are attached to usage report as "<name> <n>"
+        int32_t tasks = 4; // tiles per thread when grain allows
+        int32_t spin = 50; // microseconds that idle worker spins (yielding) before sleep
+    };
+
+    // Task (Type Erased Function of Range)
+    struct Task
+    {
+        void ( *call )( const void* context, const int32_t begin, const int32_t end, const int32_t thread );
+        const void* context;
+
+        // Task of Function (Function must outlive Task)
+        template<typename Function>
+        static pool::Task of( const Function& function )
+        {
+            const pool::Task task = { &Task::invoke<Function>, &function };
+            return task;
+        }
+
+        // Call Function
+        template<typename Function>
+        static void invoke( const void* context, const int32_t begin, const int32_t end, const int32_t thread )
+        {
+            ( *static_cast<const Function*>( context ) )( begin, end, thread );
+        }
+    };
+
+    // Index of Thread that is Executing Tile of Any Pool on Calling Thread (-1 is outside of loop)
+    int32_t current();
+
+    // Work-Stealing Thread Pool
+    // Pool is used by one calling thread at a time. Loop that is called from inside loop runs on calling thread.
+    class Pool
+    {
+    private:
+        // Range of Tiles of Each Thread (generation:32 | begin:16 | end:16), Padded to Cache Line
+        struct Slot
+        {
+            std::atomic<uint64_t> range;
+            char padding[64 - sizeof( std::atomic<uint64_t> )];
+        };
+
+        pool::Parameters parameters;
+        int32_t size = 1;
+        std::unique_ptr<Slot[]> slots;
+        std::vector<std::thread> workers;
+
+        // Loop in Progress
+        pool::Task task = { nullptr, nullptr };
+        int32_t count = 0; // elements
+        int32_t tile = 0; // elements per tile
+        int32_t tiles = 0;
+        std::atomic<uint32_t> generation; // incremented at each loop
+        std::atomic<int32_t> completed; // tiles
+        std::exception_ptr exception;
+
+        std::mutex mutex;
+        std::condition_variable wake; // workers wait for next loop
+        std::condition_variable done; // calling thread waits for last tile
+        std::atomic<bool> stop;
+
+        // Statistics
+        std::atomic<uint64_t> steals;
+        std::atomic<uint64_t> loops;
+
+    public:
+        // Constructor
+        Pool( const pool::Parameters& parameters = pool::Parameters() );
+
+        // Destructor (Join Workers)
+        ~Pool();
+
+        Pool( const Pool& ) = delete;
+        Pool& operator=( const Pool& ) = delete;
+
+        // Number of Threads including Calling Thread
+        int32_t getSize() const
+        {
+            return size;
+        }
+
+        // Parameters
+        const pool::Parameters& getParameters() const
+        {
+            return parameters;
+        }
+
+        // Number of Tiles that were Stolen and Number of Parallel Loops since Construction
+        uint64_t getSteals() const
+        {
+            return steals;
+        }
+
+        uint64_t getLoops() const
+        {
+            return loops;
+        }
+
+        // Run Task over [0, count) in Tiles of at least grain Elements (Blocks until All Tiles are Done, Rethrows Exception of Task)
+        void run( const int32_t count, const int32_t grain, const pool::Task& task );
+
+        // Run Function over [0, count) in Tiles of at least grain Elements
+        // function( begin, end, thread ) is called for each tile, thread is index of executing thread (0 to getSize() - 1).
+        template<typename Function>
+        void forEach( const int32_t count, const int32_t grain, const Function& function )
+        {
+            run( count, grain, pool::Task::of( function ) );
+        }
+
+    private:
+        // Worker Loop
+        void work( const int32_t thread );
+
+        // Execute Own Tiles then Steal Tiles of Others until No Tile is Left
+        void execute( const int32_t thread, const uint32_t generation );
+
+        // Execute One Tile
+        void executeTile( const int32_t thread, const int32_t index );
+    };
+}
+
+#endif // __POOL__
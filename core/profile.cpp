@@ -0,0 +1,333 @@
+#include "profile.h"
+
+#include <mutex>
+#include <deque>
+#include <iomanip>
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace profile
+{
+    // Histograms of Each Thread
+    struct ThreadData
+    {
+        std::array<std::atomic<profile::Histogram*>, MAX_SITES> histograms;
+
+        ThreadData()
+        {
+            for( std::atomic<profile::Histogram*>& histogram : histograms ){
+                histogram.store( nullptr, std::memory_order_relaxed );
+            }
+        }
+    };
+
+    // Registry of Sites and Threads
+    // Lock is taken only when site or thread is registered, and when summary is created.
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::string> names;
+        std::vector<ThreadData*> threads;
+        std::deque<std::string> counter_names; // deque keeps address of names (trace events refer them)
+        std::deque<std::atomic<uint64_t>> counter_values;
+    };
+
+    static Registry& registry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    // Histograms of Calling Thread (Never Freed, Results of Finished Threads are Kept)
+    static ThreadData& local()
+    {
+        static thread_local ThreadData* data = nullptr;
+        if( !data ){
+            data = new ThreadData();
+            Registry& registry = profile::registry();
+            std::lock_guard<std::mutex> lock( registry.mutex );
+            registry.threads.push_back( data );
+        }
+        return *data;
+    }
+
+    // Index of Most Significant Bit
+    static inline int32_t log2( const uint64_t value )
+    {
+        #if defined( _MSC_VER ) && defined( _M_X64 )
+        unsigned long index;
+        _BitScanReverse64( &index, value );
+        return static_cast<int32_t>( index );
+        #elif defined( __GNUC__ )
+        return 63 - __builtin_clzll( value );
+        #else
+        int32_t index = 0;
+        for( uint64_t v = value; v > 1; v >>= 1 ){
+            index++;
+        }
+        return index;
+        #endif
+    }
+
+    // Constructor
+    Site::Site( const char* name )
+        : name( name )
+    {
+        Registry& registry = profile::registry();
+        std::lock_guard<std::mutex> lock( registry.mutex );
+        id = static_cast<int32_t>( registry.names.size() );
+        registry.names.push_back( name );
+    }
+
+    // Constructor
+    Counter::Counter( const std::string& name )
+    {
+        Registry& registry = profile::registry();
+        std::lock_guard<std::mutex> lock( registry.mutex );
+        const std::deque<std::string>::const_iterator it = std::find( registry.counter_names.begin(), registry.counter_names.end(), name );
+        if( it != registry.counter_names.end() ){
+            id = static_cast<int32_t>( it - registry.counter_names.begin() );
+        }
+        else{
+            id = static_cast<int32_t>( registry.counter_names.size() );
+            registry.counter_names.push_back( name );
+            registry.counter_values.emplace_back( 0 );
+        }
+        this->name = registry.counter_names[id].c_str();
+        total = &registry.counter_values[id];
+    }
+
+    // Add Value (Thread Safe, Emits Trace Counter while Tracing)
+    // Elements of deque are never moved, so value is accessed without lock.
+#ifdef NUITRACK_PROFILE
+    void Counter::add( const uint64_t value ) const
+    {
+        const uint64_t current = total->fetch_add( value, std::memory_order_relaxed ) + value;
+        if( trace::active() ){
+            trace::counter( name, static_cast<double>( current ) );
+        }
+    }
+#endif
+
+    // Retrieve Total
+    uint64_t Counter::get() const
+    {
+        return total->load( std::memory_order_relaxed );
+    }
+
+    // Constructor
+    Histogram::Histogram()
+    {
+        for( std::atomic<uint64_t>& bucket : buckets ){
+            bucket.store( 0, std::memory_order_relaxed );
+        }
+        sum.store( 0, std::memory_order_relaxed );
+    }
+
+    // Add Value
+    // Only owner thread writes, so load and store is enough. (No read-modify-write)
+    void Histogram::add( const uint64_t nanoseconds )
+    {
+        std::atomic<uint64_t>& target = buckets[bucket( nanoseconds )];
+        target.store( target.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        sum.store( sum.load( std::memory_order_relaxed ) + nanoseconds, std::memory_order_relaxed );
+    }
+
+    // Bucket Index of Value
+    int32_t Histogram::bucket( const uint64_t nanoseconds )
+    {
+        if( nanoseconds < SUB_BUCKETS ){
+            return static_cast<int32_t>( nanoseconds );
+        }
+
+        const int32_t exponent = std::min( log2( nanoseconds ), 40 );
+        const int32_t sub = static_cast<int32_t>( ( nanoseconds >> ( exponent - 3 ) ) & ( SUB_BUCKETS - 1 ) );
+        return ( exponent - 2 ) * SUB_BUCKETS + sub;
+    }
+
+    // Representative Value of Bucket (Midpoint)
+    double Histogram::value( const int32_t bucket )
+    {
+        if( bucket < SUB_BUCKETS ){
+            return static_cast<double>( bucket );
+        }
+
+        const int32_t exponent = bucket / SUB_BUCKETS + 2;
+        const int32_t sub = bucket % SUB_BUCKETS;
+        const double width = static_cast<double>( 1ull << ( exponent - 3 ) );
+        return ( SUB_BUCKETS + sub ) * width + width * 0.5;
+    }
+
+    // Record Elapsed Time to Histogram of Calling Thread
+    void record( const profile::Site& site, const uint64_t nanoseconds )
+    {
+        const int32_t id = site.getId();
+        if( id >= MAX_SITES ){
+            return;
+        }
+
+        ThreadData& data = local();
+        profile::Histogram* histogram = data.histograms[id].load( std::memory_order_relaxed );
+        if( !histogram ){
+            histogram = new profile::Histogram();
+            data.histograms[id].store( histogram, std::memory_order_release );
+        }
+
+        histogram->add( nanoseconds );
+    }
+
+    // Constructor
+    Reporter::Reporter()
+        : previous( profile::clock::now() )
+    {
+    }
+
+    // Summarize Scopes that were recorded since previous summary
+    std::vector<profile::Statistics> Reporter::summarize()
+    {
+        std::vector<profile::Statistics> summary;
+        previous = profile::clock::now();
+
+        Registry& registry = profile::registry();
+        std::lock_guard<std::mutex> lock( registry.mutex );
+
+        const size_t sites = std::min( registry.names.size(), static_cast<size_t>( MAX_SITES ) );
+        previous_buckets.resize( sites, std::vector<uint64_t>( BUCKETS, 0 ) );
+        previous_sums.resize( sites, 0 );
+
+        std::vector<uint64_t> buckets( BUCKETS );
+        for( size_t id = 0; id < sites; id++ ){
+            // Merge Histograms of All Threads
+            std::fill( buckets.begin(), buckets.end(), 0 );
+            uint64_t sum = 0;
+            for( const ThreadData* data : registry.threads ){
+                const profile::Histogram* histogram = data->histograms[id].load( std::memory_order_acquire );
+                if( !histogram ){
+                    continue;
+                }
+
+                for( int32_t bucket = 0; bucket < BUCKETS; bucket++ ){
+                    buckets[bucket] += histogram->buckets[bucket].load( std::memory_order_relaxed );
+                }
+                sum += histogram->sum.load( std::memory_order_relaxed );
+            }
+
+            // Difference from Previous Summary
+            uint64_t count = 0;
+            for( int32_t bucket = 0; bucket < BUCKETS; bucket++ ){
+                const uint64_t current = buckets[bucket];
+                buckets[bucket] -= previous_buckets[id][bucket];
+                previous_buckets[id][bucket] = current;
+                count += buckets[bucket];
+            }
+
+            const uint64_t interval_sum = sum - previous_sums[id];
+            previous_sums[id] = sum;
+
+            if( count == 0 ){
+                continue;
+            }
+
+            // Percentiles from Histogram
+            profile::Statistics statistics;
+            statistics.name = registry.names[id];
+            statistics.count = count;
+            statistics.mean = interval_sum / 1e6 / count;
+            statistics.p50 = 0.0;
+            statistics.p99 = 0.0;
+            statistics.max = 0.0;
+
+            const uint64_t rank50 = std::max<uint64_t>( ( count * 50 + 99 ) / 100, 1 );
+            const uint64_t rank99 = std::max<uint64_t>( ( count * 99 + 99 ) / 100, 1 );
+            uint64_t cumulative = 0;
+            for( int32_t bucket = 0; bucket < BUCKETS; bucket++ ){
+                if( buckets[bucket] == 0 ){
+                    continue;
+                }
+
+                const uint64_t before = cumulative;
+                cumulative += buckets[bucket];
+                const double value = profile::Histogram::value( bucket ) / 1e6;
+                if( before < rank50 && rank50 <= cumulative ){
+                    statistics.p50 = value;
+                }
+                if( before < rank99 && rank99 <= cumulative ){
+                    statistics.p99 = value;
+                }
+                statistics.max = value;
+            }
+
+            summary.push_back( statistics );
+        }
+
+        return summary;
+    }
+
+    // Count Counters since previous count
+    std::vector<profile::Count> Reporter::count()
+    {
+        std::vector<profile::Count> counts;
+
+        Registry& registry = profile::registry();
+        std::lock_guard<std::mutex> lock( registry.mutex );
+
+        previous_counts.resize( registry.counter_values.size(), 0 );
+        for( size_t id = 0; id < registry.counter_values.size(); id++ ){
+            profile::Count count;
+            count.name = registry.counter_names[id];
+            count.total = registry.counter_values[id].load( std::memory_order_relaxed );
+            count.interval = count.total - previous_counts[id];
+            previous_counts[id] = count.total;
+            counts.push_back( count );
+        }
+
+        return counts;
+    }
+
+    // Write Summary if interval (seconds) has elapsed since previous summary
+    bool Reporter::report( std::ostream& os, const double interval )
+    {
+        const profile::clock::time_point now = profile::clock::now();
+        const double elapsed = std::chrono::duration_cast<std::chrono::duration<double>>( now - previous ).count();
+        if( elapsed < interval ){
+            return false;
+        }
+
+        const std::vector<profile::Statistics> summary = summarize();
+        const std::vector<profile::Count> counts = count();
+
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << "profile (" << std::fixed << std::setprecision( 1 ) << elapsed << " s)" << std::endl;
+        os << "  " << std::left << std::setw( 40 ) << "scope" << std::right
+           << std::setw( 8 ) << "count" << std::setw( 10 ) << "mean ms" << std::setw( 10 ) << "p50 ms" << std::setw( 10 ) << "p99 ms" << std::setw( 10 ) << "max ms" << std::endl;
+        for( const profile::Statistics& statistics : summary ){
+            os << "  " << std::left << std::setw( 40 ) << statistics.name << std::right
+               << std::setw( 8 ) << statistics.count << std::setprecision( 3 )
+               << std::setw( 10 ) << statistics.mean << std::setw( 10 ) << statistics.p50
+               << std::setw( 10 ) << statistics.p99 << std::setw( 10 ) << statistics.max << std::endl;
+        }
+        if( !counts.empty() ){
+            os << "  " << std::left << std::setw( 40 ) << "counter" << std::right
+               << std::setw( 8 ) << "total" << std::setw( 10 ) << "interval" << std::endl;
+            for( const profile::Count& count : counts ){
+                os << "  " << std::left << std::setw( 40 ) << count.name << std::right
+                   << std::setw( 8 ) << count.total << std::setw( 10 ) << count.interval << std::endl;
+            }
+        }
+        os.flags( flags );
+        os.precision( precision );
+
+        return true;
+    }
+
+    // Write Summary with Global Reporter
+    bool report( std::ostream& os, const double interval )
+    {
+        static profile::Reporter reporter;
+        return reporter.report( os, interval );
+    }
+}
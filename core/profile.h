@@ -0,0 +1,234 @@
+// This is scoped timer instrumentation that measures where frame time goes.
+// Each scope records its elapsed time to histogram of calling thread without lock,
+// and summary (count, mean, p50, p99, max) of all threads is reported at interval.
+//
+// #include "profile.h"
+//
+// void NuiTrack::updateColor()
+// {
+//     PROFILE_SCOPE( "NuiTrack::updateColor" );
+//     /* measured until end of scope */
+// }
+//
+// const profile::Counter dropped( "color dropped frames" );
+// dropped.add( 1 ); /* total and increase since previous summary are reported with scopes */
+//
+// PROFILE_REPORT( std::cout, 5.0 ); /* print summary of last 5 seconds every 5 seconds */
+//
+// Instrumentation is enabled by NUITRACK_PROFILE (CMake option).
+// If it is not defined, PROFILE_SCOPE and PROFILE_REPORT are expanded to nothing, and Counter::add does nothing.
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __PROFILE__
+#define __PROFILE__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+#include "trace.h"
+
+namespace profile
+{
+    // Maximum Number of Scopes (Scopes beyond this are not recorded)
+    static const int32_t MAX_SITES = 256;
+
+    // Histogram Buckets (Log-Linear, 8 Sub-Buckets per Power of 2, Up to 2^40 ns)
+    static const int32_t SUB_BUCKETS = 8;
+    static const int32_t BUCKETS = 41 * SUB_BUCKETS;
+
+    typedef trace::clock clock;
+
+    // Site of Scope (Registered Once per Source Location)
+    class Site
+    {
+    private:
+        int32_t id;
+        const char* name;
+
+    public:
+        // Constructor
+        // name must be alive while program is running. (e.g. string literal)
+        Site( const char* name );
+
+        int32_t getId() const
+        {
+            return id;
+        }
+
+        const char* getName() const
+        {
+            return name;
+        }
+    };
+
+    // Histogram of Elapsed Time
+    // Written by owner thread only, read by reporter thread. (Relaxed atomics, no lock)
+    struct Histogram
+    {
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets;
+        std::atomic<uint64_t> sum;
+
+        Histogram();
+
+        void add( const uint64_t nanoseconds );
+
+        // Bucket Index of Value
+        static int32_t bucket( const uint64_t nanoseconds );
+
+        // Representative Value of Bucket (Midpoint)
+        static double value( const int32_t bucket );
+    };
+
+    // Record Elapsed Time to Histogram of Calling Thread
+    void record( const profile::Site& site, const uint64_t nanoseconds );
+
+    // Scoped Timer
+    class Scope
+    {
+    private:
+        const profile::Site& site;
+        profile::clock::time_point start;
+
+    public:
+        Scope( const profile::Site& site )
+            : site( site ), start( profile::clock::now() ){}
+
+        ~Scope()
+        {
+            const profile::clock::time_point end = profile::clock::now();
+            profile::record( site, static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() ) );
+            if( trace::active() ){
+                trace::span( site.getName(), start, end );
+            }
+        }
+
+        Scope( const Scope& ) = delete;
+        Scope& operator=( const Scope& ) = delete;
+    };
+
+    // Counter (Monotonic Count of Events, e.g. Dropped Frames)
+    // Counters with same name share one value. Value is kept after Counter is destroyed.
+    class Counter
+    {
+    private:
+        int32_t id;
+        const char* name;
+        std::atomic<uint64_t>* total;
+
+    public:
+        // Constructor
+        Counter( const std::string& name );
+
+        // Add Value (Thread Safe, Emits Trace Counter while Tracing)
+        // Counter is only reported with summary, so nothing is counted without NUITRACK_PROFILE.
+#ifdef NUITRACK_PROFILE
+        void add( const uint64_t value = 1 ) const;
+#else
+        void add( const uint64_t = 1 ) const
+        {
+        }
+#endif
+
+        // Retrieve Total
+        uint64_t get() const;
+
+        int32_t getId() const
+        {
+            return id;
+        }
+
+        const char* getName() const
+        {
+            return name;
+        }
+    };
+
+    // Statistics of Scope (Milliseconds)
+    struct Statistics
+    {
+        std::string name;
+        uint64_t count;
+        double mean;
+        double p50;
+        double p99;
+        double max;
+    };
+
+    // Count of Counter
+    struct Count
+    {
+        std::string name;
+        uint64_t total;
+        uint64_t interval; // increase since previous summary
+    };
+
+    // Reporter of Summary
+    // Each summary covers time since previous summary.
+    class Reporter
+    {
+    private:
+        std::vector<std::vector<uint64_t>> previous_buckets;
+        std::vector<uint64_t> previous_sums;
+        std::vector<uint64_t> previous_counts;
+        profile::clock::time_point previous;
+
+    public:
+        // Constructor
+        Reporter();
+
+        // Summarize Scopes that were recorded since previous summary
+        std::vector<profile::Statistics> summarize();
+
+        // Count Counters since previous count
+        std::vector<profile::Count> count();
+
+        // Write Summary if interval (seconds) has elapsed since previous summary
+        bool report( std::ostream& os, const double interval );
+    };
+
+    // Write Summary with Global Reporter
+    bool report( std::ostream& os, const double interval );
+}
+
+#ifdef NUITRACK_PROFILE
+#define PROFILE_CONCAT_IMPL( a, b ) a##b
+#define PROFILE_CONCAT( a, b ) PROFILE_CONCAT_IMPL( a, b )
+#define PROFILE_SCOPE( name ) \
+    static const profile::Site PROFILE_CONCAT( profile_site_, __LINE__ )( name ); \
+    const profile::Scope PROFILE_CONCAT( profile_scope_, __LINE__ )( PROFILE_CONCAT( profile_site_, __LINE__ ) )
+#define PROFILE_REPORT( os, interval ) profile::report( os, interval )
+#else
+#define PROFILE_SCOPE( name ) do{}while( false )
+#define PROFILE_REPORT( os, interval ) do{}while( false )
+#endif
+
+#endif // __PROFILE__
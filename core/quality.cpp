@@ -0,0 +1,113 @@
+#include "quality.h"
+
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+
+namespace quality
+{
+    // Constructor
+    Controller::Controller( const std::vector<quality::Resolution>& ladder, const quality::Resolution& initial, const quality::Parameters& parameters )
+        : ladder( ladder ), parameters( parameters ), window( parameters.window )
+    {
+        if( ladder.empty() ){
+            throw std::runtime_error( "failed ladder of quality is empty" );
+        }
+
+        // Nearest Resolution
+        const double pixels = static_cast<double>( initial.width ) * initial.height;
+        double nearest = -1.0;
+        for( size_t index = 0; index < ladder.size(); index++ ){
+            const double difference = std::abs( static_cast<double>( ladder[index].width ) * ladder[index].height - pixels );
+            if( nearest < 0.0 || difference < nearest ){
+                nearest = difference;
+                level = index;
+            }
+        }
+
+        decision = quality::Decision{ ladder[level], ladder[level], 0.0, budget, 0, 0 };
+    }
+
+    // Set Frame Budget (seconds, e.g. Frame Interval of Sensor)
+    void Controller::setBudget( const double budget )
+    {
+        if( budget > 0.0 ){
+            this->budget = budget;
+        }
+    }
+
+    // Restart Measurement (e.g. after Resolution was Applied)
+    void Controller::restart( const uint64_t dropped )
+    {
+        window.clear();
+        dropped_total = dropped;
+        this->dropped = 0;
+    }
+
+    // Update Controller at End of Loop (Returns true if resolution was changed)
+    bool Controller::update( const bool processed, const double frame_time, const uint64_t dropped )
+    {
+        this->dropped += dropped > dropped_total ? dropped - dropped_total : 0;
+        dropped_total = dropped;
+
+        if( !processed ){
+            return false;
+        }
+
+        // Window of Frame Times
+        window.add( frame_time );
+        if( !window.completed() ){
+            return false;
+        }
+
+        // Evaluate Window
+        const double p90 = window.percentile( 0.9 );
+        const bool overrun = p90 > budget * parameters.high;
+        const bool dropping = this->dropped > parameters.drop * parameters.window;
+
+        if( ( overrun || dropping ) && level + 1 < ladder.size() ){
+            // Go Down Immediately
+            change( level + 1, p90 );
+            return true;
+        }
+
+        if( !overrun && !dropping && level > 0 && window.getFrames() >= parameters.cooldown ){
+            // Go Up if Predicted Frame Time (Scaled by Number of Pixels) Fits in Budget with Margin
+            const double scale = static_cast<double>( ladder[level - 1].width ) * ladder[level - 1].height / ( static_cast<double>( ladder[level].width ) * ladder[level].height );
+            if( p90 * scale < budget * parameters.low ){
+                change( level - 1, p90 );
+                return true;
+            }
+        }
+
+        this->dropped = 0;
+        return false;
+    }
+
+    // Change Level and Log Decision
+    void Controller::change( const size_t level, const double p90 )
+    {
+        decision.from = ladder[this->level];
+        decision.to = ladder[level];
+        decision.p90 = p90;
+        decision.budget = budget;
+        decision.dropped = dropped;
+        decision.frames = window.getCount();
+
+        if( log ){
+            const std::ios::fmtflags flags = log->flags();
+            const std::streamsize precision = log->precision();
+            *log << "quality " << ( level > this->level ? "down" : "up" ) << " "
+                 << decision.from.width << "x" << decision.from.height << " -> " << decision.to.width << "x" << decision.to.height
+                 << std::fixed << std::setprecision( 2 ) << " (p90 " << p90 * 1000.0 << " ms, budget " << budget * 1000.0 << " ms, dropped "
+                 << decision.dropped << "/" << decision.frames << " frames)" << std::endl;
+            log->flags( flags );
+            log->precision( precision );
+        }
+
+        this->level = level;
+        window.clear();
+        dropped = 0;
+    }
+}
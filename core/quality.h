@@ -0,0 +1,157 @@
+// This is adaptive quality controller that switches processing resolution of sensor by measured frame time.
+// Frame time excludes idle time (waiting for sensor or pacing, frametime::Meter), and it is compared with frame budget (sensor frame interval).
+// Resolution goes down one step if p90 of frame time exceeds budget (or frames are dropped),
+// and goes up one step if predicted frame time at higher resolution fits in budget with margin for long enough (hysteresis).
+//
+// #include "quality.h"
+//
+// frametime::Meter meter;
+// quality::Controller quality( quality::LADDER, { 1280, 720 } );
+// quality.setLog( &std::cout );
+//
+// while( true ){
+//     update(); /* wrap waiting with const frametime::Idle idle( meter ); */
+//     meter.update( updated );
+//     if( quality.update( updated, meter.get(), dropped ) ){
+//         apply( quality.getResolution() ); /* re-apply config */
+//     }
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __QUALITY__
+#define __QUALITY__
+
+#include "frametime.h"
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+namespace quality
+{
+    // Processing Resolution
+    struct Resolution
+    {
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Ladder of Processing Resolutions of RealSense D400 Series (Highest First)
+    static const std::vector<quality::Resolution> LADDER = { { 1280, 720 }, { 848, 480 }, { 640, 360 }, { 424, 240 } };
+
+    // Parameters of Controller
+    struct Parameters
+    {
+        int32_t window = 30; // number of frames to evaluate
+        double high = 0.9; // go down if p90 of frame time exceeds budget * high
+        double low = 0.6; // go up if predicted p90 at higher resolution is under budget * low
+        double drop = 0.1; // go down if ratio of dropped frames in window exceeds this
+        int32_t cooldown = 150; // minimum number of frames to stay before going up
+    };
+
+    // Decision of Controller
+    struct Decision
+    {
+        quality::Resolution from;
+        quality::Resolution to;
+        double p90; // seconds
+        double budget; // seconds
+        uint64_t dropped; // dropped frames in window
+        int32_t frames; // frames in window
+    };
+
+    // Controller of Processing Resolution
+    class Controller
+    {
+    private:
+        std::vector<quality::Resolution> ladder;
+        size_t level = 0;
+        quality::Parameters parameters;
+        double budget = 1.0 / 30.0; // seconds
+        std::ostream* log = nullptr;
+
+        // Frame Time
+        frametime::Window window; // frames since previous change
+
+        // Dropped Frames
+        uint64_t dropped_total = 0;
+        uint64_t dropped = 0; // in window
+
+        quality::Decision decision;
+
+    public:
+        // Constructor
+        // Initial level is nearest resolution to initial (by number of pixels).
+        Controller( const std::vector<quality::Resolution>& ladder, const quality::Resolution& initial, const quality::Parameters& parameters = quality::Parameters() );
+
+        // Set Frame Budget (seconds, e.g. Frame Interval of Sensor)
+        void setBudget( const double budget );
+
+        // Set Log Stream of Decisions (nullptr disables)
+        void setLog( std::ostream* log )
+        {
+            this->log = log;
+        }
+
+        // Update Controller at End of Loop (Returns true if resolution was changed)
+        // processed is true if new frame was processed in this loop, frame_time is its frame time (seconds, frametime::Meter),
+        // dropped is total number of dropped frames of streams.
+        bool update( const bool processed, const double frame_time, const uint64_t dropped );
+
+        // Restart Measurement (e.g. after Resolution was Applied)
+        void restart( const uint64_t dropped );
+
+        // Current Resolution
+        const quality::Resolution& getResolution() const
+        {
+            return ladder[level];
+        }
+
+        size_t getLevel() const
+        {
+            return level;
+        }
+
+        double getBudget() const
+        {
+            return budget;
+        }
+
+        // Last Decision
+        const quality::Decision& getDecision() const
+        {
+            return decision;
+        }
+
+    private:
+        // Change Level and Log Decision
+        void change( const size_t level, const double p90 );
+    };
+}
+
+#endif // __QUALITY__
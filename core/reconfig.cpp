@@ -0,0 +1,201 @@
+#include "reconfig.h"
+
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+
+namespace reconfig
+{
+    // Constructor
+    Reconfigurator::Reconfigurator( const std::vector<reconfig::Rule>& rules )
+        : rules( rules )
+    {
+    }
+
+    // Request Change of Config (Thread Safe, Applied at Next Frame Boundary)
+    void Reconfigurator::set( const std::string& key, const std::string& value )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        requested[key] = value;
+    }
+
+    void Reconfigurator::set( const reconfig::Config& config )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        for( const std::pair<const std::string, std::string>& entry : config ){
+            requested[entry.first] = entry.second;
+        }
+    }
+
+    // Set Registration of Depth to Color (Depth follows Color Resolution)
+    void Reconfigurator::setRegistration( const bool registration )
+    {
+        this->registration = registration;
+    }
+
+    // Change is Pending
+    bool Reconfigurator::pending()
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        return !requested.empty();
+    }
+
+    // Config Applied by Reconfiguration (Re-Apply after Re-Initialize)
+    reconfig::Config Reconfigurator::getConfig()
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        return applied;
+    }
+
+    // Modules that Read Key
+    uint32_t Reconfigurator::modules( const std::string& key ) const
+    {
+        for( const reconfig::Rule& rule : rules ){
+            if( key.compare( 0, rule.prefix.size(), rule.prefix ) == 0 ){
+                return rule.modules;
+            }
+        }
+
+        return reconfig::RESTART;
+    }
+
+    // Begin Reconfiguration (Returns Diff against Applied Config and Affected Modules)
+    reconfig::Change Reconfigurator::begin()
+    {
+        reconfig::Change change;
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            for( const std::pair<const std::string, std::string>& entry : requested ){
+                const reconfig::Config::const_iterator it = applied.find( entry.first );
+                if( it == applied.end() || it->second != entry.second ){
+                    change.diff.insert( entry );
+                    applied[entry.first] = entry.second;
+                }
+            }
+            requested.clear();
+        }
+
+        for( const std::pair<const std::string, std::string>& entry : change.diff ){
+            change.modules |= modules( entry.first );
+
+            // Track Registration
+            if( entry.first == "Realsense2Module.Depth2ColorRegistration" || entry.first == "DepthProvider.Depth2ColorRegistration" ){
+                registration = entry.second == "true";
+            }
+        }
+
+        // Registered Depth follows Color Resolution
+        if( registration && change.affects( reconfig::COLOR ) ){
+            change.modules |= reconfig::DEPTH | reconfig::TRACKERS;
+        }
+
+        if( !change.empty() ){
+            report = reconfig::Report();
+            report.change = change;
+            begun = clock::now();
+        }
+
+        return change;
+    }
+
+    // End Reconfiguration (Gap is Measured until Next New Frame)
+    void Reconfigurator::end()
+    {
+        if( report.change.empty() ){
+            return;
+        }
+
+        ended = clock::now();
+        report.apply = std::chrono::duration<double>( ended - begun ).count();
+        measuring = true;
+    }
+
+    // Apply Changed Config at Frame Boundary (Returns Applied Change, Empty if Nothing was Changed)
+    reconfig::Change Reconfigurator::apply( const reconfig::Hooks& hooks, const bool hot )
+    {
+        reconfig::Change change = begin();
+        if( change.empty() ){
+            return change;
+        }
+
+        if( hot && !change.affects( reconfig::RESTART ) ){
+            // Set Changed Config
+            for( const std::pair<const std::string, std::string>& entry : change.diff ){
+                hooks.set( entry.first, entry.second );
+            }
+
+            // Recreate Affected Modules (Other Modules and Buffers of Unchanged Size are Kept)
+            hooks.recreate( change );
+        }
+        else{
+            // Re-Initialize NuiTrack (Device Config and Applied Config are Set at Initialize)
+            change.modules |= reconfig::RESTART;
+            report.change.modules |= reconfig::RESTART;
+            hooks.reinitialize();
+        }
+
+        // Update Buffers Derived from Modules
+        if( hooks.applied ){
+            hooks.applied( change );
+        }
+
+        // Measure Gap until Next Frame
+        end();
+
+        return change;
+    }
+
+    // Update at New Frame (Returns true when gap of reconfiguration was measured)
+    bool Reconfigurator::update( const bool updated, const double interval )
+    {
+        if( !updated ){
+            return false;
+        }
+
+        const clock::time_point now = clock::now();
+        const clock::time_point previous = received ? last : begun;
+        last = now;
+        received = true;
+        if( !measuring ){
+            return false;
+        }
+        measuring = false;
+
+        // Gap from Last Frame before Reconfiguration (Frames that would have Arrived in Gap are Missed)
+        report.gap = std::chrono::duration<double>( now - previous ).count();
+        report.frames = ( interval > 0.0 ) ? std::max( static_cast<int32_t>( std::floor( report.gap / interval + 0.5 ) ) - 1, 0 ) : 0;
+
+        if( log ){
+            const std::ios::fmtflags flags = log->flags();
+            const std::streamsize precision = log->precision();
+            *log << "reconfig";
+            for( const std::pair<const std::string, std::string>& entry : report.change.diff ){
+                *log << " " << entry.first << "=" << entry.second;
+            }
+            *log << " (" << ( report.change.affects( reconfig::RESTART ) ? "re-initialized" : "recreated " + names( report.change.modules ) )
+                 << std::fixed << std::setprecision( 2 ) << " in " << report.apply * 1000.0 << " ms, gap " << report.frames << " frames / " << report.gap * 1000.0 << " ms)" << std::endl;
+            log->flags( flags );
+            log->precision( precision );
+        }
+
+        return true;
+    }
+
+    // Names of Modules
+    std::string names( const uint32_t modules )
+    {
+        static const std::pair<uint32_t, const char*> table[] = {
+            { reconfig::COLOR, "color" }, { reconfig::DEPTH, "depth" }, { reconfig::USER, "user" },
+            { reconfig::SKELETON, "skeleton" }, { reconfig::HAND, "hand" }, { reconfig::GESTURE, "gesture" }
+        };
+
+        std::string names;
+        for( const std::pair<uint32_t, const char*>& entry : table ){
+            if( modules & entry.first ){
+                names += ( names.empty() ? "" : ", " ) + std::string( entry.second );
+            }
+        }
+
+        return names.empty() ? "none" : names;
+    }
+}
@@ -0,0 +1,204 @@
+// This is reconfiguration that applies changed config of NuiTrack (e.g. processing resolution, registration) at frame boundary without release and re-initialize.
+// Changed config is requested from any thread, and diff against applied config is taken at frame boundary of main loop.
+// Keys of diff are mapped to modules that read them at creation (rules), so that only affected sensors and trackers are recreated.
+// Apply at frame boundary is common to samples, and each sample supplies hooks that recreate or re-initialize its own modules.
+// Gap of frames (from last frame before reconfiguration to first frame after reconfiguration) is measured and logged.
+//
+// #include "reconfig.h"
+//
+// reconfig::Reconfigurator reconfigurator;
+// reconfigurator.setLog( &std::cout );
+// reconfigurator.set( "Realsense2Module.RGB.ProcessWidth", "848" ); /* any thread */
+//
+// reconfig::Hooks hooks;
+// hooks.set = []( const std::string& key, const std::string& value ){ tdv::nuitrack::Nuitrack::setConfigValue( key, value ); };
+// hooks.recreate = [&]( const reconfig::Change& change ){ /* recreate modules that change.affects() */ };
+// hooks.reinitialize = [&](){ /* release, init and run NuiTrack */ };
+//
+// while( true ){
+//     update();
+//     reconfigurator.update( color_updated, pacer.getInterval() ); /* measures gap */
+//     if( reconfigurator.pending() ){
+//         const reconfig::Change change = reconfigurator.apply( hooks );
+//     }
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __RECONFIG__
+#define __RECONFIG__
+
+#include <map>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+#include <functional>
+
+namespace reconfig
+{
+    typedef std::chrono::steady_clock clock;
+    typedef std::map<std::string, std::string> Config;
+
+    // Modules of NuiTrack (Bit Mask)
+    enum Module : uint32_t
+    {
+        COLOR = 1u << 0,
+        DEPTH = 1u << 1,
+        USER = 1u << 2,
+        SKELETON = 1u << 3,
+        HAND = 1u << 4,
+        GESTURE = 1u << 5,
+        TRACKERS = USER | SKELETON | HAND | GESTURE,
+        RESTART = 1u << 31 // config can't be applied to running modules (re-initialize NuiTrack)
+    };
+
+    // Rule of Config Key (Modules that Read Key at Creation)
+    struct Rule
+    {
+        std::string prefix; // key or prefix of keys
+        uint32_t modules;
+    };
+
+    // Rules of RealSense D400 Series (Trackers run on Depth, Keys that Match No Rule Require Re-Initialize)
+    static const std::vector<reconfig::Rule> RULES = {
+        { "Realsense2Module.RGB.", reconfig::COLOR },
+        { "Realsense2Module.Depth.", reconfig::DEPTH | reconfig::TRACKERS },
+        { "Realsense2Module.Depth2ColorRegistration", reconfig::DEPTH | reconfig::TRACKERS },
+        { "DepthProvider.Depth2ColorRegistration", reconfig::DEPTH | reconfig::TRACKERS }
+    };
+
+    // Change of Config
+    struct Change
+    {
+        reconfig::Config diff; // keys whose values differ from applied config
+        uint32_t modules = 0; // affected modules
+
+        // Module is Affected by Change
+        bool affects( const uint32_t module ) const
+        {
+            return ( modules & module ) != 0;
+        }
+
+        bool empty() const
+        {
+            return diff.empty();
+        }
+    };
+
+    // Hooks of Sample (Modules of NuiTrack that Sample Uses)
+    struct Hooks
+    {
+        std::function<void( const std::string&, const std::string& )> set; // set config value (e.g. Nuitrack::setConfigValue)
+        std::function<void( const reconfig::Change& )> recreate; // recreate affected sensors and trackers, and reset their sequences
+        std::function<void()> reinitialize; // release and initialize NuiTrack with applied config, and reset all sequences
+        std::function<void( const reconfig::Change& )> applied; // update buffers derived from modules after change (optional)
+    };
+
+    // Report of Reconfiguration
+    struct Report
+    {
+        reconfig::Change change;
+        double apply = 0.0; // seconds to apply change
+        double gap = 0.0; // seconds from last frame before reconfiguration to first frame after reconfiguration
+        int32_t frames = 0; // frames missed in gap
+    };
+
+    // Reconfigurator of NuiTrack
+    class Reconfigurator
+    {
+    private:
+        std::vector<reconfig::Rule> rules;
+        reconfig::Config requested; // pending changes
+        reconfig::Config applied; // config applied by reconfiguration (overrides initial config)
+        bool registration = false; // depth is registered to color (depth follows color resolution)
+        std::ostream* log = nullptr;
+        std::mutex mutex;
+
+        // Gap
+        clock::time_point last; // time of last new frame
+        bool received = false;
+        clock::time_point begun;
+        clock::time_point ended;
+        bool measuring = false;
+        reconfig::Report report;
+
+    public:
+        // Constructor
+        Reconfigurator( const std::vector<reconfig::Rule>& rules = reconfig::RULES );
+
+        // Request Change of Config (Thread Safe, Applied at Next Frame Boundary)
+        void set( const std::string& key, const std::string& value );
+        void set( const reconfig::Config& config );
+
+        // Set Registration of Depth to Color (Depth follows Color Resolution)
+        void setRegistration( const bool registration );
+
+        // Set Log Stream of Reconfigurations (nullptr disables)
+        void setLog( std::ostream* log )
+        {
+            this->log = log;
+        }
+
+        // Change is Pending
+        bool pending();
+
+        // Begin Reconfiguration (Returns Diff against Applied Config and Affected Modules)
+        reconfig::Change begin();
+
+        // End Reconfiguration (Gap is Measured until Next New Frame)
+        void end();
+
+        // Apply Changed Config at Frame Boundary (Returns Applied Change, Empty if Nothing was Changed)
+        // Changed config is set and affected modules are recreated by hooks if hot is true and keys allow it,
+        // otherwise NuiTrack is re-initialized by hooks and RESTART is added to modules of change.
+        reconfig::Change apply( const reconfig::Hooks& hooks, const bool hot = true );
+
+        // Update at New Frame (Returns true when gap of reconfiguration was measured)
+        // updated is true if base stream has new frame, interval is frame interval (seconds).
+        bool update( const bool updated, const double interval );
+
+        // Config Applied by Reconfiguration (Re-Apply after Re-Initialize)
+        reconfig::Config getConfig();
+
+        // Last Report
+        const reconfig::Report& getReport() const
+        {
+            return report;
+        }
+
+    private:
+        // Modules that Read Key
+        uint32_t modules( const std::string& key ) const;
+    };
+
+    // Names of Modules
+    std::string names( const uint32_t modules );
+}
+
+#endif // __RECONFIG__
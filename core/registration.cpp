@@ -0,0 +1,131 @@
+#include "registration.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace registration
+{
+    // Minimum Number of Pixels per Task of Parallel Loop
+    static const int32_t GRAIN = 4096;
+
+    // Set Calibration
+    // Mapping table is rebuilt only when calibration is changed.
+    void Registrator::setCalibration( const int32_t depth_width, const int32_t depth_height, const camera::Intrinsics& depth_intrinsics,
+                                      const int32_t color_width, const int32_t color_height, const camera::Intrinsics& color_intrinsics,
+                                      const camera::Extrinsics& extrinsics )
+    {
+        if( this->depth_width == depth_width && this->depth_height == depth_height && this->depth_intrinsics == depth_intrinsics &&
+            this->color_width == color_width && this->color_height == color_height && this->color_intrinsics == color_intrinsics &&
+            this->extrinsics == extrinsics ){
+            return;
+        }
+
+        this->depth_width = depth_width;
+        this->depth_height = depth_height;
+        this->depth_intrinsics = depth_intrinsics;
+        this->color_width = color_width;
+        this->color_height = color_height;
+        this->color_intrinsics = color_intrinsics;
+        this->extrinsics = extrinsics;
+
+        // Build Mapping Table
+        const float* r = extrinsics.rotation;
+        const int32_t total = depth_width * depth_height;
+        ray_x.resize( total );
+        ray_y.resize( total );
+        ray_z.resize( total );
+        for( int32_t y = 0; y < depth_height; y++ ){
+            const float ry = ( y - depth_intrinsics.cy ) / depth_intrinsics.fy;
+            for( int32_t x = 0; x < depth_width; x++ ){
+                const float rx = ( x - depth_intrinsics.cx ) / depth_intrinsics.fx;
+                const int32_t index = y * depth_width + x;
+                ray_x[index] = r[0] * rx + r[1] * ry + r[2];
+                ray_y[index] = r[3] * rx + r[4] * ry + r[5];
+                ray_z[index] = r[6] * rx + r[7] * ry + r[8];
+            }
+        }
+
+        // Cover color pixels when color image is larger than depth image
+        splat = std::max( 1, static_cast<int32_t>( std::ceil( color_intrinsics.fx / depth_intrinsics.fx ) ) );
+
+        // Allocate Z-Buffers
+        zbuffer_count = parallel::threads();
+        zbuffers.assign( static_cast<size_t>( zbuffer_count ) * color_width * color_height, 0 );
+    }
+
+    // Apply Registration
+    // registered must have ( color_width * color_height ) elements. Pixel that has no depth is 0.
+    void Registrator::apply( const uint16_t* depth_data, uint16_t* registered )
+    {
+        const int32_t depth_total = depth_width * depth_height;
+        const int32_t color_total = color_width * color_height;
+        if( depth_total == 0 || color_total == 0 ){
+            return;
+        }
+
+        // Re-allocate if number of threads was changed (e.g. parallel::setThreads)
+        if( zbuffer_count < parallel::threads() ){
+            zbuffer_count = parallel::threads();
+            zbuffers.assign( static_cast<size_t>( zbuffer_count ) * color_total, 0 );
+        }
+
+        const float tx = extrinsics.translation[0], ty = extrinsics.translation[1], tz = extrinsics.translation[2];
+        const camera::Intrinsics& color = color_intrinsics;
+
+        // Scatter Depth to Z-Buffer of Each Thread
+        parallel::forEach( depth_total, GRAIN, [&]( const int32_t begin, const int32_t end, const int32_t thread ){
+            uint16_t* zbuffer = zbuffers.data() + static_cast<size_t>( thread ) * color_total;
+
+            for( int32_t index = begin; index < end; index++ ){
+                const uint16_t depth = depth_data[index];
+                if( depth == 0 ){
+                    continue;
+                }
+
+                const float z = ray_z[index] * depth + tz;
+                if( z <= 0.0f ){
+                    continue;
+                }
+
+                // Reject Point outside Color Image before Conversion to Integer (Out of Range Conversion is Undefined, NaN is also Rejected)
+                const float inverse = 1.0f / z;
+                const float x = ( ray_x[index] * depth + tx ) * inverse * color.fx + color.cx;
+                const float y = ( ray_y[index] * depth + ty ) * inverse * color.fy + color.cy;
+                if( !( x >= -splat && x < color_width && y >= -splat && y < color_height ) ){
+                    continue;
+                }
+
+                const int32_t u = static_cast<int32_t>( x );
+                const int32_t v = static_cast<int32_t>( y );
+                const uint16_t value = static_cast<uint16_t>( std::min( z + 0.5f, 65535.0f ) );
+
+                const int32_t u_end = std::min( u + splat, color_width ), v_end = std::min( v + splat, color_height );
+                for( int32_t j = std::max( v, 0 ); j < v_end; j++ ){
+                    for( int32_t i = std::max( u, 0 ); i < u_end; i++ ){
+                        uint16_t& nearest = zbuffer[j * color_width + i];
+                        if( nearest == 0 || value < nearest ){
+                            nearest = value;
+                        }
+                    }
+                }
+            }
+        } );
+
+        // Merge Z-Buffers (Nearest Depth Wins)
+        // Z-buffers are cleared here for next frame.
+        parallel::forEach( color_total, GRAIN, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t index = begin; index < end; index++ ){
+                uint16_t nearest = 0;
+                for( int32_t i = 0; i < zbuffer_count; i++ ){
+                    uint16_t& value = zbuffers[static_cast<size_t>( i ) * color_total + index];
+                    if( value != 0 && ( nearest == 0 || value < nearest ) ){
+                        nearest = value;
+                    }
+                    value = 0;
+                }
+                registered[index] = nearest;
+            }
+        } );
+    }
+}
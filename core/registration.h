@@ -0,0 +1,89 @@
+// This is software registration that aligns depth data to color image without Depth2ColorRegistration of NuiTrack.
+// The registered depth is output to uint16_t buffer that has same resolution as color image.
+//
+// #include "registration.h"
+//
+// registration::Registrator registrator;
+// registrator.setCalibration( depth_width, depth_height, depth_intrinsics, color_width, color_height, color_intrinsics, extrinsics );
+//
+// std::vector<uint16_t> registered( color_width * color_height );
+// registrator.apply( depth_frame->getData(), registered.data() );
+//
+// The ray of each depth pixel is rotated into color camera and stored to table when calibration is changed.
+// Each frame costs one multiply-add per coordinate and one projection per valid depth pixel.
+// Depth pixels are scattered to color image in parallel. Each thread has own z-buffer (nearest depth wins),
+// then z-buffers are merged once per frame. There is no atomic operation and no lock.
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __REGISTRATION__
+#define __REGISTRATION__
+
+#include "camera.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace registration
+{
+    class Registrator
+    {
+    private:
+        // Calibration
+        int32_t depth_width = 0;
+        int32_t depth_height = 0;
+        int32_t color_width = 0;
+        int32_t color_height = 0;
+        camera::Intrinsics depth_intrinsics;
+        camera::Intrinsics color_intrinsics;
+        camera::Extrinsics extrinsics;
+
+        // Mapping Table
+        // Ray of each depth pixel in color camera. ( Point in color camera = ray * depth + translation )
+        std::vector<float> ray_x;
+        std::vector<float> ray_y;
+        std::vector<float> ray_z;
+
+        // Splat Size (Color Pixels per Depth Pixel)
+        int32_t splat = 1;
+
+        // Z-Buffers of Each Thread
+        std::vector<uint16_t> zbuffers;
+        int32_t zbuffer_count = 0;
+
+    public:
+        // Set Calibration
+        // Mapping table is rebuilt only when calibration is changed.
+        void setCalibration( const int32_t depth_width, const int32_t depth_height, const camera::Intrinsics& depth_intrinsics,
+                             const int32_t color_width, const int32_t color_height, const camera::Intrinsics& color_intrinsics,
+                             const camera::Extrinsics& extrinsics );
+
+        // Apply Registration
+        // registered must have ( color_width * color_height ) elements. Pixel that has no depth is 0.
+        void apply( const uint16_t* depth_data, uint16_t* registered );
+    };
+}
+
+#endif // __REGISTRATION__
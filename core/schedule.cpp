@@ -0,0 +1,186 @@
+#include "schedule.h"
+
+#include <iomanip>
+#include <algorithm>
+
+namespace schedule
+{
+    // Seconds to Duration of Clock
+    static inline clock::duration duration( const double seconds )
+    {
+        return std::chrono::duration_cast<clock::duration>( std::chrono::duration<double>( seconds ) );
+    }
+
+    // Duration of Clock to Seconds
+    static inline double seconds( const clock::duration& duration )
+    {
+        return std::chrono::duration_cast<std::chrono::duration<double>>( duration ).count();
+    }
+
+    // Add Consumer (Returns Index of Consumer)
+    uint32_t Scheduler::add( const std::string& name, const double rate, const int32_t priority )
+    {
+        Consumer consumer;
+        consumer.name = name;
+        consumer.rate = std::max( rate, 0.0 );
+        consumer.priority = priority;
+        consumer.next = frame; // consumer that is added after first frame is due in next frame
+        consumers.push_back( consumer );
+        return static_cast<uint32_t>( consumers.size() - 1 );
+    }
+
+    // Set Target Rate of Consumer (Hz, 0 runs every frame)
+    void Scheduler::setRate( const uint32_t consumer, const double rate )
+    {
+        consumers[consumer].rate = std::max( rate, 0.0 );
+        consumers[consumer].next = frame;
+    }
+
+    // Set Priority of Consumer
+    void Scheduler::setPriority( const uint32_t consumer, const int32_t priority )
+    {
+        consumers[consumer].priority = priority;
+    }
+
+    // Plan Consumers of New Frame (Call once per new frame before consumers)
+    void Scheduler::plan( const clock::time_point& now )
+    {
+        if( !started ){
+            // Stagger First Times of Rate Limited Consumers over Their Periods
+            const size_t limited = static_cast<size_t>( std::count_if( consumers.begin(), consumers.end(), []( const Consumer& consumer ){ return consumer.rate > 0.0; } ) );
+            size_t index = 0;
+            for( Consumer& consumer : consumers ){
+                if( consumer.rate > 0.0 ){
+                    consumer.next = now + duration( static_cast<double>( index++ ) / limited / consumer.rate );
+                }
+            }
+            started = true;
+            previous = now;
+        }
+        else{
+            const double elapsed = seconds( now - frame );
+            interval = ( interval <= 0.0 ) ? elapsed : interval * 0.9 + elapsed * 0.1;
+        }
+        frame = now;
+
+        // Consumers of Every Frame are Due, Others are Candidates if Next Time comes within Half Frame
+        const clock::time_point horizon = now + duration( interval * 0.5 );
+        double spent = 0.0;
+        candidates.clear();
+        for( uint32_t index = 0; index < consumers.size(); index++ ){
+            Consumer& consumer = consumers[index];
+            consumer.due = false;
+            if( consumer.rate <= 0.0 ){
+                consumer.due = true;
+                spent += consumer.cost;
+            }
+            else if( consumer.next <= horizon ){
+                candidates.push_back( index );
+            }
+        }
+
+        // Higher Priority First, Most Late First in Same Priority
+        std::sort( candidates.begin(), candidates.end(), [&]( const uint32_t a, const uint32_t b ){
+            if( consumers[a].priority != consumers[b].priority ){
+                return consumers[a].priority > consumers[b].priority;
+            }
+            return consumers[a].next < consumers[b].next;
+        } );
+
+        // Run Candidates within Budget (Consumer Late by Whole Period Runs Regardless of Budget)
+        for( const uint32_t index : candidates ){
+            Consumer& consumer = consumers[index];
+            const bool overdue = seconds( now - consumer.next ) * consumer.rate >= 1.0;
+            if( budget <= 0.0 || spent + consumer.cost <= budget || overdue ){
+                consumer.due = true;
+                spent += consumer.cost;
+            }
+            else{
+                consumer.deferred++;
+            }
+        }
+    }
+
+    // Record Run of Consumer (Elapsed seconds)
+    void Scheduler::done( const uint32_t consumer, const double elapsed )
+    {
+        Consumer& target = consumers[consumer];
+        target.due = false;
+        target.runs++;
+        target.elapsed += elapsed;
+        target.cost = ( target.cost <= 0.0 ) ? elapsed : target.cost * 0.8 + elapsed * 0.2;
+
+        // Next Time keeps Cadence (Run that was Deferred doesn't Shift Later Runs), unless Consumer fell behind by Whole Period
+        if( target.rate > 0.0 ){
+            const clock::duration period = duration( 1.0 / target.rate );
+            target.next += period;
+            if( target.next <= frame ){
+                target.next = frame + period;
+            }
+        }
+    }
+
+    // Summarize Achieved Rates since previous summary
+    std::vector<schedule::Rate> Scheduler::summarize()
+    {
+        const clock::time_point now = clock::now();
+        const double elapsed = seconds( now - previous );
+        previous = now;
+
+        std::vector<schedule::Rate> rates;
+        rates.reserve( consumers.size() );
+        for( Consumer& consumer : consumers ){
+            schedule::Rate rate;
+            rate.name = consumer.name;
+            rate.target = consumer.rate;
+            rate.achieved = ( elapsed > 0.0 ) ? consumer.runs / elapsed : 0.0;
+            rate.mean = ( consumer.runs > 0 ) ? consumer.elapsed * 1000.0 / consumer.runs : 0.0;
+            rate.runs = consumer.runs;
+            rate.deferred = consumer.deferred;
+            rates.push_back( rate );
+
+            consumer.runs = 0;
+            consumer.deferred = 0;
+            consumer.elapsed = 0.0;
+        }
+
+        return rates;
+    }
+
+    // Write Achieved Rates if interval (seconds) has elapsed since previous summary
+    bool Scheduler::report( std::ostream& os, const double interval )
+    {
+        if( !started ){
+            return false;
+        }
+
+        const double elapsed = seconds( clock::now() - previous );
+        if( elapsed < interval ){
+            return false;
+        }
+
+        const std::vector<schedule::Rate> rates = summarize();
+
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << "schedule (" << std::fixed << std::setprecision( 1 ) << elapsed << " s, frame " << this->interval * 1000.0 << " ms)" << std::endl;
+        os << "  " << std::left << std::setw( 40 ) << "consumer" << std::right
+           << std::setw( 10 ) << "target Hz" << std::setw( 10 ) << "Hz" << std::setw( 10 ) << "mean ms" << std::setw( 10 ) << "deferred" << std::endl;
+        for( const schedule::Rate& rate : rates ){
+            os << "  " << std::left << std::setw( 40 ) << rate.name << std::right;
+            if( rate.target > 0.0 ){
+                os << std::setprecision( 1 ) << std::setw( 10 ) << rate.target;
+            }
+            else{
+                os << std::setw( 10 ) << "frame";
+            }
+            os << std::setprecision( 1 ) << std::setw( 10 ) << rate.achieved
+               << std::setprecision( 3 ) << std::setw( 10 ) << rate.mean
+               << std::setw( 10 ) << rate.deferred << std::endl;
+        }
+        os.flags( flags );
+        os.precision( precision );
+
+        return true;
+    }
+}
@@ -0,0 +1,165 @@
+// This is scheduler that runs each consumer of frames (e.g. face parse, tracker overlay) at its own target rate.
+// Consumers with rate 0 run every frame. Other consumers run when their next time comes within half a frame,
+// and their first times are staggered over their periods, so that heavy consumers fall on different frames.
+// If frame budget is set, due consumers run in order of priority (most late first in same priority) until estimated cost reaches budget,
+// and others are deferred to next frame. (Consumer that is late by whole period runs regardless of budget)
+//
+// #include "schedule.h"
+//
+// schedule::Scheduler scheduler;
+// const uint32_t face = scheduler.add( "face", 10.0 /* Hz */, 0 /* priority */ );
+//
+// while( true ){
+//     update();
+//     if( color_updated ){
+//         scheduler.plan();
+//     }
+//     if( scheduler.due( face ) ){
+//         const schedule::Run run( scheduler, face );
+//         parseFace();
+//     }
+//     scheduler.report( std::cout, 5.0 ); /* print achieved rates every 5 seconds */
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __SCHEDULE__
+#define __SCHEDULE__
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+namespace schedule
+{
+    typedef std::chrono::steady_clock clock;
+
+    // Achieved Rate of Consumer (Since Previous Summary)
+    struct Rate
+    {
+        std::string name;
+        double target; // Hz (0 is every frame)
+        double achieved; // Hz
+        double mean; // milliseconds per run
+        uint64_t runs;
+        uint64_t deferred; // frames that consumer was due but deferred by budget
+    };
+
+    // Scheduler of Consumers
+    class Scheduler
+    {
+    private:
+        struct Consumer
+        {
+            std::string name;
+            double rate = 0.0; // Hz
+            int32_t priority = 0;
+            clock::time_point next;
+            bool due = false;
+            double cost = 0.0; // estimated seconds per run (moving average)
+
+            // Since Previous Summary
+            uint64_t runs = 0;
+            uint64_t deferred = 0;
+            double elapsed = 0.0; // seconds
+        };
+        std::vector<Consumer> consumers;
+        std::vector<uint32_t> candidates;
+        double budget = 0.0; // seconds per frame (0 is unlimited)
+
+        // Frames
+        bool started = false;
+        clock::time_point frame; // time of current frame
+        double interval = 0.0; // estimated frame interval (seconds)
+        clock::time_point previous; // time of previous summary
+
+    public:
+        // Add Consumer (Returns Index of Consumer)
+        // rate is target rate (Hz), 0 runs every frame. Higher priority runs first when frame budget is short.
+        uint32_t add( const std::string& name, const double rate = 0.0, const int32_t priority = 0 );
+
+        // Set Target Rate of Consumer (Hz, 0 runs every frame)
+        void setRate( const uint32_t consumer, const double rate );
+
+        // Set Priority of Consumer
+        void setPriority( const uint32_t consumer, const int32_t priority );
+
+        // Set Frame Budget for Consumers (seconds, 0 is unlimited)
+        void setBudget( const double budget )
+        {
+            this->budget = budget;
+        }
+
+        // Plan Consumers of New Frame (Call once per new frame before consumers)
+        void plan( const clock::time_point& now = clock::now() );
+
+        // Check Consumer is Planned and has not Run in Current Frame
+        bool due( const uint32_t consumer ) const
+        {
+            return consumers[consumer].due;
+        }
+
+        // Record Run of Consumer (Elapsed seconds)
+        void done( const uint32_t consumer, const double elapsed );
+
+        // Summarize Achieved Rates since previous summary
+        std::vector<schedule::Rate> summarize();
+
+        // Write Achieved Rates if interval (seconds) has elapsed since previous summary
+        bool report( std::ostream& os, const double interval );
+
+        // Estimated Frame Interval (seconds)
+        double getInterval() const
+        {
+            return interval;
+        }
+    };
+
+    // Run of Consumer (Scope is Recorded as Run)
+    class Run
+    {
+    private:
+        schedule::Scheduler& scheduler;
+        uint32_t consumer;
+        clock::time_point start;
+
+    public:
+        Run( schedule::Scheduler& scheduler, const uint32_t consumer )
+            : scheduler( scheduler ), consumer( consumer ), start( clock::now() ){}
+
+        ~Run()
+        {
+            scheduler.done( consumer, std::chrono::duration<double>( clock::now() - start ).count() );
+        }
+
+        Run( const Run& ) = delete;
+        Run& operator=( const Run& ) = delete;
+    };
+}
+
+#endif // __SCHEDULE__
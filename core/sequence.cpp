@@ -0,0 +1,89 @@
+#include "sequence.h"
+
+#include <cmath>
+
+namespace sequence
+{
+    // Constructor
+    Stream::Stream( const std::string& name )
+        : name( name ), frames_counter( name + " frames" ), duplicates_counter( name + " duplicate frames" ), dropped_counter( name + " dropped frames" )
+    {
+    }
+
+    // Update Sequence with Frame ID and Timestamp (Returns true if frame is new)
+    bool Stream::update( const uint64_t id, const uint64_t timestamp )
+    {
+        // First Frame
+        if( first ){
+            first = false;
+            last_id = id;
+            last_timestamp = timestamp;
+            frames++;
+            frames_counter.add();
+            return true;
+        }
+
+        // Duplicate Frame
+        if( id == last_id && timestamp == last_timestamp ){
+            duplicates++;
+            duplicates_counter.add();
+            return false;
+        }
+
+        // Restart (Timestamp went Backward, e.g. Sensor was Reconnected)
+        if( timestamp < last_timestamp ){
+            restarts++;
+            ids = false;
+            interval = 0.0;
+            last_id = id;
+            last_timestamp = timestamp;
+            frames++;
+            frames_counter.add();
+            return true;
+        }
+
+        // Dropped Frames between Previous Frame
+        // Gap of ID if stream has ID, otherwise gap of timestamp divided by estimated interval.
+        const double delta = static_cast<double>( timestamp - last_timestamp );
+        ids = ids || id != last_id;
+        uint64_t missed = 0;
+        if( ids && id > last_id ){
+            missed = id - last_id - 1;
+        }
+        else if( interval > 0.0 ){
+            const double gap = std::floor( delta / interval + 0.5 );
+            missed = gap > 1.0 ? static_cast<uint64_t>( gap ) - 1 : 0;
+        }
+
+        // Estimate Frame Interval (Exponential Moving Average of Interval per Frame)
+        if( delta > 0.0 ){
+            const double sample = delta / ( missed + 1 );
+            interval = ( interval > 0.0 ) ? interval * 0.9 + sample * 0.1 : sample;
+        }
+
+        if( missed > 0 ){
+            dropped += missed;
+            dropped_counter.add( missed );
+        }
+
+        last_id = id;
+        last_timestamp = timestamp;
+        frames++;
+        frames_counter.add();
+        return true;
+    }
+
+    // Update Sequence with Timestamp (Stream has no frame ID)
+    bool Stream::update( const uint64_t timestamp )
+    {
+        return update( 0, timestamp );
+    }
+
+    // Reset Sequence (Counts are kept)
+    void Stream::reset()
+    {
+        first = true;
+        ids = false;
+        interval = 0.0;
+    }
+}
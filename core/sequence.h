@@ -0,0 +1,121 @@
+// This is frame sequencing that detects new, duplicate and dropped frames of stream from frame ID and timestamp.
+// Nuitrack::update() doesn't guarantee that each sensor has new frame, so samples skip conversion of duplicate frame.
+//
+// #include "sequence.h"
+//
+// sequence::Stream color_sequence( "color" );
+//
+// color_frame = color_sensor->getColorFrame();
+// if( !color_sequence.update( color_frame->getID(), color_frame->getTimestamp() ) ){
+//     return; /* same frame as previous, skip conversion */
+// }
+//
+// Dropped frames are counted from gap of frame ID, or from gap of timestamp (estimated frame interval) if stream has no ID.
+// Counts of each stream are published as profile counters ("<name> frames", "<name> duplicate frames", "<name> dropped frames").
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __SEQUENCE__
+#define __SEQUENCE__
+
+#include <string>
+#include <cstdint>
+
+#include "profile.h"
+
+namespace sequence
+{
+    // Sequence of Frames in Stream
+    class Stream
+    {
+    private:
+        std::string name;
+        bool first = true;
+        bool ids = false; // stream has frame ID
+        uint64_t last_id = 0;
+        uint64_t last_timestamp = 0;
+        double interval = 0.0; // estimated frame interval (timestamp units)
+
+        uint64_t frames = 0;
+        uint64_t duplicates = 0;
+        uint64_t dropped = 0;
+        uint64_t restarts = 0;
+
+        profile::Counter frames_counter;
+        profile::Counter duplicates_counter;
+        profile::Counter dropped_counter;
+
+    public:
+        // Constructor
+        Stream( const std::string& name );
+
+        // Update Sequence with Frame ID and Timestamp (Returns true if frame is new)
+        bool update( const uint64_t id, const uint64_t timestamp );
+
+        // Update Sequence with Timestamp (Stream has no frame ID)
+        bool update( const uint64_t timestamp );
+
+        // Reset Sequence (Counts are kept)
+        void reset();
+
+        const std::string& getName() const
+        {
+            return name;
+        }
+
+        // Number of New Frames
+        uint64_t getFrames() const
+        {
+            return frames;
+        }
+
+        // Number of Duplicate Frames (Same Frame was Retrieved Again)
+        uint64_t getDuplicates() const
+        {
+            return duplicates;
+        }
+
+        // Number of Dropped Frames (Frames that were never Retrieved)
+        uint64_t getDropped() const
+        {
+            return dropped;
+        }
+
+        // Number of Restarts (Timestamp went Backward)
+        uint64_t getRestarts() const
+        {
+            return restarts;
+        }
+
+        // Estimated Frame Interval (Timestamp Units)
+        double getInterval() const
+        {
+            return interval;
+        }
+    };
+}
+
+#endif // __SEQUENCE__
@@ -0,0 +1,117 @@
+#include "shedding.h"
+
+#include <iomanip>
+#include <algorithm>
+
+namespace shedding
+{
+    // Constructor
+    Controller::Controller( const shedding::Parameters& parameters )
+        : parameters( parameters ), window( parameters.window )
+    {
+        event.budget = budget;
+    }
+
+    // Add Stage (Returns Index of Stage, Stages are Shed in Order of Registration)
+    uint32_t Controller::add( const std::string& name )
+    {
+        Stage stage;
+        stage.name = name;
+        stages.push_back( stage );
+        return static_cast<uint32_t>( stages.size() - 1 );
+    }
+
+    // Set Frame Budget (seconds, e.g. Frame Interval of Sensor)
+    void Controller::setBudget( const double budget )
+    {
+        if( budget > 0.0 ){
+            this->budget = budget;
+        }
+    }
+
+    // Restart Measurement (e.g. after Processing Resolution was Changed)
+    void Controller::restart()
+    {
+        window.clear();
+
+        // Saving of Stage is Measured Again at New Resolution
+        for( Stage& stage : stages ){
+            stage.saving = -1.0;
+        }
+    }
+
+    // Update Controller at End of Loop (Returns true if stage was shed or restored)
+    bool Controller::update( const bool processed, const double frame_time )
+    {
+        if( !processed ){
+            return false;
+        }
+
+        // Window of Frame Times
+        window.add( frame_time );
+        if( !window.completed() ){
+            return false;
+        }
+
+        // Evaluate Window
+        const double p50 = window.percentile( 0.5 );
+        const double p90 = window.percentile( 0.9 );
+
+        // Measure Saving of Last Shed Stage (First Window after Shed)
+        if( level > 0 && stages[level - 1].saving < 0.0 ){
+            stages[level - 1].saving = std::max( stages[level - 1].before - p90, 0.0 );
+        }
+
+        const bool overrun = p90 > budget * parameters.high;
+        if( overrun && level < stages.size() ){
+            // Shed Next Stage Immediately
+            stages[level].before = p90;
+            stages[level].saving = -1.0;
+            change( level + 1, p50, p90 );
+            return true;
+        }
+
+        if( !overrun && level > 0 && window.getFrames() >= parameters.cooldown ){
+            // Restore Last Shed Stage if Predicted Frame Time (Plus Saving of Stage) Fits in Budget with Margin
+            const double saving = std::max( stages[level - 1].saving, 0.0 );
+            if( p90 + saving < budget * parameters.low ){
+                change( level - 1, p50, p90 );
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Change Level and Log Event
+    void Controller::change( const uint32_t level, const double p50, const double p90 )
+    {
+        const bool shed = level > this->level;
+        const Stage& stage = stages[shed ? this->level : level];
+
+        event.stage = stage.name;
+        event.shed = shed;
+        event.level = level;
+        event.p50 = p50;
+        event.p90 = p90;
+        event.saving = shed ? 0.0 : std::max( stage.saving, 0.0 );
+        event.budget = budget;
+        event.time = std::chrono::duration<double>( shedding::clock::now() - start ).count();
+
+        if( log ){
+            const std::ios::fmtflags flags = log->flags();
+            const std::streamsize precision = log->precision();
+            *log << "shedding " << ( shed ? "shed" : "restore" ) << " " << event.stage << " (level " << level << "/" << stages.size()
+                 << std::fixed << std::setprecision( 2 ) << ", p50 " << p50 * 1000.0 << " ms, p90 " << p90 * 1000.0 << " ms";
+            if( !shed ){
+                *log << ", saving " << event.saving * 1000.0 << " ms";
+            }
+            *log << ", budget " << budget * 1000.0 << " ms, at " << std::setprecision( 1 ) << event.time << " s)" << std::endl;
+            log->flags( flags );
+            log->precision( precision );
+        }
+
+        this->level = level;
+        window.clear();
+    }
+}
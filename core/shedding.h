@@ -0,0 +1,162 @@
+// This is load shedding controller that sheds optional work of main loop (e.g. overlays, display rate) under CPU overload.
+// Frame time excludes idle time (waiting for sensor or pacing, frametime::Meter), and percentiles of frame time are evaluated every window.
+// If p90 exceeds budget, next stage is shed in order of registration (first registered is shed first).
+// Last shed stage is restored if p90 plus measured saving of that stage fits in budget with margin for long enough (hysteresis),
+// so that work comes back one stage at a time. Each shed and restore is logged with frame time percentiles and budget.
+//
+// #include "shedding.h"
+//
+// frametime::Meter meter;
+// shedding::Controller shedding;
+// const uint32_t overlay = shedding.add( "user overlay" );
+// const uint32_t display = shedding.add( "display rate" );
+// shedding.setLog( &std::cout );
+//
+// while( true ){
+//     update(); /* wrap waiting with const frametime::Idle idle( meter ); */
+//     if( !shedding.isShed( overlay ) ){
+//         drawOverlay();
+//     }
+//     meter.update( updated );
+//     shedding.update( updated, meter.get() );
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __SHEDDING__
+#define __SHEDDING__
+
+#include "frametime.h"
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+namespace shedding
+{
+    typedef std::chrono::steady_clock clock;
+
+    // Parameters of Controller
+    struct Parameters
+    {
+        int32_t window = 30; // number of frames to evaluate
+        double high = 0.8; // shed next stage if p90 of frame time exceeds budget * high (under quality::Parameters::high, so work is shed before resolution goes down)
+        double low = 0.6; // restore last stage if p90 plus its saving is under budget * low
+        int32_t cooldown = 150; // minimum number of frames to stay before restoring
+    };
+
+    // Event of Controller
+    struct Event
+    {
+        std::string stage;
+        bool shed = false; // shed (true) or restored (false)
+        uint32_t level = 0; // number of shed stages after event
+        double p50 = 0.0; // seconds
+        double p90 = 0.0; // seconds
+        double saving = 0.0; // measured saving of stage (seconds, restore only)
+        double budget = 0.0; // seconds
+        double time = 0.0; // seconds since start
+    };
+
+    // Controller of Load Shedding
+    class Controller
+    {
+    private:
+        // Stage of Shedding
+        struct Stage
+        {
+            std::string name;
+            double before = 0.0; // p90 before stage was shed (seconds)
+            double saving = -1.0; // p90 saved by shedding stage (seconds, negative is not measured yet)
+        };
+
+        std::vector<Stage> stages;
+        uint32_t level = 0; // number of shed stages
+        shedding::Parameters parameters;
+        double budget = 1.0 / 30.0; // seconds
+        std::ostream* log = nullptr;
+        clock::time_point start = clock::now();
+
+        // Frame Time
+        frametime::Window window; // frames since previous change
+
+        shedding::Event event;
+
+    public:
+        // Constructor
+        Controller( const shedding::Parameters& parameters = shedding::Parameters() );
+
+        // Add Stage (Returns Index of Stage, Stages are Shed in Order of Registration)
+        uint32_t add( const std::string& name );
+
+        // Set Frame Budget (seconds, e.g. Frame Interval of Sensor)
+        void setBudget( const double budget );
+
+        // Set Log Stream of Events (nullptr disables)
+        void setLog( std::ostream* log )
+        {
+            this->log = log;
+        }
+
+        // Update Controller at End of Loop (Returns true if stage was shed or restored)
+        // processed is true if new frame was processed in this loop, frame_time is its frame time (seconds, frametime::Meter).
+        bool update( const bool processed, const double frame_time );
+
+        // Restart Measurement (e.g. after Processing Resolution was Changed)
+        void restart();
+
+        // Stage is Shed
+        bool isShed( const uint32_t stage ) const
+        {
+            return stage < level;
+        }
+
+        // Number of Shed Stages
+        uint32_t getLevel() const
+        {
+            return level;
+        }
+
+        double getBudget() const
+        {
+            return budget;
+        }
+
+        // Last Event
+        const shedding::Event& getEvent() const
+        {
+            return event;
+        }
+
+    private:
+        // Change Level and Log Event
+        void change( const uint32_t level, const double p50, const double p90 );
+    };
+}
+
+#endif // __SHEDDING__
@@ -0,0 +1,280 @@
+// This is table that maps IDs (e.g. user ID of tracker) to compact slots, so that state of each ID (e.g. color, smoothing filter, cache of attributes) can live in fixed storage.
+// IDs are placed by open addressing (linear probing), so that ID of any value (large ID of long session, ID of other device) is found without indexing array by ID.
+// Slot of ID that hasn't been acquired for retention frames is released and recycled by next new ID, and storage grows only when all slots are in use.
+// Table is not thread-safe (use one table per thread, e.g. per pipeline of device).
+//
+// #include "slots.h"
+//
+// slots::Table<cv::Vec3b> colors;
+//
+// colors.age(); /* once per frame, releases IDs that are gone */
+// for( const tdv::nuitrack::User& user : users ){
+//     bool inserted = false;
+//     const uint32_t slot = colors.acquire( user.id, &inserted );
+//     if( inserted ){
+//         colors.at( slot ) = palette[slot % palette.size()];
+//     }
+//     draw( user, colors.at( slot ) );
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __SLOTS__
+#define __SLOTS__
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace slots
+{
+    // Slot of ID that is not in Table
+    static const uint32_t NONE = 0xFFFFFFFF;
+
+    // Table of IDs to Slots
+    template<typename T>
+    class Table
+    {
+    private:
+        // Bucket of Open Addressing
+        struct Bucket
+        {
+            int32_t id = 0;
+            uint32_t slot = slots::NONE; // empty
+        };
+
+        std::vector<Bucket> buckets; // power of two, at least twice number of slots (load factor <= 0.5)
+        std::vector<T> values; // value of each slot
+        std::vector<int32_t> ids; // ID of each slot
+        std::vector<uint64_t> seen; // frame of last acquire of each slot
+        std::vector<uint8_t> used; // slot is in use
+        std::vector<uint32_t> released; // slots that can be recycled (stack)
+        uint32_t retention;
+        uint32_t count = 0;
+        uint64_t frame = 0;
+        uint64_t recycled = 0;
+        uint64_t grown = 0;
+
+    public:
+        // Constructor
+        // capacity is initial number of slots, retention is number of frames that slot of ID is kept after last acquire (0 keeps until release).
+        explicit Table( const uint32_t capacity = 8, const uint32_t retention = 30 )
+            : retention( retention )
+        {
+            resize( std::max<uint32_t>( capacity, 1 ) );
+        }
+
+        // Find Slot of ID (Returns slots::NONE if ID is not in Table)
+        uint32_t find( const int32_t id ) const
+        {
+            const uint32_t mask = static_cast<uint32_t>( buckets.size() - 1 );
+            for( uint32_t index = hash( id, mask ); ; index = ( index + 1 ) & mask ){
+                const Bucket& bucket = buckets[index];
+                if( bucket.slot == slots::NONE ){
+                    return slots::NONE;
+                }
+                if( bucket.id == id ){
+                    return bucket.slot;
+                }
+            }
+        }
+
+        // Acquire Slot of ID (ID that is not in Table takes released slot, or new slot, and its value is reset)
+        // inserted is set to true if ID was not in Table, so that caller can initialize value of slot.
+        uint32_t acquire( const int32_t id, bool* inserted = nullptr )
+        {
+            uint32_t slot = find( id );
+            if( inserted ){
+                *inserted = ( slot == slots::NONE );
+            }
+
+            if( slot == slots::NONE ){
+                if( released.empty() ){
+                    resize( static_cast<uint32_t>( values.size() ) * 2 );
+                    grown++;
+                }
+
+                slot = released.back();
+                released.pop_back();
+                if( seen[slot] != 0 ){
+                    recycled++;
+                }
+
+                ids[slot] = id;
+                used[slot] = 1;
+                values[slot] = T();
+                insert( id, slot );
+                count++;
+            }
+
+            seen[slot] = frame + 1; // 0 is never used
+            return slot;
+        }
+
+        // Release Slot of ID (Returns false if ID is not in Table)
+        bool release( const int32_t id )
+        {
+            const uint32_t slot = find( id );
+            if( slot == slots::NONE ){
+                return false;
+            }
+
+            erase( id );
+            used[slot] = 0;
+            released.push_back( slot );
+            count--;
+            return true;
+        }
+
+        // Advance Frame (Call once per frame, Releases IDs that haven't been acquired for retention frames)
+        void age()
+        {
+            frame++;
+            if( retention == 0 ){
+                return;
+            }
+
+            for( uint32_t slot = 0; slot < values.size(); slot++ ){
+                if( used[slot] && frame - ( seen[slot] - 1 ) > retention ){
+                    release( ids[slot] );
+                }
+            }
+        }
+
+        // Value of Slot
+        T& at( const uint32_t slot )
+        {
+            return values[slot];
+        }
+
+        const T& at( const uint32_t slot ) const
+        {
+            return values[slot];
+        }
+
+        // ID of Slot
+        int32_t id( const uint32_t slot ) const
+        {
+            return ids[slot];
+        }
+
+        // Slot is in Use
+        bool contains( const uint32_t slot ) const
+        {
+            return slot < used.size() && used[slot];
+        }
+
+        // Number of IDs in Table
+        uint32_t size() const
+        {
+            return count;
+        }
+
+        // Number of Slots
+        uint32_t capacity() const
+        {
+            return static_cast<uint32_t>( values.size() );
+        }
+
+        // Number of Slots that were Recycled for New ID
+        uint64_t getRecycled() const
+        {
+            return recycled;
+        }
+
+        // Number of Times that Slots were Grown
+        uint64_t getGrown() const
+        {
+            return grown;
+        }
+
+    private:
+        // Hash of ID (Fibonacci Hashing)
+        static uint32_t hash( const int32_t id, const uint32_t mask )
+        {
+            return ( static_cast<uint32_t>( id ) * 2654435769u >> 16 ) & mask;
+        }
+
+        // Insert ID into Buckets (ID is not in Buckets)
+        void insert( const int32_t id, const uint32_t slot )
+        {
+            const uint32_t mask = static_cast<uint32_t>( buckets.size() - 1 );
+            uint32_t index = hash( id, mask );
+            while( buckets[index].slot != slots::NONE ){
+                index = ( index + 1 ) & mask;
+            }
+            buckets[index].id = id;
+            buckets[index].slot = slot;
+        }
+
+        // Erase ID from Buckets (Backward Shift, so that Probe Sequences don't need Tombstones)
+        void erase( const int32_t id )
+        {
+            const uint32_t mask = static_cast<uint32_t>( buckets.size() - 1 );
+            uint32_t hole = hash( id, mask );
+            while( buckets[hole].id != id || buckets[hole].slot == slots::NONE ){
+                hole = ( hole + 1 ) & mask;
+            }
+
+            for( uint32_t index = ( hole + 1 ) & mask; buckets[index].slot != slots::NONE; index = ( index + 1 ) & mask ){
+                // Bucket can move back to hole if its home is not in between hole and itself
+                const uint32_t home = hash( buckets[index].id, mask );
+                if( ( ( index - home ) & mask ) >= ( ( index - hole ) & mask ) ){
+                    buckets[hole] = buckets[index];
+                    hole = index;
+                }
+            }
+            buckets[hole] = Bucket();
+        }
+
+        // Resize Slots (Buckets are Rebuilt, New Slots are Released)
+        void resize( const uint32_t capacity )
+        {
+            const uint32_t previous = static_cast<uint32_t>( values.size() );
+            values.resize( capacity );
+            ids.resize( capacity, 0 );
+            seen.resize( capacity, 0 );
+            used.resize( capacity, 0 );
+            released.reserve( capacity );
+            for( uint32_t slot = capacity; slot > previous; slot-- ){
+                released.push_back( slot - 1 ); // lower slot is taken first
+            }
+
+            uint32_t size = 1;
+            while( size < capacity * 2 ){
+                size <<= 1;
+            }
+            buckets.assign( size, Bucket() );
+            for( uint32_t slot = 0; slot < previous; slot++ ){
+                if( used[slot] ){
+                    insert( ids[slot], slot );
+                }
+            }
+        }
+    };
+}
+
+#endif // __SLOTS__
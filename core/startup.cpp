@@ -0,0 +1,139 @@
+#include "startup.h"
+
+#include <iomanip>
+#include <future>
+#include <exception>
+#include <algorithm>
+
+namespace startup
+{
+    // Seconds since Origin
+    static inline double seconds( const clock::time_point& origin, const clock::time_point& time )
+    {
+        return std::chrono::duration<double>( time - origin ).count();
+    }
+
+    // Record Phase (Phase after First Frame is also Written to Log)
+    void Timeline::record( const std::string& name, const clock::time_point& begin, const clock::time_point& end )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+
+        // Index of Thread
+        const std::thread::id id = std::this_thread::get_id();
+        const std::vector<std::thread::id>::const_iterator it = std::find( threads.begin(), threads.end(), id );
+        const uint32_t thread = static_cast<uint32_t>( it - threads.begin() );
+        if( it == threads.end() ){
+            threads.push_back( id );
+        }
+
+        startup::Phase phase;
+        phase.name = name;
+        phase.begin = seconds( origin, begin );
+        phase.end = seconds( origin, end );
+        phase.thread = thread;
+        phases.push_back( phase );
+
+        if( first >= 0.0 && log ){
+            const std::ios::fmtflags flags = log->flags();
+            const std::streamsize precision = log->precision();
+            *log << "startup " << name << " " << std::fixed << std::setprecision( 2 ) << ( phase.end - phase.begin ) * 1000.0 << " ms (at "
+                 << std::setprecision( 1 ) << phase.begin << " s, after first frame)" << std::endl;
+            log->flags( flags );
+            log->precision( precision );
+        }
+    }
+
+    // Mark First Frame (Returns true only at first call)
+    bool Timeline::markFirstFrame()
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if( first >= 0.0 ){
+            return false;
+        }
+
+        first = seconds( origin, clock::now() );
+        return true;
+    }
+
+    // Phases
+    std::vector<startup::Phase> Timeline::getPhases()
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        return phases;
+    }
+
+    // Write Breakdown of Phases and Time to First Frame
+    void Timeline::report( std::ostream& os )
+    {
+        std::vector<startup::Phase> sorted = getPhases();
+        std::stable_sort( sorted.begin(), sorted.end(), []( const startup::Phase& a, const startup::Phase& b ){ return a.begin < b.begin; } );
+
+        // Sum of Phases (Phases on Other Threads Overlap with Main Thread)
+        double total = 0.0;
+        for( const startup::Phase& phase : sorted ){
+            total += phase.end - phase.begin;
+        }
+
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << std::fixed << std::setprecision( 2 );
+        os << "startup (first frame " << first * 1000.0 << " ms, sum of phases " << total * 1000.0 << " ms)" << std::endl;
+        os << "  " << std::left << std::setw( 40 ) << "phase" << std::right
+           << std::setw( 10 ) << "thread" << std::setw( 12 ) << "begin ms" << std::setw( 12 ) << "ms" << std::endl;
+        for( const startup::Phase& phase : sorted ){
+            os << "  " << std::left << std::setw( 40 ) << phase.name << std::right
+               << std::setw( 10 ) << phase.thread << std::setw( 12 ) << phase.begin * 1000.0 << std::setw( 12 ) << ( phase.end - phase.begin ) * 1000.0 << std::endl;
+        }
+        os.flags( flags );
+        os.precision( precision );
+    }
+
+    // Run Independent Tasks Concurrently (First Task Runs on Calling Thread)
+    void parallel( startup::Timeline& timeline, const std::vector<std::pair<std::string, std::function<void()>>>& tasks, const bool concurrent )
+    {
+        // Run Task as Phase
+        const auto run = [&timeline]( const std::pair<std::string, std::function<void()>>& task ){
+            const startup::Scope scope( timeline, task.first );
+            task.second();
+        };
+
+        if( !concurrent || tasks.size() < 2 ){
+            for( const std::pair<std::string, std::function<void()>>& task : tasks ){
+                run( task );
+            }
+            return;
+        }
+
+        // Launch Other Tasks on Own Threads
+        std::vector<std::future<void>> futures;
+        futures.reserve( tasks.size() - 1 );
+        for( size_t index = 1; index < tasks.size(); index++ ){
+            futures.push_back( std::async( std::launch::async, run, std::cref( tasks[index] ) ) );
+        }
+
+        // Run First Task on Calling Thread
+        std::exception_ptr exception;
+        try{
+            run( tasks[0] );
+        }
+        catch( ... ){
+            exception = std::current_exception();
+        }
+
+        // Wait for All Tasks (First Exception is Rethrown)
+        for( std::future<void>& future : futures ){
+            try{
+                future.get();
+            }
+            catch( ... ){
+                if( !exception ){
+                    exception = std::current_exception();
+                }
+            }
+        }
+
+        if( exception ){
+            std::rethrow_exception( exception );
+        }
+    }
+}
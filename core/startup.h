@@ -0,0 +1,194 @@
+// This is startup timeline that measures phases of startup (e.g. Nuitrack::init, creation of modules) until first frame.
+// Independent modules can be created concurrently, and rarely used modules can be created lazily on first request,
+// so that they are not on the path to first frame. Breakdown of phases and time to first frame are printed at first frame.
+//
+// #include "startup.h"
+//
+// startup::Timeline timeline;
+// timeline.setLog( &std::cout ); /* phases after first frame (e.g. lazily created modules) */
+// startup::parallel( timeline, {
+//     { "ColorSensor::create", [&](){ color_sensor = tdv::nuitrack::ColorSensor::create(); } },
+//     { "SkeletonTracker::create", [&](){ skeleton_tracker = tdv::nuitrack::SkeletonTracker::create(); } }
+// } );
+// startup::Lazy<tdv::nuitrack::GestureRecognizer::Ptr> gesture( "GestureRecognizer::create", [](){ return tdv::nuitrack::GestureRecognizer::create(); }, &timeline );
+//
+// while( true ){
+//     update();
+//     if( updated ){
+//         show();
+//         if( timeline.markFirstFrame() ){
+//             timeline.report( std::cout );
+//         }
+//     }
+//     gesture.get(); /* created on first request */
+// }
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __STARTUP__
+#define __STARTUP__
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string>
+#include <utility>
+#include <ostream>
+#include <cstdint>
+#include <functional>
+
+namespace startup
+{
+    typedef std::chrono::steady_clock clock;
+
+    // Phase of Startup
+    struct Phase
+    {
+        std::string name;
+        double begin = 0.0; // seconds since origin
+        double end = 0.0; // seconds since origin
+        uint32_t thread = 0; // index of thread (0 is thread that created timeline)
+    };
+
+    // Timeline of Startup
+    class Timeline
+    {
+    private:
+        clock::time_point origin = clock::now();
+        std::vector<std::thread::id> threads = { std::this_thread::get_id() };
+        std::vector<startup::Phase> phases;
+        double first = -1.0; // seconds since origin (negative is not reached)
+        std::ostream* log = nullptr;
+        std::mutex mutex;
+
+    public:
+        // Constructor (Origin is Construction Time)
+        Timeline() = default;
+
+        // Set Log Stream of Phases after First Frame (e.g. Lazily Created Modules, nullptr disables)
+        void setLog( std::ostream* log )
+        {
+            this->log = log;
+        }
+
+        // Record Phase (Phase after First Frame is also Written to Log)
+        void record( const std::string& name, const clock::time_point& begin, const clock::time_point& end );
+
+        // Mark First Frame (Returns true only at first call)
+        bool markFirstFrame();
+
+        // Time to First Frame (seconds, negative is not reached)
+        double getFirstFrame() const
+        {
+            return first;
+        }
+
+        // Phases
+        std::vector<startup::Phase> getPhases();
+
+        // Write Breakdown of Phases and Time to First Frame
+        void report( std::ostream& os );
+    };
+
+    // Scope of Phase (Scope is Recorded as Phase)
+    class Scope
+    {
+    private:
+        startup::Timeline& timeline;
+        std::string name;
+        clock::time_point begin;
+
+    public:
+        Scope( startup::Timeline& timeline, const std::string& name )
+            : timeline( timeline ), name( name ), begin( clock::now() )
+        {
+        }
+
+        ~Scope()
+        {
+            timeline.record( name, begin, clock::now() );
+        }
+
+        Scope( const Scope& ) = delete;
+        Scope& operator=( const Scope& ) = delete;
+    };
+
+    // Run Independent Tasks Concurrently (First Task Runs on Calling Thread)
+    // Each task is recorded as phase, and first exception of tasks is rethrown after all tasks finished.
+    // If concurrent is false, tasks run sequentially in order.
+    void parallel( startup::Timeline& timeline, const std::vector<std::pair<std::string, std::function<void()>>>& tasks, const bool concurrent = true );
+
+    // Lazily Created Value (Created by Factory on First Request)
+    template<typename T>
+    class Lazy
+    {
+    private:
+        std::string name;
+        std::function<T()> factory;
+        startup::Timeline* timeline = nullptr;
+        T value = T();
+        bool created = false;
+
+    public:
+        // Constructor
+        Lazy() = default;
+
+        Lazy( const std::string& name, const std::function<T()>& factory, startup::Timeline* timeline = nullptr )
+            : name( name ), factory( factory ), timeline( timeline )
+        {
+        }
+
+        // Retrieve Value (Created on First Request)
+        T& get()
+        {
+            if( !created ){
+                const clock::time_point begin = clock::now();
+                value = factory();
+                created = true;
+                if( timeline ){
+                    timeline->record( name, begin, clock::now() );
+                }
+            }
+            return value;
+        }
+
+        // Value was Created
+        bool isCreated() const
+        {
+            return created;
+        }
+
+        // Discard Value (Created Again on Next Request)
+        void reset()
+        {
+            value = T();
+            created = false;
+        }
+    };
+}
+
+#endif // __STARTUP__
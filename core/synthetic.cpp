@@ -0,0 +1,172 @@
+#include "synthetic.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace synthetic
+{
+    // Maximum Number of Users
+    static const int32_t MAX_USERS = 6;
+
+    // Distance of Back Wall (millimeter)
+    static const float WALL_DISTANCE = 5000.0f;
+
+    // Integer Hash for Noise and Holes
+    static inline uint32_t hash( const uint32_t x, const uint32_t y, const uint32_t z )
+    {
+        uint32_t h = ( x * 0x8da6b343u ) ^ ( y * 0xd8163841u ) ^ ( z * 0xcb1ab31fu );
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+        return h;
+    }
+
+    // Constructor
+    Scene::Scene( const int32_t width, const int32_t height, const int32_t users, const uint32_t seed )
+        : width( width ), height( height ), users( std::min( std::max( users, 0 ), MAX_USERS ) ), seed( seed )
+    {
+    }
+
+    // Retrieve Users of Frame (Nearest First)
+    std::vector<synthetic::User> Scene::getUsers( const uint32_t index ) const
+    {
+        const float focal = getFocal();
+
+        std::vector<synthetic::User> silhouettes( users );
+        for( int32_t user = 0; user < users; user++ ){
+            synthetic::User& silhouette = silhouettes[user];
+            silhouette.id = user + 1;
+            silhouette.distance = 1500.0f + 600.0f * user;
+            silhouette.center_x = width * ( user + 1.0f ) / ( users + 1.0f ) + std::sin( index * 0.05f + user * 1.3f + seed ) * width * 0.08f;
+            silhouette.body_rx = focal * 250.0f / silhouette.distance;
+            silhouette.body_ry = focal * 700.0f / silhouette.distance;
+            silhouette.body_y = height * 0.5f + focal * 200.0f / silhouette.distance;
+            silhouette.head_r = focal * 110.0f / silhouette.distance;
+            silhouette.head_y = silhouette.body_y - silhouette.body_ry - silhouette.head_r * 0.8f;
+        }
+
+        return silhouettes;
+    }
+
+    // Retrieve Focal Length (Horizontal FOV 70 degree)
+    float Scene::getFocal() const
+    {
+        return ( width * 0.5f ) / std::tan( 35.0f * 3.14159265f / 180.0f );
+    }
+
+    // Generate Frame
+    void Scene::generate( const uint32_t index, uint16_t* depth, uint16_t* labels, uint8_t* color ) const
+    {
+        const std::vector<synthetic::User> silhouettes = getUsers( index );
+
+        const float horizon = height * 0.55f;
+
+        parallel::forEach( height, 1, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t y = begin; y < end; y++ ){
+                for( int32_t x = 0; x < width; x++ ){
+                    // Back Wall and Floor
+                    float distance = WALL_DISTANCE;
+                    if( y > horizon ){
+                        distance -= 3800.0f * ( y - horizon ) / ( height - horizon );
+                    }
+
+                    // Users
+                    int32_t label = 0;
+                    for( int32_t user = users - 1; user >= 0; user-- ){
+                        const synthetic::User& silhouette = silhouettes[user];
+                        const float dx = ( x - silhouette.center_x ) / silhouette.body_rx;
+                        const float dy = ( y - silhouette.body_y ) / silhouette.body_ry;
+                        const float body = dx * dx + dy * dy;
+                        const float hx = ( x - silhouette.center_x ) / silhouette.head_r;
+                        const float hy = ( y - silhouette.head_y ) / silhouette.head_r;
+                        const float head = hx * hx + hy * hy;
+                        const float inside = std::min( body, head );
+                        if( inside < 1.0f ){
+                            distance = silhouette.distance - 120.0f * ( 1.0f - inside );
+                            label = user + 1;
+                        }
+                    }
+
+                    const int32_t pixel = y * width + x;
+                    const uint32_t noise = hash( x, y, index ^ seed );
+
+                    if( depth ){
+                        // Noise (+-4mm) and Holes (2%)
+                        int32_t value = static_cast<int32_t>( distance + 0.5f ) + static_cast<int32_t>( noise & 7 ) - 4;
+                        if( ( noise >> 8 ) % 100 < 2 ){
+                            value = 0;
+                        }
+                        depth[pixel] = static_cast<uint16_t>( value );
+                    }
+
+                    if( labels ){
+                        labels[pixel] = static_cast<uint16_t>( label );
+                    }
+
+                    if( color ){
+                        uint8_t* bgr = color + pixel * 3;
+                        if( label == 0 ){
+                            bgr[0] = static_cast<uint8_t>( x * 255 / width );
+                            bgr[1] = static_cast<uint8_t>( y * 255 / height );
+                            bgr[2] = static_cast<uint8_t>( 96 + ( noise & 15 ) );
+                        }
+                        else{
+                            bgr[0] = static_cast<uint8_t>( ( label * 97 + 64 ) & 255 );
+                            bgr[1] = static_cast<uint8_t>( ( label * 53 + 32 ) & 255 );
+                            bgr[2] = static_cast<uint8_t>( ( label * 151 + 128 ) & 255 );
+                        }
+                    }
+                }
+            }
+        } );
+    }
+
+    // Generate Instances JSON
+    std::string instancesJson( const uint32_t index, const int32_t humans, const uint32_t seed )
+    {
+        const int32_t count = std::min( std::max( humans, 0 ), MAX_USERS );
+
+        std::ostringstream json;
+        json << std::fixed << std::setprecision( 6 );
+        json << "{\"Timestamp\": \"" << index * 33333ull << "\", \"Instances\": [";
+
+        for( int32_t human = 0; human < count; human++ ){
+            // Face Rectangle (Normalized Coordinates)
+            const double left = ( human + 0.3 ) / ( count + 0.5 ) + std::sin( index * 0.05 + human + seed ) * 0.02;
+            const double top = 0.2 + 0.01 * ( ( hash( index, human, seed ) & 7 ) / 7.0 );
+            const double width = 0.12;
+            const double height = 0.16;
+
+            json << ( human == 0 ? "" : ", " );
+            json << "{\"id\": \"" << human + 1 << "\", \"class\": \"human\", \"face\": {";
+            json << "\"rectangle\": {\"left\": \"" << left << "\", \"top\": \"" << top << "\", \"width\": \"" << width << "\", \"height\": \"" << height << "\"}, ";
+
+            // 31 Landmarks on Ellipse in Face Rectangle
+            json << "\"landmark\": [";
+            for( int32_t landmark = 0; landmark < 31; landmark++ ){
+                const double angle = landmark * 2.0 * 3.14159265358979 / 31.0;
+                const double x = left + width * ( 0.5 + 0.4 * std::cos( angle ) );
+                const double y = top + height * ( 0.5 + 0.4 * std::sin( angle ) );
+                json << ( landmark == 0 ? "" : ", " ) << "{\"x\": \"" << x << "\", \"y\": \"" << y << "\"}";
+            }
+            json << "], ";
+
+            json << "\"left_eye\": {\"x\": \"" << left + width * 0.3 << "\", \"y\": \"" << top + height * 0.4 << "\"}, ";
+            json << "\"right_eye\": {\"x\": \"" << left + width * 0.7 << "\", \"y\": \"" << top + height * 0.4 << "\"}, ";
+            json << "\"angles\": {\"yaw\": \"" << std::sin( index * 0.1 ) * 20.0 << "\", \"pitch\": \"" << 5.0 << "\", \"roll\": \"" << -2.0 << "\"}, ";
+            json << "\"emotions\": {\"happy\": \"0.700000\", \"neutral\": \"0.200000\", \"angry\": \"0.050000\", \"surprise\": \"0.050000\"}, ";
+            json << "\"age\": {\"type\": \"adult\", \"years\": \"" << 25.0 + human * 5.0 << "\"}, ";
+            json << "\"gender\": \"" << ( human % 2 == 0 ? "male" : "female" ) << "\"";
+            json << "}}";
+        }
+
+        json << "]}";
+
+        return json.str();
+    }
+}
@@ -0,0 +1,109 @@
+// This is deterministic synthetic scene generator that produces frames similar to NuiTrack data.
+// It is used to run frame kernels without sensor (e.g. benchmark).
+// Same (width, height, users, seed, index) always produces same frame.
+//
+// #include "synthetic.h"
+//
+// synthetic::Scene scene( 640, 480, 2 );
+// std::vector<uint16_t> depth( 640 * 480 ), labels( 640 * 480 );
+// std::vector<uint8_t> color( 640 * 480 * 3 );
+// scene.generate( index, depth.data(), labels.data(), color.data() );
+//
+// const std::string json = synthetic::instancesJson( index, 2 ); /* same format as Nuitrack::getInstancesJson() */
+//
+// Scene is back wall and floor with users standing in front of them.
+// Users move left and right over frames, depth has small noise and holes (0) like real depth sensor.
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __SYNTHETIC__
+#define __SYNTHETIC__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace synthetic
+{
+    // User in Scene (Pixel Coordinates of Scene Resolution, Millimeter)
+    struct User
+    {
+        int32_t id;
+        float distance;
+        float center_x;
+        float body_y;
+        float body_rx;
+        float body_ry;
+        float head_y;
+        float head_r;
+    };
+
+    class Scene
+    {
+    private:
+        int32_t width;
+        int32_t height;
+        int32_t users;
+        uint32_t seed;
+
+    public:
+        // Constructor
+        // Number of users is clamped to 0-6 (same as maximum number of users that NuiTrack tracks).
+        Scene( const int32_t width, const int32_t height, const int32_t users = 2, const uint32_t seed = 0 );
+
+        // Retrieve Users of Frame (Nearest First)
+        std::vector<synthetic::User> getUsers( const uint32_t index ) const;
+
+        // Retrieve Focal Length (Pixel)
+        float getFocal() const;
+
+        // Generate Frame
+        // depth and labels are ( width * height ) elements, color is ( width * height * 3 ) elements (BGR).
+        // Buffer that is nullptr is not generated.
+        void generate( const uint32_t index, uint16_t* depth, uint16_t* labels, uint8_t* color ) const;
+
+        int32_t getWidth() const
+        {
+            return width;
+        }
+
+        int32_t getHeight() const
+        {
+            return height;
+        }
+
+        int32_t getUsers() const
+        {
+            return users;
+        }
+    };
+
+    // Generate Instances JSON
+    // Same format as Nuitrack::getInstancesJson(), each human has face with 31 landmarks.
+    std::string instancesJson( const uint32_t index, const int32_t humans, const uint32_t seed = 0 );
+}
+
+#endif // __SYNTHETIC__
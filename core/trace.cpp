@@ -0,0 +1,307 @@
+#include "trace.h"
+
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <condition_variable>
+
+namespace trace
+{
+    // Flag of Tracing (Checked by Every Scope)
+    std::atomic<bool> enabled( false );
+
+    // Number of Events that Buffer of Thread is Handed to Writer Thread without TRACE_FLUSH()
+    static const size_t MAX_EVENTS = 8192;
+
+    // Maximum Number of Buffers Waiting for Writer Thread
+    static const size_t MAX_QUEUE = 64;
+
+    struct Event
+    {
+        const char* name;
+        int64_t start; // nanoseconds (clock epoch)
+        int64_t duration; // nanoseconds, -1 is counter
+        double value;
+        uint32_t tid;
+    };
+
+    typedef std::vector<Event> Events;
+
+    // Writer (Owns Queue of Event Buffers and Writer Thread)
+    struct Writer
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<Events> queue;
+        std::vector<Events> pool;
+        std::thread thread;
+        std::ofstream file;
+        bool running = false;
+        bool first = true;
+        int64_t origin = 0;
+        uint64_t dropped = 0;
+        std::atomic<uint32_t> generation{ 0 };
+        std::atomic<uint32_t> threads{ 0 };
+    };
+
+    static Writer& writer()
+    {
+        static Writer writer;
+        return writer;
+    }
+
+    struct Buffer;
+    static void flush( Buffer& buffer );
+
+    // Buffer of Calling Thread
+    // Remaining events are handed to writer thread when thread exits.
+    struct Buffer
+    {
+        Events events;
+        uint32_t tid;
+        uint32_t generation;
+
+        Buffer()
+            : tid( writer().threads.fetch_add( 1 ) + 1 ), generation( 0 )
+        {
+            events.reserve( MAX_EVENTS );
+        }
+
+        ~Buffer()
+        {
+            trace::flush( *this );
+        }
+    };
+
+    static Buffer& local()
+    {
+        static thread_local Buffer buffer;
+        return buffer;
+    }
+
+    static int64_t nanoseconds( const trace::clock::time_point& time )
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( time.time_since_epoch() ).count();
+    }
+
+    // Write JSON String (Escape Quote and Backslash)
+    static void writeString( std::ostream& os, const char* text )
+    {
+        os << '"';
+        for( const char* c = text; *c; c++ ){
+            if( *c == '"' || *c == '\\' ){
+                os << '\\';
+            }
+            os << *c;
+        }
+        os << '"';
+    }
+
+    // Write Events (Writer Thread Only)
+    static void writeEvents( Writer& writer, const Events& events, const size_t pending, const uint64_t dropped )
+    {
+        char number[64];
+        for( const Event& event : events ){
+            writer.file << ( writer.first ? "" : ",\n" );
+            writer.first = false;
+
+            writer.file << "{\"name\":";
+            writeString( writer.file, event.name );
+            std::snprintf( number, sizeof( number ), "%.3f", ( event.start - writer.origin ) / 1000.0 );
+            if( event.duration >= 0 ){
+                writer.file << ",\"ph\":\"X\",\"ts\":" << number;
+                std::snprintf( number, sizeof( number ), "%.3f", event.duration / 1000.0 );
+                writer.file << ",\"dur\":" << number << ",\"pid\":1,\"tid\":" << event.tid << "}";
+            }
+            else{
+                writer.file << ",\"ph\":\"C\",\"ts\":" << number;
+                std::snprintf( number, sizeof( number ), "%.17g", event.value );
+                writer.file << ",\"pid\":1,\"tid\":" << event.tid << ",\"args\":{\"value\":" << number << "}}";
+            }
+        }
+
+        // Queue Depth and Dropped Events of Writer
+        if( !events.empty() ){
+            std::snprintf( number, sizeof( number ), "%.3f", ( events.back().start - writer.origin ) / 1000.0 );
+            writer.file << ",\n{\"name\":\"trace queue\",\"ph\":\"C\",\"ts\":" << number << ",\"pid\":1,\"tid\":0,\"args\":{\"value\":" << pending << "}}";
+            writer.file << ",\n{\"name\":\"trace dropped events\",\"ph\":\"C\",\"ts\":" << number << ",\"pid\":1,\"tid\":0,\"args\":{\"value\":" << dropped << "}}";
+        }
+    }
+
+    // Writer Thread
+    static void run( Writer& writer )
+    {
+        std::unique_lock<std::mutex> lock( writer.mutex );
+        while( true ){
+            writer.condition.wait( lock, [&](){ return !writer.queue.empty() || !writer.running; } );
+            if( writer.queue.empty() ){
+                break;
+            }
+
+            Events events = std::move( writer.queue.front() );
+            writer.queue.pop_front();
+            const size_t pending = writer.queue.size();
+            const uint64_t dropped = writer.dropped;
+
+            // Format and Write without Lock
+            lock.unlock();
+            writeEvents( writer, events, pending, dropped );
+            events.clear();
+            lock.lock();
+
+            writer.pool.push_back( std::move( events ) );
+        }
+    }
+
+    // Start Tracing
+    bool start( const std::string& path )
+    {
+        std::string file = path;
+        if( file.empty() ){
+            const char* environment = std::getenv( "NUITRACK_TRACE" );
+            if( !environment || !*environment ){
+                return false;
+            }
+            file = environment;
+        }
+
+        Writer& writer = trace::writer();
+        std::lock_guard<std::mutex> lock( writer.mutex );
+        if( writer.running ){
+            return true;
+        }
+
+        writer.file.open( file, std::ios::out | std::ios::trunc );
+        if( !writer.file.is_open() ){
+            return false;
+        }
+
+        // JSON Array Format (Loadable even if closing bracket is missing)
+        writer.file << "[\n";
+        writer.first = true;
+        writer.dropped = 0;
+        writer.origin = nanoseconds( trace::clock::now() );
+        writer.generation++;
+        writer.running = true;
+
+        // Prepare Buffers (Writer thread returns written buffers to pool)
+        while( writer.pool.size() < 4 ){
+            writer.pool.push_back( Events() );
+            writer.pool.back().reserve( MAX_EVENTS );
+        }
+
+        writer.thread = std::thread( run, std::ref( writer ) );
+
+        enabled.store( true, std::memory_order_release );
+        return true;
+    }
+
+    // Stop Tracing (Flush Events of Calling Thread, and Wait for Writer Thread)
+    // Workers of parallel loop hand their events after each loop, and other threads at TRACE_FLUSH() or exit.
+    void stop()
+    {
+        Writer& writer = trace::writer();
+        if( !enabled.load( std::memory_order_acquire ) ){
+            return;
+        }
+
+        flush();
+        enabled.store( false, std::memory_order_release );
+
+        {
+            std::lock_guard<std::mutex> lock( writer.mutex );
+            writer.running = false;
+        }
+        writer.condition.notify_one();
+        writer.thread.join();
+
+        writer.file << "\n]\n";
+        writer.file.close();
+    }
+
+    // Append Event to Buffer of Calling Thread
+    static void append( const Event& event )
+    {
+        Buffer& buffer = local();
+        const uint32_t generation = writer().generation.load( std::memory_order_relaxed );
+        if( buffer.generation != generation ){
+            buffer.events.clear();
+            buffer.generation = generation;
+        }
+
+        buffer.events.push_back( event );
+        buffer.events.back().tid = buffer.tid;
+        if( buffer.events.size() >= MAX_EVENTS ){
+            flush();
+        }
+    }
+
+    // Add Span
+    void span( const char* name, const trace::clock::time_point& start, const trace::clock::time_point& end )
+    {
+        Event event;
+        event.name = name;
+        event.start = nanoseconds( start );
+        event.duration = nanoseconds( end ) - event.start;
+        event.value = 0.0;
+        append( event );
+    }
+
+    // Add Counter
+    void counter( const char* name, const double value )
+    {
+        Event event;
+        event.name = name;
+        event.start = nanoseconds( trace::clock::now() );
+        event.duration = -1;
+        event.value = value;
+        append( event );
+    }
+
+    // Hand Events of Calling Thread to Writer Thread
+    void flush()
+    {
+        flush( local() );
+    }
+
+    // Hand Events of Buffer to Writer Thread
+    static void flush( Buffer& buffer )
+    {
+        if( buffer.events.empty() ){
+            return;
+        }
+
+        Writer& writer = trace::writer();
+        {
+            std::lock_guard<std::mutex> lock( writer.mutex );
+            if( !writer.running || buffer.generation != writer.generation ){
+                buffer.events.clear();
+                return;
+            }
+
+            // Drop Events if Writer can't keep up (Bound Memory, Never Block Frame Processing)
+            if( writer.queue.size() >= MAX_QUEUE ){
+                writer.dropped += buffer.events.size();
+                buffer.events.clear();
+                return;
+            }
+
+            writer.queue.push_back( std::move( buffer.events ) );
+
+            // Reuse Buffer that was Written (No Allocation in Steady State)
+            if( !writer.pool.empty() ){
+                buffer.events = std::move( writer.pool.back() );
+                writer.pool.pop_back();
+            }
+            else{
+                buffer.events = Events();
+                buffer.events.reserve( MAX_EVENTS );
+            }
+        }
+        writer.condition.notify_one();
+    }
+}
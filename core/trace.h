@@ -0,0 +1,98 @@
+// This is timeline trace writer that outputs Chrome Trace Event Format (JSON).
+// The trace file can be opened with chrome://tracing or Perfetto UI (https://ui.perfetto.dev).
+// Each PROFILE_SCOPE becomes span (complete event), and TRACE_COUNTER becomes counter track.
+//
+// #include "profile.h"
+// #include "trace.h"
+//
+// TRACE_START( "trace.json" ); /* empty path uses NUITRACK_TRACE environment variable, disabled if it is not set */
+// while( true ){
+//     /* PROFILE_SCOPE( ... ) */
+//     TRACE_COUNTER( "dropped frames", dropped );
+//     TRACE_FLUSH(); /* hand events of this thread to writer thread */
+// }
+// TRACE_STOP();
+//
+// Events are appended to buffer of calling thread without lock, and handed to writer thread by TRACE_FLUSH().
+// Workers of parallel loop (pool or OpenMP) flush after each loop, and remaining events of any thread are flushed when it exits.
+// Writer thread formats and writes events to file, so that tracing does not block frame processing.
+// Tracing is compiled only when NUITRACK_PROFILE is defined (same as PROFILE_SCOPE).
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __TRACE__
+#define __TRACE__
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+
+namespace trace
+{
+    typedef std::chrono::steady_clock clock;
+
+    // Flag of Tracing (Checked by Every Scope)
+    extern std::atomic<bool> enabled;
+
+    // Start Tracing
+    // If path is empty, NUITRACK_TRACE environment variable is used. Return false if tracing is not started.
+    bool start( const std::string& path = "" );
+
+    // Stop Tracing (Flush Events of Calling Thread, and Wait for Writer Thread)
+    void stop();
+
+    // Check Tracing
+    inline bool active()
+    {
+        return enabled.load( std::memory_order_relaxed );
+    }
+
+    // Add Span
+    // name must be alive until tracing is stopped. (e.g. string literal)
+    void span( const char* name, const trace::clock::time_point& start, const trace::clock::time_point& end );
+
+    // Add Counter
+    // name must be alive until tracing is stopped. (e.g. string literal)
+    void counter( const char* name, const double value );
+
+    // Hand Events of Calling Thread to Writer Thread
+    void flush();
+}
+
+#ifdef NUITRACK_PROFILE
+#define TRACE_START( path ) trace::start( path )
+#define TRACE_STOP() trace::stop()
+#define TRACE_COUNTER( name, value ) do{ if( trace::active() ){ trace::counter( name, static_cast<double>( value ) ); } }while( false )
+#define TRACE_FLUSH() do{ if( trace::active() ){ trace::flush(); } }while( false )
+#else
+#define TRACE_START( path ) do{}while( false )
+#define TRACE_STOP() do{}while( false )
+#define TRACE_COUNTER( name, value ) do{}while( false )
+#define TRACE_FLUSH() do{}while( false )
+#endif
+
+#endif // __TRACE__
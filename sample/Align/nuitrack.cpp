@@ -1,6 +1,10 @@
 #include "nuitrack.h"
 
+#include <iostream>
 #include <string>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
 
 // Constructor
 NuiTrack::NuiTrack( const std::string& config_json )
@@ -20,24 +24,57 @@ NuiTrack::~NuiTrack()
 void NuiTrack::run()
 {
     // Run NuiTrack
-    tdv::nuitrack::Nuitrack::run();
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::run" );
+        tdv::nuitrack::Nuitrack::run();
+    }
+
+    // Start Trace (Chrome Trace Event Format)
+    TRACE_START( trace_path );
 
     // Main Loop
     while( true ){
+        PROFILE_SCOPE( "NuiTrack::frame" );
+
         // Update Data
         update();
 
-        // Draw Data
-        draw();
+        // Begin Frame (Pacing and Gap of Reconfiguration Follow Arrival of Color Frame)
+        runner.begin( color_arrived, color_timestamp );
 
-        // Show Data
-        show();
+        // Draw and Show Data (Skip if No Stream has New Frame)
+        if( runner.due( updated ) ){
+            // Draw Data
+            draw();
 
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
+            // Show Data
+            show();
+        }
+
+        // Report Startup, Profile and Threads, and Flush Trace
+        runner.report( updated );
+
+        // Report Pairs and Unmatched Frames of Synchronization
+        if( synchronize ){
+            synchronizer.report( std::cout, profile_interval );
+        }
+
+        // Key Check (Non-Blocking)
+        int32_t key;
+        {
+            PROFILE_SCOPE( "cv::pollKey" );
+            #if CV_VERSION_MAJOR > 4 || ( CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6 )
+            key = cv::pollKey();
+            #else
+            key = cv::waitKey( 1 );
+            #endif
+        }
         if( key == 'q' ){
             break;
         }
+
+        // End Frame (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+        runner.end( color_arrived, color_sequence.getDropped() );
     }
 }
 
@@ -46,11 +83,53 @@ void NuiTrack::initialize( const std::string& config_json )
 {
     cv::setUseOptimized( true );
 
+    // Place Main Thread (Capture, Processing and Rendering) and Workers of Pool
+    if( !thread_placement.empty() && !affinity::place( affinity::parsePlacement( thread_placement ) ) ){
+        std::cout << "thread placement " << thread_placement << " is not permitted" << std::endl;
+    }
+    if( !worker_placement.empty() ){
+        parallel::place( affinity::parsePlacement( worker_placement ) );
+    }
+
+    // Attach Main Thread to Usage Report
+    affinity::attach( "main" );
+
+    // Keep Config for Re-Initialize
+    this->config_json = config_json;
+
+    // Log Decisions of Quality Controller
+    quality_controller.setLog( &std::cout );
+
+    // Log Reconfigurations (Registered Depth follows Color Resolution)
+    reconfigurator.setLog( &std::cout );
+    reconfigurator.setRegistration( align && !software_registration );
+
+    // Hooks of Reconfiguration (Sensors of This Sample, and Intrinsics and Pairs that Depend on Output Mode)
+    reconfig_hooks.set = []( const std::string& key, const std::string& value ){ tdv::nuitrack::Nuitrack::setConfigValue( key, value ); };
+    reconfig_hooks.recreate = [this]( const reconfig::Change& change ){ recreateModules( change ); };
+    reconfig_hooks.reinitialize = [this](){ reinitialize(); };
+    reconfig_hooks.applied = [this]( const reconfig::Change& ){ updateOutputMode(); };
+
+    // Attach Components to Runner of Main Loop
+    runner.setPacer( &pacer );
+    runner.setStartup( &startup_timeline );
+    runner.setReconfigurator( &reconfigurator, reconfig_hooks, hot_reconfig );
+    if( adaptive_quality ){
+        runner.setQuality( &quality_controller, { "Realsense2Module.RGB.", "Realsense2Module.Depth." } );
+    }
+    runner.setLog( &std::cout, profile_interval );
+
     // Initialize NuiTrack
-    tdv::nuitrack::Nuitrack::init( config_json );
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::init" );
+        tdv::nuitrack::Nuitrack::init( config_json );
+    }
 
     // Initialize Sensor
     initializeSensor();
+
+    // Initialize Registration
+    initializeRegistration();
 }
 
 // Initialize Sensor
@@ -61,19 +140,75 @@ inline void NuiTrack::initializeSensor()
     tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.RGB.ProcessHeight", std::to_string( color_height ) );
     tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth.ProcessWidth", std::to_string( depth_width ) );
     tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth.ProcessHeight", std::to_string( depth_height ) );
-    tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth2ColorRegistration", align ? "true" : "false" );
+    tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth2ColorRegistration", ( align && !software_registration ) ? "true" : "false" );
 
     // Get Device Config
     max_distance = std::stoi( tdv::nuitrack::Nuitrack::getConfigValue( "Realsense2Module.Depth.ProcessMaxDepth" ) );
 
-    // Create Sensor
-    color_sensor = tdv::nuitrack::ColorSensor::create();
-    depth_sensor = tdv::nuitrack::DepthSensor::create();
+    // Set Config Changed by Reconfiguration (Overrides Device Config)
+    const reconfig::Config config = reconfigurator.getConfig();
+    for( const std::pair<const std::string, std::string>& entry : config ){
+        tdv::nuitrack::Nuitrack::setConfigValue( entry.first, entry.second );
+    }
+
+    // Create Sensor (Independent Modules are Created Concurrently)
+    startup::parallel( startup_timeline, {
+        { "ColorSensor::create", [&](){ color_sensor = tdv::nuitrack::ColorSensor::create(); } },
+        { "DepthSensor::create", [&](){ depth_sensor = tdv::nuitrack::DepthSensor::create(); } }
+    }, parallel_startup );
+}
+
+// Initialize Registration
+inline void NuiTrack::initializeRegistration()
+{
+    // Retrieve Output Mode (Intrinsics are Scaled when Output Mode is Changed by Reconfiguration)
+    color_mode = color_sensor->getOutputMode();
+    depth_mode = depth_sensor->getOutputMode();
+
+    if( !align || !software_registration ){
+        return;
+    }
+
+    // Retrieve Intrinsics from Output Mode
+    color_intrinsics = camera::Intrinsics::fromFov( color_mode.xres, color_mode.yres, color_mode.hfov );
+    depth_intrinsics = camera::Intrinsics::fromFov( depth_mode.xres, depth_mode.yres, depth_mode.hfov );
+
+    // Load Stored Calibration (Overwrite Intrinsics and Extrinsics If Exists)
+    cv::FileStorage storage( "calibration.yml", cv::FileStorage::READ );
+    if( !storage.isOpened() ){
+        return;
+    }
+
+    cv::Mat color_matrix, depth_matrix, rotation, translation;
+    storage["color_intrinsics"] >> color_matrix;
+    storage["depth_intrinsics"] >> depth_matrix;
+    storage["rotation"] >> rotation;
+    storage["translation"] >> translation;
+
+    if( color_matrix.total() == 9 ){
+        color_matrix.convertTo( color_matrix, CV_32F );
+        color_intrinsics = camera::Intrinsics( color_matrix.at<float>( 0, 0 ), color_matrix.at<float>( 1, 1 ), color_matrix.at<float>( 0, 2 ), color_matrix.at<float>( 1, 2 ) );
+    }
+    if( depth_matrix.total() == 9 ){
+        depth_matrix.convertTo( depth_matrix, CV_32F );
+        depth_intrinsics = camera::Intrinsics( depth_matrix.at<float>( 0, 0 ), depth_matrix.at<float>( 1, 1 ), depth_matrix.at<float>( 0, 2 ), depth_matrix.at<float>( 1, 2 ) );
+    }
+    if( rotation.total() == 9 ){
+        rotation.convertTo( rotation, CV_32F );
+        std::copy( rotation.ptr<float>(), rotation.ptr<float>() + 9, extrinsics.rotation );
+    }
+    if( translation.total() == 3 ){
+        translation.convertTo( translation, CV_32F );
+        std::copy( translation.ptr<float>(), translation.ptr<float>() + 3, extrinsics.translation );
+    }
 }
 
 // Finalize
 void NuiTrack::finalize()
 {
+    // Stop Trace
+    TRACE_STOP();
+
     // Close Windows
     cv::destroyAllWindows();
 
@@ -81,9 +216,58 @@ void NuiTrack::finalize()
     tdv::nuitrack::Nuitrack::release();
 }
 
+// Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+void NuiTrack::reconfigure( const std::string& key, const std::string& value )
+{
+    reconfigurator.set( key, value );
+}
+
+// Recreate Modules Affected by Changed Config (Frame ID of Recreated Module may Restart)
+inline void NuiTrack::recreateModules( const reconfig::Change& change )
+{
+    if( change.affects( reconfig::COLOR ) ){
+        color_sensor = tdv::nuitrack::ColorSensor::create();
+        color_sequence.reset();
+    }
+
+    if( change.affects( reconfig::DEPTH ) ){
+        depth_sensor = tdv::nuitrack::DepthSensor::create();
+        depth_sequence.reset();
+    }
+}
+
+// Re-Initialize NuiTrack (Device Config and Changed Config are Applied at Initialize)
+inline void NuiTrack::reinitialize()
+{
+    tdv::nuitrack::Nuitrack::release();
+    tdv::nuitrack::Nuitrack::init( config_json );
+    initializeSensor();
+    tdv::nuitrack::Nuitrack::run();
+
+    // Reset Sequence (Frame ID and Timestamp are Restarted)
+    color_sequence.reset();
+    depth_sequence.reset();
+}
+
+// Update Output Mode (Intrinsics are Scaled to New Output Mode, Stored Calibration is Kept)
+inline void NuiTrack::updateOutputMode()
+{
+    const tdv::nuitrack::OutputMode color_mode = color_sensor->getOutputMode();
+    const tdv::nuitrack::OutputMode depth_mode = depth_sensor->getOutputMode();
+    color_intrinsics = color_intrinsics.scale( static_cast<float>( color_mode.xres ) / this->color_mode.xres, static_cast<float>( color_mode.yres ) / this->color_mode.yres );
+    depth_intrinsics = depth_intrinsics.scale( static_cast<float>( depth_mode.xres ) / this->depth_mode.xres, static_cast<float>( depth_mode.yres ) / this->depth_mode.yres );
+    this->color_mode = color_mode;
+    this->depth_mode = depth_mode;
+
+    // Drop Pending Frames of Previous Resolution
+    synchronizer.reset();
+}
+
 // Update Data
 void NuiTrack::update()
 {
+    PROFILE_SCOPE( "NuiTrack::update" );
+
     // Update Frame
     updateFrame();
 
@@ -92,21 +276,44 @@ void NuiTrack::update()
 
     // Update Depth
     updateDepth();
+
+    // Synchronize Color and Depth
+    synchronizeFrames();
+
+    // Any Stream has New Frame
+    updated = color_updated || depth_updated;
 }
 
 // Update Frame
 inline void NuiTrack::updateFrame()
 {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
     // Update Frame
+    PROFILE_SCOPE( "Nuitrack::update" );
     tdv::nuitrack::Nuitrack::update();
+
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    update_elapsed = std::chrono::duration<double, std::milli>( end - start ).count();
 }
 
 // Update Color
 inline void NuiTrack::updateColor()
 {
+    PROFILE_SCOPE( "NuiTrack::updateColor" );
+
     // Retrieve Color Frame
     color_frame = color_sensor->getColorFrame();
 
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    color_updated = color_sequence.update( color_frame->getID(), color_frame->getTimestamp() );
+    color_arrived = color_updated;
+
+    // Keep Timestamp of New Frame (Pacing follows Arrival of Color, not Pairs of Synchronization)
+    if( color_arrived ){
+        color_timestamp = color_frame->getTimestamp();
+    }
+
     // Retrive Frame Size
     color_width = color_frame->getCols();
     color_height = color_frame->getRows();
@@ -115,55 +322,137 @@ inline void NuiTrack::updateColor()
 // Update Depth
 inline void NuiTrack::updateDepth()
 {
+    PROFILE_SCOPE( "NuiTrack::updateDepth" );
+
     // Retrieve Depth Frame
     depth_frame = depth_sensor->getDepthFrame();
 
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    depth_updated = depth_sequence.update( depth_frame->getID(), depth_frame->getTimestamp() );
+
     // Retrive Frame Size
     depth_width = depth_frame->getCols();
     depth_height = depth_frame->getRows();
 }
 
+// Synchronize Color and Depth
+inline void NuiTrack::synchronizeFrames()
+{
+    PROFILE_SCOPE( "NuiTrack::synchronizeFrames" );
+
+    if( !synchronize ){
+        return;
+    }
+
+    // Push New Frames (By Reference, Frames are not Copied)
+    if( color_updated ){
+        synchronizer.pushFirst( color_frame->getTimestamp(), color_frame );
+    }
+    if( depth_updated ){
+        synchronizer.pushSecond( depth_frame->getTimestamp(), depth_frame );
+    }
+
+    // Pop Pair of Nearest Timestamps (Color and Depth are Updated Together, or Neither)
+    color_updated = synchronizer.pop( color_frame, depth_frame );
+    depth_updated = color_updated;
+    if( !color_updated ){
+        return;
+    }
+
+    // Retrive Frame Size of Pair
+    color_width = color_frame->getCols();
+    color_height = color_frame->getRows();
+    depth_width = depth_frame->getCols();
+    depth_height = depth_frame->getRows();
+}
+
 // Draw Data
 void NuiTrack::draw()
 {
+    PROFILE_SCOPE( "NuiTrack::draw" );
+
     // Draw Color
     drawColor();
 
     // Draw Depth
-    drawDepth();
+    if( align && software_registration ){
+        drawRegisteredDepth();
+    }
+    else{
+        drawDepth();
+    }
 }
 
 // Draw Color
 inline void NuiTrack::drawColor()
 {
-    // Create cv::Mat form Color Data
-    const tdv::nuitrack::Color3* color_data = color_frame->getData();
-    color_mat = cv::Mat::zeros( color_height, color_width, CV_8UC3 );
+    PROFILE_SCOPE( "NuiTrack::drawColor" );
 
-    #pragma omp parallel for
-    for( int32_t index = 0; index < color_mat.total(); index++ ){
-        const tdv::nuitrack::Color3 color = color_data[index];
-        color_mat.at<cv::Vec3b>( index ) = cv::Vec3b( color.blue, color.green, color.red );
+    if( !color_updated ){
+        return;
     }
+
+    // Create cv::Mat form Color Data
+    const tdv::nuitrack::Color3* color_data = color_frame->getData();
+    color_mat.create( color_height, color_width, CV_8UC3 );
+    frame::copyColor( reinterpret_cast<const uint8_t*>( color_data ), color_mat.data, static_cast<int32_t>( color_mat.total() ) );
 }
 
 // Draw Depth
 inline void NuiTrack::drawDepth()
 {
+    PROFILE_SCOPE( "NuiTrack::drawDepth" );
+
+    if( !depth_updated ){
+        return;
+    }
+
     // Create cv::Mat form Depth Data
     const uint16_t* depth_data = depth_frame->getData();
-    depth_mat = cv::Mat::zeros( depth_height, depth_width, CV_16UC1 );
+    depth_mat.create( depth_height, depth_width, CV_16UC1 );
+    frame::copyDepth( depth_data, depth_mat.ptr<uint16_t>(), static_cast<int32_t>( depth_mat.total() ) );
+}
+
+// Draw Registered Depth
+inline void NuiTrack::drawRegisteredDepth()
+{
+    PROFILE_SCOPE( "NuiTrack::drawRegisteredDepth" );
 
-    #pragma omp parallel for
-    for( int32_t index = 0; index < depth_mat.total(); index++ ){
-        const uint16_t depth = depth_data[index];
-        depth_mat.at<ushort>( index ) = depth;
+    if( !depth_updated ){
+        return;
     }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Update Mapping Table (Rebuild Only When Resolution Changed)
+    const tdv::nuitrack::OutputMode color_mode = color_sensor->getOutputMode();
+    const tdv::nuitrack::OutputMode depth_mode = depth_sensor->getOutputMode();
+    const camera::Intrinsics color = camera::Intrinsics(
+        color_intrinsics.fx * color_width / color_mode.xres, color_intrinsics.fy * color_height / color_mode.yres,
+        color_intrinsics.cx * color_width / color_mode.xres, color_intrinsics.cy * color_height / color_mode.yres
+    );
+    const camera::Intrinsics depth = camera::Intrinsics(
+        depth_intrinsics.fx * depth_width / depth_mode.xres, depth_intrinsics.fy * depth_height / depth_mode.yres,
+        depth_intrinsics.cx * depth_width / depth_mode.xres, depth_intrinsics.cy * depth_height / depth_mode.yres
+    );
+    registrator.setCalibration( depth_width, depth_height, depth, color_width, color_height, color, extrinsics );
+
+    // Register Depth to Color
+    registered.resize( color_width * color_height );
+    registrator.apply( depth_frame->getData(), registered.data() );
+
+    // Create cv::Mat form Registered Depth Data
+    depth_mat = cv::Mat( color_height, color_width, CV_16UC1, registered.data() );
+
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    registration_elapsed = std::chrono::duration<double, std::milli>( end - start ).count();
 }
 
 // Show Data
 void NuiTrack::show()
 {
+    PROFILE_SCOPE( "NuiTrack::show" );
+
     // Show Color
     showColor();
 
@@ -174,6 +463,8 @@ void NuiTrack::show()
 // Show Color
 inline void NuiTrack::showColor()
 {
+    PROFILE_SCOPE( "NuiTrack::showColor" );
+
     if( color_mat.empty() ){
         return;
     }
@@ -185,18 +476,28 @@ inline void NuiTrack::showColor()
 // Show Depth
 inline void NuiTrack::showDepth()
 {
+    PROFILE_SCOPE( "NuiTrack::showDepth" );
+
     if( depth_mat.empty() ){
         return;
     }
 
     // Scaling
-    cv::Mat scale_mat;
-    depth_mat.convertTo( scale_mat, CV_8U, -255.0 / max_distance, 255.0 ); // 0-max_distance -> 255(white)-0(black)
+    cv::Mat scale_mat( depth_mat.rows, depth_mat.cols, CV_8UC1 );
+    frame::convertDepthToGray( depth_mat.ptr<uint16_t>(), scale_mat.data, static_cast<int32_t>( depth_mat.total() ), max_distance ); // 0-max_distance -> 255(white)-0(black)
     //depth_mat.convertTo( scale_mat, CV_8U, 255.0 / max_distance, 0.0 ); // 0-max_distance -> 0(black)-255(white)
 
     // Apply False Colour
     //cv::applyColorMap( scale_mat, scale_mat, cv::COLORMAP_BONE );
 
+    // Draw Processing Time (Compare Update Time between NuiTrack Registration and Software Registration)
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision( 2 ) << "update: " << update_elapsed << " ms";
+    if( align && software_registration ){
+        oss << ", registration: " << registration_elapsed << " ms";
+    }
+    cv::putText( scale_mat, oss.str(), cv::Point( 10, 30 ), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar( 0 ), 2 );
+
     // Show Depth Image
     cv::imshow( "Depth", scale_mat );
 }
@@ -1,6 +1,20 @@
 #ifndef __NUITRACK__
 #define __NUITRACK__
 
+#include "frame.h"
+#include "registration.h"
+#include "profile.h"
+#include "trace.h"
+#include "sequence.h"
+#include "pacing.h"
+#include "quality.h"
+#include "startup.h"
+#include "reconfig.h"
+#include "loop.h"
+#include "parallel.h"
+#include "affinity.h"
+#include "pairing.h"
+
 #include <nuitrack/Nuitrack.h>
 #include <opencv2/opencv.hpp>
 
@@ -10,6 +24,10 @@ private:
     // Color Sensor
     tdv::nuitrack::ColorSensor::Ptr color_sensor;
     tdv::nuitrack::RGBFrame::Ptr color_frame;
+    sequence::Stream color_sequence = sequence::Stream( "color" );
+    bool color_updated = false;
+    bool color_arrived = false; // new color frame arrived (color_updated is pair of synchronization)
+    uint64_t color_timestamp = 0; // timestamp of arrived color frame (microseconds)
     cv::Mat color_mat;
     uint32_t color_width = 1280;
     uint32_t color_height = 720;
@@ -17,6 +35,8 @@ private:
     // Depth Sensor
     tdv::nuitrack::DepthSensor::Ptr depth_sensor;
     tdv::nuitrack::DepthFrame::Ptr depth_frame;
+    sequence::Stream depth_sequence = sequence::Stream( "depth" );
+    bool depth_updated = false;
     cv::Mat depth_mat;
     uint32_t depth_width = 1280;
     uint32_t depth_height = 720;
@@ -25,6 +45,55 @@ private:
     // Align
     bool align = true;
 
+    // Synchronization (Pairs Color and Depth Frames by Nearest Timestamp)
+    pairing::Synchronizer<tdv::nuitrack::RGBFrame::Ptr, tdv::nuitrack::DepthFrame::Ptr> synchronizer = pairing::Synchronizer<tdv::nuitrack::RGBFrame::Ptr, tdv::nuitrack::DepthFrame::Ptr>( "color", "depth" );
+    bool synchronize = true; // draws only pairs of same instant (false draws latest frame of each sensor)
+
+    // Software Registration (Depth2ColorRegistration of NuiTrack is disabled)
+    bool software_registration = false;
+    registration::Registrator registrator;
+    camera::Intrinsics depth_intrinsics;
+    camera::Intrinsics color_intrinsics;
+    tdv::nuitrack::OutputMode depth_mode = {}; // output mode of intrinsics
+    tdv::nuitrack::OutputMode color_mode = {};
+    camera::Extrinsics extrinsics;
+    std::vector<uint16_t> registered;
+
+    // Processing Time (milliseconds)
+    double update_elapsed = 0.0;
+    double registration_elapsed = 0.0;
+
+    // Sequence
+    bool updated = false; // any stream has new frame
+
+    // Pacing
+    pacing::Pacer pacer; // sleeps until predicted arrival of next color frame
+
+    // Quality
+    quality::Controller quality_controller = quality::Controller( quality::LADDER, { color_width, color_height } ); // switches processing resolution by frame time
+    bool adaptive_quality = true;
+    std::string config_json; // re-applied when processing resolution is changed
+
+    // Reconfiguration
+    reconfig::Reconfigurator reconfigurator; // applies changed config at frame boundary
+    reconfig::Hooks reconfig_hooks; // recreate or re-initialize modules of this sample
+    bool hot_reconfig = true; // recreates only affected modules (false re-initializes NuiTrack)
+
+    // Main Loop
+    loop::Runner runner; // pacing, frame time, quality, shedding, idle rate, reports and reconfiguration of each frame
+
+    // Startup
+    startup::Timeline startup_timeline; // phases until first frame
+    bool parallel_startup = true; // creates independent modules concurrently
+
+    // Threads
+    std::string thread_placement = ""; // core set, policy and priority of main thread that captures, processes and renders (e.g. "2:fifo:10"), empty keeps
+    std::string worker_placement = ""; // core set, policy and priority of workers of pool (e.g. "3-7"), empty uses NUITRACK_CORES
+
+    // Profile
+    double profile_interval = 5.0; // seconds
+    std::string trace_path = ""; // Chrome trace file (empty uses NUITRACK_TRACE environment variable)
+
 public:
     // Constructor
     NuiTrack( const std::string& config_json = "" );
@@ -35,6 +104,9 @@ public:
     // Processing
     void run();
 
+    // Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+    void reconfigure( const std::string& key, const std::string& value );
+
 private:
     // Initialize
     void initialize( const std::string& config_json );
@@ -42,9 +114,21 @@ private:
     // Initialize Sensor
     inline void initializeSensor();
 
+    // Initialize Registration
+    inline void initializeRegistration();
+
     // Finalize
     void finalize();
 
+    // Recreate Modules
+    inline void recreateModules( const reconfig::Change& change );
+
+    // Re-Initialize NuiTrack
+    inline void reinitialize();
+
+    // Update Output Mode
+    inline void updateOutputMode();
+
     // Update Data
     void update();
 
@@ -57,6 +141,9 @@ private:
     // Update Depth
     inline void updateDepth();
 
+    // Synchronize Color and Depth
+    inline void synchronizeFrames();
+
     // Draw Data
     void draw();
 
@@ -66,6 +153,9 @@ private:
     // Draw Depth
     inline void drawDepth();
 
+    // Draw Registered Depth
+    inline void drawRegisteredDepth();
+
     // Show Data
     void show();
 
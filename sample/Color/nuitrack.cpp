@@ -1,5 +1,7 @@
 #include "nuitrack.h"
 
+#include <iostream>
+
 // Constructor
 NuiTrack::NuiTrack( const std::string& config_json )
 {
@@ -18,24 +20,52 @@ NuiTrack::~NuiTrack()
 void NuiTrack::run()
 {
     // Run NuiTrack
-    tdv::nuitrack::Nuitrack::run();
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::run" );
+        tdv::nuitrack::Nuitrack::run();
+    }
+
+    // Start Trace (Chrome Trace Event Format)
+    TRACE_START( trace_path );
 
     // Main Loop
     while( true ){
+        PROFILE_SCOPE( "NuiTrack::frame" );
+
         // Update Data
         update();
 
-        // Draw Data
-        draw();
+        // Begin Frame (Pacing and Gap of Reconfiguration Follow New Frame of Color)
+        runner.begin( color_updated, color_frame->getTimestamp() );
+
+        // Draw and Show Data (Skip if No Stream has New Frame)
+        if( runner.due( updated ) ){
+            // Draw Data
+            draw();
+
+            // Show Data
+            show();
+        }
 
-        // Show Data
-        show();
+        // Report Startup, Profile and Threads, and Flush Trace
+        runner.report( updated );
 
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
+        // Key Check (Non-Blocking)
+        int32_t key;
+        {
+            PROFILE_SCOPE( "cv::pollKey" );
+            #if CV_VERSION_MAJOR > 4 || ( CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6 )
+            key = cv::pollKey();
+            #else
+            key = cv::waitKey( 1 );
+            #endif
+        }
         if( key == 'q' ){
             break;
         }
+
+        // End Frame (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+        runner.end( color_updated, color_sequence.getDropped() );
     }
 }
 
@@ -44,8 +74,45 @@ void NuiTrack::initialize( const std::string& config_json )
 {
     cv::setUseOptimized( true );
 
+    // Place Main Thread (Capture, Processing and Rendering) and Workers of Pool
+    if( !thread_placement.empty() && !affinity::place( affinity::parsePlacement( thread_placement ) ) ){
+        std::cout << "thread placement " << thread_placement << " is not permitted" << std::endl;
+    }
+    if( !worker_placement.empty() ){
+        parallel::place( affinity::parsePlacement( worker_placement ) );
+    }
+
+    // Attach Main Thread to Usage Report
+    affinity::attach( "main" );
+
+    // Keep Config for Re-Initialize
+    this->config_json = config_json;
+
+    // Log Decisions of Quality Controller
+    quality_controller.setLog( &std::cout );
+
+    // Log Reconfigurations
+    reconfigurator.setLog( &std::cout );
+
+    // Hooks of Reconfiguration (Sensors and Trackers of This Sample)
+    reconfig_hooks.set = []( const std::string& key, const std::string& value ){ tdv::nuitrack::Nuitrack::setConfigValue( key, value ); };
+    reconfig_hooks.recreate = [this]( const reconfig::Change& change ){ recreateModules( change ); };
+    reconfig_hooks.reinitialize = [this](){ reinitialize(); };
+
+    // Attach Components to Runner of Main Loop
+    runner.setPacer( &pacer );
+    runner.setStartup( &startup_timeline );
+    runner.setReconfigurator( &reconfigurator, reconfig_hooks, hot_reconfig );
+    if( adaptive_quality ){
+        runner.setQuality( &quality_controller, { "Realsense2Module.RGB." } );
+    }
+    runner.setLog( &std::cout, profile_interval );
+
     // Initialize NuiTrack
-    tdv::nuitrack::Nuitrack::init( config_json );
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::init" );
+        tdv::nuitrack::Nuitrack::init( config_json );
+    }
 
     // Initialize Sensor
     initializeSensor();
@@ -58,13 +125,25 @@ inline void NuiTrack::initializeSensor()
     tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.RGB.ProcessWidth", std::to_string( color_width ) );
     tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.RGB.ProcessHeight", std::to_string( color_height ) );
 
+    // Set Config Changed by Reconfiguration (Overrides Device Config)
+    const reconfig::Config config = reconfigurator.getConfig();
+    for( const std::pair<const std::string, std::string>& entry : config ){
+        tdv::nuitrack::Nuitrack::setConfigValue( entry.first, entry.second );
+    }
+
     // Create Sensor
-    color_sensor = tdv::nuitrack::ColorSensor::create();
+    {
+        const startup::Scope scope( startup_timeline, "ColorSensor::create" );
+        color_sensor = tdv::nuitrack::ColorSensor::create();
+    }
 }
 
 // Finalize
 void NuiTrack::finalize()
 {
+    // Stop Trace
+    TRACE_STOP();
+
     // Close Windows
     cv::destroyAllWindows();
 
@@ -72,29 +151,67 @@ void NuiTrack::finalize()
     tdv::nuitrack::Nuitrack::release();
 }
 
+// Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+void NuiTrack::reconfigure( const std::string& key, const std::string& value )
+{
+    reconfigurator.set( key, value );
+}
+
+// Recreate Modules Affected by Changed Config (Frame ID of Recreated Module may Restart)
+inline void NuiTrack::recreateModules( const reconfig::Change& change )
+{
+    if( change.affects( reconfig::COLOR ) ){
+        color_sensor = tdv::nuitrack::ColorSensor::create();
+        color_sequence.reset();
+    }
+}
+
+// Re-Initialize NuiTrack (Device Config and Changed Config are Applied at Initialize)
+inline void NuiTrack::reinitialize()
+{
+    tdv::nuitrack::Nuitrack::release();
+    tdv::nuitrack::Nuitrack::init( config_json );
+    initializeSensor();
+    tdv::nuitrack::Nuitrack::run();
+
+    // Reset Sequence (Frame ID and Timestamp are Restarted)
+    color_sequence.reset();
+}
+
 // Update Data
 void NuiTrack::update()
 {
+    PROFILE_SCOPE( "NuiTrack::update" );
+
     // Update Frame
     updateFrame();
 
     // Update Color
     updateColor();
+
+    // Any Stream has New Frame
+    updated = color_updated;
 }
 
 // Update Frame
 inline void NuiTrack::updateFrame()
 {
     // Update Frame
+    PROFILE_SCOPE( "Nuitrack::update" );
     tdv::nuitrack::Nuitrack::update();
 }
 
 // Update Color
 inline void NuiTrack::updateColor()
 {
+    PROFILE_SCOPE( "NuiTrack::updateColor" );
+
     // Retrieve Color Frame
     color_frame = color_sensor->getColorFrame();
 
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    color_updated = color_sequence.update( color_frame->getID(), color_frame->getTimestamp() );
+
     // Retrive Frame Size
     color_width = color_frame->getCols();
     color_height = color_frame->getRows();
@@ -103,6 +220,8 @@ inline void NuiTrack::updateColor()
 // Draw Data
 void NuiTrack::draw()
 {
+    PROFILE_SCOPE( "NuiTrack::draw" );
+
     // Draw Color
     drawColor();
 }
@@ -110,20 +229,23 @@ void NuiTrack::draw()
 // Draw Color
 inline void NuiTrack::drawColor()
 {
-    // Create cv::Mat form Color Data
-    const tdv::nuitrack::Color3* color_data = color_frame->getData();
-    color_mat = cv::Mat::zeros( color_height, color_width, CV_8UC3 );
+    PROFILE_SCOPE( "NuiTrack::drawColor" );
 
-    #pragma omp parallel for
-    for( int32_t index = 0; index < color_mat.total(); index++ ){
-        const tdv::nuitrack::Color3 color = color_data[index];
-        color_mat.at<cv::Vec3b>( index ) = cv::Vec3b( color.blue, color.green, color.red );
+    if( !color_updated ){
+        return;
     }
+
+    // Create cv::Mat form Color Data
+    const tdv::nuitrack::Color3* color_data = color_frame->getData();
+    color_mat.create( color_height, color_width, CV_8UC3 );
+    frame::copyColor( reinterpret_cast<const uint8_t*>( color_data ), color_mat.data, static_cast<int32_t>( color_mat.total() ) );
 }
 
 // Show Data
 void NuiTrack::show()
 {
+    PROFILE_SCOPE( "NuiTrack::show" );
+
     // Show Color
     showColor();
 }
@@ -131,6 +253,8 @@ void NuiTrack::show()
 // Show Color
 inline void NuiTrack::showColor()
 {
+    PROFILE_SCOPE( "NuiTrack::showColor" );
+
     if( color_mat.empty() ){
         return;
     }
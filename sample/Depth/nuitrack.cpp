@@ -1,6 +1,9 @@
 #include "nuitrack.h"
 
+#include <iostream>
 #include <string>
+#include <sstream>
+#include <iomanip>
 
 // Constructor
 NuiTrack::NuiTrack( const std::string& config_json )
@@ -20,24 +23,52 @@ NuiTrack::~NuiTrack()
 void NuiTrack::run()
 {
     // Run NuiTrack
-    tdv::nuitrack::Nuitrack::run();
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::run" );
+        tdv::nuitrack::Nuitrack::run();
+    }
+
+    // Start Trace (Chrome Trace Event Format)
+    TRACE_START( trace_path );
 
     // Main Loop
     while( true ){
+        PROFILE_SCOPE( "NuiTrack::frame" );
+
         // Update Data
         update();
 
-        // Draw Data
-        draw();
+        // Begin Frame (Pacing and Gap of Reconfiguration Follow New Frame of Depth)
+        runner.begin( depth_updated, depth_frame->getTimestamp() );
+
+        // Draw and Show Data (Skip if No Stream has New Frame)
+        if( runner.due( updated ) ){
+            // Draw Data
+            draw();
+
+            // Show Data
+            show();
+        }
 
-        // Show Data
-        show();
+        // Report Startup, Profile and Threads, and Flush Trace
+        runner.report( updated );
 
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
+        // Key Check (Non-Blocking)
+        int32_t key;
+        {
+            PROFILE_SCOPE( "cv::pollKey" );
+            #if CV_VERSION_MAJOR > 4 || ( CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6 )
+            key = cv::pollKey();
+            #else
+            key = cv::waitKey( 1 );
+            #endif
+        }
         if( key == 'q' ){
             break;
         }
+
+        // End Frame (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+        runner.end( depth_updated, depth_sequence.getDropped() );
     }
 }
 
@@ -46,8 +77,45 @@ void NuiTrack::initialize( const std::string& config_json )
 {
     cv::setUseOptimized( true );
 
+    // Place Main Thread (Capture, Processing and Rendering) and Workers of Pool
+    if( !thread_placement.empty() && !affinity::place( affinity::parsePlacement( thread_placement ) ) ){
+        std::cout << "thread placement " << thread_placement << " is not permitted" << std::endl;
+    }
+    if( !worker_placement.empty() ){
+        parallel::place( affinity::parsePlacement( worker_placement ) );
+    }
+
+    // Attach Main Thread to Usage Report
+    affinity::attach( "main" );
+
+    // Keep Config for Re-Initialize
+    this->config_json = config_json;
+
+    // Log Decisions of Quality Controller
+    quality_controller.setLog( &std::cout );
+
+    // Log Reconfigurations
+    reconfigurator.setLog( &std::cout );
+
+    // Hooks of Reconfiguration (Sensors and Trackers of This Sample)
+    reconfig_hooks.set = []( const std::string& key, const std::string& value ){ tdv::nuitrack::Nuitrack::setConfigValue( key, value ); };
+    reconfig_hooks.recreate = [this]( const reconfig::Change& change ){ recreateModules( change ); };
+    reconfig_hooks.reinitialize = [this](){ reinitialize(); };
+
+    // Attach Components to Runner of Main Loop
+    runner.setPacer( &pacer );
+    runner.setStartup( &startup_timeline );
+    runner.setReconfigurator( &reconfigurator, reconfig_hooks, hot_reconfig );
+    if( adaptive_quality ){
+        runner.setQuality( &quality_controller, { "Realsense2Module.Depth." } );
+    }
+    runner.setLog( &std::cout, profile_interval );
+
     // Initialize NuiTrack
-    tdv::nuitrack::Nuitrack::init( config_json );
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::init" );
+        tdv::nuitrack::Nuitrack::init( config_json );
+    }
 
     // Initialize Sensor
     initializeSensor();
@@ -63,13 +131,25 @@ inline void NuiTrack::initializeSensor()
     // Get Device Config
     max_distance = std::stoi( tdv::nuitrack::Nuitrack::getConfigValue( "Realsense2Module.Depth.ProcessMaxDepth" ) );
 
+    // Set Config Changed by Reconfiguration (Overrides Device Config)
+    const reconfig::Config config = reconfigurator.getConfig();
+    for( const std::pair<const std::string, std::string>& entry : config ){
+        tdv::nuitrack::Nuitrack::setConfigValue( entry.first, entry.second );
+    }
+
     // Create Sensor
-    depth_sensor = tdv::nuitrack::DepthSensor::create();
+    {
+        const startup::Scope scope( startup_timeline, "DepthSensor::create" );
+        depth_sensor = tdv::nuitrack::DepthSensor::create();
+    }
 }
 
 // Finalize
 void NuiTrack::finalize()
 {
+    // Stop Trace
+    TRACE_STOP();
+
     // Close Windows
     cv::destroyAllWindows();
 
@@ -77,29 +157,67 @@ void NuiTrack::finalize()
     tdv::nuitrack::Nuitrack::release();
 }
 
+// Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+void NuiTrack::reconfigure( const std::string& key, const std::string& value )
+{
+    reconfigurator.set( key, value );
+}
+
+// Recreate Modules Affected by Changed Config (Frame ID of Recreated Module may Restart)
+inline void NuiTrack::recreateModules( const reconfig::Change& change )
+{
+    if( change.affects( reconfig::DEPTH ) ){
+        depth_sensor = tdv::nuitrack::DepthSensor::create();
+        depth_sequence.reset();
+    }
+}
+
+// Re-Initialize NuiTrack (Device Config and Changed Config are Applied at Initialize)
+inline void NuiTrack::reinitialize()
+{
+    tdv::nuitrack::Nuitrack::release();
+    tdv::nuitrack::Nuitrack::init( config_json );
+    initializeSensor();
+    tdv::nuitrack::Nuitrack::run();
+
+    // Reset Sequence (Frame ID and Timestamp are Restarted)
+    depth_sequence.reset();
+}
+
 // Update Data
 void NuiTrack::update()
 {
+    PROFILE_SCOPE( "NuiTrack::update" );
+
     // Update Frame
     updateFrame();
 
     // Update Depth
     updateDepth();
+
+    // Any Stream has New Frame
+    updated = depth_updated;
 }
 
 // Update Frame
 inline void NuiTrack::updateFrame()
 {
     // Update Frame
+    PROFILE_SCOPE( "Nuitrack::update" );
     tdv::nuitrack::Nuitrack::update();
 }
 
 // Update Depth
 inline void NuiTrack::updateDepth()
 {
+    PROFILE_SCOPE( "NuiTrack::updateDepth" );
+
     // Retrieve Depth Frame
     depth_frame = depth_sensor->getDepthFrame();
 
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    depth_updated = depth_sequence.update( depth_frame->getID(), depth_frame->getTimestamp() );
+
     // Retrive Frame Size
     depth_width = depth_frame->getCols();
     depth_height = depth_frame->getRows();
@@ -108,6 +226,8 @@ inline void NuiTrack::updateDepth()
 // Draw Data
 void NuiTrack::draw()
 {
+    PROFILE_SCOPE( "NuiTrack::draw" );
+
     // Draw Depth
     drawDepth();
 }
@@ -115,20 +235,28 @@ void NuiTrack::draw()
 // Draw Depth
 inline void NuiTrack::drawDepth()
 {
+    PROFILE_SCOPE( "NuiTrack::drawDepth" );
+
+    if( !depth_updated ){
+        return;
+    }
+
     // Create cv::Mat form Depth Data
     const uint16_t* depth_data = depth_frame->getData();
-    depth_mat = cv::Mat::zeros( depth_height, depth_width, CV_16UC1 );
+    depth_mat.create( depth_height, depth_width, CV_16UC1 );
+    frame::copyDepth( depth_data, depth_mat.ptr<uint16_t>(), static_cast<int32_t>( depth_mat.total() ) );
 
-    #pragma omp parallel for
-    for( int32_t index = 0; index < depth_mat.total(); index++ ){
-        const uint16_t depth = depth_data[index];
-        depth_mat.at<ushort>( index ) = depth;
+    // Apply Depth Filter
+    if( filtering ){
+        depth_filter.apply( depth_mat.ptr<uint16_t>(), depth_mat.cols, depth_mat.rows );
     }
 }
 
 // Show Data
 void NuiTrack::show()
 {
+    PROFILE_SCOPE( "NuiTrack::show" );
+
     // Show Depth
     showDepth();
 }
@@ -136,18 +264,29 @@ void NuiTrack::show()
 // Show Depth
 inline void NuiTrack::showDepth()
 {
+    PROFILE_SCOPE( "NuiTrack::showDepth" );
+
     if( depth_mat.empty() ){
         return;
     }
 
     // Scaling
-    cv::Mat scale_mat;
-    depth_mat.convertTo( scale_mat, CV_8U, -255.0 / max_distance, 255.0 ); // 0-max_distance -> 255(white)-0(black)
+    cv::Mat scale_mat( depth_mat.rows, depth_mat.cols, CV_8UC1 );
+    frame::convertDepthToGray( depth_mat.ptr<uint16_t>(), scale_mat.data, static_cast<int32_t>( depth_mat.total() ), max_distance ); // 0-max_distance -> 255(white)-0(black)
     //depth_mat.convertTo( scale_mat, CV_8U, 255.0 / max_distance, 0.0 ); // 0-max_distance -> 0(black)-255(white)
 
     // Apply False Colour
     //cv::applyColorMap( scale_mat, scale_mat, cv::COLORMAP_BONE );
 
+    // Draw Processing Time of Depth Filter
+    if( filtering ){
+        const filter::Pipeline::Elapsed& elapsed = depth_filter.elapsed;
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision( 2 );
+        oss << "bilateral: " << elapsed.bilateral << " ms, temporal: " << elapsed.temporal << " ms, hole filling: " << elapsed.hole_filling << " ms";
+        cv::putText( scale_mat, oss.str(), cv::Point( 10, 30 ), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar( 0 ), 2 );
+    }
+
     // Show Depth Image
     cv::imshow( "Depth", scale_mat );
 }
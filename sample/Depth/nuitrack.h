@@ -1,6 +1,19 @@
 #ifndef __NUITRACK__
 #define __NUITRACK__
 
+#include "frame.h"
+#include "filter.h"
+#include "profile.h"
+#include "trace.h"
+#include "sequence.h"
+#include "pacing.h"
+#include "quality.h"
+#include "startup.h"
+#include "reconfig.h"
+#include "loop.h"
+#include "parallel.h"
+#include "affinity.h"
+
 #include <nuitrack/Nuitrack.h>
 #include <opencv2/opencv.hpp>
 
@@ -10,11 +23,47 @@ private:
     // Depth Sensor
     tdv::nuitrack::DepthSensor::Ptr depth_sensor;
     tdv::nuitrack::DepthFrame::Ptr depth_frame;
+    sequence::Stream depth_sequence = sequence::Stream( "depth" );
+    bool depth_updated = false;
     cv::Mat depth_mat;
     uint32_t depth_width = 1280;
     uint32_t depth_height = 720;
     uint32_t max_distance = 5000;
 
+    // Depth Filter
+    filter::Pipeline depth_filter;
+    bool filtering = true;
+
+    // Sequence
+    bool updated = false; // any stream has new frame
+
+    // Pacing
+    pacing::Pacer pacer; // sleeps until predicted arrival of next depth frame
+
+    // Quality
+    quality::Controller quality_controller = quality::Controller( quality::LADDER, { depth_width, depth_height } ); // switches processing resolution by frame time
+    bool adaptive_quality = true;
+    std::string config_json; // re-applied when processing resolution is changed
+
+    // Reconfiguration
+    reconfig::Reconfigurator reconfigurator; // applies changed config at frame boundary
+    reconfig::Hooks reconfig_hooks; // recreate or re-initialize modules of this sample
+    bool hot_reconfig = true; // recreates only affected modules (false re-initializes NuiTrack)
+
+    // Main Loop
+    loop::Runner runner; // pacing, frame time, quality, shedding, idle rate, reports and reconfiguration of each frame
+
+    // Startup
+    startup::Timeline startup_timeline; // phases until first frame
+
+    // Threads
+    std::string thread_placement = ""; // core set, policy and priority of main thread that captures, processes and renders (e.g. "2:fifo:10"), empty keeps
+    std::string worker_placement = ""; // core set, policy and priority of workers of pool (e.g. "3-7"), empty uses NUITRACK_CORES
+
+    // Profile
+    double profile_interval = 5.0; // seconds
+    std::string trace_path = ""; // Chrome trace file (empty uses NUITRACK_TRACE environment variable)
+
 public:
     // Constructor
     NuiTrack( const std::string& config_json = "" );
@@ -25,6 +74,9 @@ public:
     // Processing
     void run();
 
+    // Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+    void reconfigure( const std::string& key, const std::string& value );
+
 private:
     // Initialize
     void initialize( const std::string& config_json );
@@ -35,6 +87,12 @@ private:
     // Finalize
     void finalize();
 
+    // Recreate Modules
+    inline void recreateModules( const reconfig::Change& change );
+
+    // Re-Initialize NuiTrack
+    inline void reinitialize();
+
     // Update Data
     void update();
 
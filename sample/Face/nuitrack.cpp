@@ -1,5 +1,6 @@
 #include "nuitrack.h"
 
+#include <iostream>
 #include <string>
 #include <vector>
 #include <iomanip>
@@ -27,24 +28,52 @@ NuiTrack::~NuiTrack()
 void NuiTrack::run()
 {
     // Run NuiTrack
-    tdv::nuitrack::Nuitrack::run();
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::run" );
+        tdv::nuitrack::Nuitrack::run();
+    }
+
+    // Start Trace (Chrome Trace Event Format)
+    TRACE_START( trace_path );
 
     // Main Loop
     while( true ){
+        PROFILE_SCOPE( "NuiTrack::frame" );
+
         // Update Data
         update();
 
-        // Draw Data
-        draw();
+        // Begin Frame (Pacing and Gap of Reconfiguration Follow New Frame of Color)
+        runner.begin( color_updated, color_frame->getTimestamp() );
 
-        // Show Data
-        show();
+        // Draw and Show Data (Skip if No Stream has New Frame, Every n-th Frame while Display Rate is Shed)
+        if( runner.due( updated ) ){
+            // Draw Data
+            draw();
 
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
+            // Show Data
+            show();
+        }
+
+        // Report Startup, Profile, Consumers and Threads, and Flush Trace
+        runner.report( updated );
+
+        // Key Check (Non-Blocking)
+        int32_t key;
+        {
+            PROFILE_SCOPE( "cv::pollKey" );
+            #if CV_VERSION_MAJOR > 4 || ( CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6 )
+            key = cv::pollKey();
+            #else
+            key = cv::waitKey( 1 );
+            #endif
+        }
         if( key == 'q' ){
             break;
         }
+
+        // End Frame (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+        runner.end( color_updated, color_sequence.getDropped() );
     }
 }
 
@@ -53,19 +82,69 @@ void NuiTrack::initialize( const std::string& config_json )
 {
     cv::setUseOptimized( true );
 
+    // Place Main Thread (Capture, Processing and Rendering) and Workers of Pool
+    if( !thread_placement.empty() && !affinity::place( affinity::parsePlacement( thread_placement ) ) ){
+        std::cout << "thread placement " << thread_placement << " is not permitted" << std::endl;
+    }
+    if( !worker_placement.empty() ){
+        parallel::place( affinity::parsePlacement( worker_placement ) );
+    }
+
+    // Attach Main Thread to Usage Report
+    affinity::attach( "main" );
+
+    // Keep Config for Re-Initialize
+    this->config_json = config_json;
+
+    // Log Decisions of Quality Controller
+    quality_controller.setLog( &std::cout );
+
+    // Log Reconfigurations (Registered Depth follows Color Resolution)
+    reconfigurator.setLog( &std::cout );
+    reconfigurator.setRegistration( true );
+
+    // Hooks of Reconfiguration (Sensors and Trackers of This Sample)
+    reconfig_hooks.set = []( const std::string& key, const std::string& value ){ tdv::nuitrack::Nuitrack::setConfigValue( key, value ); };
+    reconfig_hooks.recreate = [this]( const reconfig::Change& change ){ recreateModules( change ); };
+    reconfig_hooks.reinitialize = [this](){ reinitialize(); };
+
+    // Register Consumers (Face is Parsed at Its Own Rate)
+    face_consumer = scheduler.add( "face", face_rate );
+
+    // Register Stages of Shedding (Shed in This Order under Overload, Restored in Reverse Order)
+    shed_attributes = shedding_controller.add( "face attributes" );
+    shed_display = shedding_controller.add( "display rate" );
+    shedding_controller.setLog( &std::cout );
+
+    // Attach Components to Runner of Main Loop
+    runner.setPacer( &pacer );
+    runner.setStartup( &startup_timeline );
+    runner.setReconfigurator( &reconfigurator, reconfig_hooks, hot_reconfig );
+    if( adaptive_quality ){
+        runner.setQuality( &quality_controller, { "Realsense2Module.RGB." } );
+    }
+    if( load_shedding ){
+        runner.setShedding( &shedding_controller, shed_display, display_divisor );
+    }
+    runner.setScheduler( &scheduler );
+    runner.setLog( &std::cout, profile_interval );
+
     // Initialize NuiTrack
-    tdv::nuitrack::Nuitrack::init( config_json );
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::init" );
+        tdv::nuitrack::Nuitrack::init( config_json );
+    }
 
     // Initialize Sensor
     initializeSensor();
 
     // Initalize Color Table for Visualization
-    colors[0] = cv::Vec3b( 255,   0,   0 ); // Blue
-    colors[1] = cv::Vec3b(   0, 255,   0 ); // Green
-    colors[2] = cv::Vec3b(   0,   0, 255 ); // Red
-    colors[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
-    colors[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
-    colors[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
+    palette[0] = cv::Vec3b( 255,   0,   0 ); // Blue
+    palette[1] = cv::Vec3b(   0, 255,   0 ); // Green
+    palette[2] = cv::Vec3b(   0,   0, 255 ); // Red
+    palette[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
+    palette[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
+    palette[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
 }
 
 // Initialize Sensor
@@ -80,16 +159,25 @@ inline void NuiTrack::initializeSensor()
     tdv::nuitrack::Nuitrack::setConfigValue( "Faces.ToUse", "true" );
     tdv::nuitrack::Nuitrack::setConfigValue( "DepthProvider.Depth2ColorRegistration", "true" );
 
-    // Create Sensor
-    color_sensor = tdv::nuitrack::ColorSensor::create();
+    // Set Config Changed by Reconfiguration (Overrides Device Config)
+    const reconfig::Config config = reconfigurator.getConfig();
+    for( const std::pair<const std::string, std::string>& entry : config ){
+        tdv::nuitrack::Nuitrack::setConfigValue( entry.first, entry.second );
+    }
 
-    // Create Tracker
-    skeleton_tracker = tdv::nuitrack::SkeletonTracker::create();
+    // Create Sensor and Tracker (Independent Modules are Created Concurrently)
+    startup::parallel( startup_timeline, {
+        { "ColorSensor::create", [&](){ color_sensor = tdv::nuitrack::ColorSensor::create(); } },
+        { "SkeletonTracker::create", [&](){ skeleton_tracker = tdv::nuitrack::SkeletonTracker::create(); } }
+    }, parallel_startup );
 }
 
 // Finalize
 void NuiTrack::finalize()
 {
+    // Stop Trace
+    TRACE_STOP();
+
     // Close Windows
     cv::destroyAllWindows();
 
@@ -97,32 +185,84 @@ void NuiTrack::finalize()
     tdv::nuitrack::Nuitrack::release();
 }
 
+// Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+void NuiTrack::reconfigure( const std::string& key, const std::string& value )
+{
+    reconfigurator.set( key, value );
+}
+
+// Recreate Modules Affected by Changed Config (Frame ID of Recreated Module may Restart)
+inline void NuiTrack::recreateModules( const reconfig::Change& change )
+{
+    if( change.affects( reconfig::COLOR ) ){
+        color_sensor = tdv::nuitrack::ColorSensor::create();
+        color_sequence.reset();
+    }
+
+    if( change.affects( reconfig::SKELETON ) ){
+        skeleton_tracker = tdv::nuitrack::SkeletonTracker::create();
+        face_sequence.reset();
+    }
+}
+
+// Re-Initialize NuiTrack (Device Config and Changed Config are Applied at Initialize)
+inline void NuiTrack::reinitialize()
+{
+    tdv::nuitrack::Nuitrack::release();
+    tdv::nuitrack::Nuitrack::init( config_json );
+    initializeSensor();
+    tdv::nuitrack::Nuitrack::run();
+
+    // Reset Sequence (Frame ID and Timestamp are Restarted)
+    color_sequence.reset();
+    face_sequence.reset();
+}
+
 // Update Data
 void NuiTrack::update()
 {
+    PROFILE_SCOPE( "NuiTrack::update" );
+
     // Update Frame
     updateFrame();
 
     // Update Color
     updateColor();
 
-    // Update Face
-    updateFace();
+    // Plan Consumers of New Color Frame
+    if( color_updated ){
+        scheduler.plan();
+    }
+
+    // Update Face (at Rate of Face Consumer)
+    face_updated = false;
+    if( scheduler.due( face_consumer ) ){
+        updateFace();
+    }
+
+    // Any Stream has New Frame
+    updated = color_updated || face_updated;
 }
 
 // Update Frame
 inline void NuiTrack::updateFrame()
 {
     // Update Frame
+    PROFILE_SCOPE( "Nuitrack::update" );
     tdv::nuitrack::Nuitrack::update();
 }
 
 // Update Color
 inline void NuiTrack::updateColor()
 {
+    PROFILE_SCOPE( "NuiTrack::updateColor" );
+
     // Retrieve Color Frame
     color_frame = color_sensor->getColorFrame();
 
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    color_updated = color_sequence.update( color_frame->getID(), color_frame->getTimestamp() );
+
     // Retrive Frame Size
     color_width = color_frame->getCols();
     color_height = color_frame->getRows();
@@ -131,13 +271,21 @@ inline void NuiTrack::updateColor()
 // Update Face
 inline void NuiTrack::updateFace()
 {
+    PROFILE_SCOPE( "NuiTrack::updateFace" );
+    const schedule::Run run( scheduler, face_consumer );
+
     // Update Tracker
     json = parser::parse( tdv::nuitrack::Nuitrack::getInstancesJson() );
+
+    // Check Sequence (Skip Conversion of Duplicate Data, Data without Timestamp is always New)
+    face_updated = json.timestamp == 0 || face_sequence.update( static_cast<uint64_t>( json.timestamp ) );
 }
 
 // Draw Data
 void NuiTrack::draw()
 {
+    PROFILE_SCOPE( "NuiTrack::draw" );
+
     // Draw Color
     drawColor();
 
@@ -148,20 +296,23 @@ void NuiTrack::draw()
 // Draw Color
 inline void NuiTrack::drawColor()
 {
-    // Create cv::Mat form Color Data
-    const tdv::nuitrack::Color3* color_data = color_frame->getData();
-    color_mat = cv::Mat::zeros( color_height, color_width, CV_8UC3 );
+    PROFILE_SCOPE( "NuiTrack::drawColor" );
 
-    #pragma omp parallel for
-    for( int32_t index = 0; index < color_mat.total(); index++ ){
-        const tdv::nuitrack::Color3 color = color_data[index];
-        color_mat.at<cv::Vec3b>( index ) = cv::Vec3b( color.blue, color.green, color.red );
+    if( !color_updated ){
+        return;
     }
+
+    // Create cv::Mat form Color Data
+    const tdv::nuitrack::Color3* color_data = color_frame->getData();
+    color_mat.create( color_height, color_width, CV_8UC3 );
+    frame::copyColor( reinterpret_cast<const uint8_t*>( color_data ), color_mat.data, static_cast<int32_t>( color_mat.total() ) );
 }
 
 // Draw Face
 inline void NuiTrack::drawFace()
 {
+    PROFILE_SCOPE( "NuiTrack::drawFace" );
+
     if( color_mat.empty() ){
         return;
     }
@@ -169,6 +320,9 @@ inline void NuiTrack::drawFace()
     // Copy Color Mat
     color_mat.copyTo( face_mat );
 
+    // Recycle Colors of Users that are Gone
+    colors.age();
+
     // Draw Face
     for( const parser::Human& human : json.humans ){
         if( !human.face ){
@@ -176,7 +330,7 @@ inline void NuiTrack::drawFace()
         }
 
         const parser::Face& face = human.face.get();
-        const cv::Vec3b color = colors[human.id - 1];
+        const cv::Vec3b color = userColor( human.id );
 
         // Rectangle
         const cv::Rect rectangle = { 
@@ -196,12 +350,16 @@ inline void NuiTrack::drawFace()
             cv::circle( face_mat, point, 5, color, -1 );
         }
 
-        // Attributes
-        drawAttributes( face_mat, face, cv::Point( rectangle.x + rectangle.width, rectangle.y ), 1.0, color );
+        // Attributes (Skipped while Face Attributes are Shed)
+        if( !shedding_controller.isShed( shed_attributes ) ){
+            drawAttributes( face_mat, face, cv::Point( rectangle.x + rectangle.width, rectangle.y ), 1.0, color );
+        }
     }
 
-    // Draw Parsed JSON
-    std::cout << json << std::endl;
+    // Draw Parsed JSON (Only when Face is Updated, Skipped while Face Attributes are Shed)
+    if( face_updated && !shedding_controller.isShed( shed_attributes ) ){
+        std::cout << json << std::endl;
+    }
 }
 
 // Draw Attributes
@@ -239,9 +397,22 @@ inline void NuiTrack::drawAttributes( cv::Mat& image, const parser::Face& face,
     cv::putText( image, "happy"   , cv::Point( org.x + bar_width, org.y + ( offset * 7 ) ), cv::FONT_HERSHEY_SIMPLEX, fontScale, cv::Vec3b(   0, 255,   0 ), thickness );
 }
 
+// Color of User (New User takes Color of its Slot, so that Users at Same Time have Different Colors up to PALETTE_SIZE)
+inline const cv::Vec3b& NuiTrack::userColor( const int32_t id )
+{
+    bool inserted = false;
+    const uint32_t slot = colors.acquire( id, &inserted );
+    if( inserted ){
+        colors.at( slot ) = palette[slot % palette.size()];
+    }
+    return colors.at( slot );
+}
+
 // Show Data
 void NuiTrack::show()
 {
+    PROFILE_SCOPE( "NuiTrack::show" );
+
     // Show Face
     showFace();
 }
@@ -249,6 +420,8 @@ void NuiTrack::show()
 // Show Face
 inline void NuiTrack::showFace()
 {
+    PROFILE_SCOPE( "NuiTrack::showFace" );
+
     if( face_mat.empty() ){
         return;
     }
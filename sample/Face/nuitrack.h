@@ -1,13 +1,27 @@
 #ifndef __NUITRACK__
 #define __NUITRACK__
 
+#include "frame.h"
 #include "parser.h"
+#include "profile.h"
+#include "trace.h"
+#include "sequence.h"
+#include "pacing.h"
+#include "quality.h"
+#include "schedule.h"
+#include "shedding.h"
+#include "startup.h"
+#include "reconfig.h"
+#include "loop.h"
+#include "parallel.h"
+#include "affinity.h"
+#include "slots.h"
 
 #include <nuitrack/Nuitrack.h>
 #include <opencv2/opencv.hpp>
 #include <array>
 
-#define USER_COUNT 6
+#define PALETTE_SIZE 6
 
 class NuiTrack
 {
@@ -15,6 +29,8 @@ private:
     // Color Sensor
     tdv::nuitrack::ColorSensor::Ptr color_sensor;
     tdv::nuitrack::RGBFrame::Ptr color_frame;
+    sequence::Stream color_sequence = sequence::Stream( "color" );
+    bool color_updated = false;
     cv::Mat color_mat;
     uint32_t color_width = 1280;
     uint32_t color_height = 720;
@@ -24,12 +40,58 @@ private:
 
     // Face Tracker
     parser::JSON json;
+    sequence::Stream face_sequence = sequence::Stream( "face" );
+    bool face_updated = false;
+    uint32_t face_consumer = 0;
+    double face_rate = 10.0; // Hz (age, gender and emotion change slowly, 0 parses every frame)
     cv::Mat face_mat;
-    std::array<cv::Vec3b, USER_COUNT> colors;
+    std::array<cv::Vec3b, PALETTE_SIZE> palette; // color of each slot of user
+    slots::Table<cv::Vec3b> colors; // color of each user id (slot of user that is gone is recycled)
 
     // Align
     bool align = true;
 
+    // Sequence
+    bool updated = false; // any stream has new frame
+
+    // Schedule
+    schedule::Scheduler scheduler; // runs consumers at their own rates
+
+    // Pacing
+    pacing::Pacer pacer; // sleeps until predicted arrival of next color frame
+
+    // Quality
+    quality::Controller quality_controller = quality::Controller( quality::LADDER, { color_width, color_height } ); // switches processing resolution by frame time
+    bool adaptive_quality = true;
+    std::string config_json; // re-applied when processing resolution is changed
+
+    // Shedding
+    shedding::Controller shedding_controller; // sheds optional work in order of stages under overload
+    uint32_t shed_attributes = 0; // face attributes (text, emotion bars and JSON print)
+    uint32_t shed_display = 0; // display rate
+    uint32_t display_divisor = 2; // shows every n-th frame while display rate is shed
+    bool load_shedding = true;
+
+    // Reconfiguration
+    reconfig::Reconfigurator reconfigurator; // applies changed config at frame boundary
+    reconfig::Hooks reconfig_hooks; // recreate or re-initialize modules of this sample
+    bool hot_reconfig = true; // recreates only affected modules (false re-initializes NuiTrack)
+
+    // Main Loop
+    loop::Runner runner; // pacing, frame time, quality, shedding, idle rate, reports and reconfiguration of each frame
+
+    // Startup
+    startup::Timeline startup_timeline; // phases until first frame
+    bool parallel_startup = true; // creates independent modules concurrently
+
+    // Threads
+    std::string thread_placement = ""; // core set, policy and priority of main thread that captures, processes and renders (e.g. "2:fifo:10"), empty keeps
+    std::string worker_placement = ""; // core set, policy and priority of workers of pool (e.g. "3-7"), empty uses NUITRACK_CORES
+
+    // Profile
+    double profile_interval = 5.0; // seconds
+    std::string trace_path = ""; // Chrome trace file (empty uses NUITRACK_TRACE environment variable)
+
 public:
     // Constructor
     NuiTrack( const std::string& config_json = "" );
@@ -40,6 +102,9 @@ public:
     // Processing
     void run();
 
+    // Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+    void reconfigure( const std::string& key, const std::string& value );
+
 private:
     // Initialize
     void initialize( const std::string& config_json );
@@ -50,6 +115,12 @@ private:
     // Finalize
     void finalize();
 
+    // Recreate Modules
+    inline void recreateModules( const reconfig::Change& change );
+
+    // Re-Initialize NuiTrack
+    inline void reinitialize();
+
     // Update Data
     void update();
 
@@ -74,6 +145,9 @@ private:
     // Draw Attributes
     inline void drawAttributes( cv::Mat& image, const parser::Face& face, const cv::Point& org, const double fontScale, const cv::Vec3b& color, const int32_t thickness = 2 );
 
+    // Color of User
+    inline const cv::Vec3b& userColor( const int32_t id );
+
     // Show Data
     void show();
 
@@ -1,5 +1,6 @@
 #include "nuitrack.h"
 
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -21,24 +22,57 @@ NuiTrack::~NuiTrack()
 void NuiTrack::run()
 {
     // Run NuiTrack
-    tdv::nuitrack::Nuitrack::run();
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::run" );
+        tdv::nuitrack::Nuitrack::run();
+    }
+
+    // Start Trace (Chrome Trace Event Format)
+    TRACE_START( trace_path );
 
     // Main Loop
     while( true ){
+        PROFILE_SCOPE( "NuiTrack::frame" );
+
         // Update Data
         update();
 
-        // Draw Data
-        draw();
+        // Begin Frame (Pacing and Gap of Reconfiguration Follow New Frame of Skeleton)
+        runner.begin( skeleton_updated, skeleton_data->getTimestamp() );
+
+        // Draw and Show Data (Skip if No Stream has New Frame)
+        if( runner.due( updated ) ){
+            // Draw Data
+            draw();
 
-        // Show Data
-        show();
+            // Show Data
+            show();
+        }
+
+        // Report Startup, Profile and Threads, and Flush Trace
+        runner.report( updated );
 
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
+        // Request Gesture Recognizer after First Frame
+        if( recognize_gestures && startup_timeline.getFirstFrame() >= 0.0 ){
+            gesture_recognizer.get();
+        }
+
+        // Key Check (Non-Blocking)
+        int32_t key;
+        {
+            PROFILE_SCOPE( "cv::pollKey" );
+            #if CV_VERSION_MAJOR > 4 || ( CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6 )
+            key = cv::pollKey();
+            #else
+            key = cv::waitKey( 1 );
+            #endif
+        }
         if( key == 'q' ){
             break;
         }
+
+        // End Frame (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+        runner.end( skeleton_updated, skeleton_sequence.getDropped() );
     }
 }
 
@@ -47,19 +81,63 @@ void NuiTrack::initialize( const std::string& config_json )
 {
     cv::setUseOptimized( true );
 
+    // Place Main Thread (Capture, Processing and Rendering) and Workers of Pool
+    if( !thread_placement.empty() && !affinity::place( affinity::parsePlacement( thread_placement ) ) ){
+        std::cout << "thread placement " << thread_placement << " is not permitted" << std::endl;
+    }
+    if( !worker_placement.empty() ){
+        parallel::place( affinity::parsePlacement( worker_placement ) );
+    }
+
+    // Attach Main Thread to Usage Report
+    affinity::attach( "main" );
+
+    // Keep Config for Re-Initialize
+    this->config_json = config_json;
+
+    // Log Decisions of Quality Controller
+    quality_controller.setLog( &std::cout );
+
+    // Log Reconfigurations (Registered Depth follows Color Resolution)
+    reconfigurator.setLog( &std::cout );
+    reconfigurator.setRegistration( align );
+
+    // Hooks of Reconfiguration (Sensors and Trackers of This Sample)
+    reconfig_hooks.set = []( const std::string& key, const std::string& value ){ tdv::nuitrack::Nuitrack::setConfigValue( key, value ); };
+    reconfig_hooks.recreate = [this]( const reconfig::Change& change ){ recreateModules( change ); };
+    reconfig_hooks.reinitialize = [this](){ reinitialize(); };
+
+    // Log Lazily Created Modules
+    startup_timeline.setLog( &std::cout );
+
+    // Join Gestures with Skeletons within Tolerance (Gestures are Sparse Events)
+    joiner.setTolerance( JOIN_GESTURE, gesture_tolerance );
+
+    // Attach Components to Runner of Main Loop
+    runner.setPacer( &pacer );
+    runner.setStartup( &startup_timeline );
+    runner.setReconfigurator( &reconfigurator, reconfig_hooks, hot_reconfig );
+    if( adaptive_quality ){
+        runner.setQuality( &quality_controller, { "Realsense2Module.RGB." } );
+    }
+    runner.setLog( &std::cout, profile_interval );
+
     // Initialize NuiTrack
-    tdv::nuitrack::Nuitrack::init( config_json );
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::init" );
+        tdv::nuitrack::Nuitrack::init( config_json );
+    }
 
     // Initialize Sensor
     initializeSensor();
 
     // Initalize Color Table for Visualization
-    colors[0] = cv::Vec3b( 255,   0,   0 ); // Blue
-    colors[1] = cv::Vec3b(   0, 255,   0 ); // Green
-    colors[2] = cv::Vec3b(   0,   0, 255 ); // Red
-    colors[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
-    colors[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
-    colors[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
+    palette[0] = cv::Vec3b( 255,   0,   0 ); // Blue
+    palette[1] = cv::Vec3b(   0, 255,   0 ); // Green
+    palette[2] = cv::Vec3b(   0,   0, 255 ); // Red
+    palette[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
+    palette[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
+    palette[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
 }
 
 // Initialize Sensor
@@ -70,22 +148,32 @@ inline void NuiTrack::initializeSensor()
     tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.RGB.ProcessHeight", std::to_string( color_height ) );
     tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth2ColorRegistration", align ? "true" : "false" );
 
-    // Create Sensor
-    color_sensor = tdv::nuitrack::ColorSensor::create();
-
-    // Create Tracker
-    skeleton_tracker = tdv::nuitrack::SkeletonTracker::create();
-
-    // Create Recognizer
-    gesture_recognizer = tdv::nuitrack::GestureRecognizer::create();
+    // Set Config Changed by Reconfiguration (Overrides Device Config)
+    const reconfig::Config config = reconfigurator.getConfig();
+    for( const std::pair<const std::string, std::string>& entry : config ){
+        tdv::nuitrack::Nuitrack::setConfigValue( entry.first, entry.second );
+    }
 
-    // Register Callback
-    gesture_recognizer->connectOnNewGestures( std::bind( &NuiTrack::onNewGestures, this, std::placeholders::_1 ) );
+    // Create Sensor and Tracker (Independent Modules are Created Concurrently)
+    startup::parallel( startup_timeline, {
+        { "ColorSensor::create", [&](){ color_sensor = tdv::nuitrack::ColorSensor::create(); } },
+        { "SkeletonTracker::create", [&](){ skeleton_tracker = tdv::nuitrack::SkeletonTracker::create(); } }
+    }, parallel_startup );
+
+    // Defer Recognizer until First Request (Recognizer is Created and Callback is Registered Lazily)
+    gesture_recognizer = startup::Lazy<tdv::nuitrack::GestureRecognizer::Ptr>( "GestureRecognizer::create", [this](){
+        const tdv::nuitrack::GestureRecognizer::Ptr recognizer = tdv::nuitrack::GestureRecognizer::create();
+        gesture_handler = recognizer->connectOnNewGestures( std::bind( &NuiTrack::onNewGestures, this, std::placeholders::_1 ) );
+        return recognizer;
+    }, &startup_timeline );
 }
 
 // Finalize
 void NuiTrack::finalize()
 {
+    // Stop Trace
+    TRACE_STOP();
+
     // Close Windows
     cv::destroyAllWindows();
 
@@ -93,9 +181,49 @@ void NuiTrack::finalize()
     tdv::nuitrack::Nuitrack::release();
 }
 
+// Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+void NuiTrack::reconfigure( const std::string& key, const std::string& value )
+{
+    reconfigurator.set( key, value );
+}
+
+// Recreate Modules Affected by Changed Config (Frame ID of Recreated Module may Restart)
+inline void NuiTrack::recreateModules( const reconfig::Change& change )
+{
+    if( change.affects( reconfig::COLOR ) ){
+        color_sensor = tdv::nuitrack::ColorSensor::create();
+        color_sequence.reset();
+    }
+
+    if( change.affects( reconfig::SKELETON ) ){
+        skeleton_tracker = tdv::nuitrack::SkeletonTracker::create();
+        skeleton_sequence.reset();
+    }
+
+    if( change.affects( reconfig::GESTURE ) && gesture_recognizer.isCreated() ){
+        gesture_recognizer.get()->disconnectOnNewGestures( gesture_handler );
+        gesture_recognizer.reset(); // created again on next request
+    }
+}
+
+// Re-Initialize NuiTrack (Device Config and Changed Config are Applied at Initialize)
+inline void NuiTrack::reinitialize()
+{
+    tdv::nuitrack::Nuitrack::release();
+    tdv::nuitrack::Nuitrack::init( config_json );
+    initializeSensor();
+    tdv::nuitrack::Nuitrack::run();
+
+    // Reset Sequence (Frame ID and Timestamp are Restarted)
+    color_sequence.reset();
+    skeleton_sequence.reset();
+}
+
 // Update Data
 void NuiTrack::update()
 {
+    PROFILE_SCOPE( "NuiTrack::update" );
+
     // Update Frame
     updateFrame();
 
@@ -104,21 +232,30 @@ void NuiTrack::update()
 
     // Update Skeleton
     updateSkeleton();
+
+    // Any Stream has New Frame
+    updated = color_updated || skeleton_updated;
 }
 
 // Update Frame
 inline void NuiTrack::updateFrame()
 {
     // Update Frame
+    PROFILE_SCOPE( "Nuitrack::update" );
     tdv::nuitrack::Nuitrack::update();
 }
 
 // Update Color
 inline void NuiTrack::updateColor()
 {
+    PROFILE_SCOPE( "NuiTrack::updateColor" );
+
     // Retrieve Color Frame
     color_frame = color_sensor->getColorFrame();
 
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    color_updated = color_sequence.update( color_frame->getID(), color_frame->getTimestamp() );
+
     // Retrive Frame Size
     color_width = color_frame->getCols();
     color_height = color_frame->getRows();
@@ -127,8 +264,11 @@ inline void NuiTrack::updateColor()
 // Update Skeleton
 inline void NuiTrack::updateSkeleton()
 {
+    PROFILE_SCOPE( "NuiTrack::updateSkeleton" );
+
     // Update Tracker
     try{
+        PROFILE_SCOPE( "Nuitrack::waitUpdate( skeleton_tracker )" );
         tdv::nuitrack::Nuitrack::waitUpdate( skeleton_tracker );
     } catch( const tdv::nuitrack::LicenseNotAcquiredException& ex ){
         throw std::runtime_error( "failed license not acquired" );
@@ -136,11 +276,21 @@ inline void NuiTrack::updateSkeleton()
 
     // Retrieve Skeleton Data
     skeleton_data = skeleton_tracker->getSkeletons();
+
+    // Check Sequence (Skip Conversion of Duplicate Data)
+    skeleton_updated = skeleton_sequence.update( skeleton_data->getTimestamp() );
+
+    // Push New Skeletons to Join
+    if( skeleton_updated ){
+        joiner.ring<JOIN_SKELETON>().push( skeleton_data->getTimestamp(), skeleton_data );
+    }
 }
 
 // Draw Data
 void NuiTrack::draw()
 {
+    PROFILE_SCOPE( "NuiTrack::draw" );
+
     // Draw Color
     drawColor();
 
@@ -151,20 +301,23 @@ void NuiTrack::draw()
 // Draw Color
 inline void NuiTrack::drawColor()
 {
-    // Create cv::Mat form Color Data
-    const tdv::nuitrack::Color3* color_data = color_frame->getData();
-    color_mat = cv::Mat::zeros( color_height, color_width, CV_8UC3 );
+    PROFILE_SCOPE( "NuiTrack::drawColor" );
 
-    #pragma omp parallel for
-    for( int32_t index = 0; index < color_mat.total(); index++ ){
-        const tdv::nuitrack::Color3 color = color_data[index];
-        color_mat.at<cv::Vec3b>( index ) = cv::Vec3b( color.blue, color.green, color.red );
+    if( !color_updated ){
+        return;
     }
+
+    // Create cv::Mat form Color Data
+    const tdv::nuitrack::Color3* color_data = color_frame->getData();
+    color_mat.create( color_height, color_width, CV_8UC3 );
+    frame::copyColor( reinterpret_cast<const uint8_t*>( color_data ), color_mat.data, static_cast<int32_t>( color_mat.total() ) );
 }
 
 // Draw Skeleton
 inline void NuiTrack::drawSkeleton()
 {
+    PROFILE_SCOPE( "NuiTrack::drawSkeleton" );
+
     if( color_mat.empty() ){
         return;
     }
@@ -172,8 +325,19 @@ inline void NuiTrack::drawSkeleton()
     // Copy Color Mat
     color_mat.copyTo( skeleton_mat );
 
+    // Recycle Colors of Users that are Gone
+    colors.age();
+
+    // Snapshot of Latest Skeletons and Closest Gestures
+    Joiner::Bundle bundle;
+    if( !joiner.latest<JOIN_SKELETON>( bundle ) ){
+        return;
+    }
+    const join::Item<tdv::nuitrack::GestureData::Ptr>& gesture_item = std::get<JOIN_GESTURE>( bundle.items );
+    const std::vector<tdv::nuitrack::Gesture> gestures = gesture_item.valid ? gesture_item.value->getGestures() : std::vector<tdv::nuitrack::Gesture>();
+
     // Draw Skeleton
-    const std::vector<tdv::nuitrack::Skeleton> skeletons = skeleton_data->getSkeletons();
+    const std::vector<tdv::nuitrack::Skeleton> skeletons = std::get<JOIN_SKELETON>( bundle.items ).value->getSkeletons();
 
     for( const tdv::nuitrack::Skeleton& skeleton : skeletons ){
         const int32_t id = skeleton.id;
@@ -183,21 +347,44 @@ inline void NuiTrack::drawSkeleton()
         const tdv::nuitrack::Joint left_hand = joints[tdv::nuitrack::JointType::JOINT_LEFT_HAND];
         if( left_hand.confidence > 0.2 ){
             const cv::Point point = { static_cast<int32_t>( left_hand.proj.x * color_width ) , static_cast<int32_t>( left_hand.proj.y * color_height ) };
-            cv::circle( skeleton_mat, point, 5, colors[id - 1], -1 );
+            cv::circle( skeleton_mat, point, 5, userColor( id ), -1 );
         }
 
         // Right Hand
         const tdv::nuitrack::Joint right_hand = joints[tdv::nuitrack::JointType::JOINT_RIGHT_HAND];
         if( right_hand.confidence > 0.2 ){
             const cv::Point point = { static_cast<int32_t>( right_hand.proj.x * color_width ) , static_cast<int32_t>( right_hand.proj.y * color_height ) };
-            cv::circle( skeleton_mat, point, 5, colors[id - 1], -1 );
+            cv::circle( skeleton_mat, point, 5, userColor( id ), -1 );
+        }
+
+        // Gesture of User
+        const tdv::nuitrack::Joint head = joints[tdv::nuitrack::JointType::JOINT_HEAD];
+        for( const tdv::nuitrack::Gesture& gesture : gestures ){
+            if( gesture.userId != id ){
+                continue;
+            }
+            const cv::Point point = { static_cast<int32_t>( head.proj.x * color_width ) , static_cast<int32_t>( head.proj.y * color_height ) };
+            cv::putText( skeleton_mat, type2string( gesture.type ), point, cv::FONT_HERSHEY_SIMPLEX, 1.0, userColor( id ), 2 );
         }
     }
 }
 
+// Color of User (New User takes Color of its Slot, so that Users at Same Time have Different Colors up to PALETTE_SIZE)
+inline const cv::Vec3b& NuiTrack::userColor( const int32_t id )
+{
+    bool inserted = false;
+    const uint32_t slot = colors.acquire( id, &inserted );
+    if( inserted ){
+        colors.at( slot ) = palette[slot % palette.size()];
+    }
+    return colors.at( slot );
+}
+
 // Show Data
 void NuiTrack::show()
 {
+    PROFILE_SCOPE( "NuiTrack::show" );
+
     // Show Skeleton
     showSkeleton();
 }
@@ -205,6 +392,8 @@ void NuiTrack::show()
 // Show Skeleton
 inline void NuiTrack::showSkeleton()
 {
+    PROFILE_SCOPE( "NuiTrack::showSkeleton" );
+
     if( skeleton_mat.empty() ){
         return;
     }
@@ -216,6 +405,9 @@ inline void NuiTrack::showSkeleton()
 // On New Gestures
 void NuiTrack::onNewGestures( const tdv::nuitrack::GestureData::Ptr gesture_data )
 {
+    // Push Gestures to Join (Callback may be Called on Other Thread than Main Thread)
+    joiner.ring<JOIN_GESTURE>().push( gesture_data->getTimestamp(), gesture_data );
+
     // Show Gestures
     const std::vector<tdv::nuitrack::Gesture> gestures = gesture_data->getGestures();
     for( const tdv::nuitrack::Gesture& gesture : gestures ){
@@ -1,11 +1,25 @@
 #ifndef __NUITRACK__
 #define __NUITRACK__
 
+#include "frame.h"
+#include "profile.h"
+#include "trace.h"
+#include "sequence.h"
+#include "pacing.h"
+#include "quality.h"
+#include "startup.h"
+#include "reconfig.h"
+#include "loop.h"
+#include "parallel.h"
+#include "affinity.h"
+#include "slots.h"
+#include "join.h"
+
 #include <nuitrack/Nuitrack.h>
 #include <opencv2/opencv.hpp>
 #include <array>
 
-#define USER_COUNT 6
+#define PALETTE_SIZE 6
 
 class NuiTrack
 {
@@ -13,6 +27,8 @@ private:
     // Color Sensor
     tdv::nuitrack::ColorSensor::Ptr color_sensor;
     tdv::nuitrack::RGBFrame::Ptr color_frame;
+    sequence::Stream color_sequence = sequence::Stream( "color" );
+    bool color_updated = false;
     cv::Mat color_mat;
     uint32_t color_width = 1280;
     uint32_t color_height = 720;
@@ -20,16 +36,59 @@ private:
     // Skeleton Tracker
     tdv::nuitrack::SkeletonTracker::Ptr skeleton_tracker;
     tdv::nuitrack::SkeletonData::Ptr skeleton_data;
+    sequence::Stream skeleton_sequence = sequence::Stream( "skeleton" );
+    bool skeleton_updated = false;
     cv::Mat skeleton_mat;
-    std::array<cv::Vec3b, USER_COUNT> colors;
+    std::array<cv::Vec3b, PALETTE_SIZE> palette; // color of each slot of user
+    slots::Table<cv::Vec3b> colors; // color of each user id (slot of user that is gone is recycled)
 
     // Align
     bool align = true;
 
     // Gesture Recognizer
-    tdv::nuitrack::GestureRecognizer::Ptr gesture_recognizer;
+    startup::Lazy<tdv::nuitrack::GestureRecognizer::Ptr> gesture_recognizer; // created on first request (not on path to first frame)
+    uint64_t gesture_handler = 0; // handler of callback
+    bool recognize_gestures = true; // requests recognizer after first frame
     tdv::nuitrack::GestureData::Ptr gesture_data;
 
+    // Join (Snapshot of Skeletons and Gestures of Same Instant, Gestures arrive by Callback)
+    typedef join::Joiner<tdv::nuitrack::SkeletonData::Ptr, tdv::nuitrack::GestureData::Ptr> Joiner;
+    static const size_t JOIN_SKELETON = 0;
+    static const size_t JOIN_GESTURE = 1;
+    Joiner joiner; // lock-free ring of each modality
+    double gesture_tolerance = 0.5; // seconds, gesture is drawn with skeletons within this time
+
+    // Sequence
+    bool updated = false; // any stream has new frame
+
+    // Pacing
+    pacing::Pacer pacer; // sleeps until predicted arrival of next skeleton frame
+
+    // Quality
+    quality::Controller quality_controller = quality::Controller( quality::LADDER, { color_width, color_height } ); // switches processing resolution by frame time
+    bool adaptive_quality = true;
+    std::string config_json; // re-applied when processing resolution is changed
+
+    // Reconfiguration
+    reconfig::Reconfigurator reconfigurator; // applies changed config at frame boundary
+    reconfig::Hooks reconfig_hooks; // recreate or re-initialize modules of this sample
+    bool hot_reconfig = true; // recreates only affected modules (false re-initializes NuiTrack)
+
+    // Main Loop
+    loop::Runner runner; // pacing, frame time, quality, shedding, idle rate, reports and reconfiguration of each frame
+
+    // Startup
+    startup::Timeline startup_timeline; // phases until first frame
+    bool parallel_startup = true; // creates independent modules concurrently
+
+    // Threads
+    std::string thread_placement = ""; // core set, policy and priority of main thread that captures, processes and renders (e.g. "2:fifo:10"), empty keeps
+    std::string worker_placement = ""; // core set, policy and priority of workers of pool (e.g. "3-7"), empty uses NUITRACK_CORES
+
+    // Profile
+    double profile_interval = 5.0; // seconds
+    std::string trace_path = ""; // Chrome trace file (empty uses NUITRACK_TRACE environment variable)
+
 public:
     // Constructor
     NuiTrack( const std::string& config_json = "" );
@@ -40,6 +99,9 @@ public:
     // Processing
     void run();
 
+    // Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+    void reconfigure( const std::string& key, const std::string& value );
+
 private:
     // Initialize
     void initialize( const std::string& config_json );
@@ -50,6 +112,12 @@ private:
     // Finalize
     void finalize();
 
+    // Recreate Modules
+    inline void recreateModules( const reconfig::Change& change );
+
+    // Re-Initialize NuiTrack
+    inline void reinitialize();
+
     // Update Data
     void update();
 
@@ -71,6 +139,9 @@ private:
     // Draw Skeleton
     inline void drawSkeleton();
 
+    // Color of User
+    inline const cv::Vec3b& userColor( const int32_t id );
+
     // Show Data
     void show();
 
@@ -0,0 +1,553 @@
+#include "nuitrack.h"
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+// Constructor
+NuiTrack::NuiTrack( const std::string& config_json )
+{
+    // Initialize
+    initialize( config_json );
+}
+
+// Destructor
+NuiTrack::~NuiTrack()
+{
+    // Finalize
+    finalize();
+}
+
+// Processing
+void NuiTrack::run()
+{
+    // Run NuiTrack
+    tdv::nuitrack::Nuitrack::run();
+
+    // Start Pipelines
+    for( std::unique_ptr<Pipeline>& pipeline : pipelines ){
+        Pipeline* target = pipeline.get();
+        pipeline->thread = std::thread( [this, target](){ process( *target ); } );
+    }
+
+    // Start Trace (Chrome Trace Event Format)
+    TRACE_START( trace_path );
+
+    // Main Loop
+    while( true ){
+        PROFILE_SCOPE( "NuiTrack::frame" );
+
+        // Update Data
+        update();
+
+        // Draw Data
+        draw();
+
+        // Show Data (Skip if Merged Stream has No New Frame)
+        if( updated ){
+            show();
+        }
+
+        // Report Profile
+        PROFILE_REPORT( std::cout, profile_interval );
+
+        // Report CPU Time and Context Switches of Threads
+        affinity::report( std::cout, profile_interval );
+
+        // Flush Trace
+        TRACE_FLUSH();
+
+        // Key Check (Non-Blocking)
+        int32_t key;
+        {
+            PROFILE_SCOPE( "cv::pollKey" );
+            #if CV_VERSION_MAJOR > 4 || ( CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6 )
+            key = cv::pollKey();
+            #else
+            key = cv::waitKey( 1 );
+            #endif
+        }
+        if( key == 'q' ){
+            break;
+        }
+
+        // Wait for Next Frame of Any Device (or Display Deadline)
+        wait();
+    }
+}
+
+// Initialize
+void NuiTrack::initialize( const std::string& config_json )
+{
+    cv::setUseOptimized( true );
+
+    // Place Main Thread (Capture and Rendering) and Attach to Usage Report
+    if( !thread_placement.empty() && !affinity::place( affinity::parsePlacement( thread_placement ) ) ){
+        std::cout << "thread placement " << thread_placement << " is not permitted" << std::endl;
+    }
+    affinity::attach( "main" );
+
+    // Initialize NuiTrack
+    tdv::nuitrack::Nuitrack::init( config_json );
+
+    // Initialize Sensor
+    initializeSensor();
+
+    // Initialize Pipeline
+    initializePipeline();
+
+    // Initialize Fusion
+    initializeFusion();
+
+    // Initalize Color Table for Visualization
+    palette[0] = cv::Vec3b( 255,   0,   0 ); // Blue
+    palette[1] = cv::Vec3b(   0, 255,   0 ); // Green
+    palette[2] = cv::Vec3b(   0,   0, 255 ); // Red
+    palette[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
+    palette[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
+    palette[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
+}
+
+// Initialize Sensor
+inline void NuiTrack::initializeSensor()
+{
+    // Set Device Config (Common to All Devices)
+    tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth.ProcessWidth", std::to_string( depth_width ) );
+    tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth.ProcessHeight", std::to_string( depth_height ) );
+
+    // Get Device Config
+    max_distance = std::stoi( tdv::nuitrack::Nuitrack::getConfigValue( "Realsense2Module.Depth.ProcessMaxDepth" ) );
+
+    // Enumerate Devices
+    const std::vector<tdv::nuitrack::device::NuitrackDevice::Ptr> devices = tdv::nuitrack::Nuitrack::getDeviceList();
+    if( devices.empty() ){
+        throw std::runtime_error( "failed to find device" );
+    }
+
+    for( uint32_t index = 0; index < devices.size(); index++ ){
+        const std::string serial = devices[index]->getInfo( tdv::nuitrack::device::DeviceInfoType::SERIAL_NUMBER );
+        pipelines.emplace_back( new Pipeline( index, serial ) );
+        Pipeline& pipeline = *pipelines.back();
+
+        // Create Sensor and Tracker of Device (Modules are Bound to Selected Device)
+        tdv::nuitrack::Nuitrack::setDevice( devices[index] );
+        pipeline.depth_sensor = tdv::nuitrack::DepthSensor::create();
+        pipeline.user_tracker = tdv::nuitrack::UserTracker::create();
+        pipeline.skeleton_tracker = tdv::nuitrack::SkeletonTracker::create();
+    }
+}
+
+// Initialize Pipeline
+inline void NuiTrack::initializePipeline()
+{
+    // Placement of Each Pipeline (Given, or Cores are Split Evenly)
+    std::vector<affinity::Placement> placements;
+    std::istringstream stream( core_sets );
+    std::string placement;
+    while( std::getline( stream, placement, ';' ) ){
+        placements.push_back( affinity::parsePlacement( placement ) );
+    }
+
+    if( placements.empty() ){
+        for( const std::vector<int32_t>& core_set : affinity::split( static_cast<int32_t>( pipelines.size() ) ) ){
+            placements.push_back( affinity::Placement() );
+            placements.back().core_set = core_set;
+        }
+    }
+
+    for( std::unique_ptr<Pipeline>& pipeline : pipelines ){
+        pipeline->placement = placements[pipeline->index % placements.size()];
+        std::cout << "device " << pipeline->index << " (" << pipeline->serial << ") placement " << affinity::format( pipeline->placement ) << std::endl;
+    }
+
+    // Merged Stream
+    merger.reset( new merge::Merger<cv::Mat>( static_cast<uint32_t>( pipelines.size() ) ) );
+    tiles.resize( pipelines.size() );
+}
+
+// Initialize Fusion
+inline void NuiTrack::initializeFusion()
+{
+    fuser.reset( new fusion::Fuser( static_cast<uint32_t>( pipelines.size() ) ) );
+    skeletons.resize( pipelines.size() );
+
+    // Load Extrinsics of Devices (Camera to World)
+    cv::FileStorage storage( extrinsics_path, cv::FileStorage::READ );
+    if( !storage.isOpened() ){
+        return;
+    }
+
+    for( const std::unique_ptr<Pipeline>& pipeline : pipelines ){
+        cv::Mat rotation, translation;
+        storage["camera_" + pipeline->serial]["rotation"] >> rotation;
+        storage["camera_" + pipeline->serial]["translation"] >> translation;
+
+        camera::Extrinsics extrinsics;
+        if( rotation.total() == 9 ){
+            rotation.convertTo( rotation, CV_32F );
+            std::copy( rotation.ptr<float>(), rotation.ptr<float>() + 9, extrinsics.rotation );
+        }
+        if( translation.total() == 3 ){
+            translation.convertTo( translation, CV_32F );
+            std::copy( translation.ptr<float>(), translation.ptr<float>() + 3, extrinsics.translation );
+        }
+        fuser->setExtrinsics( pipeline->index, extrinsics );
+    }
+}
+
+// Finalize
+void NuiTrack::finalize()
+{
+    // Stop Pipelines
+    for( std::unique_ptr<Pipeline>& pipeline : pipelines ){
+        {
+            std::lock_guard<std::mutex> lock( pipeline->mutex );
+            pipeline->running = false;
+        }
+        pipeline->condition.notify_one();
+        if( pipeline->thread.joinable() ){
+            pipeline->thread.join();
+        }
+    }
+
+    // Stop Trace
+    TRACE_STOP();
+
+    // Close Windows
+    cv::destroyAllWindows();
+
+    // Release NuiTrack
+    tdv::nuitrack::Nuitrack::release();
+}
+
+// Update Data
+void NuiTrack::update()
+{
+    PROFILE_SCOPE( "NuiTrack::update" );
+
+    // Update Frame
+    updateFrame();
+
+    // Update Pipeline
+    skeleton_updated = false;
+    for( std::unique_ptr<Pipeline>& pipeline : pipelines ){
+        updatePipeline( *pipeline );
+    }
+
+    // Update Fusion
+    updateFusion();
+}
+
+// Update Frame
+inline void NuiTrack::updateFrame()
+{
+    // Update Frame (All Devices)
+    PROFILE_SCOPE( "Nuitrack::update" );
+    try{
+        tdv::nuitrack::Nuitrack::update();
+    }
+    catch( const tdv::nuitrack::LicenseNotAcquiredException& ex ){
+        throw std::runtime_error( "failed license not acquired" );
+    }
+}
+
+// Update Pipeline
+inline void NuiTrack::updatePipeline( Pipeline& pipeline )
+{
+    PROFILE_SCOPE( "NuiTrack::updatePipeline" );
+
+    // Rethrow Exception of Pipeline Thread on Main Thread
+    {
+        std::exception_ptr exception;
+        {
+            std::lock_guard<std::mutex> lock( pipeline.mutex );
+            std::swap( exception, pipeline.exception );
+        }
+        if( exception ){
+            std::rethrow_exception( exception );
+        }
+    }
+
+    // Retrieve Skeletons (Converted to Camera Coordinates of Fusion)
+    const tdv::nuitrack::SkeletonData::Ptr skeleton_data = pipeline.skeleton_tracker->getSkeletons();
+    if( skeleton_data && pipeline.skeleton_sequence.update( skeleton_data->getTimestamp() ) ){
+        pipeline.skeleton_data = skeleton_data;
+        std::vector<fusion::Skeleton>& skeletons = this->skeletons[pipeline.index];
+        const std::vector<tdv::nuitrack::Skeleton> tracked = skeleton_data->getSkeletons();
+        skeletons.resize( tracked.size() );
+        for( size_t index = 0; index < tracked.size(); index++ ){
+            skeletons[index].id = tracked[index].id;
+            for( int32_t joint = 0; joint < fusion::JOINTS && joint < static_cast<int32_t>( tracked[index].joints.size() ); joint++ ){
+                const tdv::nuitrack::Joint& input = tracked[index].joints[joint];
+                fusion::Joint& output = skeletons[index].joints[joint];
+                output.x = input.real.x;
+                output.y = input.real.y;
+                output.z = input.real.z;
+                output.confidence = input.confidence;
+            }
+        }
+        skeleton_updated = true;
+    }
+
+    // Retrieve Depth Frame and User Frame
+    const tdv::nuitrack::DepthFrame::Ptr depth_frame = pipeline.depth_sensor->getDepthFrame();
+    const tdv::nuitrack::UserFrame::Ptr user_frame = pipeline.user_tracker->getUserFrame();
+    if( !depth_frame || !user_frame ){
+        return;
+    }
+
+    // Check Sequence (Skip Duplicate Frame)
+    pipeline.depth_sequence.update( depth_frame->getID(), depth_frame->getTimestamp() );
+    if( !pipeline.user_sequence.update( user_frame->getID(), user_frame->getTimestamp() ) ){
+        return;
+    }
+
+    // Update Pacer with Timestamp of New Frame
+    pipeline.pacer.update( user_frame->getTimestamp() );
+
+    // Hand Frames to Pipeline Thread (Previous Frames are Skipped if Pipeline is Busy)
+    {
+        std::lock_guard<std::mutex> lock( pipeline.mutex );
+        if( pipeline.pending ){
+            pipeline.skipped.add();
+        }
+        pipeline.depth_frame = depth_frame;
+        pipeline.user_frame = user_frame;
+        pipeline.time = pipeline.pacer.arrival( user_frame->getTimestamp() );
+        pipeline.pending = true;
+    }
+    pipeline.condition.notify_one();
+}
+
+// Update Fusion
+inline void NuiTrack::updateFusion()
+{
+    PROFILE_SCOPE( "NuiTrack::updateFusion" );
+
+    if( !skeleton_updated ){
+        return;
+    }
+
+    // Fuse Latest Skeletons of All Devices
+    fuser->fuse( skeletons );
+}
+
+// Process Pipeline (Pipeline Thread)
+void NuiTrack::process( Pipeline& pipeline )
+{
+    try{
+        // Place Thread on Core Set, and Place Workers of Pool of This Thread on Other Cores of Core Set with Same Policy
+        if( !affinity::place( pipeline.placement ) ){
+            std::cout << "device " << pipeline.index << " placement " << affinity::format( pipeline.placement ) << " is not supported or not permitted" << std::endl;
+        }
+        pool::Parameters parameters;
+        parameters.threads = std::max( static_cast<int32_t>( pipeline.placement.core_set.size() ), 1 );
+        parameters.core_set = pipeline.placement.core_set;
+        parameters.policy = pipeline.placement.policy;
+        parameters.priority = pipeline.placement.priority;
+        parameters.name = "pipeline " + std::to_string( pipeline.index ) + " worker";
+        parallel::configure( parameters );
+
+        // Attach Thread to Usage Report
+        affinity::attach( "pipeline " + std::to_string( pipeline.index ) );
+
+        while( true ){
+            // Wait for New Frames
+            tdv::nuitrack::DepthFrame::Ptr depth_frame;
+            tdv::nuitrack::UserFrame::Ptr user_frame;
+            merge::clock::time_point time;
+            {
+                std::unique_lock<std::mutex> lock( pipeline.mutex );
+                pipeline.condition.wait( lock, [&](){ return pipeline.pending || !pipeline.running; } );
+                if( !pipeline.running ){
+                    break;
+                }
+
+                depth_frame = std::move( pipeline.depth_frame );
+                user_frame = std::move( pipeline.user_frame );
+                time = pipeline.time;
+                pipeline.pending = false;
+            }
+
+            // Convert Frames and Push to Merged Stream
+            cv::Mat user_mat = convertUser( pipeline, depth_frame, user_frame );
+            merger->push( pipeline.index, time, std::move( user_mat ) );
+
+            TRACE_FLUSH();
+        }
+    }
+    catch( ... ){
+        // Hand Exception to Main Thread (Escaping Pipeline Thread would Terminate without Finalize)
+        std::lock_guard<std::mutex> lock( pipeline.mutex );
+        pipeline.exception = std::current_exception();
+    }
+
+    TRACE_FLUSH();
+
+    affinity::detach();
+}
+
+// Convert User (Pipeline Thread)
+inline cv::Mat NuiTrack::convertUser( Pipeline& pipeline, const tdv::nuitrack::DepthFrame::Ptr& depth_frame, const tdv::nuitrack::UserFrame::Ptr& user_frame )
+{
+    PROFILE_SCOPE( "NuiTrack::convertUser" );
+
+    // Convert Depth to BGR (New Mat per Frame, because it is Owned by Merged Stream)
+    const int32_t width = depth_frame->getCols();
+    const int32_t height = depth_frame->getRows();
+    const int32_t total = width * height;
+    cv::Mat user_mat( height, width, CV_8UC3 );
+    frame::convertDepthToBgr( depth_frame->getData(), user_mat.data, total, max_distance ); // 0-max_distance -> 255(white)-0(black)
+
+    // Recycle Colors of Users that are Gone
+    pipeline.colors.age();
+
+    // Acquire Slots of Users of Frame (Label is User ID of Device, Label that has no Slot is not Drawn)
+    const std::vector<tdv::nuitrack::User> users = user_frame->getUsers();
+    for( const tdv::nuitrack::User& user : users ){
+        userColor( pipeline, user.id );
+    }
+
+    // Draw User Area
+    if( user_frame->getCols() == width && user_frame->getRows() == height ){
+        frame::overlayLabels( user_frame->getData(), user_mat.data, total, pipeline.colors );
+    }
+
+    // Draw Bounding Box
+    for( const tdv::nuitrack::User& user : users ){
+        const int32_t id = user.id;
+        const cv::Point point1 = { static_cast<int32_t>( user.box.left * width ), static_cast<int32_t>( user.box.top * height ) };
+        const cv::Point point2 = { static_cast<int32_t>( user.box.right * width ), static_cast<int32_t>( user.box.bottom * height ) };
+        cv::rectangle( user_mat, point1, point2, userColor( pipeline, id ) );
+    }
+
+    return user_mat;
+}
+
+// Color of User (Pipeline Thread, New User takes Color of its Slot, so that Users of Device at Same Time have Different Colors up to PALETTE_SIZE)
+inline const cv::Vec3b& NuiTrack::userColor( Pipeline& pipeline, const int32_t id )
+{
+    bool inserted = false;
+    const uint32_t slot = pipeline.colors.acquire( id, &inserted );
+    if( inserted ){
+        pipeline.colors.at( slot ) = palette[slot % palette.size()];
+    }
+    return pipeline.colors.at( slot );
+}
+
+// Draw Data
+void NuiTrack::draw()
+{
+    PROFILE_SCOPE( "NuiTrack::draw" );
+
+    // Draw Mosaic
+    drawMosaic();
+}
+
+// Draw Mosaic
+inline void NuiTrack::drawMosaic()
+{
+    PROFILE_SCOPE( "NuiTrack::drawMosaic" );
+
+    // Retrieve Converted Frames from Merged Stream in Time Order
+    updated = false;
+    merge::Item<cv::Mat> item;
+    while( merger->pop( item ) ){
+        tiles[item.source] = std::move( item.value );
+        updated = true;
+    }
+
+    if( !updated || tiles.front().empty() ){
+        return;
+    }
+
+    // Arrange Tiles in Grid (Size of First Device)
+    const int32_t columns = static_cast<int32_t>( std::ceil( std::sqrt( static_cast<double>( tiles.size() ) ) ) );
+    const int32_t rows = ( static_cast<int32_t>( tiles.size() ) + columns - 1 ) / columns;
+    const cv::Size size = tiles.front().size();
+    mosaic_mat.create( size.height * rows, size.width * columns, CV_8UC3 );
+
+    for( size_t index = 0; index < tiles.size(); index++ ){
+        const cv::Rect rect( static_cast<int32_t>( index % columns ) * size.width, static_cast<int32_t>( index / columns ) * size.height, size.width, size.height );
+        cv::Mat tile = mosaic_mat( rect );
+        if( tiles[index].empty() ){
+            tile.setTo( cv::Scalar::all( 0 ) );
+        }
+        else if( tiles[index].size() == size ){
+            tiles[index].copyTo( tile );
+        }
+        else{
+            cv::resize( tiles[index], tile, size );
+        }
+
+        // Draw Serial Number of Device
+        cv::putText( tile, pipelines[index]->serial, cv::Point( 10, 30 ), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar( 0, 0, 255 ), 2 );
+    }
+
+    // Draw Fusion
+    drawFusion( columns, size );
+}
+
+// Draw Fusion
+inline void NuiTrack::drawFusion( const int32_t columns, const cv::Size& size )
+{
+    PROFILE_SCOPE( "NuiTrack::drawFusion" );
+
+    // Draw ID of Fused Skeleton at Head of Each Skeleton that is Part of It (Same Person has Same ID on All Devices)
+    for( const fusion::Fused& fused : fuser->getFused() ){
+        for( const fusion::Member& member : fused.members ){
+            const Pipeline& pipeline = *pipelines[member.source];
+            if( !pipeline.skeleton_data ){
+                continue;
+            }
+
+            const std::vector<tdv::nuitrack::Skeleton> tracked = pipeline.skeleton_data->getSkeletons();
+            for( const tdv::nuitrack::Skeleton& skeleton : tracked ){
+                if( skeleton.id != member.id ){
+                    continue;
+                }
+
+                const tdv::nuitrack::Joint& head = skeleton.joints[tdv::nuitrack::JOINT_HEAD];
+                const cv::Point point( static_cast<int32_t>( ( member.source % columns ) * size.width + head.proj.x * size.width ),
+                                       static_cast<int32_t>( ( member.source / columns ) * size.height + head.proj.y * size.height ) );
+                cv::putText( mosaic_mat, "ID " + std::to_string( fused.id ), point, cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar( 255, 255, 255 ), 2 );
+            }
+        }
+    }
+}
+
+// Show Data
+void NuiTrack::show()
+{
+    PROFILE_SCOPE( "NuiTrack::show" );
+
+    // Show Mosaic
+    showMosaic();
+}
+
+// Show Mosaic
+inline void NuiTrack::showMosaic()
+{
+    PROFILE_SCOPE( "NuiTrack::showMosaic" );
+
+    if( mosaic_mat.empty() ){
+        return;
+    }
+
+    // Show Mosaic Image
+    cv::imshow( "MultiSensor", mosaic_mat );
+}
+
+// Wait for Next Frame of Any Device
+inline void NuiTrack::wait()
+{
+    PROFILE_SCOPE( "pacing::Pacer::wait" );
+
+    // Sleep until Earliest Predicted Arrival of Devices (or Display Deadline)
+    pacing::clock::time_point deadline = pacing::clock::time_point::max();
+    for( const std::unique_ptr<Pipeline>& pipeline : pipelines ){
+        deadline = std::min( deadline, pipeline->pacer.deadline() );
+    }
+    std::this_thread::sleep_until( deadline );
+}
@@ -0,0 +1,167 @@
+#ifndef __NUITRACK__
+#define __NUITRACK__
+
+#include "frame.h"
+#include "parallel.h"
+#include "profile.h"
+#include "trace.h"
+#include "sequence.h"
+#include "pacing.h"
+#include "affinity.h"
+#include "merge.h"
+#include "fusion.h"
+#include "slots.h"
+
+#include <nuitrack/Nuitrack.h>
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <exception>
+#include <condition_variable>
+
+#define PALETTE_SIZE 6
+
+// Pipeline of Device (Frames of Device are Converted on Own Thread that is Pinned to Core Set)
+struct Pipeline
+{
+    // Device
+    uint32_t index;
+    std::string serial;
+    affinity::Placement placement; // core set, policy and priority of pipeline thread and its workers
+
+    // Depth Sensor
+    tdv::nuitrack::DepthSensor::Ptr depth_sensor;
+    sequence::Stream depth_sequence;
+
+    // User Tracker
+    tdv::nuitrack::UserTracker::Ptr user_tracker;
+    sequence::Stream user_sequence;
+    slots::Table<cv::Vec3b> colors; // color of each user id of device (slot of user that is gone is recycled)
+
+    // Skeleton Tracker
+    tdv::nuitrack::SkeletonTracker::Ptr skeleton_tracker;
+    tdv::nuitrack::SkeletonData::Ptr skeleton_data;
+    sequence::Stream skeleton_sequence;
+
+    // Pacing (Predicts Next Frame, and Maps Timestamp of Device Clock to Monotonic Time)
+    pacing::Pacer pacer;
+
+    // Mailbox (Latest Frames Handed from SDK Thread, Overwritten if Pipeline is Busy)
+    std::mutex mutex;
+    std::condition_variable condition;
+    tdv::nuitrack::DepthFrame::Ptr depth_frame;
+    tdv::nuitrack::UserFrame::Ptr user_frame;
+    merge::clock::time_point time;
+    bool pending = false;
+    bool running = true;
+    profile::Counter skipped;
+    std::exception_ptr exception; // exception of pipeline thread (rethrown on main thread)
+
+    // Thread
+    std::thread thread;
+
+    Pipeline( const uint32_t index, const std::string& serial )
+        : index( index ), serial( serial ), depth_sequence( serial + " depth" ), user_sequence( serial + " user" ), skeleton_sequence( serial + " skeleton" ), skipped( serial + " skipped frames" )
+    {
+    }
+};
+
+class NuiTrack
+{
+private:
+    // Devices
+    std::vector<std::unique_ptr<Pipeline>> pipelines;
+    std::string core_sets = ""; // core set (and policy and priority) of each device separated by ';' (e.g. "0-3;4-7" or "0-3:fifo:10;4-7:fifo:10"), empty splits cores evenly
+    uint32_t depth_width = 848; // per device (recommended depth resolution of D435)
+    uint32_t depth_height = 480;
+    uint32_t max_distance = 5000;
+    std::array<cv::Vec3b, PALETTE_SIZE> palette; // color of each slot of user
+
+    // Merged Stream (Converted Frames of All Devices in Time Order)
+    std::unique_ptr<merge::Merger<cv::Mat>> merger;
+    std::vector<cv::Mat> tiles; // latest converted frame of each device
+    cv::Mat mosaic_mat;
+    bool updated = false; // merged stream has new frame
+
+    // Fusion (Skeletons of All Devices in World Coordinates)
+    std::unique_ptr<fusion::Fuser> fuser;
+    std::vector<std::vector<fusion::Skeleton>> skeletons; // camera coordinates of each device
+    bool skeleton_updated = false; // any device has new skeletons
+    std::string extrinsics_path = "extrinsics.yml"; // camera to world of each device (camera_<serial>: rotation, translation), identity if not exists
+
+    // Threads
+    std::string thread_placement = ""; // core set, policy and priority of main thread that captures and renders (e.g. "8:fifo:20"), empty keeps
+
+    // Profile
+    double profile_interval = 5.0; // seconds
+    std::string trace_path = ""; // Chrome trace file (empty uses NUITRACK_TRACE environment variable)
+
+public:
+    // Constructor
+    NuiTrack( const std::string& config_json = "" );
+
+    // Destructor
+    ~NuiTrack();
+
+    // Processing
+    void run();
+
+private:
+    // Initialize
+    void initialize( const std::string& config_json );
+
+    // Initialize Sensor
+    inline void initializeSensor();
+
+    // Initialize Pipeline
+    inline void initializePipeline();
+
+    // Initialize Fusion
+    inline void initializeFusion();
+
+    // Finalize
+    void finalize();
+
+    // Update Data
+    void update();
+
+    // Update Frame
+    inline void updateFrame();
+
+    // Update Pipeline
+    inline void updatePipeline( Pipeline& pipeline );
+
+    // Update Fusion
+    inline void updateFusion();
+
+    // Process Pipeline (Pipeline Thread)
+    void process( Pipeline& pipeline );
+
+    // Convert User (Pipeline Thread)
+    inline cv::Mat convertUser( Pipeline& pipeline, const tdv::nuitrack::DepthFrame::Ptr& depth_frame, const tdv::nuitrack::UserFrame::Ptr& user_frame );
+
+    // Color of User (Pipeline Thread)
+    inline const cv::Vec3b& userColor( Pipeline& pipeline, const int32_t id );
+
+    // Draw Data
+    void draw();
+
+    // Draw Mosaic
+    inline void drawMosaic();
+
+    // Draw Fusion
+    inline void drawFusion( const int32_t columns, const cv::Size& size );
+
+    // Show Data
+    void show();
+
+    // Show Mosaic
+    inline void showMosaic();
+
+    // Wait for Next Frame of Any Device
+    inline void wait();
+};
+
+#endif // __NUITRACK__
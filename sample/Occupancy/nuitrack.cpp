@@ -0,0 +1,356 @@
+#include "nuitrack.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+
+// Constructor
+NuiTrack::NuiTrack( const std::string& config_json )
+{
+    // Initialize
+    initialize( config_json );
+}
+
+// Destructor
+NuiTrack::~NuiTrack()
+{
+    // Finalize
+    finalize();
+}
+
+// Processing
+void NuiTrack::run()
+{
+    // Run NuiTrack
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::run" );
+        tdv::nuitrack::Nuitrack::run();
+    }
+
+    // Start Trace (Chrome Trace Event Format)
+    TRACE_START( trace_path );
+
+    // Main Loop
+    while( true ){
+        PROFILE_SCOPE( "NuiTrack::frame" );
+
+        // Update Data
+        update();
+
+        // Begin Frame (Pacing and Gap of Reconfiguration Follow New Frame of User)
+        runner.begin( user_updated, user_frame->getTimestamp() );
+
+        // Draw and Show Data (Skip if No Stream has New Frame)
+        if( runner.due( updated ) ){
+            // Draw Data
+            draw();
+
+            // Show Data
+            show();
+        }
+
+        // Report Startup, Profile and Threads, and Flush Trace
+        runner.report( updated );
+
+        // Key Check (Non-Blocking)
+        int32_t key;
+        {
+            PROFILE_SCOPE( "cv::pollKey" );
+            #if CV_VERSION_MAJOR > 4 || ( CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6 )
+            key = cv::pollKey();
+            #else
+            key = cv::waitKey( 1 );
+            #endif
+        }
+        if( key == 'q' ){
+            break;
+        }
+
+        // End Frame (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+        runner.end( user_updated, user_sequence.getDropped() );
+        if( key == 'c' ){
+            grid.clear();
+        }
+    }
+}
+
+// Initialize
+void NuiTrack::initialize( const std::string& config_json )
+{
+    cv::setUseOptimized( true );
+
+    // Place Main Thread (Capture, Processing and Rendering) and Workers of Pool
+    if( !thread_placement.empty() && !affinity::place( affinity::parsePlacement( thread_placement ) ) ){
+        std::cout << "thread placement " << thread_placement << " is not permitted" << std::endl;
+    }
+    if( !worker_placement.empty() ){
+        parallel::place( affinity::parsePlacement( worker_placement ) );
+    }
+
+    // Attach Main Thread to Usage Report
+    affinity::attach( "main" );
+
+    // Keep Config for Re-Initialize
+    this->config_json = config_json;
+
+    // Log Decisions of Quality Controller
+    quality_controller.setLog( &std::cout );
+
+    // Log Reconfigurations
+    reconfigurator.setLog( &std::cout );
+
+    // Hooks of Reconfiguration (Sensors and Trackers of This Sample)
+    reconfig_hooks.set = []( const std::string& key, const std::string& value ){ tdv::nuitrack::Nuitrack::setConfigValue( key, value ); };
+    reconfig_hooks.recreate = [this]( const reconfig::Change& change ){ recreateModules( change ); };
+    reconfig_hooks.reinitialize = [this](){ reinitialize(); };
+
+    // Attach Components to Runner of Main Loop
+    runner.setPacer( &pacer );
+    runner.setStartup( &startup_timeline );
+    runner.setReconfigurator( &reconfigurator, reconfig_hooks, hot_reconfig );
+    if( adaptive_quality ){
+        runner.setQuality( &quality_controller, { "Realsense2Module.Depth." } );
+    }
+    runner.setLog( &std::cout, profile_interval );
+
+    // Initialize NuiTrack
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::init" );
+        tdv::nuitrack::Nuitrack::init( config_json );
+    }
+
+    // Initialize Sensor
+    initializeSensor();
+
+    // Set Heat Map Decay (Half-Life about 2 seconds at 30 fps)
+    grid.setDecay( 0.99f );
+}
+
+// Initialize Sensor
+inline void NuiTrack::initializeSensor()
+{
+    // Set Device Config
+    tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth.ProcessWidth", std::to_string( depth_width ) );
+    tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth.ProcessHeight", std::to_string( depth_height ) );
+
+    // Set Config Changed by Reconfiguration (Overrides Device Config)
+    const reconfig::Config config = reconfigurator.getConfig();
+    for( const std::pair<const std::string, std::string>& entry : config ){
+        tdv::nuitrack::Nuitrack::setConfigValue( entry.first, entry.second );
+    }
+
+    // Create Sensor and Tracker (Independent Modules are Created Concurrently)
+    startup::parallel( startup_timeline, {
+        { "DepthSensor::create", [&](){ depth_sensor = tdv::nuitrack::DepthSensor::create(); } },
+        { "UserTracker::create", [&](){ user_tracker = tdv::nuitrack::UserTracker::create(); } }
+    }, parallel_startup );
+
+    // Retrieve Intrinsics
+    const tdv::nuitrack::OutputMode mode = depth_sensor->getOutputMode();
+    intrinsics = camera::Intrinsics::fromFov( mode.xres, mode.yres, mode.hfov );
+}
+
+// Finalize
+void NuiTrack::finalize()
+{
+    // Stop Trace
+    TRACE_STOP();
+
+    // Close Windows
+    cv::destroyAllWindows();
+
+    // Release NuiTrack
+    tdv::nuitrack::Nuitrack::release();
+}
+
+// Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+void NuiTrack::reconfigure( const std::string& key, const std::string& value )
+{
+    reconfigurator.set( key, value );
+}
+
+// Recreate Modules Affected by Changed Config (Frame ID of Recreated Module may Restart)
+inline void NuiTrack::recreateModules( const reconfig::Change& change )
+{
+    if( change.affects( reconfig::DEPTH ) ){
+        depth_sensor = tdv::nuitrack::DepthSensor::create();
+        depth_sequence.reset();
+
+        // Retrieve Intrinsics of New Output Mode
+        const tdv::nuitrack::OutputMode mode = depth_sensor->getOutputMode();
+        intrinsics = camera::Intrinsics::fromFov( mode.xres, mode.yres, mode.hfov );
+    }
+
+    if( change.affects( reconfig::USER ) ){
+        user_tracker = tdv::nuitrack::UserTracker::create();
+        user_sequence.reset();
+    }
+}
+
+// Re-Initialize NuiTrack (Device Config and Changed Config are Applied at Initialize)
+inline void NuiTrack::reinitialize()
+{
+    tdv::nuitrack::Nuitrack::release();
+    tdv::nuitrack::Nuitrack::init( config_json );
+    initializeSensor();
+    tdv::nuitrack::Nuitrack::run();
+
+    // Reset Sequence (Frame ID and Timestamp are Restarted)
+    depth_sequence.reset();
+    user_sequence.reset();
+}
+
+// Update Data
+void NuiTrack::update()
+{
+    PROFILE_SCOPE( "NuiTrack::update" );
+
+    // Update Frame
+    updateFrame();
+
+    // Update Depth
+    updateDepth();
+
+    // Update User
+    updateUser();
+
+    // Update Occupancy
+    updateOccupancy();
+
+    // Any Stream has New Frame
+    updated = depth_updated || user_updated;
+}
+
+// Update Frame
+inline void NuiTrack::updateFrame()
+{
+    // Update Frame
+    PROFILE_SCOPE( "Nuitrack::update" );
+    tdv::nuitrack::Nuitrack::update();
+}
+
+// Update Depth
+inline void NuiTrack::updateDepth()
+{
+    PROFILE_SCOPE( "NuiTrack::updateDepth" );
+
+    // Retrieve Depth Frame
+    depth_frame = depth_sensor->getDepthFrame();
+
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    depth_updated = depth_sequence.update( depth_frame->getID(), depth_frame->getTimestamp() );
+
+    // Retrive Frame Size
+    depth_width = depth_frame->getCols();
+    depth_height = depth_frame->getRows();
+
+    // Update Ray Tables (Rebuild Only When Resolution Changed)
+    const tdv::nuitrack::OutputMode mode = depth_sensor->getOutputMode();
+    const float scale_x = static_cast<float>( depth_width ) / mode.xres;
+    const float scale_y = static_cast<float>( depth_height ) / mode.yres;
+    generator.setIntrinsics( depth_width, depth_height, intrinsics.scale( scale_x, scale_y ) );
+}
+
+// Update User
+inline void NuiTrack::updateUser()
+{
+    PROFILE_SCOPE( "NuiTrack::updateUser" );
+
+    // Update Tracker
+    try{
+        PROFILE_SCOPE( "Nuitrack::waitUpdate( user_tracker )" );
+        tdv::nuitrack::Nuitrack::waitUpdate( user_tracker );
+    }
+    catch( const tdv::nuitrack::LicenseNotAcquiredException& ex ){
+        throw std::runtime_error( "failed license not acquired" );
+    }
+
+    // Retrieve User Frame
+    user_frame = user_tracker->getUserFrame();
+
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    user_updated = user_sequence.update( user_frame->getID(), user_frame->getTimestamp() );
+}
+
+// Update Occupancy
+inline void NuiTrack::updateOccupancy()
+{
+    PROFILE_SCOPE( "NuiTrack::updateOccupancy" );
+
+    if( !depth_updated ){
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Generate Point Cloud
+    const uint16_t* depth_data = depth_frame->getData();
+    if( user_only ){
+        generator.generate( depth_data, user_frame->getData(), points );
+    }
+    else{
+        generator.generate( depth_data, points );
+    }
+
+    // Accumulate Point Cloud to Occupancy Grid
+    grid.accumulate( points.data(), points.size() );
+
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    elapsed = std::chrono::duration<double, std::milli>( end - start ).count();
+}
+
+// Draw Data
+void NuiTrack::draw()
+{
+    PROFILE_SCOPE( "NuiTrack::draw" );
+
+    // Draw Occupancy
+    drawOccupancy();
+}
+
+// Draw Occupancy
+inline void NuiTrack::drawOccupancy()
+{
+    PROFILE_SCOPE( "NuiTrack::drawOccupancy" );
+
+    // Create cv::Mat form Heat Map (Reference, Not Copy)
+    const cv::Mat heat_mat( grid.height(), grid.width(), CV_32FC1, const_cast<float*>( grid.data().data() ) );
+
+    // Scaling
+    cv::Mat scale_mat;
+    heat_mat.convertTo( scale_mat, CV_8U, 255.0, 0.0 ); // 0.0-1.0 -> 0(black)-255(white)
+
+    // Apply False Colour
+    cv::applyColorMap( scale_mat, occupancy_mat, cv::COLORMAP_JET );
+    cv::resize( occupancy_mat, occupancy_mat, cv::Size(), 5.0, 5.0, cv::INTER_NEAREST );
+
+    // Draw Processing Time
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision( 2 ) << elapsed << " ms";
+    cv::putText( occupancy_mat, oss.str(), cv::Point( 10, 30 ), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Vec3b( 255, 255, 255 ), 2 );
+}
+
+// Show Data
+void NuiTrack::show()
+{
+    PROFILE_SCOPE( "NuiTrack::show" );
+
+    // Show Occupancy
+    showOccupancy();
+}
+
+// Show Occupancy
+inline void NuiTrack::showOccupancy()
+{
+    PROFILE_SCOPE( "NuiTrack::showOccupancy" );
+
+    if( occupancy_mat.empty() ){
+        return;
+    }
+
+    // Show Occupancy Image
+    cv::imshow( "Occupancy", occupancy_mat );
+}
@@ -0,0 +1,380 @@
+#include "nuitrack.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Constructor
+NuiTrack::NuiTrack( const std::string& config_json )
+{
+    // Initialize
+    initialize( config_json );
+}
+
+// Destructor
+NuiTrack::~NuiTrack()
+{
+    // Finalize
+    finalize();
+}
+
+// Processing
+void NuiTrack::run()
+{
+    // Run NuiTrack
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::run" );
+        tdv::nuitrack::Nuitrack::run();
+    }
+
+    // Start Trace (Chrome Trace Event Format)
+    TRACE_START( trace_path );
+
+    // Main Loop
+    while( !viewer.wasStopped() ){
+        PROFILE_SCOPE( "NuiTrack::frame" );
+
+        // Update Data
+        update();
+
+        // Begin Frame (Pacing and Gap of Reconfiguration Follow New Frame of User)
+        runner.begin( user_updated, user_frame->getTimestamp() );
+
+        // Draw Data (Skip if No Stream has New Frame)
+        if( runner.due( updated ) ){
+            draw();
+        }
+
+        // Show Data (Viewer is Spun Every Loop)
+        show();
+
+        // Report Startup, Profile and Threads, and Flush Trace
+        runner.report( updated );
+
+        // End Frame (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+        runner.end( user_updated, user_sequence.getDropped() );
+    }
+}
+
+// Initialize
+void NuiTrack::initialize( const std::string& config_json )
+{
+    cv::setUseOptimized( true );
+
+    // Place Main Thread (Capture, Processing and Rendering) and Workers of Pool
+    if( !thread_placement.empty() && !affinity::place( affinity::parsePlacement( thread_placement ) ) ){
+        std::cout << "thread placement " << thread_placement << " is not permitted" << std::endl;
+    }
+    if( !worker_placement.empty() ){
+        parallel::place( affinity::parsePlacement( worker_placement ) );
+    }
+
+    // Attach Main Thread to Usage Report
+    affinity::attach( "main" );
+
+    // Keep Config for Re-Initialize
+    this->config_json = config_json;
+
+    // Log Decisions of Quality Controller
+    quality_controller.setLog( &std::cout );
+
+    // Log Reconfigurations
+    reconfigurator.setLog( &std::cout );
+
+    // Hooks of Reconfiguration (Sensors and Trackers of This Sample)
+    reconfig_hooks.set = []( const std::string& key, const std::string& value ){ tdv::nuitrack::Nuitrack::setConfigValue( key, value ); };
+    reconfig_hooks.recreate = [this]( const reconfig::Change& change ){ recreateModules( change ); };
+    reconfig_hooks.reinitialize = [this](){ reinitialize(); };
+
+    // Attach Components to Runner of Main Loop
+    runner.setPacer( &pacer );
+    runner.setStartup( &startup_timeline );
+    runner.setReconfigurator( &reconfigurator, reconfig_hooks, hot_reconfig );
+    if( adaptive_quality ){
+        runner.setQuality( &quality_controller, { "Realsense2Module.Depth." } );
+    }
+    runner.setLog( &std::cout, profile_interval );
+
+    // Initialize NuiTrack
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::init" );
+        tdv::nuitrack::Nuitrack::init( config_json );
+    }
+
+    // Initialize Sensor
+    initializeSensor();
+
+    // Initialize Viewer
+    initializeViewer();
+
+    // Initalize Color Table for Visualization
+    palette[0] = cv::Vec3b( 255,   0,   0 ); // Blue
+    palette[1] = cv::Vec3b(   0, 255,   0 ); // Green
+    palette[2] = cv::Vec3b(   0,   0, 255 ); // Red
+    palette[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
+    palette[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
+    palette[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
+}
+
+// Initialize Sensor
+inline void NuiTrack::initializeSensor()
+{
+    // Set Device Config
+    tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth.ProcessWidth", std::to_string( depth_width ) );
+    tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth.ProcessHeight", std::to_string( depth_height ) );
+
+    // Get Device Config
+    max_distance = std::stoi( tdv::nuitrack::Nuitrack::getConfigValue( "Realsense2Module.Depth.ProcessMaxDepth" ) );
+
+    // Set Config Changed by Reconfiguration (Overrides Device Config)
+    const reconfig::Config config = reconfigurator.getConfig();
+    for( const std::pair<const std::string, std::string>& entry : config ){
+        tdv::nuitrack::Nuitrack::setConfigValue( entry.first, entry.second );
+    }
+
+    // Create Sensor and Tracker (Independent Modules are Created Concurrently)
+    startup::parallel( startup_timeline, {
+        { "DepthSensor::create", [&](){ depth_sensor = tdv::nuitrack::DepthSensor::create(); } },
+        { "UserTracker::create", [&](){ user_tracker = tdv::nuitrack::UserTracker::create(); } }
+    }, parallel_startup );
+
+    // Retrieve Intrinsics
+    const tdv::nuitrack::OutputMode mode = depth_sensor->getOutputMode();
+    intrinsics = camera::Intrinsics::fromFov( mode.xres, mode.yres, mode.hfov );
+}
+
+// Initialize Viewer
+inline void NuiTrack::initializeViewer()
+{
+    // Create Viewer
+    viewer = cv::viz::Viz3d( "Point Cloud" );
+
+    // Set Viewing Direction (Look to +Z from Camera Position)
+    viewer.setViewerPose( cv::viz::makeCameraPose( cv::Vec3d( 0.0, 0.0, -1000.0 ), cv::Vec3d( 0.0, 0.0, 1000.0 ), cv::Vec3d( 0.0, 1.0, 0.0 ) ) );
+}
+
+// Finalize
+void NuiTrack::finalize()
+{
+    // Stop Trace
+    TRACE_STOP();
+
+    // Close Viewer
+    viewer.close();
+
+    // Release NuiTrack
+    tdv::nuitrack::Nuitrack::release();
+}
+
+// Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+void NuiTrack::reconfigure( const std::string& key, const std::string& value )
+{
+    reconfigurator.set( key, value );
+}
+
+// Recreate Modules Affected by Changed Config (Frame ID of Recreated Module may Restart)
+inline void NuiTrack::recreateModules( const reconfig::Change& change )
+{
+    if( change.affects( reconfig::DEPTH ) ){
+        depth_sensor = tdv::nuitrack::DepthSensor::create();
+        depth_sequence.reset();
+
+        // Retrieve Intrinsics of New Output Mode
+        const tdv::nuitrack::OutputMode mode = depth_sensor->getOutputMode();
+        intrinsics = camera::Intrinsics::fromFov( mode.xres, mode.yres, mode.hfov );
+    }
+
+    if( change.affects( reconfig::USER ) ){
+        user_tracker = tdv::nuitrack::UserTracker::create();
+        user_sequence.reset();
+    }
+}
+
+// Re-Initialize NuiTrack (Device Config and Changed Config are Applied at Initialize)
+inline void NuiTrack::reinitialize()
+{
+    tdv::nuitrack::Nuitrack::release();
+    tdv::nuitrack::Nuitrack::init( config_json );
+    initializeSensor();
+    tdv::nuitrack::Nuitrack::run();
+
+    // Reset Sequence (Frame ID and Timestamp are Restarted)
+    depth_sequence.reset();
+    user_sequence.reset();
+}
+
+// Update Data
+void NuiTrack::update()
+{
+    PROFILE_SCOPE( "NuiTrack::update" );
+
+    // Update Frame
+    updateFrame();
+
+    // Update Depth
+    updateDepth();
+
+    // Update User
+    updateUser();
+
+    // Any Stream has New Frame
+    updated = depth_updated || user_updated;
+}
+
+// Update Frame
+inline void NuiTrack::updateFrame()
+{
+    // Update Frame
+    PROFILE_SCOPE( "Nuitrack::update" );
+    tdv::nuitrack::Nuitrack::update();
+}
+
+// Update Depth
+inline void NuiTrack::updateDepth()
+{
+    PROFILE_SCOPE( "NuiTrack::updateDepth" );
+
+    // Retrieve Depth Frame
+    depth_frame = depth_sensor->getDepthFrame();
+
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    depth_updated = depth_sequence.update( depth_frame->getID(), depth_frame->getTimestamp() );
+
+    // Retrive Frame Size
+    depth_width = depth_frame->getCols();
+    depth_height = depth_frame->getRows();
+
+    // Update Ray Tables (Rebuild Only When Resolution Changed)
+    const tdv::nuitrack::OutputMode mode = depth_sensor->getOutputMode();
+    const float scale_x = static_cast<float>( depth_width ) / mode.xres;
+    const float scale_y = static_cast<float>( depth_height ) / mode.yres;
+    generator.setIntrinsics( depth_width, depth_height, intrinsics.scale( scale_x, scale_y ) );
+}
+
+// Update User
+inline void NuiTrack::updateUser()
+{
+    PROFILE_SCOPE( "NuiTrack::updateUser" );
+
+    // Update Tracker
+    try{
+        PROFILE_SCOPE( "Nuitrack::waitUpdate( user_tracker )" );
+        tdv::nuitrack::Nuitrack::waitUpdate( user_tracker );
+    }
+    catch( const tdv::nuitrack::LicenseNotAcquiredException& ex ){
+        throw std::runtime_error( "failed license not acquired" );
+    }
+
+    // Retrieve User Frame
+    user_frame = user_tracker->getUserFrame();
+
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    user_updated = user_sequence.update( user_frame->getID(), user_frame->getTimestamp() );
+}
+
+// Draw Data
+void NuiTrack::draw()
+{
+    PROFILE_SCOPE( "NuiTrack::draw" );
+
+    // Draw Point Cloud
+    drawPointCloud();
+}
+
+// Draw Point Cloud
+inline void NuiTrack::drawPointCloud()
+{
+    PROFILE_SCOPE( "NuiTrack::drawPointCloud" );
+
+    // Generate Point Cloud
+    const uint16_t* depth_data = depth_frame->getData();
+    if( user_only ){
+        generator.generate( depth_data, user_frame->getData(), points, &labels );
+    }
+    else{
+        generator.generate( depth_data, points );
+    }
+
+    if( points.empty() ){
+        cloud_mat.release();
+        color_mat.release();
+        return;
+    }
+
+    // Create cv::Mat form Point Cloud (Reference, Not Copy)
+    const int32_t total = static_cast<int32_t>( points.size() );
+    cloud_mat = cv::Mat( 1, total, CV_32FC3, points.data() );
+
+    // Colorize Point Cloud
+    color_mat.create( 1, total, CV_8UC3 );
+    if( user_only ){
+        // Recycle Colors of Users that are Gone
+        colors.age();
+
+        // Acquire Slots of Users of Frame (Label is User ID)
+        for( const tdv::nuitrack::User& user : user_frame->getUsers() ){
+            userColor( user.id );
+        }
+
+        // Color of Slot of Label (Table is only Read, Slot is Looked up once per Run of Same Label, Label that has no Slot is Black)
+        parallel::forEach( total, 4096, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            uint16_t last = 0;
+            cv::Vec3b color;
+            for( int32_t index = begin; index < end; index++ ){
+                const uint16_t label = labels[index];
+                if( label != last ){
+                    const uint32_t slot = colors.find( label );
+                    color = ( slot != slots::NONE ) ? colors.at( slot ) : cv::Vec3b( 0, 0, 0 );
+                    last = label;
+                }
+                color_mat.at<cv::Vec3b>( index ) = color;
+            }
+        } );
+    }
+    else{
+        parallel::forEach( total, 4096, [&]( const int32_t begin, const int32_t end, const int32_t ){
+            for( int32_t index = begin; index < end; index++ ){
+                const uint8_t gray = cv::saturate_cast<uint8_t>( 255.0f - points[index].z * 255.0f / max_distance ); // 0-max_distance -> 255(white)-0(black)
+                color_mat.at<cv::Vec3b>( index ) = cv::Vec3b( gray, gray, gray );
+            }
+        } );
+    }
+}
+
+// Color of User (New User takes Color of its Slot, so that Users at Same Time have Different Colors up to PALETTE_SIZE)
+inline const cv::Vec3b& NuiTrack::userColor( const int32_t id )
+{
+    bool inserted = false;
+    const uint32_t slot = colors.acquire( id, &inserted );
+    if( inserted ){
+        colors.at( slot ) = palette[slot % palette.size()];
+    }
+    return colors.at( slot );
+}
+
+// Show Data
+void NuiTrack::show()
+{
+    PROFILE_SCOPE( "NuiTrack::show" );
+
+    // Show Point Cloud
+    showPointCloud();
+}
+
+// Show Point Cloud
+inline void NuiTrack::showPointCloud()
+{
+    PROFILE_SCOPE( "NuiTrack::showPointCloud" );
+
+    if( cloud_mat.empty() ){
+        viewer.removeAllWidgets();
+        viewer.spinOnce();
+        return;
+    }
+
+    // Show Point Cloud (Upload Only New Point Cloud)
+    if( updated ){
+        viewer.showWidget( "Cloud", cv::viz::WCloud( cloud_mat, color_mat ) );
+    }
+    viewer.spinOnce();
+}
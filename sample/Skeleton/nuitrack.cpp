@@ -1,5 +1,6 @@
 #include "nuitrack.h"
 
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -21,24 +22,57 @@ NuiTrack::~NuiTrack()
 void NuiTrack::run()
 {
     // Run NuiTrack
-    tdv::nuitrack::Nuitrack::run();
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::run" );
+        tdv::nuitrack::Nuitrack::run();
+    }
+
+    // Start Trace (Chrome Trace Event Format)
+    TRACE_START( trace_path );
 
     // Main Loop
     while( true ){
+        PROFILE_SCOPE( "NuiTrack::frame" );
+
         // Update Data
         update();
 
-        // Draw Data
-        draw();
+        // Begin Frame (Pacing and Gap of Reconfiguration Follow New Frame of Color)
+        runner.begin( color_updated, color_frame->getTimestamp() );
 
-        // Show Data
-        show();
+        // Update Idle Mode with Presence of Users (Full Rate Comes Back at First Frame with Users)
+        if( skeleton_updated ){
+            idle_monitor.update( !skeleton_data->getSkeletons().empty() );
+        }
 
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
+        // Draw and Show Data (Skip if No Stream has New Frame, Idle Rate while No Users are Present, Every n-th Frame while Display Rate is Shed)
+        if( runner.due( updated ) ){
+            // Draw Data
+            draw();
+
+            // Show Data
+            show();
+        }
+
+        // Report Startup, Profile, Consumers, Idle Mode and Threads, and Flush Trace
+        runner.report( updated );
+
+        // Key Check (Non-Blocking)
+        int32_t key;
+        {
+            PROFILE_SCOPE( "cv::pollKey" );
+            #if CV_VERSION_MAJOR > 4 || ( CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6 )
+            key = cv::pollKey();
+            #else
+            key = cv::waitKey( 1 );
+            #endif
+        }
         if( key == 'q' ){
             break;
         }
+
+        // End Frame (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+        runner.end( color_updated, color_sequence.getDropped() );
     }
 }
 
@@ -47,19 +81,74 @@ void NuiTrack::initialize( const std::string& config_json )
 {
     cv::setUseOptimized( true );
 
+    // Place Main Thread (Capture, Processing and Rendering) and Workers of Pool
+    if( !thread_placement.empty() && !affinity::place( affinity::parsePlacement( thread_placement ) ) ){
+        std::cout << "thread placement " << thread_placement << " is not permitted" << std::endl;
+    }
+    if( !worker_placement.empty() ){
+        parallel::place( affinity::parsePlacement( worker_placement ) );
+    }
+
+    // Attach Main Thread to Usage Report
+    affinity::attach( "main" );
+
+    // Keep Config for Re-Initialize
+    this->config_json = config_json;
+
+    // Log Decisions of Quality Controller
+    quality_controller.setLog( &std::cout );
+
+    // Log Changes of Idle Mode
+    idle_monitor.setLog( &std::cout );
+
+    // Log Reconfigurations (Registered Depth follows Color Resolution)
+    reconfigurator.setLog( &std::cout );
+    reconfigurator.setRegistration( align );
+
+    // Hooks of Reconfiguration (Sensors and Trackers of This Sample)
+    reconfig_hooks.set = []( const std::string& key, const std::string& value ){ tdv::nuitrack::Nuitrack::setConfigValue( key, value ); };
+    reconfig_hooks.recreate = [this]( const reconfig::Change& change ){ recreateModules( change ); };
+    reconfig_hooks.reinitialize = [this](){ reinitialize(); };
+
+    // Register Consumers (Tracker is Updated at Its Own Rate)
+    skeleton_consumer = scheduler.add( "skeleton", skeleton_rate );
+
+    // Register Stages of Shedding (Shed in This Order under Overload, Restored in Reverse Order)
+    shed_display = shedding_controller.add( "display rate" );
+    shedding_controller.setLog( &std::cout );
+
+    // Attach Components to Runner of Main Loop
+    runner.setPacer( &pacer );
+    runner.setStartup( &startup_timeline );
+    runner.setReconfigurator( &reconfigurator, reconfig_hooks, hot_reconfig );
+    if( adaptive_quality ){
+        runner.setQuality( &quality_controller, { "Realsense2Module.RGB." } );
+    }
+    if( load_shedding ){
+        runner.setShedding( &shedding_controller, shed_display, display_divisor );
+    }
+    if( idle_mode ){
+        runner.setIdle( &idle_monitor );
+    }
+    runner.setScheduler( &scheduler );
+    runner.setLog( &std::cout, profile_interval );
+
     // Initialize NuiTrack
-    tdv::nuitrack::Nuitrack::init( config_json );
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::init" );
+        tdv::nuitrack::Nuitrack::init( config_json );
+    }
 
     // Initialize Sensor
     initializeSensor();
 
     // Initalize Color Table for Visualization
-    colors[0] = cv::Vec3b( 255,   0,   0 ); // Blue
-    colors[1] = cv::Vec3b(   0, 255,   0 ); // Green
-    colors[2] = cv::Vec3b(   0,   0, 255 ); // Red
-    colors[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
-    colors[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
-    colors[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
+    palette[0] = cv::Vec3b( 255,   0,   0 ); // Blue
+    palette[1] = cv::Vec3b(   0, 255,   0 ); // Green
+    palette[2] = cv::Vec3b(   0,   0, 255 ); // Red
+    palette[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
+    palette[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
+    palette[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
 }
 
 // Initialize Sensor
@@ -70,16 +159,25 @@ inline void NuiTrack::initializeSensor()
     tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.RGB.ProcessHeight", std::to_string( color_height ) );
     tdv::nuitrack::Nuitrack::setConfigValue( "Realsense2Module.Depth2ColorRegistration", align ? "true" : "false" );
 
-    // Create Sensor
-    color_sensor = tdv::nuitrack::ColorSensor::create();
+    // Set Config Changed by Reconfiguration (Overrides Device Config)
+    const reconfig::Config config = reconfigurator.getConfig();
+    for( const std::pair<const std::string, std::string>& entry : config ){
+        tdv::nuitrack::Nuitrack::setConfigValue( entry.first, entry.second );
+    }
 
-    // Create Tracker
-    skeleton_tracker = tdv::nuitrack::SkeletonTracker::create();
+    // Create Sensor and Tracker (Independent Modules are Created Concurrently)
+    startup::parallel( startup_timeline, {
+        { "ColorSensor::create", [&](){ color_sensor = tdv::nuitrack::ColorSensor::create(); } },
+        { "SkeletonTracker::create", [&](){ skeleton_tracker = tdv::nuitrack::SkeletonTracker::create(); } }
+    }, parallel_startup );
 }
 
 // Finalize
 void NuiTrack::finalize()
 {
+    // Stop Trace
+    TRACE_STOP();
+
     // Close Windows
     cv::destroyAllWindows();
 
@@ -87,32 +185,84 @@ void NuiTrack::finalize()
     tdv::nuitrack::Nuitrack::release();
 }
 
+// Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+void NuiTrack::reconfigure( const std::string& key, const std::string& value )
+{
+    reconfigurator.set( key, value );
+}
+
+// Recreate Modules Affected by Changed Config (Frame ID of Recreated Module may Restart)
+inline void NuiTrack::recreateModules( const reconfig::Change& change )
+{
+    if( change.affects( reconfig::COLOR ) ){
+        color_sensor = tdv::nuitrack::ColorSensor::create();
+        color_sequence.reset();
+    }
+
+    if( change.affects( reconfig::SKELETON ) ){
+        skeleton_tracker = tdv::nuitrack::SkeletonTracker::create();
+        skeleton_sequence.reset();
+    }
+}
+
+// Re-Initialize NuiTrack (Device Config and Changed Config are Applied at Initialize)
+inline void NuiTrack::reinitialize()
+{
+    tdv::nuitrack::Nuitrack::release();
+    tdv::nuitrack::Nuitrack::init( config_json );
+    initializeSensor();
+    tdv::nuitrack::Nuitrack::run();
+
+    // Reset Sequence (Frame ID and Timestamp are Restarted)
+    color_sequence.reset();
+    skeleton_sequence.reset();
+}
+
 // Update Data
 void NuiTrack::update()
 {
+    PROFILE_SCOPE( "NuiTrack::update" );
+
     // Update Frame
     updateFrame();
 
     // Update Color
     updateColor();
 
-    // Update Skeleton
-    updateSkeleton();
+    // Plan Consumers of New Color Frame
+    if( color_updated ){
+        scheduler.plan();
+    }
+
+    // Update Skeleton (at Rate of Skeleton Consumer)
+    skeleton_updated = false;
+    if( scheduler.due( skeleton_consumer ) ){
+        updateSkeleton();
+    }
+
+    // Any Stream has New Frame
+    updated = color_updated || skeleton_updated;
 }
 
 // Update Frame
 inline void NuiTrack::updateFrame()
 {
     // Update Frame
+    PROFILE_SCOPE( "Nuitrack::update" );
     tdv::nuitrack::Nuitrack::update();
 }
 
 // Update Color
 inline void NuiTrack::updateColor()
 {
+    PROFILE_SCOPE( "NuiTrack::updateColor" );
+
     // Retrieve Color Frame
     color_frame = color_sensor->getColorFrame();
 
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    color_updated = color_sequence.update( color_frame->getID(), color_frame->getTimestamp() );
+
     // Retrive Frame Size
     color_width = color_frame->getCols();
     color_height = color_frame->getRows();
@@ -121,8 +271,12 @@ inline void NuiTrack::updateColor()
 // Update Skeleton
 inline void NuiTrack::updateSkeleton()
 {
+    PROFILE_SCOPE( "NuiTrack::updateSkeleton" );
+    const schedule::Run run( scheduler, skeleton_consumer );
+
     // Update Tracker
     try{
+        PROFILE_SCOPE( "Nuitrack::waitUpdate( skeleton_tracker )" );
         tdv::nuitrack::Nuitrack::waitUpdate( skeleton_tracker );
     }
     catch( const tdv::nuitrack::LicenseNotAcquiredException& ex ){
@@ -131,11 +285,16 @@ inline void NuiTrack::updateSkeleton()
 
     // Retrieve Skeleton Data
     skeleton_data = skeleton_tracker->getSkeletons();
+
+    // Check Sequence (Skip Conversion of Duplicate Data)
+    skeleton_updated = skeleton_sequence.update( skeleton_data->getTimestamp() );
 }
 
 // Draw Data
 void NuiTrack::draw()
 {
+    PROFILE_SCOPE( "NuiTrack::draw" );
+
     // Draw Color
     drawColor();
 
@@ -146,27 +305,33 @@ void NuiTrack::draw()
 // Draw Color
 inline void NuiTrack::drawColor()
 {
-    // Create cv::Mat form Color Data
-    const tdv::nuitrack::Color3* color_data = color_frame->getData();
-    color_mat = cv::Mat::zeros( color_height, color_width, CV_8UC3 );
+    PROFILE_SCOPE( "NuiTrack::drawColor" );
 
-    #pragma omp parallel for
-    for( int32_t index = 0; index < color_mat.total(); index++ ){
-        const tdv::nuitrack::Color3 color = color_data[index];
-        color_mat.at<cv::Vec3b>( index ) = cv::Vec3b( color.blue, color.green, color.red );
+    if( !color_updated ){
+        return;
     }
+
+    // Create cv::Mat form Color Data
+    const tdv::nuitrack::Color3* color_data = color_frame->getData();
+    color_mat.create( color_height, color_width, CV_8UC3 );
+    frame::copyColor( reinterpret_cast<const uint8_t*>( color_data ), color_mat.data, static_cast<int32_t>( color_mat.total() ) );
 }
 
 // Draw Skeleton
 inline void NuiTrack::drawSkeleton()
 {
-    if( color_mat.empty() ){
+    PROFILE_SCOPE( "NuiTrack::drawSkeleton" );
+
+    if( color_mat.empty() || !skeleton_data ){
         return;
     }
 
     // Copy Color Mat
     color_mat.copyTo( skeleton_mat );
 
+    // Recycle Colors of Users that are Gone
+    colors.age();
+
     // Draw Skeleton
     const std::vector<tdv::nuitrack::Skeleton> skeletons = skeleton_data->getSkeletons();
 
@@ -178,14 +343,27 @@ inline void NuiTrack::drawSkeleton()
                 continue;
             }
             const cv::Point point = { static_cast<int32_t>( joint.proj.x * color_width ) , static_cast<int32_t>( joint.proj.y * color_height ) };
-            cv::circle( skeleton_mat, point, 5, colors[id - 1], -1 );
+            cv::circle( skeleton_mat, point, 5, userColor( id ), -1 );
         }
     }
 }
 
+// Color of User (New User takes Color of its Slot, so that Users at Same Time have Different Colors up to PALETTE_SIZE)
+inline const cv::Vec3b& NuiTrack::userColor( const int32_t id )
+{
+    bool inserted = false;
+    const uint32_t slot = colors.acquire( id, &inserted );
+    if( inserted ){
+        colors.at( slot ) = palette[slot % palette.size()];
+    }
+    return colors.at( slot );
+}
+
 // Show Data
 void NuiTrack::show()
 {
+    PROFILE_SCOPE( "NuiTrack::show" );
+
     // Show Skeleton
     showSkeleton();
 }
@@ -193,6 +371,8 @@ void NuiTrack::show()
 // Show Skeleton
 inline void NuiTrack::showSkeleton()
 {
+    PROFILE_SCOPE( "NuiTrack::showSkeleton" );
+
     if( skeleton_mat.empty() ){
         return;
     }
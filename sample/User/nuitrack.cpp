@@ -1,5 +1,6 @@
 #include "nuitrack.h"
 
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -21,24 +22,57 @@ NuiTrack::~NuiTrack()
 void NuiTrack::run()
 {
     // Run NuiTrack
-    tdv::nuitrack::Nuitrack::run();
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::run" );
+        tdv::nuitrack::Nuitrack::run();
+    }
+
+    // Start Trace (Chrome Trace Event Format)
+    TRACE_START( trace_path );
 
     // Main Loop
     while( true ){
+        PROFILE_SCOPE( "NuiTrack::frame" );
+
         // Update Data
         update();
 
-        // Draw Data
-        draw();
+        // Begin Frame (Pacing and Gap of Reconfiguration Follow New Frame of Depth)
+        runner.begin( depth_updated, depth_frame->getTimestamp() );
+
+        // Update Idle Mode with Presence of Users (Full Rate Comes Back at First Frame with Users)
+        if( user_updated ){
+            idle_monitor.update( !user_frame->getUsers().empty() );
+        }
+
+        // Draw and Show Data (Skip if No Stream has New Frame, Idle Rate while No Users are Present, Every n-th Frame while Display Rate is Shed)
+        if( runner.due( updated ) ){
+            // Draw Data
+            draw();
 
-        // Show Data
-        show();
+            // Show Data
+            show();
+        }
 
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
+        // Report Startup, Profile, Consumers, Idle Mode and Threads, and Flush Trace
+        runner.report( updated );
+
+        // Key Check (Non-Blocking)
+        int32_t key;
+        {
+            PROFILE_SCOPE( "cv::pollKey" );
+            #if CV_VERSION_MAJOR > 4 || ( CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6 )
+            key = cv::pollKey();
+            #else
+            key = cv::waitKey( 1 );
+            #endif
+        }
         if( key == 'q' ){
             break;
         }
+
+        // End Frame (Adapt to Frame Time, Apply Changed Config at Frame Boundary, and Wait for Next Frame)
+        runner.end( depth_updated, depth_sequence.getDropped() );
     }
 }
 
@@ -47,19 +81,74 @@ void NuiTrack::initialize( const std::string& config_json )
 {
     cv::setUseOptimized( true );
 
+    // Place Main Thread (Capture, Processing and Rendering) and Workers of Pool
+    if( !thread_placement.empty() && !affinity::place( affinity::parsePlacement( thread_placement ) ) ){
+        std::cout << "thread placement " << thread_placement << " is not permitted" << std::endl;
+    }
+    if( !worker_placement.empty() ){
+        parallel::place( affinity::parsePlacement( worker_placement ) );
+    }
+
+    // Attach Main Thread to Usage Report
+    affinity::attach( "main" );
+
+    // Keep Config for Re-Initialize
+    this->config_json = config_json;
+
+    // Log Decisions of Quality Controller
+    quality_controller.setLog( &std::cout );
+
+    // Log Changes of Idle Mode
+    idle_monitor.setLog( &std::cout );
+
+    // Log Reconfigurations
+    reconfigurator.setLog( &std::cout );
+
+    // Hooks of Reconfiguration (Sensors and Trackers of This Sample)
+    reconfig_hooks.set = []( const std::string& key, const std::string& value ){ tdv::nuitrack::Nuitrack::setConfigValue( key, value ); };
+    reconfig_hooks.recreate = [this]( const reconfig::Change& change ){ recreateModules( change ); };
+    reconfig_hooks.reinitialize = [this](){ reinitialize(); };
+
+    // Register Consumers (Tracker is Updated at Its Own Rate)
+    user_consumer = scheduler.add( "user", user_rate );
+
+    // Register Stages of Shedding (Shed in This Order under Overload, Restored in Reverse Order)
+    shed_overlay = shedding_controller.add( "user overlay" );
+    shed_display = shedding_controller.add( "display rate" );
+    shedding_controller.setLog( &std::cout );
+
+    // Attach Components to Runner of Main Loop
+    runner.setPacer( &pacer );
+    runner.setStartup( &startup_timeline );
+    runner.setReconfigurator( &reconfigurator, reconfig_hooks, hot_reconfig );
+    if( adaptive_quality ){
+        runner.setQuality( &quality_controller, { "Realsense2Module.Depth." } );
+    }
+    if( load_shedding ){
+        runner.setShedding( &shedding_controller, shed_display, display_divisor );
+    }
+    if( idle_mode ){
+        runner.setIdle( &idle_monitor );
+    }
+    runner.setScheduler( &scheduler );
+    runner.setLog( &std::cout, profile_interval );
+
     // Initialize NuiTrack
-    tdv::nuitrack::Nuitrack::init( config_json );
+    {
+        const startup::Scope scope( startup_timeline, "Nuitrack::init" );
+        tdv::nuitrack::Nuitrack::init( config_json );
+    }
 
     // Initialize Sensor
     initializeSensor();
 
     // Initalize Color Table for Visualization
-    colors[0] = cv::Vec3b( 255,   0,   0 ); // Blue
-    colors[1] = cv::Vec3b(   0, 255,   0 ); // Green
-    colors[2] = cv::Vec3b(   0,   0, 255 ); // Red
-    colors[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
-    colors[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
-    colors[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
+    palette[0] = cv::Vec3b( 255,   0,   0 ); // Blue
+    palette[1] = cv::Vec3b(   0, 255,   0 ); // Green
+    palette[2] = cv::Vec3b(   0,   0, 255 ); // Red
+    palette[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
+    palette[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
+    palette[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
 }
 
 // Initialize Sensor
@@ -72,16 +161,25 @@ inline void NuiTrack::initializeSensor()
     // Get Device Config
     max_distance = std::stoi( tdv::nuitrack::Nuitrack::getConfigValue( "Realsense2Module.Depth.ProcessMaxDepth" ) );
 
-    // Create Sensor
-    depth_sensor = tdv::nuitrack::DepthSensor::create();
+    // Set Config Changed by Reconfiguration (Overrides Device Config)
+    const reconfig::Config config = reconfigurator.getConfig();
+    for( const std::pair<const std::string, std::string>& entry : config ){
+        tdv::nuitrack::Nuitrack::setConfigValue( entry.first, entry.second );
+    }
 
-    // Create Tracker
-    user_tracker = tdv::nuitrack::UserTracker::create();
+    // Create Sensor and Tracker (Independent Modules are Created Concurrently)
+    startup::parallel( startup_timeline, {
+        { "DepthSensor::create", [&](){ depth_sensor = tdv::nuitrack::DepthSensor::create(); } },
+        { "UserTracker::create", [&](){ user_tracker = tdv::nuitrack::UserTracker::create(); } }
+    }, parallel_startup );
 }
 
 // Finalize
 void NuiTrack::finalize()
 {
+    // Stop Trace
+    TRACE_STOP();
+
     // Close Windows
     cv::destroyAllWindows();
 
@@ -89,32 +187,84 @@ void NuiTrack::finalize()
     tdv::nuitrack::Nuitrack::release();
 }
 
+// Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+void NuiTrack::reconfigure( const std::string& key, const std::string& value )
+{
+    reconfigurator.set( key, value );
+}
+
+// Recreate Modules Affected by Changed Config (Frame ID of Recreated Module may Restart)
+inline void NuiTrack::recreateModules( const reconfig::Change& change )
+{
+    if( change.affects( reconfig::DEPTH ) ){
+        depth_sensor = tdv::nuitrack::DepthSensor::create();
+        depth_sequence.reset();
+    }
+
+    if( change.affects( reconfig::USER ) ){
+        user_tracker = tdv::nuitrack::UserTracker::create();
+        user_sequence.reset();
+    }
+}
+
+// Re-Initialize NuiTrack (Device Config and Changed Config are Applied at Initialize)
+inline void NuiTrack::reinitialize()
+{
+    tdv::nuitrack::Nuitrack::release();
+    tdv::nuitrack::Nuitrack::init( config_json );
+    initializeSensor();
+    tdv::nuitrack::Nuitrack::run();
+
+    // Reset Sequence (Frame ID and Timestamp are Restarted)
+    depth_sequence.reset();
+    user_sequence.reset();
+}
+
 // Update Data
 void NuiTrack::update()
 {
+    PROFILE_SCOPE( "NuiTrack::update" );
+
     // Update Frame
     updateFrame();
 
     // Update Depth
     updateDepth();
 
-    // Update User
-    updateUser();
+    // Plan Consumers of New Depth Frame
+    if( depth_updated ){
+        scheduler.plan();
+    }
+
+    // Update User (at Rate of User Consumer)
+    user_updated = false;
+    if( scheduler.due( user_consumer ) ){
+        updateUser();
+    }
+
+    // Any Stream has New Frame
+    updated = depth_updated || user_updated;
 }
 
 // Update Frame
 inline void NuiTrack::updateFrame()
 {
     // Update Frame
+    PROFILE_SCOPE( "Nuitrack::update" );
     tdv::nuitrack::Nuitrack::update();
 }
 
 // Update Depth
 inline void NuiTrack::updateDepth()
 {
+    PROFILE_SCOPE( "NuiTrack::updateDepth" );
+
     // Retrieve Depth Frame
     depth_frame = depth_sensor->getDepthFrame();
 
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    depth_updated = depth_sequence.update( depth_frame->getID(), depth_frame->getTimestamp() );
+
     // Retrive Frame Size
     depth_width = depth_frame->getCols();
     depth_height = depth_frame->getRows();
@@ -123,8 +273,12 @@ inline void NuiTrack::updateDepth()
 // Update User
 inline void NuiTrack::updateUser()
 {
+    PROFILE_SCOPE( "NuiTrack::updateUser" );
+    const schedule::Run run( scheduler, user_consumer );
+
     // Update Tracker
     try{
+        PROFILE_SCOPE( "Nuitrack::waitUpdate( user_tracker )" );
         tdv::nuitrack::Nuitrack::waitUpdate( user_tracker );
     }
     catch( const tdv::nuitrack::LicenseNotAcquiredException& ex ){
@@ -133,11 +287,16 @@ inline void NuiTrack::updateUser()
 
     // Retrieve User Frame
     user_frame = user_tracker->getUserFrame();
+
+    // Check Sequence (Skip Conversion of Duplicate Frame)
+    user_updated = user_sequence.update( user_frame->getID(), user_frame->getTimestamp() );
 }
 
 // Draw Data
 void NuiTrack::draw()
 {
+    PROFILE_SCOPE( "NuiTrack::draw" );
+
     // Draw Depth
     drawDepth();
 
@@ -148,55 +307,72 @@ void NuiTrack::draw()
 // Draw Depth
 inline void NuiTrack::drawDepth()
 {
-    // Create cv::Mat form Depth Data
-    const uint16_t* depth_data = depth_frame->getData();
-    depth_mat = cv::Mat::zeros( depth_height, depth_width, CV_16UC1 );
+    PROFILE_SCOPE( "NuiTrack::drawDepth" );
 
-    #pragma omp parallel for
-    for( int32_t index = 0; index < depth_mat.total(); index++ ){
-        const uint16_t depth = depth_data[index];
-        depth_mat.at<ushort>( index ) = depth;
+    if( !depth_updated ){
+        return;
     }
+
+    // Create cv::Mat form Depth Data
+    const uint16_t* depth_data = depth_frame->getData();
+    depth_mat.create( depth_height, depth_width, CV_16UC1 );
+    frame::copyDepth( depth_data, depth_mat.ptr<uint16_t>(), static_cast<int32_t>( depth_mat.total() ) );
 }
 
 // Draw User
 inline void NuiTrack::drawUser()
 {
-    if( depth_mat.empty() ){
+    PROFILE_SCOPE( "NuiTrack::drawUser" );
+
+    if( depth_mat.empty() || !user_frame ){
         return;
     }
 
     // Copy Depth Mat
-    cv::cvtColor( depth_mat, user_mat, CV_GRAY2BGR );
-    user_mat.convertTo( user_mat, CV_8U, -255.0 / max_distance, 255.0 ); // 0-max_distance -> 255(white)-0(black)
-    //user_mat.convertTo( user_mat, CV_8U, 255.0 / max_distance, 0.0 ); // 0-max_distance -> 0(black)-255(white)
-
-    // Draw User Area
-    const uint16_t* labels = user_frame->getData();
-    #pragma omp parallel for
-    for( int32_t y = 0; y < depth_height; y++ ){
-        for( int32_t x = 0; x < depth_width; x++ ){
-            const uint32_t index = y * depth_width + x;
-            const uint16_t label = labels[index];
-            if( label ){
-                user_mat.at<cv::Vec3b>( y, x ) = colors[label - 1];
-            }
-        }
+    const int32_t total = static_cast<int32_t>( depth_mat.total() );
+    user_mat.create( depth_mat.rows, depth_mat.cols, CV_8UC3 );
+    frame::convertDepthToBgr( depth_mat.ptr<uint16_t>(), user_mat.data, total, max_distance ); // 0-max_distance -> 255(white)-0(black)
+
+    // Recycle Colors of Users that are Gone
+    colors.age();
+
+    // Acquire Slots of Users of Frame (Label is User ID, Label that has no Slot is not Drawn)
+    const std::vector<tdv::nuitrack::User> users = user_frame->getUsers();
+    for( const tdv::nuitrack::User& user : users ){
+        userColor( user.id );
+    }
+
+    // Draw User Area (Labels of Previous Resolution are Skipped until User is Updated, and Skipped while User Overlay is Shed)
+    if( !shedding_controller.isShed( shed_overlay ) && user_frame->getCols() == depth_mat.cols && user_frame->getRows() == depth_mat.rows ){
+        const uint16_t* labels = user_frame->getData();
+        frame::overlayLabels( labels, user_mat.data, total, colors );
     }
 
     // Draw Bounding Box
-    const std::vector<tdv::nuitrack::User> users = user_frame->getUsers();
     for( const tdv::nuitrack::User& user : users ){
         const int32_t id = user.id;
         const cv::Point point1 = { static_cast<int32_t>( user.box.left * depth_width ), static_cast<int32_t>( user.box.top * depth_height ) };
         const cv::Point point2 = { static_cast<int32_t>( user.box.right * depth_width ), static_cast<int32_t>( user.box.bottom * depth_height ) };
-        cv::rectangle( user_mat, point1, point2, colors[id - 1] );
+        cv::rectangle( user_mat, point1, point2, userColor( id ) );
     }
 }
 
+// Color of User (New User takes Color of its Slot, so that Users at Same Time have Different Colors up to PALETTE_SIZE)
+inline const cv::Vec3b& NuiTrack::userColor( const int32_t id )
+{
+    bool inserted = false;
+    const uint32_t slot = colors.acquire( id, &inserted );
+    if( inserted ){
+        colors.at( slot ) = palette[slot % palette.size()];
+    }
+    return colors.at( slot );
+}
+
 // Show Data
 void NuiTrack::show()
 {
+    PROFILE_SCOPE( "NuiTrack::show" );
+
     // Show User
     showUser();
 }
@@ -204,6 +380,8 @@ void NuiTrack::show()
 // Show User
 inline void NuiTrack::showUser()
 {
+    PROFILE_SCOPE( "NuiTrack::showUser" );
+
     if( user_mat.empty() ){
         return;
     }
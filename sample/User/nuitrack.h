@@ -1,11 +1,27 @@
 #ifndef __NUITRACK__
 #define __NUITRACK__
 
+#include "frame.h"
+#include "profile.h"
+#include "trace.h"
+#include "sequence.h"
+#include "pacing.h"
+#include "quality.h"
+#include "schedule.h"
+#include "shedding.h"
+#include "startup.h"
+#include "reconfig.h"
+#include "loop.h"
+#include "idle.h"
+#include "parallel.h"
+#include "affinity.h"
+#include "slots.h"
+
 #include <nuitrack/Nuitrack.h>
 #include <opencv2/opencv.hpp>
 #include <array>
 
-#define USER_COUNT 6
+#define PALETTE_SIZE 6
 
 class NuiTrack
 {
@@ -13,6 +29,8 @@ private:
     // Depth Sensor
     tdv::nuitrack::DepthSensor::Ptr depth_sensor;
     tdv::nuitrack::DepthFrame::Ptr depth_frame;
+    sequence::Stream depth_sequence = sequence::Stream( "depth" );
+    bool depth_updated = false;
     cv::Mat depth_mat;
     uint32_t depth_width = 1280;
     uint32_t depth_height = 720;
@@ -21,8 +39,58 @@ private:
     // User Tracker
     tdv::nuitrack::UserTracker::Ptr user_tracker;
     tdv::nuitrack::UserFrame::Ptr user_frame;
+    sequence::Stream user_sequence = sequence::Stream( "user" );
+    bool user_updated = false;
+    uint32_t user_consumer = 0;
+    double user_rate = 0.0; // Hz (0 updates every frame)
     cv::Mat user_mat;
-    std::array<cv::Vec3b, USER_COUNT> colors;
+    std::array<cv::Vec3b, PALETTE_SIZE> palette; // color of each slot of user
+    slots::Table<cv::Vec3b> colors; // color of each user id (slot of user that is gone is recycled)
+
+    // Sequence
+    bool updated = false; // any stream has new frame
+
+    // Schedule
+    schedule::Scheduler scheduler; // runs consumers at their own rates
+
+    // Pacing
+    pacing::Pacer pacer; // sleeps until predicted arrival of next depth frame
+
+    // Quality
+    quality::Controller quality_controller = quality::Controller( quality::LADDER, { depth_width, depth_height } ); // switches processing resolution by frame time
+    bool adaptive_quality = true;
+    std::string config_json; // re-applied when processing resolution is changed
+
+    // Shedding
+    shedding::Controller shedding_controller; // sheds optional work in order of stages under overload
+    uint32_t shed_overlay = 0; // user overlay (label colors)
+    uint32_t shed_display = 0; // display rate
+    uint32_t display_divisor = 2; // shows every n-th frame while display rate is shed
+    bool load_shedding = true;
+
+    // Idle
+    idle::Monitor idle_monitor; // throttles conversion and display while no users are present
+    bool idle_mode = true;
+
+    // Reconfiguration
+    reconfig::Reconfigurator reconfigurator; // applies changed config at frame boundary
+    reconfig::Hooks reconfig_hooks; // recreate or re-initialize modules of this sample
+    bool hot_reconfig = true; // recreates only affected modules (false re-initializes NuiTrack)
+
+    // Main Loop
+    loop::Runner runner; // pacing, frame time, quality, shedding, idle rate, reports and reconfiguration of each frame
+
+    // Startup
+    startup::Timeline startup_timeline; // phases until first frame
+    bool parallel_startup = true; // creates independent modules concurrently
+
+    // Threads
+    std::string thread_placement = ""; // core set, policy and priority of main thread that captures, processes and renders (e.g. "2:fifo:10"), empty keeps
+    std::string worker_placement = ""; // core set, policy and priority of workers of pool (e.g. "3-7"), empty uses NUITRACK_CORES
+
+    // Profile
+    double profile_interval = 5.0; // seconds
+    std::string trace_path = ""; // Chrome trace file (empty uses NUITRACK_TRACE environment variable)
 
 public:
     // Constructor
@@ -34,6 +102,9 @@ public:
     // Processing
     void run();
 
+    // Reconfigure (Changed Config is Applied at Next Frame Boundary, Thread Safe)
+    void reconfigure( const std::string& key, const std::string& value );
+
 private:
     // Initialize
     void initialize( const std::string& config_json );
@@ -44,6 +115,12 @@ private:
     // Finalize
     void finalize();
 
+    // Recreate Modules
+    inline void recreateModules( const reconfig::Change& change );
+
+    // Re-Initialize NuiTrack
+    inline void reinitialize();
+
     // Update Data
     void update();
 
@@ -65,6 +142,9 @@ private:
     // Draw User
     inline void drawUser();
 
+    // Color of User
+    inline const cv::Vec3b& userColor( const int32_t id );
+
     // Show Data
     void show();
 
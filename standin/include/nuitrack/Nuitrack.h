@@ -0,0 +1,532 @@
+// This is local stand-in of NuiTrack SDK that serves deterministic synthetic or recorded data without sensor.
+// It implements subset of tdv::nuitrack API that is used by samples, so that samples can be built and run on CI.
+// Select it with CMake option NUITRACK_STANDIN=ON instead of real NuiTrack SDK.
+//
+// Configuration (Nuitrack::setConfigValue() or environment variable NUITRACK_STANDIN_<NAME>)
+//
+// Standin.FPS         : Frame rate of depth and trackers (default 30)
+// Standin.ColorFPS    : Frame rate of color (default same as Standin.FPS)
+// Standin.Realtime    : "true" delivers frames by clock, "false" advances virtual clock to next frame per update (default true)
+// Standin.Frames      : Number of depth frames before end of stream (default 0 is unlimited)
+// Standin.Users       : Number of synthetic users 0-6 (default 2)
+// Standin.DropRate    : Ratio of dropped frames 0.0-1.0 (default 0.0)
+// Standin.Devices     : Number of devices 1-8 (default 1), each device has own scene and clock (timestamp origin)
+// Standin.Depth       : Recorded depth frames (raw uint16, concatenated) at Realsense2Module.Depth.ProcessWidth/Height
+// Standin.Labels      : Recorded user label frames (raw uint16, concatenated) at same resolution as depth
+// Standin.Color       : Recorded color frames (raw BGR uint8, concatenated) at Realsense2Module.RGB.ProcessWidth/Height
+// Standin.Json        : Recorded instances JSON (one per line)
+//
+// Recorded frames are looped. If Standin.Frames is reached, Nuitrack::update() throws tdv::nuitrack::Exception.
+// Nuitrack::update() doesn't block (frames that are not due yet are not delivered), Nuitrack::waitUpdate() blocks until new frame of module.
+// Nuitrack::update() advances all devices. Modules are bound to device that was selected by Nuitrack::setDevice() at creation (default first device).
+//
+// This source code is licensed under the MIT license.
+//
+// MIT License
+//
+// Copyright (c) 2018 Tsukasa Sugiura
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __NUITRACK_STANDIN__
+#define __NUITRACK_STANDIN__
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <exception>
+#include <functional>
+
+namespace tdv
+{
+    namespace nuitrack
+    {
+        // Backend of Stand-in and Device of Backend (Fill Frames and Data)
+        struct Backend;
+        struct Device;
+
+        // Exception
+        class Exception : public std::exception
+        {
+        private:
+            std::string message;
+
+        public:
+            Exception( const std::string& message = "nuitrack exception" )
+                : message( message ){}
+
+            const char* what() const noexcept override
+            {
+                return message.c_str();
+            }
+        };
+
+        class LicenseNotAcquiredException : public Exception
+        {
+        public:
+            LicenseNotAcquiredException()
+                : Exception( "license not acquired" ){}
+        };
+
+        // Basic Types
+        struct Color3
+        {
+            uint8_t blue;
+            uint8_t green;
+            uint8_t red;
+        };
+
+        struct Vector3
+        {
+            float x;
+            float y;
+            float z;
+
+            Vector3()
+                : x( 0.0f ), y( 0.0f ), z( 0.0f ){}
+
+            Vector3( const float x, const float y, const float z )
+                : x( x ), y( y ), z( z ){}
+        };
+
+        struct OutputMode
+        {
+            int fps;
+            int xres;
+            int yres;
+            float hfov;
+        };
+
+        // Frame (Image Data with Resolution, ID and Timestamp in Microseconds)
+        template<typename T>
+        class Frame
+        {
+        protected:
+            int rows;
+            int cols;
+            uint64_t id;
+            uint64_t timestamp;
+            std::vector<T> data;
+
+            friend struct Backend;
+            friend struct Device;
+
+        public:
+            Frame( const int rows, const int cols, const uint64_t id, const uint64_t timestamp )
+                : rows( rows ), cols( cols ), id( id ), timestamp( timestamp ), data( static_cast<size_t>( rows ) * cols ){}
+
+            int getRows() const
+            {
+                return rows;
+            }
+
+            int getCols() const
+            {
+                return cols;
+            }
+
+            uint64_t getID() const
+            {
+                return id;
+            }
+
+            uint64_t getTimestamp() const
+            {
+                return timestamp;
+            }
+
+            const T* getData() const
+            {
+                return data.data();
+            }
+        };
+
+        class RGBFrame : public Frame<Color3>
+        {
+        public:
+            typedef std::shared_ptr<RGBFrame> Ptr;
+
+            RGBFrame( const int rows, const int cols, const uint64_t id, const uint64_t timestamp )
+                : Frame<Color3>( rows, cols, id, timestamp ){}
+        };
+
+        class DepthFrame : public Frame<uint16_t>
+        {
+        public:
+            typedef std::shared_ptr<DepthFrame> Ptr;
+
+            DepthFrame( const int rows, const int cols, const uint64_t id, const uint64_t timestamp )
+                : Frame<uint16_t>( rows, cols, id, timestamp ){}
+        };
+
+        // User
+        struct BoundingBox
+        {
+            float top;
+            float bottom;
+            float left;
+            float right;
+        };
+
+        struct User
+        {
+            int id;
+            Vector3 proj;
+            Vector3 real;
+            BoundingBox box;
+            float occlusion;
+        };
+
+        class UserFrame : public Frame<uint16_t>
+        {
+        private:
+            std::vector<User> users;
+
+            friend struct Backend;
+            friend struct Device;
+
+        public:
+            typedef std::shared_ptr<UserFrame> Ptr;
+
+            UserFrame( const int rows, const int cols, const uint64_t id, const uint64_t timestamp )
+                : Frame<uint16_t>( rows, cols, id, timestamp ){}
+
+            int getNumberOfUsers() const
+            {
+                return static_cast<int>( users.size() );
+            }
+
+            std::vector<User> getUsers() const
+            {
+                return users;
+            }
+        };
+
+        // Skeleton
+        enum JointType
+        {
+            JOINT_NONE = 0,
+            JOINT_HEAD = 1,
+            JOINT_NECK = 2,
+            JOINT_TORSO = 3,
+            JOINT_WAIST = 4,
+            JOINT_LEFT_COLLAR = 5,
+            JOINT_LEFT_SHOULDER = 6,
+            JOINT_LEFT_ELBOW = 7,
+            JOINT_LEFT_WRIST = 8,
+            JOINT_LEFT_HAND = 9,
+            JOINT_LEFT_FINGERTIP = 10,
+            JOINT_RIGHT_COLLAR = 11,
+            JOINT_RIGHT_SHOULDER = 12,
+            JOINT_RIGHT_ELBOW = 13,
+            JOINT_RIGHT_WRIST = 14,
+            JOINT_RIGHT_HAND = 15,
+            JOINT_RIGHT_FINGERTIP = 16,
+            JOINT_LEFT_HIP = 17,
+            JOINT_LEFT_KNEE = 18,
+            JOINT_LEFT_ANKLE = 19,
+            JOINT_LEFT_FOOT = 20,
+            JOINT_RIGHT_HIP = 21,
+            JOINT_RIGHT_KNEE = 22,
+            JOINT_RIGHT_ANKLE = 23,
+            JOINT_RIGHT_FOOT = 24
+        };
+
+        struct Orientation
+        {
+            float matrix[9];
+        };
+
+        struct Joint
+        {
+            JointType type;
+            float confidence;
+            Vector3 real;
+            Vector3 proj;
+            Orientation orient;
+        };
+
+        struct Skeleton
+        {
+            int id;
+            std::vector<Joint> joints;
+        };
+
+        class SkeletonData
+        {
+        private:
+            uint64_t timestamp;
+            std::vector<Skeleton> skeletons;
+
+        public:
+            typedef std::shared_ptr<SkeletonData> Ptr;
+
+            SkeletonData( const uint64_t timestamp, const std::vector<Skeleton>& skeletons )
+                : timestamp( timestamp ), skeletons( skeletons ){}
+
+            int getNumSkeletons() const
+            {
+                return static_cast<int>( skeletons.size() );
+            }
+
+            std::vector<Skeleton> getSkeletons() const
+            {
+                return skeletons;
+            }
+
+            uint64_t getTimestamp() const
+            {
+                return timestamp;
+            }
+        };
+
+        // Hand
+        struct Hand
+        {
+            typedef std::shared_ptr<Hand> Ptr;
+
+            float x;
+            float y;
+            bool click;
+            int pressure;
+            float xReal;
+            float yReal;
+            float zReal;
+        };
+
+        struct UserHands
+        {
+            int userId;
+            Hand::Ptr leftHand;
+            Hand::Ptr rightHand;
+        };
+
+        class HandTrackerData
+        {
+        private:
+            uint64_t timestamp;
+            std::vector<UserHands> users_hands;
+
+        public:
+            typedef std::shared_ptr<HandTrackerData> Ptr;
+
+            HandTrackerData( const uint64_t timestamp, const std::vector<UserHands>& users_hands )
+                : timestamp( timestamp ), users_hands( users_hands ){}
+
+            int getNumUsers() const
+            {
+                return static_cast<int>( users_hands.size() );
+            }
+
+            std::vector<UserHands> getUsersHands() const
+            {
+                return users_hands;
+            }
+
+            uint64_t getTimestamp() const
+            {
+                return timestamp;
+            }
+        };
+
+        // Gesture
+        enum GestureType
+        {
+            GESTURE_WAVING = 0,
+            GESTURE_SWIPE_LEFT = 1,
+            GESTURE_SWIPE_RIGHT = 2,
+            GESTURE_SWIPE_UP = 3,
+            GESTURE_SWIPE_DOWN = 4,
+            GESTURE_PUSH = 5
+        };
+
+        struct Gesture
+        {
+            int userId;
+            GestureType type;
+        };
+
+        class GestureData
+        {
+        private:
+            uint64_t timestamp;
+            std::vector<Gesture> gestures;
+
+        public:
+            typedef std::shared_ptr<GestureData> Ptr;
+
+            GestureData( const uint64_t timestamp, const std::vector<Gesture>& gestures )
+                : timestamp( timestamp ), gestures( gestures ){}
+
+            int getNumGestures() const
+            {
+                return static_cast<int>( gestures.size() );
+            }
+
+            std::vector<Gesture> getGestures() const
+            {
+                return gestures;
+            }
+
+            uint64_t getTimestamp() const
+            {
+                return timestamp;
+            }
+        };
+
+        namespace device
+        {
+            // Type of Device Information
+            struct DeviceInfoType
+            {
+                enum Type
+                {
+                    DEVICE_NAME = 0,
+                    SERIAL_NUMBER = 1,
+                    PROVIDER_NAME = 2
+                };
+            };
+
+            // Device (Sensor)
+            class NuitrackDevice
+            {
+            private:
+                friend struct tdv::nuitrack::Backend;
+                uint32_t index;
+
+            public:
+                typedef std::shared_ptr<NuitrackDevice> Ptr;
+
+                NuitrackDevice( const uint32_t index )
+                    : index( index ){}
+
+                std::string getInfo( const DeviceInfoType::Type type ) const;
+            };
+        }
+
+        // Module (Base of Sensors and Trackers, Bound to Device that was Selected at Creation)
+        class Module
+        {
+        protected:
+            friend struct Backend;
+            uint32_t device = 0;
+
+        public:
+            typedef std::shared_ptr<Module> Ptr;
+
+            virtual ~Module(){}
+        };
+
+        class ColorSensor : public Module
+        {
+        public:
+            typedef std::shared_ptr<ColorSensor> Ptr;
+
+            static Ptr create();
+
+            RGBFrame::Ptr getColorFrame();
+
+            OutputMode getOutputMode() const;
+        };
+
+        class DepthSensor : public Module
+        {
+        public:
+            typedef std::shared_ptr<DepthSensor> Ptr;
+
+            static Ptr create();
+
+            DepthFrame::Ptr getDepthFrame();
+
+            OutputMode getOutputMode() const;
+        };
+
+        class UserTracker : public Module
+        {
+        public:
+            typedef std::shared_ptr<UserTracker> Ptr;
+
+            static Ptr create();
+
+            UserFrame::Ptr getUserFrame();
+        };
+
+        class SkeletonTracker : public Module
+        {
+        public:
+            typedef std::shared_ptr<SkeletonTracker> Ptr;
+
+            static Ptr create();
+
+            SkeletonData::Ptr getSkeletons();
+        };
+
+        class HandTracker : public Module
+        {
+        public:
+            typedef std::shared_ptr<HandTracker> Ptr;
+
+            static Ptr create();
+
+            HandTrackerData::Ptr getData();
+        };
+
+        class GestureRecognizer : public Module
+        {
+        public:
+            typedef std::shared_ptr<GestureRecognizer> Ptr;
+            typedef std::function<void( GestureData::Ptr )> OnNewGestures;
+
+            static Ptr create();
+
+            uint64_t connectOnNewGestures( const OnNewGestures& callback );
+
+            void disconnectOnNewGestures( const uint64_t handler );
+        };
+
+        // NuiTrack
+        class Nuitrack
+        {
+        public:
+            static void init( const std::string& config = "" );
+
+            static void run();
+
+            static void update();
+
+            static void waitUpdate( const Module::Ptr& module );
+
+            static void release();
+
+            static void setConfigValue( const std::string& key, const std::string& value );
+
+            static std::string getConfigValue( const std::string& key );
+
+            static std::string getInstancesJson();
+
+            static std::vector<device::NuitrackDevice::Ptr> getDeviceList();
+
+            static void setDevice( const device::NuitrackDevice::Ptr& device );
+        };
+    }
+}
+
+#endif // __NUITRACK_STANDIN__
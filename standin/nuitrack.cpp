@@ -0,0 +1,903 @@
+#include <nuitrack/Nuitrack.h>
+
+#include "synthetic.h"
+
+#include <map>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+#include <type_traits>
+
+namespace tdv
+{
+    namespace nuitrack
+    {
+        // Stream of Frames (Color, or Depth with Trackers)
+        struct Stream
+        {
+            double fps = 30.0;
+            uint64_t index = 0; // index of next frame
+            uint64_t produced = 0; // number of frames that were delivered
+            int32_t width = 640;
+            int32_t height = 480;
+            uint64_t epoch = 0; // origin of device clock (microseconds)
+
+            // Time of Frame since Start (microseconds)
+            uint64_t time( const uint64_t index ) const
+            {
+                return static_cast<uint64_t>( index * 1e6 / fps + 0.5 );
+            }
+
+            // Timestamp of Frame by Device Clock (microseconds)
+            uint64_t timestamp( const uint64_t index ) const
+            {
+                return epoch + time( index );
+            }
+        };
+
+        // Recorded Frames (Raw File that Concatenates Frames)
+        struct Recording
+        {
+            std::ifstream file;
+            size_t frame_size = 0;
+            uint64_t frames = 0;
+
+            // Open File
+            void open( const std::string& path, const size_t frame_size )
+            {
+                file.open( path, std::ios::binary );
+                if( !file.is_open() ){
+                    throw tdv::nuitrack::Exception( "failed to open " + path );
+                }
+
+                file.seekg( 0, std::ios::end );
+                this->frame_size = frame_size;
+                frames = static_cast<uint64_t>( file.tellg() ) / frame_size;
+                if( frames == 0 ){
+                    throw tdv::nuitrack::Exception( "failed to read " + path + " (smaller than one frame)" );
+                }
+            }
+
+            // Read Frame (Loop)
+            void read( const uint64_t index, void* data )
+            {
+                file.seekg( static_cast<std::streamoff>( ( index % frames ) * frame_size ), std::ios::beg );
+                file.read( reinterpret_cast<char*>( data ), frame_size );
+            }
+
+            bool isOpen() const
+            {
+                return file.is_open();
+            }
+        };
+
+        // Device (Streams, Sources and Latest Data of One Sensor)
+        struct Device
+        {
+            Stream color;
+            Stream depth;
+            uint32_t seed = 0;
+
+            // Sources
+            std::unique_ptr<synthetic::Scene> color_scene;
+            std::unique_ptr<synthetic::Scene> depth_scene;
+            Recording color_recording;
+            Recording depth_recording;
+            Recording labels_recording;
+
+            // Latest Data
+            RGBFrame::Ptr color_frame;
+            DepthFrame::Ptr depth_frame;
+            UserFrame::Ptr user_frame;
+            SkeletonData::Ptr skeleton_data;
+            HandTrackerData::Ptr hand_data;
+            std::string instances_json = "{}";
+
+            // Gesture Callbacks
+            std::map<uint64_t, GestureRecognizer::OnNewGestures> gesture_callbacks;
+
+            // Produce Color Frame
+            void produceColor( const uint64_t index )
+            {
+                RGBFrame::Ptr frame = std::make_shared<RGBFrame>( color.height, color.width, index, color.timestamp( index ) );
+                if( color_recording.isOpen() ){
+                    color_recording.read( index, frame->data.data() );
+                }
+                else{
+                    color_scene->generate( static_cast<uint32_t>( index ), nullptr, nullptr, reinterpret_cast<uint8_t*>( frame->data.data() ) );
+                }
+                color_frame = frame;
+            }
+
+            // Produce Depth Frame and Tracker Data
+            void produceDepth( const uint64_t index, const int32_t users, const std::vector<std::string>& json_recording )
+            {
+                const uint64_t timestamp = depth.timestamp( index );
+                DepthFrame::Ptr depth_frame = std::make_shared<DepthFrame>( depth.height, depth.width, index, timestamp );
+                UserFrame::Ptr user_frame = std::make_shared<UserFrame>( depth.height, depth.width, index, timestamp );
+
+                std::vector<synthetic::User> silhouettes;
+                if( depth_recording.isOpen() ){
+                    depth_recording.read( index, depth_frame->data.data() );
+                    if( labels_recording.isOpen() ){
+                        labels_recording.read( index, user_frame->data.data() );
+                    }
+                    silhouettes = measure( depth_frame->data, user_frame->data );
+                }
+                else{
+                    depth_scene->generate( static_cast<uint32_t>( index ), depth_frame->data.data(), user_frame->data.data(), nullptr );
+                    silhouettes = depth_scene->getUsers( static_cast<uint32_t>( index ) );
+                }
+
+                // Users, Skeletons and Hands from Silhouettes
+                std::vector<User> tracked_users;
+                std::vector<Skeleton> skeletons;
+                std::vector<UserHands> users_hands;
+                for( const synthetic::User& silhouette : silhouettes ){
+                    tracked_users.push_back( user( silhouette ) );
+                    skeletons.push_back( skeleton( silhouette, index ) );
+                    users_hands.push_back( hands( skeletons.back(), index ) );
+                }
+                user_frame->users = tracked_users;
+
+                this->depth_frame = depth_frame;
+                this->user_frame = user_frame;
+                skeleton_data = std::make_shared<SkeletonData>( timestamp, skeletons );
+                hand_data = std::make_shared<HandTrackerData>( timestamp, users_hands );
+
+                // Instances JSON
+                if( !json_recording.empty() ){
+                    instances_json = json_recording[index % json_recording.size()];
+                }
+                else{
+                    instances_json = synthetic::instancesJson( static_cast<uint32_t>( index ), users, seed );
+                }
+
+                // Gestures (Every 3 seconds, User takes turns)
+                const uint64_t period = std::max<uint64_t>( static_cast<uint64_t>( depth.fps * 3.0 ), 1 );
+                if( !silhouettes.empty() && index % period == period - 1 && !gesture_callbacks.empty() ){
+                    const uint64_t turn = index / period;
+                    Gesture gesture;
+                    gesture.userId = silhouettes[turn % silhouettes.size()].id;
+                    gesture.type = static_cast<GestureType>( turn % 6 );
+                    const GestureData::Ptr gesture_data = std::make_shared<GestureData>( timestamp, std::vector<Gesture>( 1, gesture ) );
+
+                    // Copy Callbacks (Callback may disconnect itself)
+                    const std::map<uint64_t, GestureRecognizer::OnNewGestures> callbacks = gesture_callbacks;
+                    for( const std::pair<const uint64_t, GestureRecognizer::OnNewGestures>& callback : callbacks ){
+                        callback.second( gesture_data );
+                    }
+                }
+            }
+
+            // Measure Silhouettes of Recorded Users from Labels (Bounding Box and Mean Depth)
+            std::vector<synthetic::User> measure( const std::vector<uint16_t>& depth_data, const std::vector<uint16_t>& labels ) const
+            {
+                struct Box
+                {
+                    int32_t left = INT32_MAX, top = INT32_MAX, right = -1, bottom = -1;
+                    double sum = 0.0;
+                    uint64_t count = 0;
+                };
+
+                std::map<uint16_t, Box> boxes;
+                for( int32_t y = 0; y < depth.height; y++ ){
+                    for( int32_t x = 0; x < depth.width; x++ ){
+                        const size_t pixel = static_cast<size_t>( y ) * depth.width + x;
+                        const uint16_t label = labels[pixel];
+                        if( label == 0 ){
+                            continue;
+                        }
+
+                        Box& box = boxes[label];
+                        box.left = std::min( box.left, x );
+                        box.top = std::min( box.top, y );
+                        box.right = std::max( box.right, x );
+                        box.bottom = std::max( box.bottom, y );
+                        if( depth_data[pixel] > 0 ){
+                            box.sum += depth_data[pixel];
+                            box.count++;
+                        }
+                    }
+                }
+
+                std::vector<synthetic::User> silhouettes;
+                for( const std::pair<const uint16_t, Box>& labeled : boxes ){
+                    const Box& box = labeled.second;
+                    synthetic::User silhouette;
+                    silhouette.id = labeled.first;
+                    silhouette.distance = box.count > 0 ? static_cast<float>( box.sum / box.count ) : 2000.0f;
+                    silhouette.center_x = ( box.left + box.right ) * 0.5f;
+                    silhouette.head_r = std::max( ( box.right - box.left ) * 0.2f, 1.0f );
+                    silhouette.head_y = box.top + silhouette.head_r;
+                    silhouette.body_rx = std::max( ( box.right - box.left ) * 0.5f, 1.0f );
+                    silhouette.body_ry = std::max( ( box.bottom - silhouette.head_y - silhouette.head_r * 0.8f ) * 0.5f, 1.0f );
+                    silhouette.body_y = box.bottom - silhouette.body_ry;
+                    silhouettes.push_back( silhouette );
+                }
+
+                return silhouettes;
+            }
+
+            // Projective (Normalized) and Real (millimeter) Coordinates of Pixel
+            void project( const float x, const float y, const float z, Vector3& proj, Vector3& real ) const
+            {
+                const float focal = depth_scene->getFocal();
+                proj = Vector3( x / depth.width, y / depth.height, z );
+                real = Vector3( ( x - depth.width * 0.5f ) * z / focal, -( y - depth.height * 0.5f ) * z / focal, z );
+            }
+
+            // User of Silhouette
+            User user( const synthetic::User& silhouette ) const
+            {
+                User user;
+                user.id = silhouette.id;
+                project( silhouette.center_x, silhouette.body_y, silhouette.distance, user.proj, user.real );
+                user.box.left = ( silhouette.center_x - silhouette.body_rx ) / depth.width;
+                user.box.right = ( silhouette.center_x + silhouette.body_rx ) / depth.width;
+                user.box.top = ( silhouette.head_y - silhouette.head_r ) / depth.height;
+                user.box.bottom = ( silhouette.body_y + silhouette.body_ry ) / depth.height;
+                user.occlusion = 0.0f;
+                return user;
+            }
+
+            // Skeleton of Silhouette (Joints on Body Ellipse, Arms Swing over Frames)
+            Skeleton skeleton( const synthetic::User& silhouette, const uint64_t index ) const
+            {
+                // Offset from Body Center (Body Radius Units)
+                static const float offsets[25][2] = {
+                    {  0.00f,  0.00f }, // NONE
+                    {  0.00f,  0.00f }, // HEAD (Head Center)
+                    {  0.00f, -0.95f }, // NECK
+                    {  0.00f, -0.35f }, // TORSO
+                    {  0.00f,  0.15f }, // WAIST
+                    { -0.25f, -0.90f }, // LEFT_COLLAR
+                    { -0.75f, -0.85f }, // LEFT_SHOULDER
+                    { -0.95f, -0.45f }, // LEFT_ELBOW
+                    { -1.00f, -0.10f }, // LEFT_WRIST
+                    { -1.00f,  0.00f }, // LEFT_HAND
+                    { -1.00f,  0.08f }, // LEFT_FINGERTIP
+                    {  0.25f, -0.90f }, // RIGHT_COLLAR
+                    {  0.75f, -0.85f }, // RIGHT_SHOULDER
+                    {  0.95f, -0.45f }, // RIGHT_ELBOW
+                    {  1.00f, -0.10f }, // RIGHT_WRIST
+                    {  1.00f,  0.00f }, // RIGHT_HAND
+                    {  1.00f,  0.08f }, // RIGHT_FINGERTIP
+                    { -0.40f,  0.35f }, // LEFT_HIP
+                    { -0.40f,  0.65f }, // LEFT_KNEE
+                    { -0.40f,  0.92f }, // LEFT_ANKLE
+                    { -0.40f,  1.00f }, // LEFT_FOOT
+                    {  0.40f,  0.35f }, // RIGHT_HIP
+                    {  0.40f,  0.65f }, // RIGHT_KNEE
+                    {  0.40f,  0.92f }, // RIGHT_ANKLE
+                    {  0.40f,  1.00f }  // RIGHT_FOOT
+                };
+
+                const float swing = std::sin( index * 0.1f + silhouette.id ) * 0.4f;
+
+                Skeleton skeleton;
+                skeleton.id = silhouette.id;
+                skeleton.joints.resize( 25 );
+                for( int32_t type = 0; type < 25; type++ ){
+                    Joint& joint = skeleton.joints[type];
+                    joint.type = static_cast<JointType>( type );
+                    joint.confidence = ( type == JOINT_NONE ) ? 0.0f : 0.75f;
+                    for( float& value : joint.orient.matrix ){
+                        value = 0.0f;
+                    }
+                    joint.orient.matrix[0] = joint.orient.matrix[4] = joint.orient.matrix[8] = 1.0f;
+
+                    // Arms (Elbow to Fingertip) Swing Up and Down
+                    float dy = offsets[type][1];
+                    if( ( type >= JOINT_LEFT_ELBOW && type <= JOINT_LEFT_FINGERTIP ) || ( type >= JOINT_RIGHT_ELBOW && type <= JOINT_RIGHT_FINGERTIP ) ){
+                        dy -= ( type >= JOINT_RIGHT_COLLAR ? swing : -swing ) * ( dy + 0.85f );
+                    }
+
+                    const float x = silhouette.center_x + offsets[type][0] * silhouette.body_rx;
+                    const float y = ( type == JOINT_HEAD ) ? silhouette.head_y : silhouette.body_y + dy * silhouette.body_ry;
+                    project( x, y, silhouette.distance, joint.proj, joint.real );
+                }
+
+                return skeleton;
+            }
+
+            // Hands of Skeleton (Click while Hand is Raised)
+            UserHands hands( const Skeleton& skeleton, const uint64_t index ) const
+            {
+                UserHands user_hands;
+                user_hands.userId = skeleton.id;
+
+                const JointType types[2] = { JOINT_LEFT_HAND, JOINT_RIGHT_HAND };
+                Hand::Ptr hands[2];
+                for( int32_t side = 0; side < 2; side++ ){
+                    const Joint& joint = skeleton.joints[types[side]];
+                    Hand::Ptr hand = std::make_shared<Hand>();
+                    hand->x = joint.proj.x;
+                    hand->y = joint.proj.y;
+                    hand->click = std::sin( index * 0.1f + skeleton.id ) * ( side == 0 ? -1.0f : 1.0f ) > 0.3f;
+                    hand->pressure = hand->click ? 100 : 0;
+                    hand->xReal = joint.real.x;
+                    hand->yReal = joint.real.y;
+                    hand->zReal = joint.real.z;
+                    hands[side] = hand;
+                }
+
+                user_hands.leftHand = hands[0];
+                user_hands.rightHand = hands[1];
+                return user_hands;
+            }
+        };
+
+        // Backend of Stand-in
+        struct Backend
+        {
+            bool initialized = false;
+            bool running = false;
+
+            std::map<std::string, std::string> config;
+
+            // Streams
+            bool realtime = true;
+            uint64_t frames = 0;
+            int32_t users = 2;
+            double drop_rate = 0.0;
+            std::chrono::steady_clock::time_point start;
+
+            // Devices
+            std::vector<Device> devices;
+            uint32_t selected = 0; // device of modules that are created
+            std::vector<std::string> json_recording;
+
+            // Gesture Callbacks
+            uint64_t gesture_handler = 0;
+
+            static Backend& instance()
+            {
+                static Backend backend;
+                return backend;
+            }
+
+            // Retrieve Config Value (setConfigValue(), Environment Variable, Default)
+            std::string value( const std::string& key, const std::string& default_value ) const
+            {
+                const std::map<std::string, std::string>::const_iterator it = config.find( key );
+                if( it != config.end() ){
+                    return it->second;
+                }
+
+                // Standin.ColorFPS -> NUITRACK_STANDIN_COLORFPS
+                const std::string prefix = "Standin.";
+                if( key.compare( 0, prefix.size(), prefix ) == 0 ){
+                    std::string name = "NUITRACK_STANDIN_" + key.substr( prefix.size() );
+                    std::transform( name.begin(), name.end(), name.begin(), []( const char c ){ return static_cast<char>( std::toupper( static_cast<unsigned char>( c ) ) ); } );
+                    const char* environment = std::getenv( name.c_str() );
+                    if( environment && *environment ){
+                        return environment;
+                    }
+                }
+
+                return default_value;
+            }
+
+            // Retrieve Config Value as Number
+            double number( const std::string& key, const double default_value ) const
+            {
+                const std::string text = value( key, "" );
+                if( text.empty() ){
+                    return default_value;
+                }
+
+                try{
+                    return std::stod( text );
+                }
+                catch( const std::exception& ){
+                    throw tdv::nuitrack::Exception( "failed to parse " + key + " (" + text + ")" );
+                }
+            }
+
+            // Enumerate Devices (Number of Devices is Fixed until Release)
+            void enumerate()
+            {
+                if( !devices.empty() ){
+                    return;
+                }
+
+                const int32_t count = std::min( std::max( static_cast<int32_t>( number( "Standin.Devices", 1 ) ), 1 ), 8 );
+                devices.resize( count );
+                for( int32_t index = 0; index < count; index++ ){
+                    devices[index].seed = static_cast<uint32_t>( index );
+                }
+            }
+
+            // Retrieve Device of Module
+            Device& device( const uint32_t index )
+            {
+                enumerate();
+                if( index >= devices.size() ){
+                    throw tdv::nuitrack::Exception( "failed to find device " + std::to_string( index ) );
+                }
+                return devices[index];
+            }
+
+            // Create Module Bound to Selected Device (Modules can be Created Concurrently)
+            template<typename T>
+            std::shared_ptr<T> create()
+            {
+                // Emulate Loading of Module (Milliseconds)
+                const double latency = number( "Standin.ModuleLatency", 0.0 );
+                if( latency > 0.0 ){
+                    std::this_thread::sleep_for( std::chrono::duration<double, std::milli>( latency ) );
+                }
+
+                static std::mutex mutex;
+                std::lock_guard<std::mutex> lock( mutex );
+                Device& device = this->device( selected );
+                std::shared_ptr<T> module = std::make_shared<T>();
+
+                // Module that is Created while Running Applies Changed Resolution to Its Stream (Color Sensor or Depth with Trackers)
+                if( running ){
+                    restream( device, std::is_same<T, ColorSensor>::value );
+                }
+                static_cast<Module&>( *module ).device = selected;
+                return module;
+            }
+
+            // Retrieve Device of Module
+            Device& device( const Module& module )
+            {
+                return device( module.device );
+            }
+
+            // Index of Device
+            static uint32_t indexOf( const device::NuitrackDevice& device )
+            {
+                return device.index;
+            }
+
+            // Processing Resolution of Streams
+            void resolution( int32_t& color_width, int32_t& color_height, int32_t& depth_width, int32_t& depth_height ) const
+            {
+                // Depth is Registered to Color if Depth2ColorRegistration is enabled (Same as Real Sensor)
+                const bool registration = value( "Realsense2Module.Depth2ColorRegistration", "false" ) == "true" || value( "DepthProvider.Depth2ColorRegistration", "false" ) == "true";
+
+                color_width = static_cast<int32_t>( number( "Realsense2Module.RGB.ProcessWidth", 640 ) );
+                color_height = static_cast<int32_t>( number( "Realsense2Module.RGB.ProcessHeight", 480 ) );
+                depth_width = registration ? color_width : static_cast<int32_t>( number( "Realsense2Module.Depth.ProcessWidth", 640 ) );
+                depth_height = registration ? color_height : static_cast<int32_t>( number( "Realsense2Module.Depth.ProcessHeight", 480 ) );
+                if( color_width <= 0 || color_height <= 0 || depth_width <= 0 || depth_height <= 0 ){
+                    throw tdv::nuitrack::Exception( "failed to run (invalid resolution)" );
+                }
+            }
+
+            // Apply Resolution to Stream of Module that is Created while Running (Clock of Stream Continues)
+            void restream( Device& device, const bool color )
+            {
+                int32_t color_width, color_height, depth_width, depth_height;
+                resolution( color_width, color_height, depth_width, depth_height );
+
+                Stream& stream = color ? device.color : device.depth;
+                const int32_t width = color ? color_width : depth_width;
+                const int32_t height = color ? color_height : depth_height;
+                if( stream.width == width && stream.height == height ){
+                    return;
+                }
+
+                stream.width = width;
+                stream.height = height;
+                ( color ? device.color_scene : device.depth_scene ).reset( new synthetic::Scene( width, height, users, device.seed ) );
+
+                // Recorded Frames are Re-Opened with Frame Size of New Resolution
+                const size_t pixels = static_cast<size_t>( width ) * height;
+                if( color ){
+                    const std::string color_path = value( "Standin.Color", "" );
+                    device.color_recording = Recording();
+                    if( !color_path.empty() ){
+                        device.color_recording.open( color_path, pixels * sizeof( Color3 ) );
+                    }
+                }
+                else{
+                    const std::string depth_path = value( "Standin.Depth", "" );
+                    const std::string labels_path = value( "Standin.Labels", "" );
+                    device.depth_recording = Recording();
+                    device.labels_recording = Recording();
+                    if( !depth_path.empty() ){
+                        device.depth_recording.open( depth_path, pixels * sizeof( uint16_t ) );
+                    }
+                    if( !labels_path.empty() ){
+                        device.labels_recording.open( labels_path, pixels * sizeof( uint16_t ) );
+                    }
+                }
+            }
+
+            // Start Streams
+            void run()
+            {
+                enumerate();
+
+                // Depth is Registered to Color if Depth2ColorRegistration is enabled (Same as Real Sensor)
+                int32_t color_width, color_height, depth_width, depth_height;
+                resolution( color_width, color_height, depth_width, depth_height );
+
+                const double depth_fps = number( "Standin.FPS", 30.0 );
+                const double color_fps = number( "Standin.ColorFPS", depth_fps );
+                if( depth_fps <= 0.0 || color_fps <= 0.0 ){
+                    throw tdv::nuitrack::Exception( "failed to run (invalid frame rate)" );
+                }
+
+                realtime = value( "Standin.Realtime", "true" ) != "false";
+                frames = static_cast<uint64_t>( std::max( number( "Standin.Frames", 0.0 ), 0.0 ) );
+                users = static_cast<int32_t>( number( "Standin.Users", 2 ) );
+                drop_rate = std::min( std::max( number( "Standin.DropRate", 0.0 ), 0.0 ), 0.9 );
+
+                const std::string color_path = value( "Standin.Color", "" );
+                const std::string depth_path = value( "Standin.Depth", "" );
+                const std::string labels_path = value( "Standin.Labels", "" );
+
+                for( Device& device : devices ){
+                    // Each Device has Own Clock (Timestamp Origin is One Hour Apart)
+                    const uint64_t epoch = device.seed * 3600000000ull;
+                    device.color = Stream();
+                    device.depth = Stream();
+                    device.color.width = color_width;
+                    device.color.height = color_height;
+                    device.color.fps = color_fps;
+                    device.color.epoch = epoch;
+                    device.depth.width = depth_width;
+                    device.depth.height = depth_height;
+                    device.depth.fps = depth_fps;
+                    device.depth.epoch = epoch;
+
+                    // Synthetic Scene
+                    device.color_scene.reset( new synthetic::Scene( color_width, color_height, users, device.seed ) );
+                    device.depth_scene.reset( new synthetic::Scene( depth_width, depth_height, users, device.seed ) );
+
+                    // Recorded Frames (Shared by Devices)
+                    device.color_recording = Recording();
+                    device.depth_recording = Recording();
+                    device.labels_recording = Recording();
+
+                    if( !color_path.empty() ){
+                        device.color_recording.open( color_path, static_cast<size_t>( color_width ) * color_height * sizeof( Color3 ) );
+                    }
+
+                    if( !depth_path.empty() ){
+                        device.depth_recording.open( depth_path, static_cast<size_t>( depth_width ) * depth_height * sizeof( uint16_t ) );
+                    }
+
+                    if( !labels_path.empty() ){
+                        device.labels_recording.open( labels_path, static_cast<size_t>( depth_width ) * depth_height * sizeof( uint16_t ) );
+                    }
+                }
+
+                json_recording.clear();
+                const std::string json_path = value( "Standin.Json", "" );
+                if( !json_path.empty() ){
+                    std::ifstream file( json_path );
+                    if( !file.is_open() ){
+                        throw tdv::nuitrack::Exception( "failed to open " + json_path );
+                    }
+
+                    std::string line;
+                    while( std::getline( file, line ) ){
+                        if( !line.empty() ){
+                            json_recording.push_back( line );
+                        }
+                    }
+                }
+
+                start = std::chrono::steady_clock::now();
+                running = true;
+            }
+
+            // Frame is Dropped (Deterministic)
+            bool dropped( const uint64_t index, const uint32_t stream ) const
+            {
+                if( drop_rate <= 0.0 || index == 0 ){
+                    return false;
+                }
+
+                uint32_t h = static_cast<uint32_t>( index ) * 0x9e3779b1u ^ stream * 0x85ebca6bu;
+                h ^= h >> 15;
+                h *= 0x2c1b3c6du;
+                h ^= h >> 12;
+                return ( h % 10000 ) < drop_rate * 10000.0;
+            }
+
+            // Time of Next Frame since Start (microseconds)
+            uint64_t next() const
+            {
+                uint64_t time = UINT64_MAX;
+                for( const Device& device : devices ){
+                    time = std::min( { time, device.color.time( device.color.index ), device.depth.time( device.depth.index ) } );
+                }
+                return time;
+            }
+
+            // Advance Streams of All Devices (Non-Blocking)
+            // Realtime stream delivers frames that are due by clock, otherwise virtual clock advances to next frame.
+            void update()
+            {
+                if( !running ){
+                    throw tdv::nuitrack::Exception( "failed to update (not running)" );
+                }
+
+                if( frames > 0 && devices.front().depth.index >= frames ){
+                    throw tdv::nuitrack::Exception( "end of stream" );
+                }
+
+                uint64_t now = next();
+                if( realtime ){
+                    now = static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count() );
+                }
+
+                // Deliver Latest Frame of Each Stream (Frames that were missed by slow consumer are skipped like real sensor)
+                for( Device& device : devices ){
+                    Stream& color = device.color;
+                    if( color.time( color.index ) <= now ){
+                        const uint64_t index = std::max( color.index, static_cast<uint64_t>( now * color.fps / 1e6 ) );
+                        color.index = index + 1;
+                        if( !dropped( index, device.seed * 2 ) ){
+                            device.produceColor( index );
+                            color.produced++;
+                        }
+                    }
+
+                    Stream& depth = device.depth;
+                    if( depth.time( depth.index ) <= now ){
+                        uint64_t index = std::max( depth.index, static_cast<uint64_t>( now * depth.fps / 1e6 ) );
+                        if( frames > 0 ){
+                            index = std::min( index, frames - 1 );
+                        }
+                        depth.index = index + 1;
+                        if( !dropped( index, device.seed * 2 + 1 ) ){
+                            device.produceDepth( index, users, json_recording );
+                            depth.produced++;
+                        }
+                    }
+                }
+            }
+
+            // Wait for New Frame of Module (Blocking)
+            void waitUpdate( const Module::Ptr& module )
+            {
+                const Device& device = this->device( *module );
+                const Stream& stream = std::dynamic_pointer_cast<ColorSensor>( module ) ? device.color : device.depth;
+                const uint64_t produced = stream.produced;
+                while( true ){
+                    update();
+                    if( stream.produced != produced ){
+                        break;
+                    }
+
+                    if( realtime ){
+                        std::this_thread::sleep_until( start + std::chrono::microseconds( next() ) );
+                    }
+                }
+            }
+
+            // Release
+            void release()
+            {
+                *this = Backend();
+            }
+
+            Backend() = default;
+            Backend& operator=( Backend&& ) = default;
+        };
+
+        // Create Color Sensor
+        ColorSensor::Ptr ColorSensor::create()
+        {
+            return Backend::instance().create<ColorSensor>();
+        }
+
+        // Retrieve Color Frame
+        RGBFrame::Ptr ColorSensor::getColorFrame()
+        {
+            return Backend::instance().device( *this ).color_frame;
+        }
+
+        // Retrieve Output Mode
+        OutputMode ColorSensor::getOutputMode() const
+        {
+            const Stream& stream = Backend::instance().device( *this ).color;
+            OutputMode mode;
+            mode.fps = static_cast<int>( stream.fps + 0.5 );
+            mode.xres = stream.width;
+            mode.yres = stream.height;
+            mode.hfov = 70.0f * 3.14159265f / 180.0f;
+            return mode;
+        }
+
+        // Create Depth Sensor
+        DepthSensor::Ptr DepthSensor::create()
+        {
+            return Backend::instance().create<DepthSensor>();
+        }
+
+        // Retrieve Depth Frame
+        DepthFrame::Ptr DepthSensor::getDepthFrame()
+        {
+            return Backend::instance().device( *this ).depth_frame;
+        }
+
+        // Retrieve Output Mode
+        OutputMode DepthSensor::getOutputMode() const
+        {
+            const Stream& stream = Backend::instance().device( *this ).depth;
+            OutputMode mode;
+            mode.fps = static_cast<int>( stream.fps + 0.5 );
+            mode.xres = stream.width;
+            mode.yres = stream.height;
+            mode.hfov = 70.0f * 3.14159265f / 180.0f;
+            return mode;
+        }
+
+        // Create User Tracker
+        UserTracker::Ptr UserTracker::create()
+        {
+            return Backend::instance().create<UserTracker>();
+        }
+
+        // Retrieve User Frame
+        UserFrame::Ptr UserTracker::getUserFrame()
+        {
+            return Backend::instance().device( *this ).user_frame;
+        }
+
+        // Create Skeleton Tracker
+        SkeletonTracker::Ptr SkeletonTracker::create()
+        {
+            return Backend::instance().create<SkeletonTracker>();
+        }
+
+        // Retrieve Skeletons
+        SkeletonData::Ptr SkeletonTracker::getSkeletons()
+        {
+            return Backend::instance().device( *this ).skeleton_data;
+        }
+
+        // Create Hand Tracker
+        HandTracker::Ptr HandTracker::create()
+        {
+            return Backend::instance().create<HandTracker>();
+        }
+
+        // Retrieve Hands
+        HandTrackerData::Ptr HandTracker::getData()
+        {
+            return Backend::instance().device( *this ).hand_data;
+        }
+
+        // Create Gesture Recognizer
+        GestureRecognizer::Ptr GestureRecognizer::create()
+        {
+            return Backend::instance().create<GestureRecognizer>();
+        }
+
+        // Connect Callback of New Gestures
+        uint64_t GestureRecognizer::connectOnNewGestures( const OnNewGestures& callback )
+        {
+            Backend& backend = Backend::instance();
+            const uint64_t handler = ++backend.gesture_handler;
+            backend.device( *this ).gesture_callbacks[handler] = callback;
+            return handler;
+        }
+
+        // Disconnect Callback of New Gestures
+        void GestureRecognizer::disconnectOnNewGestures( const uint64_t handler )
+        {
+            Backend::instance().device( *this ).gesture_callbacks.erase( handler );
+        }
+
+        // Initialize
+        void Nuitrack::init( const std::string& /*config*/ )
+        {
+            Backend& backend = Backend::instance();
+            backend.release();
+            backend.initialized = true;
+        }
+
+        // Run
+        void Nuitrack::run()
+        {
+            Backend& backend = Backend::instance();
+            if( !backend.initialized ){
+                throw tdv::nuitrack::Exception( "failed to run (not initialized)" );
+            }
+            backend.run();
+        }
+
+        // Update
+        void Nuitrack::update()
+        {
+            Backend::instance().update();
+        }
+
+        // Wait Update of Module
+        void Nuitrack::waitUpdate( const Module::Ptr& module )
+        {
+            Backend::instance().waitUpdate( module );
+        }
+
+        // Release
+        void Nuitrack::release()
+        {
+            Backend::instance().release();
+        }
+
+        // Set Config Value
+        void Nuitrack::setConfigValue( const std::string& key, const std::string& value )
+        {
+            Backend::instance().config[key] = value;
+        }
+
+        // Retrieve Config Value
+        std::string Nuitrack::getConfigValue( const std::string& key )
+        {
+            // Default Values of Keys that Samples Read
+            static const std::map<std::string, std::string> defaults = {
+                { "Realsense2Module.Depth.ProcessMaxDepth", "5000" },
+                { "Realsense2Module.Depth.ProcessWidth", "640" },
+                { "Realsense2Module.Depth.ProcessHeight", "480" },
+                { "Realsense2Module.RGB.ProcessWidth", "640" },
+                { "Realsense2Module.RGB.ProcessHeight", "480" },
+                { "Realsense2Module.Depth2ColorRegistration", "false" }
+            };
+
+            const std::map<std::string, std::string>::const_iterator it = defaults.find( key );
+            return Backend::instance().value( key, it != defaults.end() ? it->second : "" );
+        }
+
+        // Retrieve Instances JSON
+        std::string Nuitrack::getInstancesJson()
+        {
+            Backend& backend = Backend::instance();
+            return backend.device( backend.selected ).instances_json;
+        }
+
+        // Retrieve Devices
+        std::vector<device::NuitrackDevice::Ptr> Nuitrack::getDeviceList()
+        {
+            Backend& backend = Backend::instance();
+            if( !backend.initialized ){
+                throw tdv::nuitrack::Exception( "failed to get device list (not initialized)" );
+            }
+
+            backend.enumerate();
+            std::vector<device::NuitrackDevice::Ptr> devices;
+            for( uint32_t index = 0; index < backend.devices.size(); index++ ){
+                devices.push_back( std::make_shared<device::NuitrackDevice>( index ) );
+            }
+            return devices;
+        }
+
+        // Select Device of Modules that are Created after
+        void Nuitrack::setDevice( const device::NuitrackDevice::Ptr& device )
+        {
+            Backend& backend = Backend::instance();
+            backend.selected = Backend::indexOf( *device );
+            backend.device( backend.selected );
+        }
+
+        // Retrieve Information of Device
+        std::string device::NuitrackDevice::getInfo( const DeviceInfoType::Type type ) const
+        {
+            switch( type ){
+                case DeviceInfoType::DEVICE_NAME:
+                    return "Stand-in D435";
+                case DeviceInfoType::SERIAL_NUMBER:
+                    return "STANDIN" + std::to_string( 1000 + index );
+                case DeviceInfoType::PROVIDER_NAME:
+                    return "Stand-in";
+                default:
+                    return "";
+            }
+        }
+    }
+}
@@ -0,0 +1,343 @@
+// This is test of depth codec (core/codec.h).
+// Frames are round tripped through encode() and decode() on edge cases (all-zero, 1 pixel, odd width, maximum values),
+// and truncated or corrupted frames are checked to be rejected by header() and decode().
+// Returns non-zero if any check is failed.
+//
+// ctest --test-dir <build> -R codec
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <stdexcept>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "codec.h"
+
+// Number of Failed Checks
+static int32_t failures = 0;
+
+// Check Condition
+static void check( const bool condition, const std::string& name )
+{
+    if( !condition ){
+        std::cerr << "FAILED: " << name << std::endl;
+        failures++;
+    }
+}
+
+// Check Function Throws std::runtime_error
+static void checkThrows( const std::function<void()>& function, const std::string& name )
+{
+    try{
+        function();
+    }
+    catch( const std::runtime_error& ){
+        return;
+    }
+    std::cerr << "FAILED: " << name << " (not rejected)" << std::endl;
+    failures++;
+}
+
+// Store 32 bit Value to Encoded Frame (Little Endian)
+static void store( std::vector<uint8_t>& buffer, const size_t offset, const uint32_t value )
+{
+    for( size_t index = 0; index < 4; index++ ){
+        buffer[offset + index] = static_cast<uint8_t>( value >> ( index * 8 ) );
+    }
+}
+
+// Load 32 bit Value from Encoded Frame (Little Endian)
+static uint32_t load( const std::vector<uint8_t>& buffer, const size_t offset )
+{
+    uint32_t value = 0;
+    for( size_t index = 0; index < 4; index++ ){
+        value |= static_cast<uint32_t>( buffer[offset + index] ) << ( index * 8 );
+    }
+    return value;
+}
+
+// Encode Frame and Return Exactly Encoded Bytes
+static std::vector<uint8_t> encode( const std::vector<uint16_t>& depth, const std::vector<uint16_t>& labels, const int32_t width, const int32_t height )
+{
+    std::vector<uint8_t> buffer;
+    const size_t size = codec::encode( depth.data(), labels.empty() ? nullptr : labels.data(), width, height, buffer );
+    buffer.resize( size );
+    return buffer;
+}
+
+// Round Trip Frame (Depth, and User Labels if not Empty)
+static void roundTrip( const std::vector<uint16_t>& depth, const std::vector<uint16_t>& labels, const int32_t width, const int32_t height, const std::string& name )
+{
+    const size_t total = static_cast<size_t>( width ) * height;
+    const bool labeled = !labels.empty();
+
+    std::vector<uint8_t> encoded;
+    try{
+        encoded = encode( depth, labels, width, height );
+    }
+    catch( const std::exception& exception ){
+        check( false, name + " (encode: " + exception.what() + ")" );
+        return;
+    }
+    check( encoded.size() <= codec::bound( width, height, labeled ), name + " (bound)" );
+
+    // Header
+    try{
+        const codec::Header header = codec::header( encoded.data(), encoded.size() );
+        check( header.width == static_cast<uint32_t>( width ) && header.height == static_cast<uint32_t>( height ) && header.labels == labeled, name + " (header)" );
+    }
+    catch( const std::exception& exception ){
+        check( false, name + " (header: " + exception.what() + ")" );
+        return;
+    }
+
+    // Decode into Buffers with Guard Pixels (Decoder must not Write beyond width * height)
+    const uint16_t guard = 0xBEEF;
+    std::vector<uint16_t> decoded_depth( total + 1, guard );
+    std::vector<uint16_t> decoded_labels( total + 1, guard );
+    try{
+        codec::decode( encoded.data(), encoded.size(), decoded_depth.data(), labeled ? decoded_labels.data() : nullptr );
+    }
+    catch( const std::exception& exception ){
+        check( false, name + " (decode: " + exception.what() + ")" );
+        return;
+    }
+
+    check( std::equal( depth.begin(), depth.end(), decoded_depth.begin() ) && decoded_depth[total] == guard, name + " (depth)" );
+    if( labeled ){
+        check( std::equal( labels.begin(), labels.end(), decoded_labels.begin() ) && decoded_labels[total] == guard, name + " (labels)" );
+    }
+
+    // Depth Only from Frame with Labels
+    if( labeled ){
+        std::vector<uint16_t> depth_only( total );
+        try{
+            codec::decode( encoded.data(), encoded.size(), depth_only.data(), nullptr );
+            check( depth_only == depth, name + " (depth only)" );
+        }
+        catch( const std::exception& exception ){
+            check( false, name + " (depth only: " + exception.what() + ")" );
+        }
+    }
+}
+
+// Round Trip Frame with and without User Labels
+static void roundTrip( const std::vector<uint16_t>& depth, const std::vector<uint16_t>& labels, const int32_t width, const int32_t height )
+{
+    const std::string name = std::to_string( width ) + "x" + std::to_string( height );
+    roundTrip( depth, std::vector<uint16_t>(), width, height, "round trip " + name );
+    roundTrip( depth, labels, width, height, "round trip " + name + " with labels" );
+}
+
+// Generate Depth like Sensor (Holes, Smooth Surfaces, Edges)
+static std::vector<uint16_t> generateDepth( const int32_t width, const int32_t height, std::mt19937& engine )
+{
+    std::uniform_int_distribution<int32_t> hole( 0, 9 );
+    std::uniform_int_distribution<int32_t> noise( -3, 3 );
+    std::uniform_int_distribution<int32_t> edge( 0, 63 );
+    std::uniform_int_distribution<int32_t> distance( 1, 65535 );
+
+    std::vector<uint16_t> depth( static_cast<size_t>( width ) * height );
+    int32_t value = 1000;
+    for( size_t index = 0; index < depth.size(); index++ ){
+        if( edge( engine ) == 0 ){
+            value = distance( engine );
+        }
+        value = std::min( std::max( value + noise( engine ), 1 ), 65535 );
+        depth[index] = hole( engine ) == 0 ? 0 : static_cast<uint16_t>( value );
+    }
+    return depth;
+}
+
+// Generate User Labels (Runs of Same Label)
+static std::vector<uint16_t> generateLabels( const int32_t width, const int32_t height, std::mt19937& engine )
+{
+    std::uniform_int_distribution<int32_t> change( 0, 31 );
+    std::uniform_int_distribution<int32_t> label( 0, 6 );
+
+    std::vector<uint16_t> labels( static_cast<size_t>( width ) * height );
+    uint16_t value = 0;
+    for( size_t index = 0; index < labels.size(); index++ ){
+        if( change( engine ) == 0 ){
+            value = static_cast<uint16_t>( label( engine ) );
+        }
+        labels[index] = value;
+    }
+    return labels;
+}
+
+// Round Trip Edge Cases
+static void testRoundTrip()
+{
+    std::mt19937 engine( 0 );
+
+    // All-Zero Frames
+    for( const int32_t size : { 1, 2, 7, 8, 9, 64 } ){
+        const std::vector<uint16_t> zero( static_cast<size_t>( size ) * size, 0 );
+        roundTrip( zero, zero, size, size );
+    }
+    roundTrip( std::vector<uint16_t>( 640 * 480, 0 ), std::vector<uint16_t>( 640 * 480, 0 ), 640, 480 );
+
+    // 1 Pixel Frames
+    for( const uint16_t value : { 0, 1, 2, 1000, 65534, 65535 } ){
+        roundTrip( std::vector<uint16_t>( 1, value ), std::vector<uint16_t>( 1, value ), 1, 1 );
+    }
+
+    // Odd Widths (Not Multiple of 8 Pixels Scanned at a Time)
+    for( const int32_t width : { 1, 3, 5, 7, 9, 15, 17, 641 } ){
+        const int32_t height = 7;
+        roundTrip( generateDepth( width, height, engine ), generateLabels( width, height, engine ), width, height );
+    }
+    roundTrip( generateDepth( 1, 480, engine ), generateLabels( 1, 480, engine ), 1, 480 );
+
+    // Maximum Values
+    {
+        const int32_t width = 33;
+        const int32_t height = 3;
+        const size_t total = width * height;
+
+        // Saturated Depth and Labels
+        roundTrip( std::vector<uint16_t>( total, 65535 ), std::vector<uint16_t>( total, 65535 ), width, height );
+
+        // Maximum Differences between Non-Zero Pixels
+        std::vector<uint16_t> alternate( total );
+        std::vector<uint16_t> labels( total );
+        for( size_t index = 0; index < total; index++ ){
+            alternate[index] = index % 2 ? 65535 : 1;
+            labels[index] = index % 2 ? 65535 : 0;
+        }
+        roundTrip( alternate, labels, width, height );
+
+        // Maximum Differences across Zero Runs
+        std::vector<uint16_t> sparse( total, 0 );
+        for( size_t index = 0; index < total; index += 5 ){
+            sparse[index] = ( index / 5 ) % 2 ? 65535 : 1;
+        }
+        roundTrip( sparse, labels, width, height );
+
+        // Single Non-Zero Pixel at End of Frame
+        std::vector<uint16_t> last( total, 0 );
+        last[total - 1] = 65535;
+        roundTrip( last, last, width, height );
+    }
+}
+
+// Rejection of Truncated and Corrupted Frames
+static void testReject()
+{
+    std::mt19937 engine( 1 );
+    const int32_t width = 37;
+    const int32_t height = 11;
+    const size_t total = width * height;
+    const std::vector<uint16_t> depth = generateDepth( width, height, engine );
+    const std::vector<uint16_t> labels = generateLabels( width, height, engine );
+    const std::vector<uint8_t> encoded = encode( depth, labels, width, height );
+    const std::vector<uint8_t> depth_only = encode( depth, std::vector<uint16_t>(), width, height );
+    const uint32_t depth_bytes = load( encoded, 16 );
+    const uint32_t label_bytes = load( encoded, 20 );
+
+    std::vector<uint16_t> decoded_depth( total );
+    std::vector<uint16_t> decoded_labels( total );
+    const auto decode = [&]( const std::vector<uint8_t>& data, const size_t size ){
+        codec::decode( data.data(), size, decoded_depth.data(), decoded_labels.data() );
+    };
+
+    // Invalid Arguments of Encoder
+    std::vector<uint8_t> buffer;
+    checkThrows( [&](){ codec::encode( nullptr, nullptr, width, height, buffer ); }, "encode null depth" );
+    checkThrows( [&](){ codec::encode( depth.data(), nullptr, 0, height, buffer ); }, "encode zero width" );
+    checkThrows( [&](){ codec::encode( depth.data(), nullptr, width, -1, buffer ); }, "encode negative height" );
+    checkThrows( [&](){ codec::encode( depth.data(), nullptr, 65536, 1, buffer ); }, "encode too large width" );
+
+    // Truncated at Every Length
+    for( size_t size = 0; size < encoded.size(); size++ ){
+        checkThrows( [&](){ decode( encoded, size ); }, "truncated to " + std::to_string( size ) + " bytes" );
+    }
+    checkThrows( [&](){ codec::decode( nullptr, 0, decoded_depth.data(), nullptr ); }, "null data" );
+
+    // Truncated Streams (Header is Consistent with Shortened Data)
+    for( uint32_t cut = 1; cut <= depth_bytes; cut++ ){
+        std::vector<uint8_t> corrupted( depth_only.begin(), depth_only.end() - cut );
+        store( corrupted, 16, depth_bytes - cut );
+        checkThrows( [&](){ codec::decode( corrupted.data(), corrupted.size(), decoded_depth.data(), nullptr ); }, "depth stream truncated by " + std::to_string( cut ) + " bytes" );
+    }
+    for( uint32_t cut = 1; cut < label_bytes; cut++ ){
+        std::vector<uint8_t> corrupted( encoded.begin(), encoded.end() - cut );
+        store( corrupted, 20, label_bytes - cut );
+        checkThrows( [&](){ decode( corrupted, corrupted.size() ); }, "label stream truncated by " + std::to_string( cut ) + " bytes" );
+    }
+
+    // Corrupted Header
+    const auto corruptHeader = [&]( const size_t offset, const uint32_t value, const std::string& name ){
+        std::vector<uint8_t> corrupted = encoded;
+        store( corrupted, offset, value );
+        checkThrows( [&](){ decode( corrupted, corrupted.size() ); }, name );
+    };
+    corruptHeader( 0, 0x314C5653u, "invalid magic" );
+    corruptHeader( 4, 0, "zero width" );
+    corruptHeader( 8, 0, "zero height" );
+    corruptHeader( 4, 65536, "too large width" );
+    corruptHeader( 8, 0xFFFFFFFFu, "too large height" );
+    corruptHeader( 12, 0, "labels flag cleared" );
+    corruptHeader( 16, depth_bytes + 1, "depth bytes beyond data" );
+    corruptHeader( 16, 0xFFFFFFFFu, "depth bytes overflow" );
+    corruptHeader( 20, label_bytes + 1, "label bytes beyond data" );
+    corruptHeader( 20, 0, "label bytes cleared" );
+    corruptHeader( 4, width * 2, "larger width than coded" );
+    corruptHeader( 8, height * 2, "larger height than coded" );
+
+    // Labels Requested from Frame without Labels
+    checkThrows( [&](){ decode( depth_only, depth_only.size() ); }, "labels of frame without labels" );
+
+    // Corrupted Payload (All Bits Set: Run Lengths and Differences beyond Frame)
+    {
+        std::vector<uint8_t> corrupted = encoded;
+        std::fill( corrupted.begin() + codec::HEADER_BYTES, corrupted.begin() + codec::HEADER_BYTES + depth_bytes, 0xFF );
+        checkThrows( [&](){ decode( corrupted, corrupted.size() ); }, "corrupted depth stream" );
+    }
+    {
+        std::vector<uint8_t> corrupted = encoded;
+        std::fill( corrupted.begin() + codec::HEADER_BYTES + depth_bytes, corrupted.end(), 0xFF );
+        checkThrows( [&](){ decode( corrupted, corrupted.size() ); }, "corrupted label stream" );
+    }
+
+    // Random Bit Flips (Not always Detectable, but must not Write beyond Output or Crash)
+    std::uniform_int_distribution<size_t> position( codec::HEADER_BYTES, encoded.size() - 1 );
+    std::uniform_int_distribution<int32_t> bit( 0, 7 );
+    const uint16_t guard = 0xBEEF;
+    std::vector<uint16_t> guarded_depth( total + 1 );
+    std::vector<uint16_t> guarded_labels( total + 1 );
+    for( int32_t iteration = 0; iteration < 10000; iteration++ ){
+        std::vector<uint8_t> corrupted = encoded;
+        corrupted[position( engine )] ^= static_cast<uint8_t>( 1 << bit( engine ) );
+        guarded_depth[total] = guard;
+        guarded_labels[total] = guard;
+        try{
+            codec::decode( corrupted.data(), corrupted.size(), guarded_depth.data(), guarded_labels.data() );
+        }
+        catch( const std::runtime_error& ){
+        }
+        if( guarded_depth[total] != guard || guarded_labels[total] != guard ){
+            check( false, "bit flip " + std::to_string( iteration ) + " (written beyond output)" );
+            break;
+        }
+    }
+}
+
+int main()
+{
+    testRoundTrip();
+    testReject();
+
+    if( failures ){
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}